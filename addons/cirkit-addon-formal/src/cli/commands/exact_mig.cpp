@@ -31,10 +31,12 @@
 
 #include <cli/stores.hpp>
 #include <core/utils/program_options.hpp>
+#include <core/utils/timer.hpp>
 #include <classical/mig/mig.hpp>
 #include <classical/mig/mig_from_string.hpp>
 #include <classical/mig/mig_utils.hpp>
 #include <classical/utils/truth_table_utils.hpp>
+#include <classical/xmg/xmg_exact_cnf.hpp>
 #include <formal/synthesis/exact_mig.hpp>
 
 using namespace boost::program_options;
@@ -63,7 +65,13 @@ exact_mig_command::exact_mig_command( const environment::ptr& env )
     ( "stop",              value( &stop ),                       "stop value for gate enumeration (ignored for depth/size-optimum)" )
     ( "start_depth",       value_with_default( &start_depth ),   "start value for depth enumeration" )
     ( "mig,m",                                                   "load spec from MIG instead of truth table" )
+    ( "engine,e",          value_with_default( &engine ),        "synthesis engine: z3, minisat, abcsat" )
+    ( "binary",                                                  "binary instead of one-hot selection variables (minisat and abcsat engines)" )
+    ( "cardinality",       value_with_default( &cardinality ),   "one-hot encoding (minisat and abcsat engines):\n0: pairwise\n1: Sinz\n2: Bailleux-Boufkhad" )
+    ( "npn4",                                                    "compare engine against z3 on all 4-input NPN classes" )
     ( "incremental,i",                                           "incremental SAT solving" )
+    ( "portfolio,p",                                             "solve several sizes and encodings in parallel (only for size-optimum)" )
+    ( "threads,j",         value_with_default( &num_threads ),   "number of threads in portfolio mode" )
     ( "max_solutions,m",   value_with_default( &max_solutions ), "enumerate as many solutions (only with non incremental)" )
     ( "breaking",          value_with_default( &breaking ),      "symmetry breaking\ns: structural hashing\na: associativity\nl: co-lexicographic ordering\nt: support\ny: symmetric variables" )
     ( "print_solutions",                                         "print solutions" )
@@ -75,6 +83,20 @@ exact_mig_command::exact_mig_command( const environment::ptr& env )
   be_verbose();
 }
 
+command::rules_t exact_mig_command::validity_rules() const
+{
+  return {
+    {[this]() { return engine == "z3" || engine == "minisat" || engine == "abcsat"; }, "unknown engine, use z3, minisat, or abcsat"},
+    {[this]() { return engine == "z3" || objective == 0u; }, "depth objectives require --engine z3"},
+    {[this]() { return engine == "z3" || !is_set( "incremental" ); }, "--incremental requires --engine z3"},
+    {[this]() { return engine == "z3" || !is_set( "portfolio" ); }, "--portfolio requires --engine z3"},
+    {[this]() { return engine == "z3" || !is_set( "timeout" ); }, "--timeout requires --engine z3"},
+    {[this]() { return engine == "z3" || max_solutions == 1u; }, "--max_solutions requires --engine z3"},
+    {[this]() { return engine == "z3" || start_depth == 1u; }, "--start_depth requires --engine z3"},
+    {[this]() { return engine != "z3" || is_set( "npn4" ) || ( !is_set( "binary" ) && cardinality == 0u ); }, "--binary and --cardinality require --engine minisat or abcsat"}
+  };
+}
+
 bool exact_mig_command::execute()
 {
   using boost::format;
@@ -88,9 +110,14 @@ bool exact_mig_command::execute()
   }
   settings->set( "start_depth",         start_depth );
   settings->set( "incremental",         is_set( "incremental" ) );
+  settings->set( "portfolio",           is_set( "portfolio" ) );
+  settings->set( "num_threads",         num_threads );
   settings->set( "max_solutions",       max_solutions );
   settings->set( "breaking",            breaking );
   settings->set( "enc_with_bitvectors", !is_set( "enc_int" ) );
+  settings->set( "solver",              engine );
+  settings->set( "binary",              is_set( "binary" ) );
+  settings->set( "cardinality",         cardinality );
   settings->set( "very_verbose",        is_set( "very_verbose" ) );
   if ( is_set( "timeout" ) )
   {
@@ -101,34 +128,41 @@ bool exact_mig_command::execute()
   const auto& tts = env->store<tt>();
   auto& migs = env->store<mig_graph>();
 
-  if ( is_set( "mig" ) )
+  if ( is_set( "npn4" ) )
   {
-    auto new_mig = exact_mig_with_sat( migs.current(), settings, statistics );
-    if ( (bool)new_mig )
-    {
-      migs.extend();
-      migs.current() = *new_mig;
-    }
-    else
+    if ( engine == "z3" )
     {
-      std::cout << "[w] timeout" << std::endl;
+      settings->set( "solver", std::string( "minisat" ) );
     }
+    exact_npn4_engine_comparison( false, settings, statistics );
+    return true;
+  }
+
+  boost::optional<mig_graph> new_mig;
+  if ( is_set( "mig" ) )
+  {
+    new_mig = engine == "z3" ? exact_mig_with_sat( migs.current(), settings, statistics ) : exact_mig_with_cnf( migs.current(), settings, statistics );
   }
   else
   {
-    auto new_mig = exact_mig_with_sat( tts.current(), settings, statistics );
-    if ( (bool)new_mig )
-    {
-      migs.extend();
-      migs.current() = *new_mig;
-    }
-    else
-    {
-      std::cout << "[w] timeout" << std::endl;
-    }
+    new_mig = engine == "z3" ? exact_mig_with_sat( tts.current(), settings, statistics ) : exact_mig_with_cnf( tts.current(), settings, statistics );
+  }
+
+  if ( (bool)new_mig )
+  {
+    migs.extend();
+    migs.current() = *new_mig;
+  }
+  else if ( engine == "z3" && is_set( "timeout" ) )
+  {
+    std::cout << "[w] timeout" << std::endl;
+  }
+  else
+  {
+    std::cout << format( "[w] no MIG found with up to %d gates" ) % statistics->get<unsigned>( "last_size" ) << std::endl;
   }
 
-  if ( is_set( "print_solutions" ) )
+  if ( is_set( "print_solutions" ) && engine == "z3" )
   {
     const auto& solutions = statistics->get<std::vector<mig_graph>>( "all_solutions" );
 
@@ -142,7 +176,10 @@ bool exact_mig_command::execute()
   }
 
   print_runtime();
-  std::cout << format( "[i] memory: %.2f MB" ) % statistics->get<double>( "memory" ) << std::endl;
+  if ( engine == "z3" )
+  {
+    std::cout << format( "[i] memory: %.2f MB" ) % statistics->get<double>( "memory" ) << std::endl;
+  }
 
   return true;
 }
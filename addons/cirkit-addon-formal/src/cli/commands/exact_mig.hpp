@@ -36,6 +36,9 @@
 #ifndef CLI_EXACT_MIG_COMMAND_HPP
 #define CLI_EXACT_MIG_COMMAND_HPP
 
+#include <algorithm>
+#include <thread>
+
 #include <cli/cirkit_command.hpp>
 
 namespace cirkit
@@ -47,6 +50,7 @@ public:
   exact_mig_command( const environment::ptr& env );
 
 protected:
+  rules_t validity_rules() const;
   bool execute();
 
 public:
@@ -59,7 +63,10 @@ private:
   unsigned    start_depth = 1u;
   unsigned    timeout;
   unsigned    max_solutions = 1u;
+  unsigned    num_threads = std::max( 1u, std::thread::hardware_concurrency() );
   std::string breaking = "CIsalty";
+  std::string engine = "z3";
+  unsigned    cardinality = 0u;
 };
 
 }
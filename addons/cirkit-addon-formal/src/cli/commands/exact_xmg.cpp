@@ -31,9 +31,11 @@
 
 #include <cli/stores.hpp>
 #include <core/utils/program_options.hpp>
+#include <core/utils/timer.hpp>
 #include <classical/mig/mig.hpp>
 #include <classical/utils/truth_table_utils.hpp>
 #include <classical/xmg/xmg.hpp>
+#include <classical/xmg/xmg_exact_cnf.hpp>
 #include <classical/xmg/xmg_expr.hpp>
 #include <formal/synthesis/exact_mig.hpp>
 
@@ -61,7 +63,13 @@ exact_xmg_command::exact_xmg_command( const environment::ptr& env )
     ( "objective,o",       value_with_default( &objective ), "optimization objective:\n0: size-optimum\n1: size/depth-optimum\n2: depth/size-optimum" )
     ( "start,s",           value_with_default( &start ),     "start value for gate enumeration" )
     ( "mig,m",                                               "load spec from MIG instead of truth table" )
+    ( "engine,e",          value_with_default( &engine ),    "synthesis engine: z3, minisat, abcsat" )
+    ( "binary",                                              "binary instead of one-hot selection variables (minisat and abcsat engines)" )
+    ( "cardinality",       value_with_default( &cardinality ), "one-hot encoding (minisat and abcsat engines):\n0: pairwise\n1: Sinz\n2: Bailleux-Boufkhad" )
+    ( "npn4",                                                "compare engine against z3 on all 4-input NPN classes" )
     ( "incremental,i",                                       "incremental SAT solving" )
+    ( "portfolio,p",                                         "solve several sizes and encodings in parallel (only for size-optimum)" )
+    ( "threads,j",         value_with_default( &num_threads ), "number of threads in portfolio mode" )
     ( "all_solutions,a",                                     "enumerate all solutions (only with non incremental)" )
     ( "breaking",          value_with_default( &breaking ),  "symmetry breaking\ns: structural hashing\na: associativity\nl: co-lexicographic ordering\nt: support" )
     ( "print_solutions",                                     "print solutions" )
@@ -73,6 +81,19 @@ exact_xmg_command::exact_xmg_command( const environment::ptr& env )
   be_verbose();
 }
 
+command::rules_t exact_xmg_command::validity_rules() const
+{
+  return {
+    {[this]() { return engine == "z3" || engine == "minisat" || engine == "abcsat"; }, "unknown engine, use z3, minisat, or abcsat"},
+    {[this]() { return engine == "z3" || objective == 0u; }, "depth objectives require --engine z3"},
+    {[this]() { return engine == "z3" || !is_set( "incremental" ); }, "--incremental requires --engine z3"},
+    {[this]() { return engine == "z3" || !is_set( "portfolio" ); }, "--portfolio requires --engine z3"},
+    {[this]() { return engine == "z3" || !is_set( "timeout" ); }, "--timeout requires --engine z3"},
+    {[this]() { return engine == "z3" || !is_set( "all_solutions" ); }, "--all_solutions requires --engine z3"},
+    {[this]() { return engine != "z3" || is_set( "npn4" ) || ( !is_set( "binary" ) && cardinality == 0u ); }, "--binary and --cardinality require --engine minisat or abcsat"}
+  };
+}
+
 bool exact_xmg_command::execute()
 {
   using boost::format;
@@ -81,9 +102,14 @@ bool exact_xmg_command::execute()
   settings->set( "objective",           objective );
   settings->set( "start",               start );
   settings->set( "incremental",         is_set( "incremental" ) );
+  settings->set( "portfolio",           is_set( "portfolio" ) );
+  settings->set( "num_threads",         num_threads );
   settings->set( "all_solutions",       is_set( "all_solutions" ) );
   settings->set( "breaking",            breaking );
   settings->set( "enc_with_bitvectors", !is_set( "enc_int" ) );
+  settings->set( "solver",              engine );
+  settings->set( "binary",              is_set( "binary" ) );
+  settings->set( "cardinality",         cardinality );
   settings->set( "very_verbose",        is_set( "very_verbose" ) );
   if ( is_set( "timeout" ) )
   {
@@ -95,34 +121,41 @@ bool exact_xmg_command::execute()
   auto& migs = env->store<mig_graph>();
   auto& xmgs = env->store<xmg_graph>();
 
-  if ( is_set( "mig" ) )
+  if ( is_set( "npn4" ) )
   {
-    auto new_xmg = exact_xmg_with_sat( migs.current(), settings, statistics );
-    if ( (bool)new_xmg )
-    {
-      xmgs.extend();
-      xmgs.current() = *new_xmg;
-    }
-    else
+    if ( engine == "z3" )
     {
-      std::cout << "[w] timeout" << std::endl;
+      settings->set( "solver", std::string( "minisat" ) );
     }
+    exact_npn4_engine_comparison( true, settings, statistics );
+    return true;
+  }
+
+  boost::optional<xmg_graph> new_xmg;
+  if ( is_set( "mig" ) )
+  {
+    new_xmg = engine == "z3" ? exact_xmg_with_sat( migs.current(), settings, statistics ) : exact_xmg_with_cnf( migs.current(), settings, statistics );
   }
   else
   {
-    auto new_xmg = exact_xmg_with_sat( tts.current(), settings, statistics );
-    if ( (bool)new_xmg )
-    {
-      xmgs.extend();
-      xmgs.current() = *new_xmg;
-    }
-    else
-    {
-      std::cout << "[w] timeout" << std::endl;
-    }
+    new_xmg = engine == "z3" ? exact_xmg_with_sat( tts.current(), settings, statistics ) : exact_xmg_with_cnf( tts.current(), settings, statistics );
+  }
+
+  if ( (bool)new_xmg )
+  {
+    xmgs.extend();
+    xmgs.current() = *new_xmg;
+  }
+  else if ( engine == "z3" && is_set( "timeout" ) )
+  {
+    std::cout << "[w] timeout" << std::endl;
+  }
+  else
+  {
+    std::cout << format( "[w] no XMG found with up to %d gates" ) % statistics->get<unsigned>( "last_size" ) << std::endl;
   }
 
-  if ( is_set( "all_solutions" ) )
+  if ( is_set( "all_solutions" ) && engine == "z3" )
   {
     const auto& solutions = statistics->get<std::vector<xmg_graph>>( "all_solutions" );
     std::cout << format( "[i] found %d solutions" ) % solutions.size() << std::endl;
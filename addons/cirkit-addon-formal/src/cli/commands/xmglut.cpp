@@ -70,6 +70,7 @@ xmglut_command::xmglut_command( const environment::ptr& env )
     ( "noxor",                                       "don't use XOR, only works with LUT sizes up to 4" )
     ( "blif_name",  value( &blif_name ),             "read cover from BLIF instead of AIG" )
     ( "dump_luts",  value( &dump_luts ),             "if not empty, all LUTs will be written to file without performing mapping" )
+    ( "priority_cuts", value_with_default( &priority_cuts ), "number of priority cuts per node when mapping an XMG (0: enumerate all cuts)" )
     ( "progress,p",                                  "show progress" )
     ;
   add_new_option();
@@ -93,6 +94,8 @@ bool xmglut_command::execute()
 
   auto settings = make_settings();
   settings->set( "lut_size", lut_size );
+  settings->set( "cut_size", lut_size );
+  settings->set( "priority_cuts", priority_cuts );
   settings->set( "noxor", is_set( "noxor" ) );
   settings->set( "progress", is_set( "progress" ) );
   if ( is_set( "dump_luts" ) )
@@ -54,7 +54,8 @@ public:
   log_opt_t log() const;
 
 private:
-  unsigned lut_size    = 6u;
+  unsigned lut_size      = 6u;
+  unsigned priority_cuts = 8u;
   unsigned timeout;
   std::string map_cmd  = "&if -a -K %d";
   std::string blif_name;
@@ -31,6 +31,7 @@
 
 #include <alice/rules.hpp>
 #include <cli/stores.hpp>
+#include <core/utils/program_options.hpp>
 #include <formal/xmg/xmg_mine.hpp>
 #include <formal/xmg/xmg_minlib.hpp>
 
@@ -46,6 +47,9 @@ xmgmine_command::xmgmine_command( const environment::ptr& env )
     ( "lut_file",  value( &lut_file ), "filename with truth table in binary form in each line" )
     ( "opt_file",  value( &opt_file ), "filename with optimum XMG database" )
     ( "timeout,t", value( &timeout ),  "timeout in seconds (afterwards, heuristics are tried)" )
+    ( "threads,j", value_with_default( &num_threads ), "number of worker threads" )
+    ( "checkpoint", value_with_default( &checkpoint_interval ), "number of new entries after which the database is updated" )
+    ( "no_npn",                        "do not reduce functions to NPN representatives" )
     ( "add,a",                         "add current XMG to database" )
     ( "verify",                        "verifies entries in optimum XMG database" )
     ;
@@ -115,6 +119,9 @@ bool xmgmine_command::execute()
     {
       settings->set( "timeout", boost::optional<unsigned>( timeout ) );
     }
+    settings->set( "num_threads", num_threads );
+    settings->set( "checkpoint_interval", checkpoint_interval );
+    settings->set( "npn", !is_set( "no_npn" ) );
     xmg_mine( lut_file, opt_file, settings );
   }
 
@@ -56,6 +56,8 @@ private:
   std::string lut_file;
   std::string opt_file;
   unsigned    timeout;
+  unsigned    num_threads = 4u;
+  unsigned    checkpoint_interval = 1u;
 };
 
 }
@@ -26,21 +26,34 @@
 
 #include "exact_mig.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <condition_variable>
+#include <functional>
+#include <iostream>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
 #include <type_traits>
 #include <vector>
 
 #include <boost/assign/std/vector.hpp>
+#include <boost/dynamic_bitset.hpp>
 #include <boost/format.hpp>
 #include <boost/optional.hpp>
 #include <boost/variant.hpp>
 
 #include <core/utils/range_utils.hpp>
+#include <core/utils/thread_pool.hpp>
 #include <core/utils/timer.hpp>
+#include <classical/functions/npn_canonization.hpp>
 #include <classical/mig/mig_from_string.hpp>
 #include <classical/mig/mig_utils.hpp>
 #include <classical/utils/spec_representation.hpp>
+#include <classical/xmg/xmg_exact_cnf.hpp>
 
 #ifdef ADDON_FORMAL
 #include <formal/utils/z3_utils.hpp>
@@ -663,55 +676,94 @@ struct exact_mig_instance
   }
 
   void constrain( const tt& spec )
+  {
+    encode_simulation();
+
+    for ( auto j = 0u; j < sim_out.size(); ++j )
+    {
+      solver.add( sim_out[j].back() == ctx.bool_val( spec[j] ) );
+    }
+  }
+
+  /* output constraints guarded by the returned literal, which needs to be
+     passed as assumption; only new levels are added to the simulation */
+  z3::expr constrain_activated( const tt& spec )
+  {
+    encode_simulation();
+
+    const auto act = ctx.bool_const( str( format( "act_%d" ) % gates.size() ).c_str() );
+    for ( auto j = 0u; j < sim_out.size(); ++j )
+    {
+      solver.add( implies( act, sim_out[j].back() == ctx.bool_val( spec[j] ) ) );
+    }
+    return act;
+  }
+
+  /* encodes the value constraints for all levels that are not yet encoded */
+  void encode_simulation()
   {
     auto N = 1u << num_vars;
 
-    std::vector<std::vector<z3::expr>> out( N );
-    std::vector<std::vector<std::vector<z3::expr>>> in( 3u, std::vector<std::vector<z3::expr>>( N ) );
+    sim_out.resize( N );
 
     /* value constraints */
     for ( auto j = 0u; j < N; ++j )
     {
-      for ( auto level = 0u; level < gates.size(); ++level )
+      auto& out = sim_out[j];
+      boost::dynamic_bitset<> val( num_vars, j );
+
+      for ( auto level = out.size(); level < gates.size(); ++level )
       {
-        out[j] += ctx.bool_const( str( format( "out_%d_%d" ) % j % level ).c_str() );
-        in[0u][j] += ctx.bool_const( str( format( "in1_%d_%d" ) % j % level ).c_str() );
-        in[1u][j] += ctx.bool_const( str( format( "in2_%d_%d" ) % j % level ).c_str() );
-        in[2u][j] += ctx.bool_const( str( format( "in3_%d_%d" ) % j % level ).c_str() );
+        out += ctx.bool_const( str( format( "out_%d_%d" ) % j % level ).c_str() );
+        const z3::expr in[] = {ctx.bool_const( str( format( "in1_%d_%d" ) % j % level ).c_str() ),
+                               ctx.bool_const( str( format( "in2_%d_%d" ) % j % level ).c_str() ),
+                               ctx.bool_const( str( format( "in3_%d_%d" ) % j % level ).c_str() )};
 
         /* assertion for out[j][level] = M(in1[j][level],in2[j][level],in3[j][level] */
         if ( with_xor )
         {
-          solver.add( out[j][level] == ( implies( !gates[level].type(), ( in[0u][j][level] && in[1u][j][level] ) || ( in[0u][j][level] && in[2u][j][level] ) || ( in[1u][j][level] && in[2u][j][level] ) )
-                                         && implies( gates[level].type(), logic_xor( in[0u][j][level], in[1u][j][level] ) ) ) );
+          solver.add( out[level] == ( implies( !gates[level].type(), ( in[0u] && in[1u] ) || ( in[0u] && in[2u] ) || ( in[1u] && in[2u] ) )
+                                      && implies( gates[level].type(), logic_xor( in[0u], in[1u] ) ) ) );
         }
         else
         {
-          solver.add( out[j][level] == ( ( in[0u][j][level] && in[1u][j][level] ) || ( in[0u][j][level] && in[2u][j][level] ) || ( in[1u][j][level] && in[2u][j][level] ) ) );
+          solver.add( out[level] == ( ( in[0u] && in[1u] ) || ( in[0u] && in[2u] ) || ( in[1u] && in[2u] ) ) );
         }
 
         /* assertions for in[x][j][level] = neg[level] ^ ite( sel[level], ... ) */
-        boost::dynamic_bitset<> val( num_vars, j );
         for ( auto x = 0u; x < 3u; ++x )
         {
           solver.add( implies( equals( gates[level][x].sel, 0 ),
-                               in[x][j][level] == logic_xor( gates[level][x].neg, ctx.bool_val( false ) ) ) );
+                               in[x] == logic_xor( gates[level][x].neg, ctx.bool_val( false ) ) ) );
 
           for ( auto l = 0u; l < num_vars; ++l )
           {
             solver.add( implies( equals( gates[level][x].sel, l + 1 ),
-                                 in[x][j][level] == logic_xor( gates[level][x].neg, ctx.bool_val( val[l] ) ) ) );
+                                 in[x] == logic_xor( gates[level][x].neg, ctx.bool_val( val[l] ) ) ) );
           }
           for ( auto l = 0u; l < level; ++l )
           {
             solver.add( implies( equals( gates[level][x].sel, l + 1 + num_vars ),
-                                 in[x][j][level] == logic_xor( gates[level][x].neg, out[j][l] ) ) );
+                                 in[x] == logic_xor( gates[level][x].neg, out[l] ) ) );
           }
         }
       }
+    }
+  }
+
+  z3::check_result check()
+  {
+    if ( assumptions.empty() )
+    {
+      return solver.check();
+    }
 
-      solver.add( out[j].back() == ctx.bool_val( spec[j] ) );
+    z3::expr_vector assumption_vector( ctx );
+    for ( const auto& a : assumptions )
+    {
+      assumption_vector.push_back( a );
     }
+    return solver.check( assumption_vector );
   }
 
   mig_graph extract_mig( const std::string& model_name, const std::string& output_name, bool invert, bool very_verbose )
@@ -973,6 +1025,12 @@ struct exact_mig_instance
 
   unsigned bw;
 
+  /* simulation variables out[j][level] for truth table specs */
+  std::vector<std::vector<z3::expr>> sim_out;
+
+  /* activation literals passed to the solver on each check */
+  std::vector<z3::expr> assumptions;
+
   /* spec properties */
   boost::dynamic_bitset<>                    support;
   std::vector<std::pair<unsigned, unsigned>> symmetries;
@@ -1001,9 +1059,12 @@ public:
     start_depth         = get( settings, "start_depth",         1u );
     incremental         = get( settings, "incremental",         false );
     max_solutions       = get( settings, "max_solutions",       1u );
+    portfolio           = get( settings, "portfolio",           false );
+    num_threads         = get( settings, "num_threads",         std::max( 1u, std::thread::hardware_concurrency() ) );
 
     /* encoding */
     breaking            = get( settings, "breaking",            std::string( "CIsalty" ) );
+    portfolio_breaking  = get( settings, "portfolio_breaking",  std::string( "CI" ) );
     enc_with_bitvectors = get( settings, "enc_with_bitvectors", true );
 
     timeout             = get( settings, "timeout",             boost::optional<unsigned>() );
@@ -1046,7 +1107,11 @@ public:
       spec.invert();
     }
 
-    if ( incremental )
+    if ( portfolio && objective == 0u )
+    {
+      return exact_mig_size_portfolio();
+    }
+    else if ( incremental )
     {
       return exact_mig_size_incremental();
     }
@@ -1231,10 +1296,20 @@ public:
         std::cout << boost::format( "[i] check for realization with %d gates" ) % inst->gates.size() << std::endl;
       }
 
-      /* solve */
-      inst->solver.push();
-      constrain( inst );
-      const auto result = inst->solver.check();
+      /* solve: truth tables keep all value constraints and only switch the
+         output constraint, other specs are re-encoded inside a push/pop frame */
+      const auto act = constrain_activated( inst );
+      if ( (bool)act )
+      {
+        inst->assumptions = {*act};
+      }
+      else
+      {
+        inst->solver.push();
+        constrain( inst );
+      }
+
+      const auto result = inst->check();
       if ( result == z3::sat )
       {
         store_memory( inst );
@@ -1245,11 +1320,144 @@ public:
         last_size = inst->gates.size();
         return std::vector<T>();
       }
-      inst->solver.pop();
+
+      if ( (bool)act )
+      {
+        inst->assumptions.clear();
+        inst->solver.add( !*act );
+      }
+      else
+      {
+        inst->solver.pop();
+      }
+    }
+  }
+
+  std::vector<T> exact_mig_size_portfolio()
+  {
+    /* configurations that race against each other for each k */
+    std::vector<portfolio_config> configs;
+    const auto add_config = [&configs]( bool enc_bv, const boost::dynamic_bitset<>& sb ) {
+      for ( const auto& c : configs )
+      {
+        if ( c.enc_bv == enc_bv && c.symmetry_breaking == sb ) { return; }
+      }
+      configs.push_back( {enc_bv, sb} );
+    };
+    add_config( enc_with_bitvectors, symmetry_breaking );
+    add_config( !enc_with_bitvectors, symmetry_breaking );
+    add_config( enc_with_bitvectors, symmetry_breaking_from_string( portfolio_breaking ) );
+
+    /* at least as many k values as to keep all threads busy */
+    const auto num_configs = static_cast<unsigned>( configs.size() );
+    const auto window      = std::max( 1u, ( num_threads + num_configs - 1u ) / num_configs );
+
+    if ( verbose )
+    {
+      std::cout << boost::format( "[i] portfolio with %d configurations on %d threads, %d levels at a time" ) % num_configs % num_threads % window << std::endl;
+    }
+
+    portfolio_state state;
+    state.best = stop + 1u;
+    auto found = false;
+
+    {
+      thread_pool pool( num_threads );
+      std::unique_lock<std::mutex> lock( state.mutex );
+
+      auto lo     = start; /* all k < lo are unsat */
+      auto next_k = start;
+      auto done   = false;
+
+      while ( !done )
+      {
+        /* schedule new levels */
+        while ( next_k <= stop && next_k < state.best && next_k < lo + window )
+        {
+          state.levels[next_k].open = num_configs;
+          for ( const auto& config : configs )
+          {
+            ++state.outstanding;
+            pool.enqueue( [this, &state, &config, next_k]() { run_portfolio_job( state, config, next_k ); } );
+          }
+          ++next_k;
+        }
+
+        /* advance lower bound */
+        while ( lo < state.best && state.levels.count( lo ) && state.levels[lo].settled && !state.levels[lo].sat &&
+                ( !state.levels[lo].unknown || timeout_heuristic ) )
+        {
+          ++lo;
+        }
+
+        if ( lo == state.best )
+        {
+          found = done = true;
+        }
+        else if ( lo > stop )
+        {
+          last_size = stop;
+          done = true;
+        }
+        else if ( state.levels.count( lo ) && state.levels[lo].settled && state.levels[lo].unknown && !timeout_heuristic )
+        {
+          last_size = lo;
+          done = true;
+        }
+        else
+        {
+          /* interrupting is repeated on every wake-up since a job may start
+             its solver just after the interrupt has been sent */
+          interrupt_cancelled( state );
+          state.cv.wait_for( lock, std::chrono::milliseconds( 10 ) );
+        }
+      }
+
+      /* cancel all remaining jobs */
+      state.finished = true;
+      while ( state.outstanding )
+      {
+        interrupt_cancelled( state );
+        state.cv.wait_for( lock, std::chrono::milliseconds( 10 ) );
+      }
     }
+
+    if ( !found )
+    {
+      return std::vector<T>();
+    }
+
+    store_memory( state.winner );
+    return extract_solutions( state.winner );
   }
 
 private:
+  struct portfolio_config
+  {
+    bool                    enc_bv;
+    boost::dynamic_bitset<> symmetry_breaking;
+  };
+
+  struct portfolio_level
+  {
+    unsigned open    = 0u;    /* configurations that did not answer yet */
+    bool     settled = false;
+    bool     sat     = false;
+    bool     unknown = false; /* no configuration could decide the level */
+  };
+
+  struct portfolio_state
+  {
+    std::mutex                                                            mutex;
+    std::condition_variable                                               cv;
+    std::map<unsigned, portfolio_level>                                   levels;
+    std::vector<std::pair<unsigned, std::shared_ptr<exact_mig_instance>>> running;
+    std::shared_ptr<exact_mig_instance>                                   winner;
+    unsigned                                                              best;
+    unsigned                                                              outstanding = 0u;
+    bool                                                                  finished = false;
+  };
+
   template<typename C, typename std::enable_if<std::is_same<mig_graph, C>::value>::type* = nullptr>
   bool with_xor() const
   {
@@ -1318,7 +1526,12 @@ private:
 
   inline std::shared_ptr<exact_mig_instance> create_instance() const
   {
-    auto inst = std::make_shared<exact_mig_instance>( spec.num_vars(), with_xor<T>(), enc_with_bitvectors, spec.is_explicit(), timeout );
+    return create_instance( enc_with_bitvectors );
+  }
+
+  inline std::shared_ptr<exact_mig_instance> create_instance( bool enc_bv ) const
+  {
+    auto inst = std::make_shared<exact_mig_instance>( spec.num_vars(), with_xor<T>(), enc_bv, spec.is_explicit(), timeout );
     inst->support    = support;
     inst->symmetries = symmetries;
     return inst;
@@ -1334,7 +1547,7 @@ private:
     {
       migs.push_back( extract_solution<T>( inst ) );
       inst->block_solution();
-    } while ( inst->solver.check() == z3::sat && ++counter < max_solutions );
+    } while ( inst->check() == z3::sat && ++counter < max_solutions );
 
     return migs;
   }
@@ -1362,9 +1575,132 @@ private:
     spec.apply_visitor( constrain_visitor( inst ) );
   }
 
-  void make_symmetry_breaking_bitset()
+  struct constrain_activated_visitor : public boost::static_visitor<boost::optional<z3::expr>>
+  {
+    constrain_activated_visitor( const std::shared_ptr<exact_mig_instance>& inst ) : inst( inst ) {}
+
+    boost::optional<z3::expr> operator()( const tt& spec ) const
+    {
+      return inst->constrain_activated( spec );
+    }
+
+    boost::optional<z3::expr> operator()( const mig_graph& spec ) const
+    {
+      return boost::none;
+    }
+
+  private:
+    const std::shared_ptr<exact_mig_instance>& inst;
+  };
+
+  /* returns the activation literal of the output constraint, or none if the spec cannot be constrained incrementally */
+  boost::optional<z3::expr> constrain_activated( const std::shared_ptr<exact_mig_instance>& inst ) const
+  {
+    return spec.apply_visitor( constrain_activated_visitor( inst ) );
+  }
+
+  void run_portfolio_job( portfolio_state& state, const portfolio_config& config, unsigned k ) const
+  {
+    const auto is_cancelled = [&state, k]() {
+      return state.finished || state.levels[k].settled || k >= state.best;
+    };
+
+    std::shared_ptr<exact_mig_instance> inst;
+    auto result = z3::unknown;
+    auto cancelled = false;
+
+    {
+      std::lock_guard<std::mutex> lock( state.mutex );
+      cancelled = is_cancelled();
+    }
+
+    if ( !cancelled )
+    {
+      try
+      {
+        inst = create_instance( config.enc_bv );
+
+        for ( auto i = 0u; i < k; ++i )
+        {
+          inst->add_level( config.symmetry_breaking );
+        }
+
+        constrain( inst );
+
+        {
+          std::lock_guard<std::mutex> lock( state.mutex );
+          cancelled = is_cancelled();
+          if ( !cancelled )
+          {
+            state.running.push_back( {k, inst} );
+          }
+        }
+
+        if ( !cancelled )
+        {
+          result = inst->check();
+        }
+      }
+      catch ( const z3::exception& e )
+      {
+        result = z3::unknown;
+      }
+    }
+
+    std::lock_guard<std::mutex> lock( state.mutex );
+
+    state.running.erase( std::remove_if( state.running.begin(), state.running.end(),
+                                         [&inst]( const std::pair<unsigned, std::shared_ptr<exact_mig_instance>>& p ) { return p.second == inst; } ),
+                         state.running.end() );
+
+    auto& level = state.levels[k];
+    --level.open;
+
+    if ( !cancelled && !level.settled )
+    {
+      if ( result == z3::sat )
+      {
+        level.settled = level.sat = true;
+        if ( k < state.best )
+        {
+          state.best = k;
+          state.winner = inst;
+        }
+      }
+      else if ( result == z3::unsat )
+      {
+        level.settled = true;
+      }
+      else if ( level.open == 0u )
+      {
+        level.settled = level.unknown = true;
+      }
+
+      if ( verbose && level.settled )
+      {
+        std::cout << boost::format( "[i] realization with %d gates: %s" ) % k % ( level.sat ? "sat" : ( level.unknown ? "unknown" : "unsat" ) ) << std::endl;
+      }
+    }
+
+    --state.outstanding;
+    state.cv.notify_all();
+  }
+
+  /* interrupts all solvers whose result is not of interest anymore */
+  void interrupt_cancelled( portfolio_state& state ) const
   {
-    symmetry_breaking.resize( 7u );
+    for ( const auto& p : state.running )
+    {
+      if ( state.finished || p.first >= state.best || state.levels[p.first].settled )
+      {
+        p.second->ctx.interrupt();
+      }
+    }
+  }
+
+  static boost::dynamic_bitset<> symmetry_breaking_from_string( const std::string& breaking )
+  {
+    boost::dynamic_bitset<> symmetry_breaking( 7u );
 
     for ( auto c : breaking )
     {
@@ -1379,6 +1715,13 @@ private:
       case 'y': symmetry_breaking.set( 6u ); break;
       };
     }
+
+    return symmetry_breaking;
+  }
+
+  void make_symmetry_breaking_bitset()
+  {
+    symmetry_breaking = symmetry_breaking_from_string( breaking );
   };
 
   void store_memory( const std::shared_ptr<exact_mig_instance>& inst )
@@ -1406,7 +1749,10 @@ private:
   unsigned objective;
   bool incremental;
   unsigned max_solutions;
+  bool portfolio;
+  unsigned num_threads;
   std::string breaking;
+  std::string portfolio_breaking;
   bool enc_with_bitvectors;
   boost::optional<unsigned> timeout;
   bool timeout_heuristic;
@@ -1435,6 +1781,57 @@ public:
 };
 #endif
 
+/* the synthesis functions return the number of gates of the optimum network */
+using exact_size_func_t = std::function<boost::optional<unsigned>( const tt&, const properties::ptr& )>;
+
+void compare_exact_engines_npn4( const exact_size_func_t& z3_size_func, const exact_size_func_t& cnf_size_func,
+                                 const std::string& engine, const properties::ptr& statistics )
+{
+  std::set<unsigned long> classes;
+  boost::dynamic_bitset<> phase;
+  std::vector<unsigned>   perm;
+  for ( auto f = 0u; f < ( 1u << 16u ); ++f )
+  {
+    classes.insert( exact_npn_canonization( tt( 16u, f ), phase, perm ).to_ulong() );
+  }
+
+  const auto size_str = []( const boost::optional<unsigned>& size ) {
+    return size ? std::to_string( *size ) : std::string( "-" );
+  };
+
+  auto z3_runtime = 0.0, cnf_runtime = 0.0;
+  auto mismatches = 0u;
+
+  for ( auto c : classes )
+  {
+    const tt spec( 16u, c );
+
+    const auto z3_statistics  = std::make_shared<properties>();
+    const auto cnf_statistics = std::make_shared<properties>();
+
+    const auto z3_size  = z3_size_func( spec, z3_statistics );
+    const auto cnf_size = cnf_size_func( spec, cnf_statistics );
+
+    z3_runtime  += z3_statistics->get<double>( "runtime" );
+    cnf_runtime += cnf_statistics->get<double>( "runtime" );
+
+    if ( z3_size && cnf_size && *z3_size != *cnf_size )
+    {
+      ++mismatches;
+    }
+
+    std::cout << format( "[i] 0x%04x   z3: %2s gates %8.2f s   %s: %2s gates %8.2f s" )
+      % c % size_str( z3_size ) % z3_statistics->get<double>( "runtime" )
+      % engine % size_str( cnf_size ) % cnf_statistics->get<double>( "runtime" ) << std::endl;
+  }
+
+  std::cout << format( "[i] %d classes   z3: %.2f s   %s: %.2f s   mismatches: %d" ) % classes.size() % z3_runtime % engine % cnf_runtime % mismatches << std::endl;
+
+  set( statistics, "z3_runtime",  z3_runtime );
+  set( statistics, "cnf_runtime", cnf_runtime );
+  set( statistics, "mismatches",  mismatches );
+}
+
 /******************************************************************************
  * Public functions                                                           *
  ******************************************************************************/
@@ -1550,6 +1947,39 @@ boost::optional<mig_graph> exact_mig_with_bdds( const tt& spec,
   return boost::none;
 }
 
+void exact_npn4_engine_comparison( bool with_xor,
+                                   const properties::ptr& settings,
+                                   const properties::ptr& statistics )
+{
+  /* timing */
+  properties_timer t( statistics );
+
+  const auto engine = get( settings, "solver", std::string( "minisat" ) );
+
+  if ( with_xor )
+  {
+    const auto num_gates = []( const boost::optional<xmg_graph>& xmg ) -> boost::optional<unsigned> {
+      if ( !xmg ) { return boost::none; }
+      return xmg->num_gates();
+    };
+
+    compare_exact_engines_npn4( [&]( const tt& spec, const properties::ptr& stats ) { return num_gates( exact_xmg_with_sat( spec, settings, stats ) ); },
+                                [&]( const tt& spec, const properties::ptr& stats ) { return num_gates( exact_xmg_with_cnf( spec, settings, stats ) ); },
+                                engine, statistics );
+  }
+  else
+  {
+    const auto num_gates = []( const boost::optional<mig_graph>& mig ) -> boost::optional<unsigned> {
+      if ( !mig ) { return boost::none; }
+      return num_vertices( *mig ) - mig_info( *mig ).inputs.size() - 1u;
+    };
+
+    compare_exact_engines_npn4( [&]( const tt& spec, const properties::ptr& stats ) { return num_gates( exact_mig_with_sat( spec, settings, stats ) ); },
+                                [&]( const tt& spec, const properties::ptr& stats ) { return num_gates( exact_mig_with_cnf( spec, settings, stats ) ); },
+                                engine, statistics );
+  }
+}
+
 }
 
 // Local Variables:
@@ -57,6 +57,9 @@ namespace cirkit
    | output_name         | Name of the output                            | std::string( "f" )     |
    | output_inverter     | Allow output inversion in encoding            | false                  |
    | incremental         | Explicit or incremental SAT solving           | false                  |
+   | portfolio           | Race sizes and encodings on a thread pool     | false                  |
+   | num_threads         | Number of threads in portfolio mode           | #cores                 |
+   | portfolio_breaking  | Additional symmetry breaking in portfolio     | std::string( "CI" )    |
    | min_depth           | Smallest MIG with smallest depth              | false                  |
    | all_solutions       | Enumerate all solutions                       | false                  |
    | enc_with_bitvectors | Encode numbers as bit-vectors and not as ints | false                  |
@@ -83,6 +86,28 @@ boost::optional<mig_graph> exact_mig_with_bdds( const tt& spec,
                                                 const properties::ptr& settings = properties::ptr(),
                                                 const properties::ptr& statistics = properties::ptr() );
 
+/**
+ * @brief Compares the CNF engine against Z3 on all NPN classes of 4-input functions
+ *
+ * Settings are passed to both engines, the CNF engine is selected with the
+ * `solver' setting of exact_mig_with_cnf.  With `with_xor' XMGs are
+ * synthesized instead of MIGs.
+ *
+ * @statistics
+ *
+   |-------------+-------------------------------------------------|
+   | Statistics  | Description                                     |
+   |-------------+-------------------------------------------------|
+   | runtime     | Total runtime                                   |
+   | z3_runtime  | Runtime of the Z3 engine                        |
+   | cnf_runtime | Runtime of the CNF engine                       |
+   | mismatches  | Classes for which both engines differ in size   |
+   |-------------+-------------------------------------------------|
+ */
+void exact_npn4_engine_comparison( bool with_xor,
+                                   const properties::ptr& settings = properties::ptr(),
+                                   const properties::ptr& statistics = properties::ptr() );
+
 }
 
 #endif
@@ -26,13 +26,22 @@
 
 #include "xmg_mine.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <future>
 #include <iostream>
+#include <set>
+#include <thread>
+#include <unordered_set>
 
 #include <boost/algorithm/string/trim.hpp>
+#include <boost/format.hpp>
 #include <boost/optional.hpp>
 
 #include <core/utils/string_utils.hpp>
+#include <core/utils/thread_pool.hpp>
+#include <core/utils/timer.hpp>
 #include <classical/utils/truth_table_utils.hpp>
 #include <formal/xmg/xmg_minlib.hpp>
 
@@ -47,12 +56,40 @@ namespace cirkit
  * Private functions                                                          *
  ******************************************************************************/
 
+/* NPN classes of the functions in shard [begin, end), as number of variables
+ * and hex string, since the hex string alone does not determine the size */
+using xmg_mine_classes_t = std::set<std::pair<unsigned, std::string>>;
+
+xmg_mine_classes_t xmg_mine_classify_shard( const std::vector<std::string>& functions, unsigned begin, unsigned end, bool npn )
+{
+  xmg_mine_classes_t classes;
+
+  boost::dynamic_bitset<> phase;
+  std::vector<unsigned>   perm;
+
+  for ( auto i = begin; i < end; ++i )
+  {
+    const tt spec( functions[i] );
+    classes.insert( {tt_num_vars( spec ), tt_to_hex( npn ? xmg_minlib_manager::canonize( spec, phase, perm ) : spec )} );
+  }
+
+  return classes;
+}
+
 /******************************************************************************
  * Public functions                                                           *
  ******************************************************************************/
 
 void xmg_mine( const std::string& lut_file, const std::string& opt_file, const properties::ptr& settings, const properties::ptr& statistics )
 {
+  /* settings */
+  const auto num_threads = std::max( get( settings, "num_threads", std::thread::hardware_concurrency() ), 1u );
+  const auto npn         = get( settings, "npn", true );
+  const auto verbose     = get( settings, "verbose", false );
+
+  /* timing */
+  properties_timer t( statistics );
+
   xmg_minlib_manager minlib( settings );
   minlib.load_library_string( xmg_minlib_manager::npn2_s );
   minlib.load_library_string( xmg_minlib_manager::npn3_s );
@@ -60,17 +97,88 @@ void xmg_mine( const std::string& lut_file, const std::string& opt_file, const p
 
   minlib.load_library_file( opt_file, true );
 
-  std::ifstream in( lut_file.c_str(), std::ifstream::in );
-  std::string line;
+  /* read functions and remove duplicates */
+  std::vector<std::string> functions;
+  auto num_functions = 0u;
+  {
+    std::unordered_set<std::string> visited;
+
+    std::ifstream in( lut_file.c_str(), std::ifstream::in );
+    std::string line;
+
+    while ( getline( in, line ) )
+    {
+      boost::trim( line );
+      if ( line.empty() ) { continue; }
+
+      ++num_functions;
+      if ( visited.insert( line ).second )
+      {
+        functions.push_back( line );
+      }
+    }
+  }
 
-  while ( getline( in, line ) )
+  thread_pool pool( num_threads );
+
+  /* classify in shards */
+  xmg_mine_classes_t classes;
+  {
+    std::vector<std::future<xmg_mine_classes_t>> shards;
+    const auto shard_size = ( functions.size() + num_threads - 1u ) / num_threads;
+    for ( auto begin = 0u; begin < functions.size(); begin += shard_size )
+    {
+      const auto end = std::min<unsigned>( begin + shard_size, functions.size() );
+      shards.push_back( pool.enqueue( xmg_mine_classify_shard, std::cref( functions ), begin, end, npn ) );
+    }
+
+    for ( auto& shard : shards )
+    {
+      const auto shard_classes = shard.get();
+      classes.insert( shard_classes.begin(), shard_classes.end() );
+    }
+  }
+
+  /* classes that are not yet in the library, small functions first */
+  std::vector<tt> missing;
+  for ( const auto& c : classes )
   {
-    boost::trim( line );
+    const auto spec = tt_from_hex( c.second, c.first );
+    if ( !minlib.contains( spec ) )
+    {
+      missing.push_back( spec );
+    }
+  }
+  std::sort( missing.begin(), missing.end(), []( const tt& a, const tt& b ) { return a.size() < b.size() || ( a.size() == b.size() && a < b ); } );
 
-    tt t( line );
+  if ( verbose )
+  {
+    std::cout << boost::format( "[i] %d functions, %d unique, %d classes, %d not in library" ) % num_functions % functions.size() % classes.size() % missing.size() << std::endl;
+  }
 
-    minlib.find_xmg_no_npn( t );
+  /* mine missing classes; each worker takes the next class, exact synthesis
+     creates its own solver with the given timeout */
+  std::atomic<unsigned> next( 0u );
+  std::vector<std::future<void>> workers;
+  for ( auto i = 0u; i < num_threads; ++i )
+  {
+    workers.push_back( pool.enqueue( [&minlib, &missing, &next]() {
+          for ( auto j = next++; j < missing.size(); j = next++ )
+          {
+            minlib.find_xmg_no_npn( missing[j] );
+          }
+        } ) );
+  }
+  for ( auto& worker : workers )
+  {
+    worker.get();
   }
+
+  minlib.checkpoint();
+
+  set( statistics, "num_functions", num_functions );
+  set( statistics, "num_classes", static_cast<unsigned>( classes.size() ) );
+  set( statistics, "num_mined", static_cast<unsigned>( missing.size() ) );
 }
 
 }
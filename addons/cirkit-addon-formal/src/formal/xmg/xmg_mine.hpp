@@ -43,6 +43,37 @@
 namespace cirkit
 {
 
+/**
+ * @brief Mines optimum XMGs for all functions in a LUT file
+ *
+ * Functions are deduplicated (by NPN class) before synthesis, the classes
+ * that are not in the library yet are mined in parallel.  New entries are
+ * appended to `opt_file' every `checkpoint_interval' entries, such that an
+ * interrupted run can be resumed by calling it again.
+ *
+ * @settings
+ *
+   |---------------------+---------------------------------------------+--------------------------------------|
+   | Settings            | Description                                 | Default                              |
+   |---------------------+---------------------------------------------+--------------------------------------|
+   | num_threads         | Number of worker threads                    | std::thread::hardware_concurrency()  |
+   | npn                 | Mine NPN representatives                    | true                                 |
+   | timeout             | Timeout for exact synthesis (in seconds)    | boost::none                          |
+   | checkpoint_interval | Number of new entries between file updates  | 1u                                   |
+   | verbose             | Be verbose                                  | false                                |
+   |---------------------+---------------------------------------------+--------------------------------------|
+ *
+ * @statistics
+ *
+   |---------------+-------------------------------------|
+   | Statistics    | Description                         |
+   |---------------+-------------------------------------|
+   | runtime       | Runtime                             |
+   | num_functions | Number of functions in the LUT file |
+   | num_classes   | Number of (NPN) classes             |
+   | num_mined     | Number of newly mined classes       |
+   |---------------+-------------------------------------|
+ */
 void xmg_mine( const std::string& lut_file, const std::string& opt_file, const properties::ptr& settings = properties::ptr(), const properties::ptr& statistics = properties::ptr() );
 
 }
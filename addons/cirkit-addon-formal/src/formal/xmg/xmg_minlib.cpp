@@ -95,13 +95,16 @@ std::string xmg_minlib_manager::format_library_entry( const std::string& hex, co
 
 std::string xmg_minlib_manager::find_or_create_xmg( const std::string& hex )
 {
-  const auto it = library.find( hex );
-
-  /* if hex is found in library and corresponding array is not empty */
-  if ( it != library.end() && !it->second.empty() )
   {
-    /* TODO implement different strategies if there are more than one implementation */
-    return it->second.front();
+    std::lock_guard<std::mutex> lock( mutex );
+    const auto it = library.find( hex );
+
+    /* if hex is found in library and corresponding array is not empty */
+    if ( it != library.end() && !it->second.empty() )
+    {
+      /* TODO implement different strategies if there are more than one implementation */
+      return it->second.front();
+    }
   }
 
   auto exs_settings = std::make_shared<properties>();
@@ -156,6 +159,15 @@ std::string xmg_minlib_manager::find_or_create_xmg( const std::string& hex )
   const auto expr = xmg_to_expression( xmg, xmg.outputs().front().first );
   const auto str = expression_to_string( expr );
 
+  std::lock_guard<std::mutex> lock( mutex );
+
+  /* another thread may have found the same entry in the meantime */
+  const auto it = library.find( hex );
+  if ( it != library.end() && !it->second.empty() )
+  {
+    return it->second.front();
+  }
+
   add_to_library( hex, str );
 
   if ( verbose )
@@ -165,25 +177,30 @@ std::string xmg_minlib_manager::find_or_create_xmg( const std::string& hex )
 
   if ( auto_update )
   {
-    update_out << format_library_entry( hex, str ) << std::endl;
-    update_out.flush();
+    pending.push_back( format_library_entry( hex, str ) );
+
+    if ( pending.size() >= checkpoint_interval )
+    {
+      write_pending();
+    }
   }
 
   return str;
 }
 
+void xmg_minlib_manager::write_pending()
+{
+  for ( const auto& entry : pending )
+  {
+    update_out << entry << std::endl;
+  }
+  update_out.flush();
+  pending.clear();
+}
+
 npn_manager::npn_classifier_t make_classifier()
 {
-  return npn_manager::npn_classifier_t([]( const tt& t, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm ) {
-      if ( tt_num_vars( t ) <= 5u )
-      {
-        return exact_npn_canonization( t, phase, perm );
-      }
-      else
-      {
-        return npn_canonization_lucky( t, phase, perm );
-      }
-    } );
+  return npn_manager::npn_classifier_t( &xmg_minlib_manager::canonize );
 }
 
 /******************************************************************************
@@ -193,14 +210,16 @@ npn_manager::npn_classifier_t make_classifier()
 xmg_minlib_manager::xmg_minlib_manager( const properties::ptr& settings )
   : npn( 4096, make_classifier() )
 {
-  timeout = get( settings, "timeout", timeout );
-  verbose = get( settings, "verbose", verbose );
+  timeout             = get( settings, "timeout",             timeout );
+  verbose             = get( settings, "verbose",             verbose );
+  checkpoint_interval = get( settings, "checkpoint_interval", checkpoint_interval );
 }
 
 xmg_minlib_manager::~xmg_minlib_manager()
 {
   if ( auto_update )
   {
+    write_pending();
     update_out.close();
   }
 }
@@ -250,7 +269,11 @@ xmg_graph xmg_minlib_manager::find_xmg( const tt& spec )
 
   std::vector<unsigned> perm;
   boost::dynamic_bitset<> phase;
-  const auto npn_spec = npn.compute( spec, phase, perm );
+  tt npn_spec;
+  {
+    std::lock_guard<std::mutex> lock( mutex );
+    npn_spec = npn.compute( spec, phase, perm );
+  }
 
   xmg_graph xmg;
   std::vector<xmg_function> pis;
@@ -305,6 +328,22 @@ void xmg_minlib_manager::add_to_library( const xmg_graph& xmg )
   add_to_library( tt_to_hex( sim_res ), str );
 }
 
+bool xmg_minlib_manager::contains( const tt& spec )
+{
+  std::lock_guard<std::mutex> lock( mutex );
+  const auto it = library.find( tt_to_hex( spec ) );
+  return it != library.end() && !it->second.empty();
+}
+
+void xmg_minlib_manager::checkpoint()
+{
+  std::lock_guard<std::mutex> lock( mutex );
+  if ( auto_update )
+  {
+    write_pending();
+  }
+}
+
 bool xmg_minlib_manager::verify()
 {
   auto okay = true;
@@ -332,6 +371,18 @@ bool xmg_minlib_manager::verify()
   return okay;
 }
 
+tt xmg_minlib_manager::canonize( const tt& spec, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm )
+{
+  if ( tt_num_vars( spec ) <= 5u )
+  {
+    return exact_npn_canonization( spec, phase, perm );
+  }
+  else
+  {
+    return npn_canonization_lucky( spec, phase, perm );
+  }
+}
+
 void xmg_minlib_manager::print_statistics( std::ostream& os )
 {
   os << "[i] circuit library:" << std::endl;
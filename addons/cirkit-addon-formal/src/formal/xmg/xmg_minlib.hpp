@@ -38,6 +38,7 @@
 
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -52,6 +53,12 @@
 namespace cirkit
 {
 
+/**
+ * Library lookups with find_xmg_no_npn are thread-safe, missing entries are
+ * synthesized outside the lock such that several threads can mine in
+ * parallel.  With auto update, new entries are appended to the library file
+ * every `checkpoint_interval' entries (and on checkpoint() and destruction).
+ */
 class xmg_minlib_manager
 {
 public:
@@ -69,16 +76,22 @@ public:
                                 const std::vector<xmg_function>& pi_mapping );
 
   void add_to_library( const xmg_graph& xmg );
+  bool contains( const tt& spec );
+  void checkpoint();
   bool verify();
 
   void print_statistics( std::ostream& os );
 
+  /* NPN classifier used for the library keys */
+  static tt canonize( const tt& spec, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm );
+
 private:
   void load_library( std::istream& in );
   void add_to_library( const std::string& hex, const std::string& expr );
   std::string format_library_entry( const std::string& hex, const std::string& expr );
 
   std::string find_or_create_xmg( const std::string& hex );
+  void write_pending();
 
 private:
   std::unordered_map<std::string, std::vector<std::string>> library;
@@ -88,6 +101,10 @@ private:
 
   bool auto_update = false;
   std::ofstream update_out;
+  unsigned checkpoint_interval = 1u;
+  std::vector<std::string> pending;
+
+  std::mutex mutex;
 
 public: /* libraries */
   static std::string npn2_s;
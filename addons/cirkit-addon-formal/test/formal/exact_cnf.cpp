@@ -0,0 +1,136 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE exact_cnf
+
+#include <string>
+#include <vector>
+
+#define timer timer_class
+#include <boost/test/unit_test.hpp>
+#undef timer
+
+#include <core/properties.hpp>
+#include <classical/mig/mig_simulate.hpp>
+#include <classical/mig/mig_utils.hpp>
+#include <classical/utils/truth_table_utils.hpp>
+#include <classical/xmg/xmg_exact_cnf.hpp>
+#include <classical/xmg/xmg_simulate.hpp>
+#include <formal/synthesis/exact_mig.hpp>
+
+using namespace cirkit;
+
+const std::vector<std::string> functions = {"e8", "80", "96", "17", "d8", "6996", "8000", "cafe"};
+
+unsigned mig_num_gates( const mig_graph& mig )
+{
+  return num_vertices( mig ) - mig_info( mig ).inputs.size() - 1u;
+}
+
+tt mig_truth_table( const mig_graph& mig, unsigned num_vars )
+{
+  auto func = simulate_mig_function( mig, mig_info( mig ).outputs.front().first, mig_tt_simulator() );
+  tt_shrink( func, num_vars );
+  return func;
+}
+
+tt xmg_truth_table( const xmg_graph& xmg, unsigned num_vars )
+{
+  auto func = simulate_xmg_function( xmg, xmg.outputs().front().first, xmg_tt_simulator() );
+  tt_shrink( func, num_vars );
+  return func;
+}
+
+BOOST_AUTO_TEST_CASE(exact_mig_cnf_against_z3)
+{
+  for ( const auto& engine : {"minisat", "abcsat"} )
+  {
+    for ( const auto& hex : functions )
+    {
+      const auto spec = tt_from_hex( hex );
+      const auto settings = std::make_shared<properties>();
+      settings->set( "solver", std::string( engine ) );
+
+      const auto z3_mig  = exact_mig_with_sat( spec, settings );
+      const auto cnf_mig = exact_mig_with_cnf( spec, settings );
+
+      BOOST_REQUIRE( (bool)z3_mig );
+      BOOST_REQUIRE( (bool)cnf_mig );
+      BOOST_CHECK( mig_truth_table( *cnf_mig, tt_num_vars( spec ) ) == spec );
+      BOOST_CHECK_EQUAL( mig_num_gates( *cnf_mig ), mig_num_gates( *z3_mig ) );
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(exact_xmg_cnf_against_z3)
+{
+  for ( const auto& engine : {"minisat", "abcsat"} )
+  {
+    for ( const auto& hex : functions )
+    {
+      const auto spec = tt_from_hex( hex );
+      const auto settings = std::make_shared<properties>();
+      settings->set( "solver", std::string( engine ) );
+
+      const auto z3_xmg  = exact_xmg_with_sat( spec, settings );
+      const auto cnf_xmg = exact_xmg_with_cnf( spec, settings );
+
+      BOOST_REQUIRE( (bool)z3_xmg );
+      BOOST_REQUIRE( (bool)cnf_xmg );
+      BOOST_CHECK( xmg_truth_table( *cnf_xmg, tt_num_vars( spec ) ) == spec );
+      BOOST_CHECK_EQUAL( cnf_xmg->num_gates(), z3_xmg->num_gates() );
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(exact_cnf_encodings)
+{
+  /* binary selection variables and the cardinality encodings must not change the optimum */
+  const auto spec = tt_from_hex( "cafe" );
+  const auto z3_size = mig_num_gates( *exact_mig_with_sat( spec ) );
+
+  for ( auto binary : {false, true} )
+  {
+    for ( auto cardinality = 0u; cardinality < 3u; ++cardinality )
+    {
+      const auto settings = std::make_shared<properties>();
+      settings->set( "binary",      binary );
+      settings->set( "cardinality", cardinality );
+
+      const auto mig = exact_mig_with_cnf( spec, settings );
+      BOOST_REQUIRE( (bool)mig );
+      BOOST_CHECK( mig_truth_table( *mig, 4u ) == spec );
+      BOOST_CHECK_EQUAL( mig_num_gates( *mig ), z3_size );
+    }
+  }
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -30,6 +30,7 @@
 #include <reversible/circuit.hpp>
 
 #include <fstream>
+#include <core/utils/program_options.hpp>
 #include <core/utils/string_utils.hpp>
 #include <reversible/IBMgraph.hpp>
 
@@ -67,7 +68,8 @@ graph_command::graph_command( const environment::ptr& env )
     // ( "file,w", value( &filename ), "Write graph, matrix and transformations to a file" )
     // ( "from_file,f", value( &filename ), "Read matrix and transformations from a file" )
     // ( "mapping,x", "Realize the mapping for a current circuit")
-    // ( "try_all", "Try all the permutations for the circuit")
+    ( "try_all", "Try all the permutations for the circuit")
+    ( "threads", value_with_default( &num_threads ), "number of threads for try_all" )
     ;
     add_new_option();
 }
@@ -85,16 +87,16 @@ bool graph_command::execute()
         rm_dup = true;
     }
     if( is_set( "read" ) ){
-        read_graph( filename );
+        graph.read_graph( filename );
     }
     if( is_set( "print" ) ){
-        print_graph( );
-        print_matrix( );
+        graph.print_graph( );
+        graph.print_matrix( );
     }
     if( is_set( "movements" ) ){
         auto& circuits = env->store<circuit>();
         circuit circ_working = circuits.current();
-        print_movements( circ_working );
+        graph.print_movements( circ_working );
     }
     // if( is_set( "file" ) )
     // {
@@ -105,10 +107,10 @@ bool graph_command::execute()
     //     read_from_file( filename );
     // }
     if( is_set( "create" ) ){
-        create_trans( verbose );
+        graph.create_trans( verbose );
     }
     if( is_set( "delete" ) ){
-        delete_graph( );
+        graph.delete_graph( );
     }
     // if( is_set( "mapping" ) )
     // {
@@ -121,21 +123,21 @@ bool graph_command::execute()
     //     mapping( circ_in);
     // }
     
-    // if( is_set( "try_all" ) )
-    // {
-    //     if( env->store<circuit>().current_index() < 0 ){
-    //         std::cout << "no current circuit available" << std::endl;
-    //         return true;
-    //     }
-    //     auto& circuits = env->store<circuit>();
-    //     circuit circ_out, circ_in = circuits.current();
-    //     circ_out = try_all( circ_in, verbose, rm_dup);
-    //     if ( is_set( "new" ) )
-    //     {
-    //         circuits.extend();
-    //     }
-    //     circuits.current() = circ_out;
-    // }
+    if( is_set( "try_all" ) )
+    {
+        if( env->store<circuit>().current_index() < 0 ){
+            std::cout << "no current circuit available" << std::endl;
+            return true;
+        }
+        auto& circuits = env->store<circuit>();
+        circuit circ_out, circ_in = circuits.current();
+        circ_out = try_all( graph, circ_in, verbose, rm_dup, num_threads );
+        if ( is_set( "new" ) )
+        {
+            circuits.extend();
+        }
+        circuits.current() = circ_out;
+    }
 
     if( is_set( "transform" ) ){
         if( env->store<circuit>().current_index() < 0 ){
@@ -145,7 +147,7 @@ bool graph_command::execute()
         auto& circuits = env->store<circuit>();
         circuit circ_working = circuits.current();
         circuit circ_result;
-        expand_cnots( circ_result, circ_working );
+        expand_cnots( graph, circ_result, circ_working );
         if ( is_set( "new" ) )
         {
             circuits.extend();
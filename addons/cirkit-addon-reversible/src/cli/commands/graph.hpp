@@ -38,6 +38,7 @@
 
 #include <cli/cirkit_command.hpp>
 #include <reversible/circuit.hpp>
+#include <reversible/IBMgraph.hpp>
 
 namespace cirkit
 {
@@ -57,6 +58,9 @@ public:
 private:
     //std::string filename = "graph.txt";
     std::string filename;
+    unsigned num_threads = 1u;
+
+    coupling_graph graph;
 
 };
 
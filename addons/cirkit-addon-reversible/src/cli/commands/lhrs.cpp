@@ -26,9 +26,12 @@
 
 #include "lhrs.hpp"
 
+#include <iostream>
+
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <boost/format.hpp>
 #include <boost/program_options.hpp>
 
 #include <core/utils/program_options.hpp>
@@ -40,6 +43,7 @@
 #include <classical/xmg/xmg_aig.hpp>
 #include <classical/xmg/xmg_cover.hpp>
 #include <cli/reversible_stores.hpp>
+#include <reversible/synthesis/lhrs/lhrs.hpp>
 #include <reversible/synthesis/lhrs/legacy/lhrs.hpp>
 
 using boost::program_options::bool_switch;
@@ -59,6 +63,10 @@ lhrs_command::lhrs_command( const environment::ptr& env )
     ( "onlylines",          bool_switch( &params.onlylines ),                 "do not create gates (useful for qubit estimation)" )
     ( "area_iters_init",    value_with_default( &area_iters_init ),           "number of exact area recovery iterations (in initial mapping)" )
     ( "flow_iters_init",    value_with_default( &flow_iters_init ),           "number of area flow recovery iterations (in initial mapping)" )
+    ( "xmg,x",                                                                "use XMG-based synthesis flow" )
+    ( "threads,j",          value_with_default( &xmg_params.num_threads ),    "number of threads to precompute LUT circuits (only with --xmg and direct mapping, ESOP minimization is not parallel)" )
+    ( "cache",                                                                "cache LUT realizations and classification results (only with --xmg)" )
+    ( "cache_file",         value( &xmg_params.cache_file ),                  "read cache from and write it to this file (implies --cache)" )
     ;
 
   boost::program_options::options_description esopdecomp_options( "ESOP decomposition options" );
@@ -95,10 +103,47 @@ lhrs_command::lhrs_command( const environment::ptr& env )
 command::rules_t lhrs_command::validity_rules() const
 {
   return {
-    {has_store_element<aig_graph>( env )}
+    {has_store_element<aig_graph>( env )},
+    {[this]() { return xmg_params.num_threads >= 1u; }, "number of threads must be positive"},
+    {[this]() { return is_set( "xmg" ) || xmg_params.num_threads == 1u; }, "--threads requires --xmg"},
+    {[this]() { return is_set( "xmg" ) || ( !is_set( "cache" ) && !is_set( "cache_file" ) ); }, "--cache and --cache_file require --xmg"}
   };
 }
 
+/* options are bound to the legacy parameters, the XMG-based flow uses the same
+ * values; the Shannon mapper has no own options but reads map_luts_params, and
+ * the ESOP cover method only exists in the legacy flow */
+void lhrs_command::copy_xmg_params()
+{
+  xmg_params.additional_ancilla                 = params.additional_ancilla;
+  xmg_params.onlylines                          = params.onlylines;
+  xmg_params.mapping_strategy                   = static_cast<lhrs_mapping_strategy>( static_cast<unsigned>( params.mapping_strategy ) );
+  xmg_params.max_func_size                      = params.max_func_size;
+  xmg_params.progress                           = params.progress;
+  xmg_params.verbose                            = params.verbose;
+  xmg_params.count_costs                        = params.count_costs;
+
+  xmg_params.map_esop_params.script             = params.map_esop_params.script;
+  xmg_params.map_esop_params.optimize_postesop  = params.map_esop_params.optimize_postesop;
+  xmg_params.map_esop_params.nocollapse         = params.map_esop_params.nocollapse;
+  xmg_params.map_esop_params.dumpfile           = params.map_esop_params.dumpfile;
+
+  xmg_params.map_luts_params.max_cut_size       = params.map_luts_params.max_cut_size;
+  xmg_params.map_luts_params.strategy           = static_cast<stg_map_luts_params::mapping_strategy>( static_cast<unsigned>( params.map_luts_params.strategy ) );
+  xmg_params.map_luts_params.satlut             = params.map_luts_params.satlut;
+  xmg_params.map_luts_params.area_iters         = params.map_luts_params.area_iters;
+  xmg_params.map_luts_params.flow_iters         = params.map_luts_params.flow_iters;
+  xmg_params.map_precomp_params.class_method    = params.map_precomp_params.class_method;
+
+  if ( !is_set( "cache_file" ) )
+  {
+    xmg_params.cache_file.clear();
+  }
+  xmg_params.cache = ( is_set( "cache" ) || is_set( "cache_file" ) ) ? std::make_shared<stg_cache>() : nullptr;
+
+  xmg_params.sync();
+}
+
 bool lhrs_command::execute()
 {
   auto& circuits = env->store<circuit>();
@@ -113,11 +158,24 @@ bool lhrs_command::execute()
   const auto gia = gia_graph( aig() );
 
   const auto lut = gia.if_mapping( make_settings_from( std::make_pair( "lut_size", cut_size ), "area_mapping", std::make_pair( "area_iters", area_iters_init ), std::make_pair( "flow_iters", flow_iters_init ), std::make_pair( "rounds", 7u ), std::make_pair( "rounds_ela", 7u ) ) );
-  legacy::lut_based_synthesis( circuits.current(), /*xmg_from_gia( lut )*/ lut, params, *stats );
 
-  // auto& xmg = env->store<xmg_graph>().current();
-  // xmg_map( xmg, make_settings_from( std::make_pair( "cut_size", cut_size ) ) );
-  // lut_based_synthesis( circuits.current(), xmg, params, *stats );
+  if ( is_set( "xmg" ) )
+  {
+    copy_xmg_params();
+    xmg_stats = std::make_shared<lhrs_stats>();
+    lut_based_synthesis( circuits.current(), xmg_from_gia( lut ), xmg_params, *xmg_stats );
+    stats->runtime = xmg_stats->runtime;
+
+    if ( xmg_params.cache )
+    {
+      const auto& esop_stats = xmg_stats->map_esop_stats;
+      std::cout << boost::format( "[i] cache hits: %d, misses: %d, time saved: %.2f secs, class hits: %d" ) % esop_stats.cache_hits % esop_stats.cache_misses % esop_stats.cache_time_saved % xmg_stats->map_precomp_stats.class_cache_hits << std::endl;
+    }
+  }
+  else
+  {
+    legacy::lut_based_synthesis( circuits.current(), lut, params, *stats );
+  }
 
   lut_count = lut.lut_count();
 
@@ -143,7 +201,6 @@ bool lhrs_command::execute()
 command::log_opt_t lhrs_command::log() const
 {
   log_map_t map({
-      {"runtime", stats->runtime},
       {"cut_size", cut_size},
       {"lut_count", lut_count},
       {"onlylines", is_set( "onlylines" )},
@@ -154,27 +211,50 @@ command::log_opt_t lhrs_command::log() const
       {"area_iters", params.map_luts_params.area_iters},
       {"flow_iters", params.map_luts_params.flow_iters},
       {"class_method", params.map_precomp_params.class_method},
-      {"num_decomp_default", stats->num_decomp_default},
-      {"num_decomp_lut", stats->num_decomp_lut},
-      {"exorcism_runtime", stats->map_esop_stats.exorcism_runtime},
-      {"cover_runtime", stats->map_esop_stats.cover_runtime},
-      {"class_counter", stats->map_precomp_stats.class_counter},
-      {"class_runtime", stats->map_precomp_stats.class_runtime},
-      {"mapping_runtime", stats->map_luts_stats.mapping_runtime}
+      {"xmg", is_set( "xmg" )},
+      {"num_threads", xmg_params.num_threads}
     });
 
-  if ( is_set( "bounds" ) )
+  const auto add_stats = [this, &map]( const auto& stats ) {
+    map["runtime"]            = stats.runtime;
+    map["num_decomp_default"] = stats.num_decomp_default;
+    map["num_decomp_lut"]     = stats.num_decomp_lut;
+    map["exorcism_runtime"]   = stats.map_esop_stats.exorcism_runtime;
+    map["cover_runtime"]      = stats.map_esop_stats.cover_runtime;
+    map["class_counter"]      = stats.map_precomp_stats.class_counter;
+    map["class_runtime"]      = stats.map_precomp_stats.class_runtime;
+    map["mapping_runtime"]    = stats.map_luts_stats.mapping_runtime;
+
+    if ( this->is_set( "count_costs" ) )
+    {
+      map["gate_costs"]     = stats.gate_costs;
+      map["line_maps"]      = stats.line_maps;
+      map["affected_lines"] = stats.affected_lines;
+      map["clean_ancillas"] = stats.clean_ancillas;
+    }
+  };
+
+  if ( is_set( "xmg" ) )
   {
-    map["debug_lb"] = debug_lb;
-    map["debug_ub"] = lut_count;
+    add_stats( *xmg_stats );
+
+    if ( xmg_params.cache )
+    {
+      map["cache_hits"]       = xmg_stats->map_esop_stats.cache_hits;
+      map["cache_misses"]     = xmg_stats->map_esop_stats.cache_misses;
+      map["cache_time_saved"] = xmg_stats->map_esop_stats.cache_time_saved;
+      map["class_cache_hits"] = xmg_stats->map_precomp_stats.class_cache_hits;
+    }
+  }
+  else
+  {
+    add_stats( *stats );
   }
 
-  if ( is_set( "count_costs" ) )
+  if ( is_set( "bounds" ) )
   {
-    map["gate_costs"] = stats->gate_costs;
-    map["line_maps"] = stats->line_maps;
-    map["affected_lines"] = stats->affected_lines;
-    map["clean_ancillas"] = stats->clean_ancillas;
+    map["debug_lb"] = debug_lb;
+    map["debug_ub"] = lut_count;
   }
 
   return map;
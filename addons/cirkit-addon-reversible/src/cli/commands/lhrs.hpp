@@ -39,6 +39,7 @@
 #include <memory>
 
 #include <cli/aig_command.hpp>
+#include <reversible/synthesis/lhrs/lhrs_params.hpp>
 #include <reversible/synthesis/lhrs/legacy/lhrs_params.hpp>
 
 namespace cirkit
@@ -53,6 +54,9 @@ protected:
   rules_t validity_rules() const;
   bool execute();
 
+private:
+  void copy_xmg_params();
+
 public:
   log_opt_t log() const;
 
@@ -60,6 +64,10 @@ private:
   legacy::lhrs_params params;
   std::shared_ptr<legacy::lhrs_stats> stats;
 
+  /* XMG-based flow */
+  lhrs_params xmg_params;
+  std::shared_ptr<lhrs_stats> xmg_stats;
+
   unsigned cut_size = 16u;
   unsigned lut_count = 0u;
   unsigned area_iters_init = 2u;
@@ -51,7 +51,7 @@ revsimp_command::revsimp_command( const environment::ptr& env )
   : cirkit_command( env, "Reversible circuit simplification" )
 {
   opts.add_options()
-    ( "methods",   value_with_default( &methods ), "optimization methods:\nm: try to merge gates with same target\nn: cancel NOT gates\na: merge adjacent gates\ne: resynthesize same-target gates with exorcism\np: same target optimization (reduces T-count)\ns: propagate SWAP gates (may change output order)" )
+    ( "methods",   value_with_default( &methods ), "optimization methods:\nm: try to merge gates with same target\nn: cancel NOT gates\na: merge adjacent gates\ne: resynthesize same-target gates with exorcism\np: same target optimization (reduces T-count)\ns: propagate SWAP gates (may change output order)\nc: commutation-aware cancellation (also for Clifford+T gates)" )
     ( "noreverse",                                 "do not optimize in reverse direction" )
     ;
   be_verbose();
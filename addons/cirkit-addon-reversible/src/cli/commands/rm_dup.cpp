@@ -32,6 +32,7 @@
 #include <alice/rules.hpp>
 #include <core/utils/range_utils.hpp>
 #include <core/utils/program_options.hpp>
+#include <core/utils/timer.hpp>
 #include <reversible/circuit.hpp>
 #include <cli/reversible_stores.hpp>
 #include <reversible/functions/remove_dup_gates.hpp>
@@ -40,6 +41,7 @@
 #include <reversible/pauli_tags.hpp>
 #include <reversible/functions/add_gates.hpp>
 #include <reversible/io/print_circuit.hpp>
+#include <reversible/optimization/peephole_optimization.hpp>
 
 namespace cirkit
 {
@@ -60,6 +62,8 @@ rm_dup_command::rm_dup_command( const environment::ptr& env )
     : cirkit_command( env, "rm_dup circuit" )
 {
     opts.add_options()
+    ( "peephole,p",                                    "linear-time commutation-aware cancellation" )
+    ( "lookahead,l", value_with_default( &lookahead ), "maximum number of gates to look back (only with --peephole)" )
     ;
   add_new_option();
 }
@@ -73,9 +77,19 @@ command::rules_t rm_dup_command::validity_rules() const
 bool rm_dup_command::execute()
 {
 	auto& circuits = env->store<circuit>();
-    circuit circ_rm = circuits.current();
-   
-    circ_rm = remove_dup_gates(circ_rm);
+    circuit circ_rm;
+
+    if ( is_set( "peephole" ) )
+    {
+      auto settings = make_settings();
+      settings->set( "lookahead", lookahead );
+      peephole_optimization( circ_rm, circuits.current(), settings, statistics );
+    }
+    else
+    {
+      properties_timer t( statistics );
+      circ_rm = remove_dup_gates( circuits.current() );
+    }
     extend_if_new( circuits );
     circuits.current() = circ_rm;
     
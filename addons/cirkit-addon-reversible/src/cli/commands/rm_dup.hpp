@@ -55,6 +55,8 @@ protected:
 public:
   log_opt_t log() const;
 
+private:
+  unsigned lookahead = 64u;
 };
 
 }
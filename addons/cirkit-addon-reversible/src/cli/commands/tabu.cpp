@@ -26,8 +26,13 @@
 
 #include "tabu.hpp"
 
+#include <algorithm>
+#include <cassert>
+#include <future>
 #include <iostream>
+#include <memory>
 #include <time.h>
+#include <core/utils/thread_pool.hpp>
 #include <core/utils/timer.hpp>
 #include <alice/rules.hpp>
 #include <cli/reversible_stores.hpp>
@@ -39,6 +44,7 @@
 #include <reversible/functions/clear_circuit.hpp>
 #include <reversible/functions/is_identity.hpp>
 #include <reversible/functions/reverse_circuit.hpp>
+#include <reversible/target_tags.hpp>
 
 //#include <reversible/pauli_tags.hpp>
 //#include <reversible/target_tags.hpp>
@@ -62,6 +68,8 @@ tabu_command::tabu_command(const environment::ptr& env)
     ( "neighborhood,g",value_with_default(&neighborhood),	"Select the size of the neighborhood" )
     ( "optimization,t",value_with_default(&opt),				"Select the optimization. 0: gates (default), 1: quantum cost, 2: average of both" )
     ( "overlap,o",value_with_default(&overlap),			"Select the size of the overlap (%)" )
+    ( "threads,j",value_with_default(&num_threads),		"Number of threads to evaluate the neighborhood" )
+    ( "check,c",								"check the whole circuit against the original in the end (moves are always checked locally)" )
     ( "verbose,v",								"be verbose")
     ( "step,s",									"be verbose and step-by-step")
     ;
@@ -73,18 +81,14 @@ command::rules_t tabu_command::validity_rules() const
 	return {has_store_element<circuit>( env )};
 }
 
-//Any rule changed the truth table?
-bool changed_circuit(circuit circ)
+//Does circ realize the same function as orig?
+bool same_function(const circuit& orig, const circuit& circ)
 {
-	circuit aux;
+	circuit both, aux;
+	copy_circuit(orig, both);
 	reverse_circuit(circ, aux);
-	append_circuit(circ, aux);
-	if(!is_identity(circ))
-	{
-		std::cout << "Some rule changed the truth table of the circuit!" << std::endl;
-		return false;
-	}
-	return true;
+	append_circuit(both, aux);
+	return is_identity(both);
 }
 
 int ncv_cost(unsigned int control)
@@ -125,175 +129,274 @@ int t_depth(unsigned int control)
 	}
 }
 
-unsigned int circuit_ncv_cost(circuit& circ)
+unsigned int circuit_ncv_cost(const circuit& circ)
 {
 	unsigned int cost = 0;
-	for (auto g : circ)
+	for (const auto& g : circ)
  		cost += ncv_cost(g.controls().size());
  	return cost;
 }
 
-void list_rules( circuit circ, std::vector<std::vector<int>>& x, unsigned begin, unsigned end, bool verbose )
+//Costs of the current circuit, updated by each move over the window it touches
+struct tabu_cost
+{
+	unsigned int gates = 0;
+	unsigned int qcost = 0;
+};
+
+tabu_cost window_cost(const circuit& circ, unsigned begin, unsigned end)
 {
-	for( circuit::const_iterator itGate = circ.begin() + begin, nextGate = ++( circ.begin() + begin );  nextGate != circ.begin() + end; ++itGate, ++nextGate )
+	tabu_cost c;
+	for (unsigned i = begin; i < end && i < circ.num_gates(); ++i)
 	{
-		unsigned int itGateIndex = itGate - circ.begin();
-		unsigned int nextGateIndex = nextGate - circ.begin();
-		int gaNCVCost, gbNCVCost, gaTdepth, gbTdepth; //Quantum cost of the gates
-		unsigned int gaControls, gbControls; //Controls of the gates
-
-		gate ga, gb;
-		
-		std::sort( itGate->controls().begin(), itGate->controls().end() );
-		std::sort( nextGate->controls().begin(), nextGate->controls().end() );
-		
-		ga.controls() = itGate->controls();
-		gb.controls() = nextGate->controls();
-		ga.targets() = itGate->targets();
-		gb.targets() = nextGate->targets();
-
-		gaControls = ga.controls().size();
-		gbControls = gb.controls().size();
-
-		gaNCVCost = ncv_cost(ga.controls().size());
-		gbNCVCost = ncv_cost(gb.controls().size());
-		gaTdepth = t_depth(ga.controls().size());
-		gbTdepth = t_depth(gb.controls().size());
-
-		if( verify_rule_Done( ga, gb ) )
-		{
-			std::vector<int> v;
-			if(verbose)
-				std::cout  << "[D1] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can be removed.\t\tCost=-2;\t\tQCost:" << -1*(gaNCVCost + gbNCVCost) << std::endl;
-			v.push_back(1);
-			v.push_back(itGateIndex);
-			v.push_back(nextGateIndex);
-			v.push_back(-2);
-			v.push_back(-1*(gaNCVCost + gbNCVCost));
-			x.push_back( v );
-		}
-	
-		apply_rule_Rfive( ga, gb );
+		++c.gates;
+		c.qcost += ncv_cost(circ[i].controls().size());
+	}
+	return c;
+}
 
-		if( verify_rule_Dtwo( ga, gb ) ) 
-		{
-			std::vector<int> v;
-			if(verbose)
-				std::cout  << "[R5] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can be interchanged.\t\tNo cost change;" << std::endl;
-			v.push_back(2);
-			v.push_back(itGateIndex);
-			v.push_back(nextGateIndex);
-			v.push_back(0);
-			v.push_back(0);
-			x.push_back( v );
-		}
+//All rules are applied to two adjacent gates and may insert one gate after them
+const unsigned rule_window = 3u;
 
-		if( verify_rule_Dthree( ga, gb ) )
+//Checks that two gate windows realize the same function on the lines they touch;
+//windows that cannot be checked exhaustively are not considered equivalent
+bool window_equivalent(const std::vector<gate>& before, const std::vector<gate>& after)
+{
+	std::vector<unsigned> lines;
+	for (const auto* w : {&before, &after})
+		for (const auto& g : *w)
 		{
-			std::vector<int> v;
-			if(verbose)
-				std::cout  << "[D3] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can be merged.\t\t\t--Cost;\t\tQCost:" << -1*(gaNCVCost-1) << std::endl;
-			v.push_back(3);
-			v.push_back(itGateIndex);
-			v.push_back(nextGateIndex);
-			v.push_back(-1);
-			v.push_back(-1*(gaNCVCost-1));
-			x.push_back( v );
+			if (!is_toffoli(g))
+				return false; //can only simulate MCT gates
+			for (const auto& c : g.controls())
+				lines.push_back(c.line());
+			for (const auto& t : g.targets())
+				lines.push_back(t);
 		}
-		
-		if( verify_rule_Dfour( ga, gb ) )
+	std::sort(lines.begin(), lines.end());
+	lines.erase(std::unique(lines.begin(), lines.end()), lines.end());
+	if (lines.size() > 16u)
+		return false; //too wide to check exhaustively
+
+	auto index = [&lines](unsigned l) { return std::lower_bound(lines.begin(), lines.end(), l) - lines.begin(); };
+	auto simulate = [&index](const std::vector<gate>& w, uint64_t x) {
+		for (const auto& g : w)
 		{
-			std::vector<int> v;
-			// if(verbose)
-			// 	std::cout  << "[D4] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can be merged.\t\t\t--Cost" << std::endl;
-			v.push_back(14);
-			v.push_back(itGateIndex);
-			v.push_back(nextGateIndex);
-			v.push_back(-1);
-			if(gaControls > gbControls)
-			{
-				v.push_back(-1*gaNCVCost);
-				if(verbose)
-					std::cout  << "[D4] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can be merged.\t\t\t--Cost;\t\tQCost:" << -1*gaNCVCost << std::endl;
-			}
-			else
-			{
-				if(verbose)
-					std::cout  << "[D4] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can be merged.\t\t\t--Cost;\t\tQCost:" << -1*gbNCVCost << std::endl;
-				v.push_back(-1*gbNCVCost);
-			}
-			x.push_back( v );
+			bool active = true;
+			for (const auto& c : g.controls())
+				active = active && ( ( ( x >> index(c.line()) ) & 1u ) == c.polarity() );
+			if (active)
+				x ^= uint64_t(1) << index(g.targets().front());
 		}
+		return x;
+	};
 
-		if( verify_rule_Rfour( ga, gb ) )
-		{
-			std::vector<int> v;
-			if(verbose)
-				std::cout  << "[R4] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can be interchanged.\t\tNo cost change;" << std::endl;
-			v.push_back(4);
-			v.push_back(itGateIndex);
-			v.push_back(nextGateIndex);
-			v.push_back(0);
-			v.push_back(0);
-			x.push_back( v );
-		}
-		
-		if( verify_rule_Dfive( ga, gb ) )
+	for (uint64_t x = 0; x < ( uint64_t(1) << lines.size() ); ++x)
+		if (simulate(before, x) != simulate(after, x))
+			return false;
+	return true;
+}
+
+void list_rules_pair( const gate& itGate, const gate& nextGate, unsigned itGateIndex, matrix& x, bool verbose )
+{
+	unsigned int nextGateIndex = itGateIndex + 1;
+	int gaNCVCost, gbNCVCost, gaTdepth, gbTdepth; //Quantum cost of the gates
+	unsigned int gaControls, gbControls; //Controls of the gates
+
+	gate ga, gb;
+	
+	ga.controls() = itGate.controls();
+	gb.controls() = nextGate.controls();
+	ga.targets() = itGate.targets();
+	gb.targets() = nextGate.targets();
+
+	std::sort( ga.controls().begin(), ga.controls().end() );
+	std::sort( gb.controls().begin(), gb.controls().end() );
+
+	gaControls = ga.controls().size();
+	gbControls = gb.controls().size();
+
+	gaNCVCost = ncv_cost(ga.controls().size());
+	gbNCVCost = ncv_cost(gb.controls().size());
+	gaTdepth = t_depth(ga.controls().size());
+	gbTdepth = t_depth(gb.controls().size());
+
+	if( verify_rule_Done( ga, gb ) )
+	{
+		std::vector<int> v;
+		if(verbose)
+			std::cout  << "[D1] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can be removed.\t\tCost=-2;\t\tQCost:" << -1*(gaNCVCost + gbNCVCost) << std::endl;
+		v.push_back(1);
+		v.push_back(itGateIndex);
+		v.push_back(nextGateIndex);
+		v.push_back(-2);
+		v.push_back(-1*(gaNCVCost + gbNCVCost));
+		x.push_back( v );
+	}
+
+	apply_rule_Rfive( ga, gb );
+
+	if( verify_rule_Dtwo( ga, gb ) ) 
+	{
+		std::vector<int> v;
+		if(verbose)
+			std::cout  << "[R5] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can be interchanged.\t\tNo cost change;" << std::endl;
+		v.push_back(2);
+		v.push_back(itGateIndex);
+		v.push_back(nextGateIndex);
+		v.push_back(0);
+		v.push_back(0);
+		x.push_back( v );
+	}
+
+	if( verify_rule_Dthree( ga, gb ) )
+	{
+		std::vector<int> v;
+		if(verbose)
+			std::cout  << "[D3] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can be merged.\t\t\t--Cost;\t\tQCost:" << -1*(gaNCVCost-1) << std::endl;
+		v.push_back(3);
+		v.push_back(itGateIndex);
+		v.push_back(nextGateIndex);
+		v.push_back(-1);
+		v.push_back(-1*(gaNCVCost-1));
+		x.push_back( v );
+	}
+	
+	if( verify_rule_Dfour( ga, gb ) )
+	{
+		std::vector<int> v;
+		// if(verbose)
+		// 	std::cout  << "[D4] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can be merged.\t\t\t--Cost" << std::endl;
+		v.push_back(14);
+		v.push_back(itGateIndex);
+		v.push_back(nextGateIndex);
+		v.push_back(-1);
+		if(gaControls > gbControls)
 		{
-			std::vector<int> v;
+			v.push_back(-1*gaNCVCost);
 			if(verbose)
-				std::cout  << "[D5] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can insert controls.\t\tNo cost change;\tQCost:" << ncv_cost(gaControls+1) + ncv_cost(gbControls+1) << std::endl;
-			v.push_back(5);
-			v.push_back(itGateIndex);
-			v.push_back(nextGateIndex);
-			v.push_back(0);
-			v.push_back(ncv_cost(gaControls+1) + ncv_cost(gbControls+1));
-			x.push_back( v );
+				std::cout  << "[D4] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can be merged.\t\t\t--Cost;\t\tQCost:" << -1*gaNCVCost << std::endl;
 		}
-		
-		if( verify_rule_Dfivee( ga, gb ) )
+		else
 		{
-			std::vector<int> v;
 			if(verbose)
-				std::cout  << "[D5] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can remove controls.\t\tNo cost change;\tQCost:" << -1*(ncv_cost(gaControls+1) + ncv_cost(gbControls+1)) <<std::endl;
-			v.push_back(-5);
-			v.push_back(itGateIndex);
-			v.push_back(nextGateIndex);
-			v.push_back(0);
-			v.push_back(-1*(ncv_cost(gaControls+1) + ncv_cost(gbControls+1)));
-			x.push_back( v );
+				std::cout  << "[D4] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can be merged.\t\t\t--Cost;\t\tQCost:" << -1*gbNCVCost << std::endl;
+			v.push_back(-1*gbNCVCost);
 		}
+		x.push_back( v );
+	}
 
-		if( verify_rule_Dsix( ga, gb ) )
-		{
-			std::vector<int> v;
-			if(verbose)
-				std::cout  << "[D6] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can be interchanged.\t\tNo cost change;" << std::endl;
-			v.push_back(6);
-			v.push_back(itGateIndex);
-			v.push_back(nextGateIndex);
-			v.push_back(0);
-			v.push_back(0);
-			x.push_back( v );
-		}
+	if( verify_rule_Rfour( ga, gb ) )
+	{
+		std::vector<int> v;
+		if(verbose)
+			std::cout  << "[R4] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can be interchanged.\t\tNo cost change;" << std::endl;
+		v.push_back(4);
+		v.push_back(itGateIndex);
+		v.push_back(nextGateIndex);
+		v.push_back(0);
+		v.push_back(0);
+		x.push_back( v );
+	}
+	
+	if( verify_rule_Dfive( ga, gb ) )
+	{
+		std::vector<int> v;
+		if(verbose)
+			std::cout  << "[D5] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can insert controls.\t\tNo cost change;\tQCost:" << ncv_cost(gaControls+1) + ncv_cost(gbControls+1) << std::endl;
+		v.push_back(5);
+		v.push_back(itGateIndex);
+		v.push_back(nextGateIndex);
+		v.push_back(0);
+		v.push_back(ncv_cost(gaControls+1) + ncv_cost(gbControls+1));
+		x.push_back( v );
+	}
+	
+	if( verify_rule_Dfivee( ga, gb ) )
+	{
+		std::vector<int> v;
+		if(verbose)
+			std::cout  << "[D5] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can remove controls.\t\tNo cost change;\tQCost:" << -1*(ncv_cost(gaControls+1) + ncv_cost(gbControls+1)) <<std::endl;
+		v.push_back(-5);
+		v.push_back(itGateIndex);
+		v.push_back(nextGateIndex);
+		v.push_back(0);
+		v.push_back(-1*(ncv_cost(gaControls+1) + ncv_cost(gbControls+1)));
+		x.push_back( v );
+	}
 
-		if( verify_rule_Dseven( ga, gb ) )
-		{
-			std::vector<int> v;
-			if(verbose)
-				std::cout  << "[D7] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can be interchanged.\t\t++Cost;\t\tQCost:" << ncv_cost(gaControls + gbControls) << std::endl;
-			v.push_back(7);
-			v.push_back(itGateIndex);
-			v.push_back(nextGateIndex);
-			v.push_back(1);
-			v.push_back(ncv_cost(gaControls + gbControls));
-			x.push_back( v );
-		}
+	if( verify_rule_Dsix( ga, gb ) )
+	{
+		std::vector<int> v;
+		if(verbose)
+			std::cout  << "[D6] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can be interchanged.\t\tNo cost change;" << std::endl;
+		v.push_back(6);
+		v.push_back(itGateIndex);
+		v.push_back(nextGateIndex);
+		v.push_back(0);
+		v.push_back(0);
+		x.push_back( v );
+	}
+
+	if( verify_rule_Dseven( ga, gb ) )
+	{
+		std::vector<int> v;
+		if(verbose)
+			std::cout  << "[D7] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can be interchanged.\t\t++Cost;\t\tQCost:" << ncv_cost(gaControls + gbControls) << std::endl;
+		v.push_back(7);
+		v.push_back(itGateIndex);
+		v.push_back(nextGateIndex);
+		v.push_back(1);
+		v.push_back(ncv_cost(gaControls + gbControls));
+		x.push_back( v );
+	}
+}
+
+//The rules pick controls in order, so the gates of the window are kept sorted
+void sort_controls( circuit& circ, unsigned begin, unsigned end )
+{
+	for ( unsigned i = begin; i < end && i < circ.num_gates(); ++i )
+		std::sort( circ[i].controls().begin(), circ[i].controls().end() );
+}
+
+//Lists the moves of all adjacent pairs in [begin, end), the pairs are independent
+//and split over the pool; the order of the list is the same as in serial
+void list_rules( const circuit& circ, matrix& x, unsigned begin, unsigned end, bool verbose, thread_pool* pool = nullptr, unsigned num_threads = 1u )
+{
+	if ( end <= begin + 1 )
+		return;
+
+	const unsigned pairs = end - begin - 1;
+	const unsigned min_chunk = 32u;
+
+	if ( !pool || verbose || pairs < 2 * min_chunk )
+	{
+		for ( unsigned i = begin; i + 1 < end; ++i )
+			list_rules_pair( circ[i], circ[i + 1], i, x, verbose );
+		return;
 	}
 
+	const unsigned chunks = std::min( num_threads, pairs / min_chunk );
+	std::vector<std::future<matrix>> futures;
+	for ( unsigned c = 0; c < chunks; ++c )
+	{
+		const unsigned cbegin = begin + ( pairs * c ) / chunks;
+		const unsigned cend = begin + ( pairs * ( c + 1 ) ) / chunks;
+		futures.push_back( pool->enqueue( [&circ, cbegin, cend]() {
+					matrix local;
+					for ( unsigned i = cbegin; i < cend; ++i )
+						list_rules_pair( circ[i], circ[i + 1], i, local, false );
+					return local;
+				} ) );
+	}
+	for ( auto& f : futures )
+	{
+		const auto local = f.get();
+		x.insert( x.end(), local.begin(), local.end() );
+	}
 }
 
-void apply_rule( circuit& circ, std::vector<std::vector<int>> x, unsigned y )
+void apply_rule( circuit& circ, const matrix& x, unsigned y )
 {
 	circuit::const_iterator itGate = circ.begin(), nextGate = circ.begin();
 	switch( x[y][0] )
@@ -347,7 +450,7 @@ void apply_rule( circuit& circ, std::vector<std::vector<int>> x, unsigned y )
 	}
 }
 
-void apply_rule( circuit& circ, std::vector<std::vector<int>> x, unsigned y, bool verbose )
+void apply_rule( circuit& circ, const matrix& x, unsigned y, bool verbose )
 {
 	circuit::const_iterator itGate = circ.begin(), nextGate = circ.begin();
 	switch( x[y][0] )
@@ -410,6 +513,41 @@ void apply_rule( circuit& circ, std::vector<std::vector<int>> x, unsigned y, boo
 	}
 }
 
+//Applies a move and updates the costs over the window it touches; the move
+//is checked locally and undone if the function of the window changes or
+//cannot be checked
+bool apply_move( circuit& circ, const matrix& x, unsigned y, bool verbose, tabu_cost& cost )
+{
+	const unsigned pos = x[y][1];
+	const unsigned n = circ.num_gates();
+	const auto before = window_cost( circ, pos, pos + 2 );
+	std::vector<gate> old_gates( circ.begin() + pos, circ.begin() + pos + 2 );
+
+	if ( verbose )
+		apply_rule( circ, x, y, verbose );
+	else
+		apply_rule( circ, x, y );
+
+	const unsigned after_end = pos + 2 + circ.num_gates() - n;
+	assert( after_end <= pos + rule_window );
+	std::vector<gate> new_gates( circ.begin() + pos, circ.begin() + after_end );
+	if ( !window_equivalent( old_gates, new_gates ) )
+	{
+		if ( verbose )
+			std::cout << "Move refused, the window changed or cannot be checked" << std::endl;
+		for ( unsigned i = pos; i < after_end; ++i )
+			circ.remove_gate_at( pos );
+		for ( unsigned i = 0; i < old_gates.size(); ++i )
+			circ.insert_gate( pos + i ) = old_gates[i];
+		return false;
+	}
+
+	const auto after = window_cost( circ, pos, after_end );
+	cost.gates = cost.gates - before.gates + after.gates;
+	cost.qcost = cost.qcost - before.qcost + after.qcost;
+	return true;
+}
+
 //Sort the vector of the rules
 void sortrows(matrix& x, int col)
 {    
@@ -433,7 +571,7 @@ void print_list(matrix& x)
 }
 
 //Function to decide which rule must be applied
-void choosing_rule(circuit& circ, matrix x, matrix& tp, bool verbose)
+void choosing_rule(circuit& circ, const matrix& x, matrix& tp, tabu_cost& cost, bool verbose)
 {
 	bool insert;
 	//std::cout << t.size() << std::endl;
@@ -441,7 +579,7 @@ void choosing_rule(circuit& circ, matrix x, matrix& tp, bool verbose)
 	{
 		if(x[k][3] < 0)
 		{
-			apply_rule(circ, x, k, verbose);
+			apply_move(circ, x, k, verbose, cost);
 			break;
 		}
 		insert = true;
@@ -455,9 +593,9 @@ void choosing_rule(circuit& circ, matrix x, matrix& tp, bool verbose)
 		}
 		if(insert)
 		{
-			x[k][3] = 0;
 			tp.push_back( x[k] );
-			apply_rule( circ, x, k, verbose );
+			tp.back()[3] = 0;
+			apply_move( circ, x, k, verbose, cost );
 			break;
 		}
 	}
@@ -466,7 +604,7 @@ void choosing_rule(circuit& circ, matrix x, matrix& tp, bool verbose)
 }
 
 //Function to decide which rule must be applied
-void choosing_rule(circuit& circ, matrix x, matrix& tp)
+void choosing_rule(circuit& circ, const matrix& x, matrix& tp, tabu_cost& cost)
 {
 	bool insert;
 	//std::cout << t.size() << std::endl;
@@ -474,7 +612,7 @@ void choosing_rule(circuit& circ, matrix x, matrix& tp)
 	{
 		if(x[k][3] < 0)
 		{
-			apply_rule(circ, x, k);
+			apply_move(circ, x, k, false, cost);
 			break;
 		}
 		insert = true;
@@ -488,9 +626,9 @@ void choosing_rule(circuit& circ, matrix x, matrix& tp)
 		}
 		if(insert)
 		{
-			x[k][3] = 0;
 			tp.push_back( x[k] );
-			apply_rule( circ, x, k );
+			tp.back()[3] = 0;
+			apply_move( circ, x, k, false, cost );
 			break;
 		}
 	}
@@ -512,22 +650,24 @@ void update_tabu_list(matrix& tp, int penalization)
 }
 
 //Save the minimum circuit found
-bool update_circuit(circuit& circ, circuit& min, unsigned opt)
+bool update_circuit(const circuit& circ, circuit& min, const tabu_cost& cost, tabu_cost& min_cost, unsigned opt)
 {
 	switch(opt){
 		case 0:
-			if(circ.num_gates() < min.num_gates())
+			if(cost.gates < min_cost.gates)
 			{
 				clear_circuit(min);
 				copy_circuit(circ, min);
+				min_cost = cost;
 				//std::cout << " Minimo: " << min.num_gates() << std::endl;
 				return true;
 			}
 		default:
-			if(circuit_ncv_cost(circ) < circuit_ncv_cost(min))
+			if(cost.qcost < min_cost.qcost)
 			{
 				clear_circuit(min);
 				copy_circuit(circ, min);
+				min_cost = cost;
 				//std::cout << " Minimo: " << min.num_gates() << std::endl;
 				return true;
 			}
@@ -535,9 +675,10 @@ bool update_circuit(circuit& circ, circuit& min, unsigned opt)
 	return false;
 }
 
-void tabu_search( circuit& circ, unsigned overlap, unsigned neighborhood, const properties::ptr& statistics, unsigned opt )
+void tabu_search( circuit& circ, unsigned overlap, unsigned neighborhood, const properties::ptr& statistics, unsigned opt, unsigned num_threads )
 {
 	properties_timer t( statistics );
+	std::unique_ptr<thread_pool> pool( num_threads > 1u ? new thread_pool( num_threads ) : nullptr );
 	unsigned stop = 0, begin, end;
 	bool finish = false;
 	matrix x; //list of possible rules of the current iteration
@@ -546,6 +687,7 @@ void tabu_search( circuit& circ, unsigned overlap, unsigned neighborhood, const
 
 	copy_circuit( circ, orig );
  	copy_circuit( circ, min );
+	tabu_cost cost = window_cost( circ, 0, circ.num_gates() ), min_cost = cost;
  	// reverse_circuit( orig );
  	begin = 0;
 	end = neighborhood;
@@ -576,11 +718,12 @@ void tabu_search( circuit& circ, unsigned overlap, unsigned neighborhood, const
 	 	tp.clear();
 	 	while(stop < neighborhood * 50)
 	 	{
-	 		list_rules(circ, x, begin, end, false);
+	 		sort_controls(circ, begin, end);
+	 		list_rules(circ, x, begin, end, false, pool.get(), num_threads);
 	 		sortrows(x, opt+3);
-	 		choosing_rule(circ, x, tp);
+	 		choosing_rule(circ, x, tp, cost);
 	 		update_tabu_list(tp, neighborhood);
-	 		if(!update_circuit(circ, min, opt))
+	 		if(!update_circuit(circ, min, cost, min_cost, opt))
 	 			++stop;
 	 		else
 	 			stop = 0;
@@ -596,6 +739,7 @@ void tabu_search( circuit& circ, unsigned overlap, unsigned neighborhood, const
 	 	}
 	 	clear_circuit(circ);
 	 	copy_circuit(min, circ);
+	 	cost = min_cost;
 	 	improvement = improvement - min.num_gates();
 	 	//std::cout << "improvement: " << improvement << std::endl;
 	 	//std::cin.get();
@@ -617,6 +761,7 @@ void tabu_search( circuit& circ, unsigned overlap, unsigned neighborhood, const
 
 	copy_circuit( circ, orig );
  	copy_circuit( circ, min );
+	tabu_cost cost = window_cost( circ, 0, circ.num_gates() ), min_cost = cost;
  	// reverse_circuit( orig );
  	begin = 0;
 	end = neighborhood;
@@ -649,17 +794,18 @@ void tabu_search( circuit& circ, unsigned overlap, unsigned neighborhood, const
 	 	{
 	 		std::cout << "++++++++++ ITERATION " << stop << " +++++++++++" << std::endl;
 	 		std::cout << circ << std::endl;
+	 		sort_controls(circ, begin, end);
 	 		list_rules(circ, x, begin, end, verbose);
 	 		sortrows(x, opt+3);
 	 		std::cout << "++++++++++ BEGIN LIST OF RULES +++++++++++" << std::endl;
  			print_list( x );
 	 		std::cout << "++++++++++   END LIST OF RULES +++++++++++" << std::endl;
-	 		choosing_rule(circ, x, tp, verbose);
+	 		choosing_rule(circ, x, tp, cost, verbose);
 	 		update_tabu_list(tp, neighborhood);
  			std::cout << "++++++++++ BEGIN TABU LIST +++++++++++" << std::endl;
  			print_list( tp );
  			std::cout << "++++++++++   END TABU LIST +++++++++++" << std::endl;	
-	 		if(!update_circuit(circ, min, opt))
+	 		if(!update_circuit(circ, min, cost, min_cost, opt))
 	 		{
 	 			++stop;
 	 		}
@@ -682,6 +828,7 @@ void tabu_search( circuit& circ, unsigned overlap, unsigned neighborhood, const
 	 	}
 	 	clear_circuit(circ);
 	 	copy_circuit(min, circ);
+	 	cost = min_cost;
 	 	improvement = improvement - min.num_gates();
 	 	//std::cout << "improvement: " << improvement << std::endl;
 	 	//std::cin.get();
@@ -695,10 +842,10 @@ void tabu_search( circuit& circ, unsigned overlap, unsigned neighborhood, const
 
 bool tabu_command::execute()
 {
-	circuit aux, circ;
+	circuit orig, circ;
 	auto& circuits = env->store<circuit>();
-	aux = circuits.current();
-	copy_circuit(aux, circ);
+	orig = circuits.current();
+	copy_circuit(orig, circ);
  	unsigned int InitialGatesCost, InitialQuantumCost = 0, FinalQuantumCost = 0;
  	InitialGatesCost = circ.num_gates();
  	
@@ -709,7 +856,14 @@ bool tabu_command::execute()
  	else if ( is_set("verbose") && !is_set("step") )
  		tabu_search( circ, overlap, neighborhood, statistics, opt, true, false );
  	else
- 		tabu_search( circ, overlap, neighborhood, statistics, opt );
+ 		tabu_search( circ, overlap, neighborhood, statistics, opt, num_threads );
+
+ 	if ( is_set( "check" ) && !same_function( orig, circ ) )
+ 	{
+ 		std::cout << "[e] optimized circuit is not equivalent to the original circuit, store is not changed" << std::endl;
+ 		return false;
+ 	}
+
 	if ( is_set( "new" ) )
         circuits.extend();    
  	circuits.current() = circ;
@@ -721,9 +875,6 @@ bool tabu_command::execute()
     std::cout << " Begin quantum cost: " << InitialQuantumCost <<std::endl; 
     std::cout << " Final quantum cost: " << FinalQuantumCost << std::endl;
     print_runtime();
-    
-    if (!changed_circuit(circ))
-    	std::cout << "BRRRRRR" << std::endl;
 
 	return true;
 }
@@ -36,12 +36,17 @@
 #ifndef CLI_TABU_COMMAND_HPP
 #define CLI_TABU_COMMAND_HPP
 
+#include <core/properties.hpp>
 #include <reversible/circuit.hpp>
 #include <cli/cirkit_command.hpp>
 
 namespace cirkit
 {
 
+/* optimizes an MCT circuit in place with tabu search over neighborhoods of gates;
+ * opt selects the cost (0: gates, otherwise quantum cost) */
+void tabu_search( circuit& circ, unsigned overlap, unsigned neighborhood, const properties::ptr& statistics, unsigned opt, unsigned num_threads );
+
 class tabu_command : public cirkit_command
     {
     public:
@@ -57,6 +62,7 @@ private:
 	unsigned int penalization = 10u;
 	unsigned int neighborhood = 10u;
 	unsigned int overlap = 70u;
+	unsigned int num_threads = 1u;
 	
 public:
   log_opt_t log() const;
@@ -25,6 +25,17 @@
  */
 
 #include "IBMgraph.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <future>
+#include <limits>
+#include <mutex>
+
+#include <boost/range/algorithm_ext/iota.hpp>
+
+#include <core/utils/thread_pool.hpp>
 #include <reversible/io/print_circuit.hpp>
 #include <reversible/functions/move_qubit.hpp>
 #include <reversible/functions/copy_metadata.hpp>
@@ -44,13 +55,8 @@
 namespace cirkit
 {
     using matrix = std::vector<std::vector<int>>;
-    // Here the memory error stopped
-    std::vector<TransPath> path_list;
-    bool **graph_adjacency = NULL;  // graph structure
-    int **trans_cost = NULL;        // the cost of each cnot
-    TransPath **trans_path = NULL;  // the transformation path or a given cnot
-    
-    bool read_graph( const std::string& filename )
+
+    bool coupling_graph::read_graph( const std::string& filename )
     {
         int v,w;
         std::fstream graphfile;
@@ -60,15 +66,7 @@ namespace cirkit
             return false;
         }
         graphfile >> graph_size;
-        graph_adjacency = new bool*[graph_size];
-        for(int i = 0; i < graph_size ; i++ )
-        {
-            graph_adjacency[i] = new bool[graph_size];
-            for(int j = 0; j < graph_size; j++)
-            {
-                graph_adjacency[i][j] = false;
-            }
-        }
+        graph_adjacency.assign( graph_size, std::vector<bool>( graph_size, false ) );
         while ( !graphfile.eof() )
         {
             graphfile >> v >> w;
@@ -79,7 +77,7 @@ namespace cirkit
     }
 
     // read the matrix and the transformations from a file
-    bool read_from_file ( const std::string& filename )
+    bool coupling_graph::read_from_file ( const std::string& filename )
     { 
         std::vector<std::string> type_name = { "cab", "cba", "tab", "tba", "cabi", "cbai", "tabi", "tbai", "nop", "flip", "cnot3"};
         std::string tmp;
@@ -90,12 +88,11 @@ namespace cirkit
             return false;
         
         graphfile >> graph_size; // get the number of qubits
-        graph_adjacency = new bool*[graph_size];
+        graph_adjacency.assign( graph_size, std::vector<bool>( graph_size, false ) );
         allocate_data_stuctures();
 
         // read the graph
         for(int i = 0; i < graph_size ; i++ ){
-            graph_adjacency[i] = new bool[graph_size];
             for(int j = 0; j < graph_size; j++){
                 graphfile >> tmp;
                 if(tmp == "X")
@@ -143,7 +140,7 @@ namespace cirkit
     }
 
     // write the graph, the matrix and the transformations to a file
-    bool write_to_file ( const std::string& filename )
+    bool coupling_graph::write_to_file ( const std::string& filename )
     {
         std::ofstream graphfile ( filename );
         if ( !graphfile.is_open() )
@@ -177,7 +174,7 @@ namespace cirkit
         return true;
     }
 
-   void print_graph( ){
+   void coupling_graph::print_graph( ) const {
         for( int i = 0; i < graph_size; i++ ){
             for( int j = 0; j < graph_size; j++ ){
                 std::cout << (graph_adjacency[i][j] ? "X " : "- ");
@@ -187,7 +184,7 @@ namespace cirkit
     }
 
     // print the matrix and the transformations
-    void print_matrix( )
+    void coupling_graph::print_matrix( )
     {
         for( int v = 0; v < graph_size; v++)
         {
@@ -208,21 +205,15 @@ namespace cirkit
         }
     }
 
-    void delete_graph( ){
-        for( int i = 0; i < graph_size; i++ ){
-            delete [] graph_adjacency[i];
-            delete [] trans_path[i];
-            delete [] trans_cost[i];
-            
-        }
-        delete [] graph_adjacency;
-        delete [] trans_path;
-        delete [] trans_cost;
+    void coupling_graph::delete_graph( ){
+        graph_adjacency.clear();
+        trans_path.clear();
+        trans_cost.clear();
         graph_size = 0;
     }
     
-    // When a path is found add it to the global vector of paths.
-    void find_all_paths( int v, int w, TransPath &tp, bool *visited )
+    // When a path is found add it to the vector of paths.
+    void coupling_graph::find_all_paths( int v, int w, TransPath &tp, std::vector<bool>& visited, std::vector<TransPath>& path_list ) const
     {
         bool done = false;
         for( int i = 0; i < graph_size; i++ )
@@ -246,7 +237,7 @@ namespace cirkit
             {
                 tp.add( MoveQubit( cab, v, i ));
                 visited[i] = true;
-                find_all_paths( i,  w, tp, visited );
+                find_all_paths( i,  w, tp, visited, path_list );
                 tp.remove_last();
                 visited[i] = false;
             }
@@ -254,7 +245,7 @@ namespace cirkit
             {
                 tp.add( MoveQubit( cba, v, i ));
                 visited[i] = true;
-                find_all_paths( i,  w, tp, visited );
+                find_all_paths( i,  w, tp, visited, path_list );
                 tp.remove_last();
                 visited[i] = false;
             }
@@ -262,7 +253,7 @@ namespace cirkit
             {
                 tp.add( MoveQubit( tab, w, i ));
                 visited[i] = true;
-                find_all_paths( v,  i, tp, visited );           
+                find_all_paths( v,  i, tp, visited, path_list );           
                 tp.remove_last();
                 visited[i] = false;
             }
@@ -270,7 +261,7 @@ namespace cirkit
             {
                 tp.add( MoveQubit( tba, w, i ));
                 visited[i] = true;
-                find_all_paths( v,  i, tp, visited );
+                find_all_paths( v,  i, tp, visited, path_list );
                 tp.remove_last();
                 visited[i] = false;
             }
@@ -283,7 +274,7 @@ namespace cirkit
         - trans_path[v][w]
      */
     
-    void set_best_path(int v, int w )
+    void coupling_graph::set_best_path(int v, int w, std::vector<TransPath>& path_list )
     {
         TransPath tp, best_tp;
         int best_cost;
@@ -304,25 +295,16 @@ namespace cirkit
         trans_path[v][w] = best_tp;
     }
 
-    void allocate_data_stuctures(){
-        trans_cost = new int*[graph_size];
-        trans_path = new TransPath*[graph_size];
-        for(int i = 0; i < graph_size ; i++ )
-        {
-            trans_cost[i] = new int[graph_size];
-            trans_path[i] = new TransPath[graph_size];
-        }
+    void coupling_graph::allocate_data_stuctures(){
+        trans_cost.assign( graph_size, std::vector<int>( graph_size, 0 ) );
+        trans_path.assign( graph_size, std::vector<TransPath>( graph_size ) );
     }
     
-    void create_trans( bool verbose )
+    void coupling_graph::create_trans( bool verbose )
     {
         allocate_data_stuctures();
-        path_list.clear();
-        bool visited[graph_size];
-        for( int i = 0; i < graph_size ; i++ )
-        {
-            visited[i] = false;
-        }
+        std::vector<TransPath> path_list;
+        std::vector<bool> visited( graph_size, false );
 
         TransPath tp;
         for( int v = 0; v < graph_size; v++)
@@ -339,8 +321,8 @@ namespace cirkit
                     visited[w] = true;
                     path_list.clear();
                     tp.clear();
-                    find_all_paths( v,  w, tp, visited );
-                    set_best_path( v,  w);
+                    find_all_paths( v,  w, tp, visited, path_list );
+                    set_best_path( v,  w, path_list );
                 }
             }
         }
@@ -380,7 +362,7 @@ namespace cirkit
         }
     }
 
-    void print_movements( const circuit& circ_in )
+    void coupling_graph::print_movements( const circuit& circ_in )
     {
         unsigned target, control;
         for ( const auto& gate : circ_in )
@@ -437,7 +419,7 @@ namespace cirkit
         }
     }
 
-    circuit transform_tof_clif( const circuit& circ )
+    circuit transform_tof_clif( const coupling_graph& graph, const circuit& circ )
     {
         circuit circ_out;
         copy_metadata(circ, circ_out);
@@ -473,23 +455,23 @@ namespace cirkit
                     bool ta1, ta2, ta3, ta4;
                     bool tb, tc1, tc2;
 
-                    if(trans_cost[ca][cb] < trans_cost[cb][ca])
-                        tab = 2*trans_cost[ca][cb];
+                    if(graph.trans_cost[ca][cb] < graph.trans_cost[cb][ca])
+                        tab = 2*graph.trans_cost[ca][cb];
                     else
-                        tab = 2*trans_cost[cb][ca];
+                        tab = 2*graph.trans_cost[cb][ca];
                     
-                    if(trans_cost[cb][target] < trans_cost[target][cb])
-                        tbc = 2*trans_cost[cb][target];
+                    if(graph.trans_cost[cb][target] < graph.trans_cost[target][cb])
+                        tbc = 2*graph.trans_cost[cb][target];
                     else
-                        tbc = 2*trans_cost[target][cb];
-                    if(trans_cost[ca][target] < trans_cost[target][ca])
-                        tac = 2*trans_cost[ca][target];
+                        tbc = 2*graph.trans_cost[target][cb];
+                    if(graph.trans_cost[ca][target] < graph.trans_cost[target][ca])
+                        tac = 2*graph.trans_cost[ca][target];
                     else
-                        tac = 2*trans_cost[target][ca];
+                        tac = 2*graph.trans_cost[target][ca];
 
-                    t1 = 2*trans_cost[ca][target] + 2*trans_cost[cb][target] + tab;
-                    t2 = 2*trans_cost[target][ca] + 2*trans_cost[cb][ca] + tbc;
-                    t3 = 2*trans_cost[target][cb] + 2*trans_cost[ca][cb] + tac;
+                    t1 = 2*graph.trans_cost[ca][target] + 2*graph.trans_cost[cb][target] + tab;
+                    t2 = 2*graph.trans_cost[target][ca] + 2*graph.trans_cost[cb][ca] + tbc;
+                    t3 = 2*graph.trans_cost[target][cb] + 2*graph.trans_cost[ca][cb] + tac;
                     // std::cout << "t1: " << t1 << " t2: " << t2 << " t3: " << t3 << std::endl;  
                     std::vector<unsigned> controla, controlb, controlt;
                     if( t1 < t2 && t1 < t3 )
@@ -528,7 +510,7 @@ namespace cirkit
                         append_pauli( circ_out,  target, pauli_axis::Z, 4u, ta4 );
                         append_toffoli( circ_out, controlb, target );
 
-                        if(trans_cost[ca][cb] < trans_cost[cb][ca])
+                        if(graph.trans_cost[ca][cb] < graph.trans_cost[cb][ca])
                         {
                             append_toffoli( circ_out, controla, cb );
                             append_pauli( circ_out,  cb, pauli_axis::Z, 4u, tc1 );
@@ -596,7 +578,7 @@ namespace cirkit
                         append_pauli( circ_out,  ca, pauli_axis::Z, 4u, ta4 );
                         append_toffoli( circ_out, controlb, ca );
 
-                        if(trans_cost[cb][target] < trans_cost[target][cb])
+                        if(graph.trans_cost[cb][target] < graph.trans_cost[target][cb])
                         {
                             append_toffoli( circ_out, controlb, target );
                             append_pauli( circ_out,  target, pauli_axis::Z, 4u, tc1 );
@@ -623,7 +605,7 @@ namespace cirkit
         return circ_out;
     }
 
-    circuit transform_v_clif( const circuit& circ )
+    circuit transform_v_clif( const coupling_graph& graph, const circuit& circ )
     {
         circuit circ_out;
         copy_metadata(circ, circ_out);
@@ -638,7 +620,7 @@ namespace cirkit
                 control = gate.controls().front().line();
                 
 
-                if (trans_cost[control][target] < trans_cost[target][control])
+                if (graph.trans_cost[control][target] < graph.trans_cost[target][control])
                 {
                     controls.clear();
                     controls.push_back( control );   
@@ -671,12 +653,12 @@ namespace cirkit
 
     // expand the cnot gates that are not supported by the architecture
     // assume that the corresponding matricies have been set up correctly
-    void expand_cnots( circuit& circ_out, const circuit& circ_in ){
+    void expand_cnots( const coupling_graph& graph, circuit& circ_out, const circuit& circ_in ){
 
         circuit circ_aux;
         copy_metadata( circ_in, circ_aux );
-        circ_aux = transform_v_clif(circ_in);
-        circ_aux = transform_tof_clif(circ_aux);
+        circ_aux = transform_v_clif(graph, circ_in);
+        circ_aux = transform_tof_clif(graph, circ_aux);
         unsigned target, control, moreCnot3 = 0, aux = 0;
         std::vector<unsigned int> new_controls, control2, old_controls;
         
@@ -704,7 +686,7 @@ namespace cirkit
                     moreCnot3 = 0;
                     aux = 0;
                     unsigned cnot3a, cnot3b;
-                    for ( auto &p : trans_path[control][target].tpath )
+                    for ( const auto &p : graph.trans_path[control][target].tpath )
                         if (p.getType() == cnot3 || p.getType() == cnot3i)
                         {
                             if(aux < 1)
@@ -718,7 +700,7 @@ namespace cirkit
                             }
                             ++aux;
                         }
-                    for ( auto &p : trans_path[control][target].tpath ) {
+                    for ( const auto &p : graph.trans_path[control][target].tpath ) {
                         switch ( p.getType() )
                         {
                             case cab : //std::cout << "cab" << std::endl;
@@ -873,108 +855,246 @@ namespace cirkit
     }
 
  
-    unsigned custo;
-    matrix mapeamento;
-    matrix matrix_custo;
-    std::vector<int> vector_costs;
-
-    void extract_matrix(std::vector<int>& m)
+    void clear_matrix(matrix& m)
     {
         for (int i = 0; i < m.size(); ++i)
+            m[i].clear();
+        m.clear();
+    }
+
+    void initialize_matrix(matrix& m, unsigned size)
+    {
+        std::vector<int> aux;
+        for (int i = 0; i < size; ++i)
+            aux.push_back(0);
+        for (int i = 0; i < size; ++i)
+            m.push_back(aux);
+    }
+
+    // Branch-and-bound over injective placements of the circuit lines on the
+    // qubits. Lines are placed in the order of their number of cnots, the cost
+    // of a placement is the sum of the transformation costs of all cnots.
+    class placement_search
+    {
+    public:
+        using placement_t = std::vector<int>;
+        using candidate_t = std::pair<unsigned, placement_t>;
+
+        placement_search( const coupling_graph& graph, const matrix& cnots, unsigned slack, unsigned max_candidates )
+            : graph( graph ),
+              cnots( cnots ),
+              lines( cnots.size() ),
+              slack( slack ),
+              max_candidates( std::max( max_candidates, 1u ) )
+        {
+            std::vector<int> weight( lines, 0 );
+            for (int i = 0; i < lines; ++i)
+                for (int j = 0; j < lines; ++j)
+                {
+                    weight[i] += cnots[i][j];
+                    weight[j] += cnots[i][j];
+                }
+            order.resize( lines );
+            boost::iota( order, 0 );
+            std::stable_sort( order.begin(), order.end(), [&weight]( int a, int b ) { return weight[a] > weight[b]; } );
+        }
+
+        std::vector<candidate_t> run( unsigned num_threads )
         {
-            for (int j = 0; j < m.size(); ++j)
+            candidates.clear();
+
+            // warm start, the greedy placement also bounds the search
+            placement_t placement( lines, -1 );
+            std::vector<bool> used( graph.graph_size, false );
+            unsigned cost = 0u;
+            for (int d = 0; d < lines; ++d)
+            {
+                auto best_q = -1;
+                auto best_inc = std::numeric_limits<unsigned>::max();
+                for (int q = 0; q < graph.graph_size; ++q)
+                {
+                    if ( used[q] ) continue;
+                    const auto inc = increment( placement, order[d], q );
+                    if ( inc < best_inc )
+                    {
+                        best_inc = inc;
+                        best_q = q;
+                    }
+                }
+                placement[order[d]] = best_q;
+                used[best_q] = true;
+                cost += best_inc;
+            }
+            best = cost;
+            add_candidate( cost, placement );
+
+            // split the search tree at the first two levels
+            std::vector<std::pair<int, int>> roots;
+            for (int q0 = 0; q0 < graph.graph_size && lines > 0; ++q0)
             {
-                matrix_custo[i][j] = trans_cost[m[i]][m[j]];
-                // std::cout << " " << matrix_q[i][j];
+                if ( lines == 1 )
+                    roots.push_back( {q0, -1} );
+                else
+                    for (int q1 = 0; q1 < graph.graph_size; ++q1)
+                        if ( q0 != q1 )
+                            roots.push_back( {q0, q1} );
             }
-            // std::cout << std::endl;
+
+            auto solve_root = [this]( std::pair<int, int> root ) {
+                placement_t placement( lines, -1 );
+                std::vector<bool> used( graph.graph_size, false );
+                unsigned cost = 0u;
+                placement[order[0]] = root.first;
+                used[root.first] = true;
+                if ( root.second == -1 )
+                {
+                    add_candidate( cost, placement );
+                    return;
+                }
+                cost += increment( placement, order[1], root.second );
+                placement[order[1]] = root.second;
+                used[root.second] = true;
+                branch( placement, used, 2, cost );
+            };
+
+            if ( num_threads <= 1u )
+            {
+                for ( const auto& root : roots )
+                    solve_root( root );
+            }
+            else
+            {
+                thread_pool pool( num_threads );
+                std::vector<std::future<void>> futures;
+                for ( const auto& root : roots )
+                    futures.push_back( pool.enqueue( solve_root, root ) );
+                for ( auto& f : futures )
+                    f.get();
+            }
+
+            compact_candidates();
+            return candidates;
         }
-    }
 
-    void all_combinations(int offset, int k, std::vector<int>& qubits, std::vector<int>& combination, matrix& matrix_circuit) 
-    {
-        // long long int total = 0;
-        if (k == 0) 
+    private:
+        // cost of the cnots between `line' on qubit `q' and all placed lines
+        unsigned increment( const placement_t& placement, int line, int q ) const
         {
-            // pretty_print(combination);
-            unsigned int aux;
-            do
+            unsigned inc = 0u;
+            for (int l = 0; l < lines; ++l)
             {
+                if ( placement[l] == -1 ) continue;
+                inc += cnots[line][l] * graph.trans_cost[q][placement[l]] + cnots[l][line] * graph.trans_cost[placement[l]][q];
+            }
+            return inc;
+        }
 
-                extract_matrix(combination);
-                aux = 0;
-                for (int i = 0; i < combination.size(); ++i)
+        // every open cnot costs at least the cheapest transformation among the free qubits
+        unsigned lower_bound( const placement_t& placement, const std::vector<bool>& used ) const
+        {
+            std::vector<unsigned> min_from( graph.graph_size, std::numeric_limits<unsigned>::max() );
+            std::vector<unsigned> min_to( graph.graph_size, std::numeric_limits<unsigned>::max() );
+            unsigned min_free = std::numeric_limits<unsigned>::max();
+            for (int v = 0; v < graph.graph_size; ++v)
+                for (int w = 0; w < graph.graph_size; ++w)
                 {
-                    for (int j = 0; j < combination.size(); ++j)
-                    {
-                        aux += matrix_custo[i][j]*matrix_circuit[i][j];
-                    }
+                    if ( v == w || used[w] ) continue;
+                    min_from[v] = std::min<unsigned>( min_from[v], graph.trans_cost[v][w] );
+                    min_to[v] = std::min<unsigned>( min_to[v], graph.trans_cost[w][v] );
+                    if ( !used[v] )
+                        min_free = std::min<unsigned>( min_free, graph.trans_cost[v][w] );
                 }
-                
-                if(aux < custo+10)
+
+            unsigned lb = 0u;
+            for (int u = 0; u < lines; ++u)
+            {
+                if ( placement[u] != -1 ) continue;
+                for (int l = 0; l < lines; ++l)
                 {
-                    if(aux < custo)
-                        custo = aux;
-                    vector_costs.push_back(aux);
-                    // mapeamento.clear();
-                    mapeamento.push_back(combination);
-                    for (int i = 0; i < vector_costs.size(); ++i) 
-                    {
-                        if(vector_costs[i] > aux+10)
-                        {
-                            vector_costs.erase(vector_costs.begin()+i);
-                            mapeamento.erase(mapeamento.begin()+i);
-                            --i;
-                        }
-                    }
+                    if ( l == u ) continue;
+                    if ( placement[l] != -1 )
+                        lb += cnots[u][l] * min_to[placement[l]] + cnots[l][u] * min_from[placement[l]];
+                    else
+                        lb += cnots[u][l] * min_free;
                 }
+            }
+            return lb;
+        }
+
+        void branch( placement_t& placement, std::vector<bool>& used, int depth, unsigned cost )
+        {
+            if ( depth == lines )
+            {
+                add_candidate( cost, placement );
+                return;
+            }
+            if ( cost + lower_bound( placement, used ) > best.load() + slack )
+                return;
 
-           } while ( std::next_permutation(combination.begin(),combination.begin()+combination.size()) );
-            return;
+            const auto line = order[depth];
+            for (int q = 0; q < graph.graph_size; ++q)
+            {
+                if ( used[q] ) continue;
+                const auto inc = increment( placement, line, q );
+                if ( cost + inc > best.load() + slack ) continue;
+                placement[line] = q;
+                used[q] = true;
+                branch( placement, used, depth + 1, cost + inc );
+                used[q] = false;
+                placement[line] = -1;
+            }
         }
-        for (int i = offset; i <= qubits.size() - k; ++i) 
+
+        void add_candidate( unsigned cost, const placement_t& placement )
         {
-            combination.push_back(qubits[i]);
-            all_combinations(i+1, k-1, qubits, combination, matrix_circuit);
-            combination.pop_back();
+            auto current = best.load();
+            while ( cost < current && !best.compare_exchange_weak( current, cost ) );
+
+            if ( cost > best.load() + slack )
+                return;
+
+            std::lock_guard<std::mutex> lock( mutex );
+            candidates.push_back( {cost, placement} );
+            if ( candidates.size() > 4u * max_candidates )
+                compact_candidates();
         }
-    }
 
-    void clear_matrix(matrix& m)
-    {
-        for (int i = 0; i < m.size(); ++i)
-            m[i].clear();
-        m.clear();
-    }
+        // keeps the cheapest candidates within the slack
+        void compact_candidates()
+        {
+            const auto limit = best.load() + slack;
+            candidates.erase( std::remove_if( candidates.begin(), candidates.end(), [limit]( const candidate_t& c ) { return c.first > limit; } ), candidates.end() );
+            std::sort( candidates.begin(), candidates.end() );
+            candidates.erase( std::unique( candidates.begin(), candidates.end() ), candidates.end() );
+            if ( candidates.size() > max_candidates )
+                candidates.resize( max_candidates );
+        }
 
-    void initialize_matrix(matrix& m, unsigned size)
-    {
-        std::vector<int> aux;
-        for (int i = 0; i < size; ++i)
-            aux.push_back(0);
-        for (int i = 0; i < size; ++i)
-            m.push_back(aux);
-    }
+    private:
+        const coupling_graph& graph;
+        const matrix& cnots;
+        int lines;
+        unsigned slack;
+        unsigned max_candidates;
+        std::vector<int> order;
 
-    circuit try_all( const circuit& circ_in, bool verbose, bool rm_dup )
+        std::atomic<unsigned> best;
+        std::mutex mutex;
+        std::vector<candidate_t> candidates;
+    };
+
+    circuit try_all( const coupling_graph& graph, const circuit& circ_in, bool verbose, bool rm_dup, unsigned num_threads, unsigned slack, unsigned max_candidates )
     {
-        circuit aux, circ_out;
-        copy_circuit(circ_in, aux);
         unsigned target, control;
-        std::vector<int> qubits;
-        std::vector<int> combination;
         matrix matrix_circuit;
-        custo = INT_MAX;
 
-        vector_costs.clear(); // clear the vector with the mapping costs
-        clear_matrix(mapeamento); // clear the matrix with the mappings
-        clear_matrix(matrix_custo); // clear the matrix with the mapping cost
+        if ( circ_in.lines() > graph.graph_size )
+        {
+            std::cout << "[e] circuit has more lines than the graph has qubits" << std::endl;
+            return circ_in;
+        }
 
         initialize_matrix(matrix_circuit, circ_in.lines()); // initialize the matrix with zeros
-        initialize_matrix(matrix_custo, circ_in.lines()); // initialize the matrix with zeros
-
-        // std::cout << "Number of initial gates: " << circ_in.num_gates() << std::endl;
-        // std::cout << "\t" << circ_in.num_gates();
 
         for ( const auto& gate : circ_in )
         {
@@ -986,96 +1106,67 @@ namespace cirkit
             }
         }
 
-        for (int i = 0; i < graph_size; ++i) // initialize a vector with the qubits
-            qubits.push_back(i);
+        // search the placements
+        placement_search search( graph, matrix_circuit, slack, max_candidates );
+        const auto mapeamento = search.run( num_threads );
 
-        // test all the combinations
-        all_combinations(0, circ_in.lines(), qubits, combination, matrix_circuit);
-        
         // printing all the mappings found in the interval
         if(verbose)
         {
             for (int i = 0; i < mapeamento.size(); ++i)
             {
-                std::cout << "Need to add " << vector_costs[i] << " gates ->";
-                for (int j = 0; j < mapeamento[i].size(); ++j)
-                    std::cout << " " << mapeamento[i][j];
+                std::cout << "Need to add " << mapeamento[i].first << " gates ->";
+                for (int j = 0; j < mapeamento[i].second.size(); ++j)
+                    std::cout << " " << mapeamento[i].second[j];
                 std::cout << std::endl;
-            }    
-            std::cout << "Best mapping without optimization: " << custo << " total: " << custo + circ_in.num_gates() << std::endl;
+            }
+            std::cout << "Best mapping without optimization: " << mapeamento.front().first << " total: " << mapeamento.front().first + circ_in.num_gates() << std::endl;
         }
-        
-        circuit minimo;
-        std::vector<int> map_minimo;
 
-        for (int i = 0; i < mapeamento.size(); ++i)
-        {
-            clear_circuit(aux);
+        // expand the cnots for each candidate
+        auto expand = [&graph, &circ_in, rm_dup]( const std::vector<int>& placement ) {
+            circuit aux, circ_out;
             copy_circuit(circ_in, aux);
-            for(unsigned i = circ_in.lines() ; i < graph_size; i++)
+            for(unsigned i = circ_in.lines() ; i < graph.graph_size; i++)
                 add_line_to_circuit( aux, "i" + boost::lexical_cast<std::string>(i) , "o" + boost::lexical_cast<std::string>(i));
-            
-            permute_lines(aux, &mapeamento[i][0]);
-            expand_cnots( circ_out, aux );
-            if(circ_out.num_gates() == custo)
-            {
-                for (int j = 0; j < mapeamento[i].size(); ++j)
-                    std::cout << " " << mapeamento[i][j];             
-                std::cout << std::endl;
-            }
+
+            std::vector<int> perm( placement );
+            permute_lines(aux, &perm[0]);
+            expand_cnots( graph, circ_out, aux );
             if(rm_dup)
                 circ_out = remove_dup_gates( circ_out);
+            return circ_out;
+        };
 
-            if(i == 0 || circ_out.num_gates() < minimo.num_gates())
-            {
-                map_minimo.clear();
-                for (int j = 0; j < mapeamento[i].size(); ++j) 
-                    map_minimo.push_back(mapeamento[i][j]);
-                clear_circuit(minimo);
-                copy_circuit(circ_out, minimo);
-            }
-            clear_circuit(circ_out);
+        std::vector<circuit> expanded;
+        if ( num_threads <= 1u )
+        {
+            for ( const auto& m : mapeamento )
+                expanded.push_back( expand( m.second ) );
+        }
+        else
+        {
+            thread_pool pool( num_threads );
+            std::vector<std::future<circuit>> futures;
+            for ( const auto& m : mapeamento )
+                futures.push_back( pool.enqueue( expand, std::cref( m.second ) ) );
+            for ( auto& f : futures )
+                expanded.push_back( f.get() );
         }
 
-        // std::cout << "\t" << minimo.num_gates();
-
-        // bool d = false;
-        // for (int i = 0; i < 5; ++i)
-        // {
-        //     d = false;
-        //     for (int j = 0; j < minimo.num_gates(); ++j)
-        //     {
-        //         if(minimo[j].targets().front() == i)
-        //         {
-        //             if(minimo[j].controls().empty())
-        //             {
-        //                 if(d)
-        //                 {
-        //                     // std::cout << i << " posicao: " << j << std::endl;
-        //                     minimo.remove_gate_at(j);
-        //                     --j;
-        //                     // getchar();
-        //                 }
-        //                 else
-        //                     d = true;
-        //             }
-        //             else
-        //             {
-        //                 d = false;
-        //             }
-        //         }
-        //         else if(!minimo[j].controls().empty())
-        //             d = false;
-        //     }
-        // }
-        // std::cout << minimo << std::endl;
-        // std::cout << "\t" << circ_in.num_gates() << "\t" << minimo.num_gates();        
-        std::cout << "Best mapping: " << minimo.num_gates() << " ->";
-        for (int i = 0; i < map_minimo.size(); ++i)
-            std::cout << " " << map_minimo[i];             
+        auto index_minimo = 0u;
+        for (int i = 1; i < expanded.size(); ++i)
+        {
+            if( expanded[i].num_gates() < expanded[index_minimo].num_gates() )
+                index_minimo = i;
+        }
+
+        std::cout << "Best mapping: " << expanded[index_minimo].num_gates() << " ->";
+        for ( auto q : mapeamento[index_minimo].second )
+            std::cout << " " << q;
         std::cout << std::endl;
-       
-        return minimo;
+
+        return expanded[index_minimo];
     }
 
     int get_max_element(matrix& m, unsigned& l, unsigned& c)
@@ -1120,20 +1211,20 @@ namespace cirkit
         }
     }
 
-    void get_min_element(std::vector<unsigned> a, unsigned& l, unsigned& c)
+    void get_min_element(const coupling_graph& graph, std::vector<unsigned> a, unsigned& l, unsigned& c)
     {
         int min = INT_MAX;
-        for( int v = 0; v < graph_size; v++)
+        for( int v = 0; v < graph.graph_size; v++)
         {
-            for( int w = 0; w < graph_size; w++)
+            for( int w = 0; w < graph.graph_size; w++)
             {
-                std::cout << trans_cost[v][w] << " ";
+                std::cout << graph.trans_cost[v][w] << " ";
             }
             std::cout << std::endl;
         }
     }
 
-    void mapping( const circuit& circ_in )
+    void mapping( const coupling_graph& graph, const circuit& circ_in )
     {
         unsigned target, control, max;
         matrix matrix_circuit;
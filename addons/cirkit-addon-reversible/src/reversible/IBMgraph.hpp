@@ -48,26 +48,38 @@
 namespace cirkit
 {
 
-	extern bool **graph_adjacency;  // graph structure
-	extern int **trans_cost;        // the cost of each cnot
-	extern TransPath **trans_path;  // the transformation path or a given cnot
+	// coupling graph of a device and the cheapest transformation path for each
+	// cnot; it is only read once created, so it can be shared among threads
+	class coupling_graph
+	{
+	public:
+		int graph_size = 0;
+		std::vector<std::vector<bool>> graph_adjacency;     // graph structure
+		std::vector<std::vector<int>> trans_cost;           // the cost of each cnot
+		std::vector<std::vector<TransPath>> trans_path;     // the transformation path or a given cnot
 
-	int graph_size = 0;
-	
-extern std::vector<TransPath> path_list; //-- it was giving memory error (now it is in cpp file)
+		bool read_graph( const std::string& filename );
+		bool write_to_file( const std::string& filename );
+		bool read_from_file( const std::string& filename );
+		void print_graph( ) const;
+		void print_matrix( );
+		void print_movements( const circuit& circ_in );
+		void delete_graph( );
+		void create_trans( bool verbose );
 
-	void allocate_data_stuctures();
-	bool read_graph( const std::string& filename );
-	bool write_to_file( const std::string& filename );
-	bool read_from_file( const std::string& filename );
-	void print_graph( );
-	void print_matrix( );
-	void print_movements( const circuit& circ_in );
-	void delete_graph( );
-	void create_trans( bool verbose );
-    circuit try_all( const circuit& circ_in, bool verbose, bool rm_dup );
-    void mapping( const circuit& circ_in );
-    void expand_cnots( circuit& circ_out, const circuit& circ_in );
+	private:
+		void allocate_data_stuctures();
+		void find_all_paths( int v, int w, TransPath &tp, std::vector<bool>& visited, std::vector<TransPath>& path_list ) const;
+		void set_best_path( int v, int w, std::vector<TransPath>& path_list );
+	};
+
+	// branch-and-bound search over the placements of the circuit lines on the
+	// qubits, warm-started with a greedy placement; all placements within
+	// `slack' of the best cost (at most `max_candidates') are expanded
+	circuit try_all( const coupling_graph& graph, const circuit& circ_in, bool verbose, bool rm_dup,
+	                 unsigned num_threads = 1u, unsigned slack = 10u, unsigned max_candidates = 64u );
+	void mapping( const coupling_graph& graph, const circuit& circ_in );
+	void expand_cnots( const coupling_graph& graph, circuit& circ_out, const circuit& circ_in );
 
 }
 #endif /* IBMgraph_hpp */
@@ -72,10 +72,10 @@ namespace cirkit
         void print( std::ofstream& );
         int cost();
         void invert();
-        move_qubit_type getType() { return mv_type; };
-        unsigned int getA() { return v; };
-        unsigned int getB() { return w; };
-        unsigned int getC() { return z; };
+        move_qubit_type getType() const { return mv_type; };
+        unsigned int getA() const { return v; };
+        unsigned int getB() const { return w; };
+        unsigned int getC() const { return z; };
     };
     
 
@@ -0,0 +1,433 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "peephole_optimization.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include <boost/functional/hash.hpp>
+
+#include <core/utils/timer.hpp>
+#include <reversible/gate.hpp>
+#include <reversible/pauli_tags.hpp>
+#include <reversible/rotation_tags.hpp>
+#include <reversible/target_tags.hpp>
+#include <reversible/functions/copy_circuit.hpp>
+#include <reversible/functions/copy_metadata.hpp>
+
+namespace cirkit
+{
+
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+/* how a gate acts on one of its lines */
+enum class line_action { diagonal, x_type, other };
+
+/* gates of one family with the same controls and target can be merged,
+ * the exponent is taken modulo the family's order:
+ *   z: T = 1, S = 2, Z = 4, S* = 6, T* = 7 (mod 8)
+ *   x: V = 1, X = 2, V* = 3 (mod 4)
+ *   h: H = 1 (mod 2) */
+enum class merge_family { none, z, x, h };
+
+struct peephole_gate
+{
+  gate                                          g;
+  bool                                          alive = true;
+  std::size_t                                   key = 0u;
+  merge_family                                  family = merge_family::none;
+  unsigned                                      exponent = 0u;
+  gate::control_container                       sorted_controls;
+  std::vector<std::pair<unsigned, line_action>> actions;
+};
+
+class peephole_manager
+{
+public:
+  peephole_manager( unsigned lines, unsigned lookahead )
+    : frontier( lines ),
+      lookahead( lookahead )
+  {
+  }
+
+  void add_gate( const gate& g );
+  void write_circuit( circuit& circ ) const;
+
+public:
+  unsigned cancelled = 0u;
+  unsigned merged = 0u;
+
+private:
+  peephole_gate make_peephole_gate( const gate& g ) const;
+  bool commutes( const peephole_gate& g1, const peephole_gate& g2 ) const;
+  bool same_signature( const peephole_gate& g1, const peephole_gate& g2 ) const;
+  int find_partner( const peephole_gate& pg ) const;
+  bool is_blocked( const peephole_gate& pg, unsigned line, unsigned partner ) const;
+
+private:
+  std::vector<peephole_gate>         gates;
+  std::vector<std::vector<unsigned>> frontier;
+  unsigned                           lookahead;
+};
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+unsigned family_order( merge_family family )
+{
+  switch ( family )
+  {
+  case merge_family::z: return 8u;
+  case merge_family::x: return 4u;
+  case merge_family::h: return 2u;
+  default:              return 0u;
+  }
+}
+
+/* sets the gate type for an exponent, returns false if no single gate realizes it */
+bool set_merged_type( gate& g, merge_family family, unsigned exponent )
+{
+  switch ( family )
+  {
+  case merge_family::z:
+    switch ( exponent )
+    {
+    case 1u: g.set_type( pauli_tag( pauli_axis::Z, 4u, false ) ); return true;
+    case 2u: g.set_type( pauli_tag( pauli_axis::Z, 2u, false ) ); return true;
+    case 4u: g.set_type( pauli_tag( pauli_axis::Z, 1u, false ) ); return true;
+    case 6u: g.set_type( pauli_tag( pauli_axis::Z, 2u, true ) );  return true;
+    case 7u: g.set_type( pauli_tag( pauli_axis::Z, 4u, true ) );  return true;
+    default: return false;
+    }
+  case merge_family::x:
+    switch ( exponent )
+    {
+    case 1u: g.set_type( v_tag( false ) ); return true;
+    case 2u: g.set_type( toffoli_tag() );  return true;
+    case 3u: g.set_type( v_tag( true ) );  return true;
+    default: return false;
+    }
+  default:
+    return false;
+  }
+}
+
+peephole_gate peephole_manager::make_peephole_gate( const gate& g ) const
+{
+  peephole_gate pg;
+  pg.g = g;
+
+  auto target_action = line_action::other;
+
+  if ( g.targets().size() == 1u )
+  {
+    if ( is_toffoli( g ) )
+    {
+      pg.family = merge_family::x;
+      pg.exponent = 2u;
+      target_action = line_action::x_type;
+    }
+    else if ( is_v( g ) )
+    {
+      pg.family = merge_family::x;
+      pg.exponent = boost::any_cast<v_tag>( g.type() ).adjoint ? 3u : 1u;
+      target_action = line_action::x_type;
+    }
+    else if ( is_hadamard( g ) )
+    {
+      pg.family = merge_family::h;
+      pg.exponent = 1u;
+    }
+    else if ( is_pauli( g ) )
+    {
+      const auto& tag = boost::any_cast<pauli_tag>( g.type() );
+      if ( tag.axis == pauli_axis::Z )
+      {
+        target_action = line_action::diagonal;
+        if ( tag.root == 1u || tag.root == 2u || tag.root == 4u )
+        {
+          pg.family = merge_family::z;
+          pg.exponent = tag.adjoint ? 8u - 4u / tag.root : 4u / tag.root;
+        }
+      }
+      else if ( tag.axis == pauli_axis::X )
+      {
+        target_action = line_action::x_type;
+        if ( tag.root == 1u )
+        {
+          pg.family = merge_family::x;
+          pg.exponent = 2u;
+        }
+      }
+    }
+    else if ( is_rotation( g ) )
+    {
+      const auto& tag = boost::any_cast<rotation_tag>( g.type() );
+      if ( tag.axis == rotation_axis::Z )
+      {
+        target_action = line_action::diagonal;
+      }
+      else if ( tag.axis == rotation_axis::X )
+      {
+        target_action = line_action::x_type;
+      }
+    }
+  }
+
+  /* negative controls are projectors onto |0>, hence still diagonal */
+  for ( const auto& c : g.controls() )
+  {
+    pg.actions.push_back( {c.line(), line_action::diagonal} );
+  }
+  for ( const auto& t : g.targets() )
+  {
+    pg.actions.push_back( {t, target_action} );
+  }
+
+  if ( pg.family != merge_family::none )
+  {
+    pg.sorted_controls = g.controls();
+    std::sort( pg.sorted_controls.begin(), pg.sorted_controls.end(), []( const variable& a, const variable& b ) {
+        return a.line() < b.line() || ( a.line() == b.line() && a.polarity() < b.polarity() );
+      } );
+
+    pg.key = static_cast<std::size_t>( pg.family );
+    boost::hash_combine( pg.key, g.targets().front() );
+    for ( const auto& c : pg.sorted_controls )
+    {
+      boost::hash_combine( pg.key, c.line() );
+      boost::hash_combine( pg.key, c.polarity() );
+    }
+  }
+
+  return pg;
+}
+
+bool peephole_manager::commutes( const peephole_gate& g1, const peephole_gate& g2 ) const
+{
+  for ( const auto& a1 : g1.actions )
+  {
+    for ( const auto& a2 : g2.actions )
+    {
+      if ( a1.first != a2.first ) { continue; }
+      if ( a1.second == line_action::other || a1.second != a2.second )
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool peephole_manager::same_signature( const peephole_gate& g1, const peephole_gate& g2 ) const
+{
+  if ( g1.key != g2.key || g1.family != g2.family ) { return false; }
+  if ( g1.g.targets().front() != g2.g.targets().front() ) { return false; }
+  if ( g1.sorted_controls.size() != g2.sorted_controls.size() ) { return false; }
+
+  for ( auto i = 0u; i < g1.sorted_controls.size(); ++i )
+  {
+    const auto& c1 = g1.sorted_controls[i];
+    const auto& c2 = g2.sorted_controls[i];
+    if ( c1.line() != c2.line() || c1.polarity() != c2.polarity() ) { return false; }
+  }
+  return true;
+}
+
+/* true, if some gate after partner on line does not commute with pg */
+bool peephole_manager::is_blocked( const peephole_gate& pg, unsigned line, unsigned partner ) const
+{
+  const auto& on_line = frontier[line];
+  auto steps = 0u;
+
+  for ( auto it = on_line.rbegin(); it != on_line.rend() && *it > partner; ++it )
+  {
+    if ( ++steps > lookahead ) { return true; }
+
+    const auto& other = gates[*it];
+    if ( other.alive && !commutes( other, pg ) ) { return true; }
+  }
+  return false;
+}
+
+int peephole_manager::find_partner( const peephole_gate& pg ) const
+{
+  if ( pg.family == merge_family::none ) { return -1; }
+
+  const auto target = pg.g.targets().front();
+  const auto& on_target = frontier[target];
+  auto steps = 0u;
+
+  for ( auto it = on_target.rbegin(); it != on_target.rend(); ++it )
+  {
+    if ( ++steps > lookahead ) { return -1; }
+
+    const auto& cand = gates[*it];
+    if ( !cand.alive ) { continue; }
+
+    if ( same_signature( cand, pg ) )
+    {
+      const auto exponent = ( cand.exponent + pg.exponent ) % family_order( pg.family );
+      gate tmp;
+      if ( exponent == 0u || set_merged_type( tmp, pg.family, exponent ) )
+      {
+        /* all other lines of pg must be free between the candidate and the end */
+        const auto blocked = std::any_of( pg.actions.begin(), pg.actions.end(), [this, &pg, target, it]( const std::pair<unsigned, line_action>& a ) {
+            return a.first != target && is_blocked( pg, a.first, *it );
+          } );
+        return blocked ? -1 : static_cast<int>( *it );
+      }
+    }
+
+    if ( !commutes( cand, pg ) ) { return -1; }
+  }
+
+  return -1;
+}
+
+void peephole_manager::add_gate( const gate& g )
+{
+  auto pg = make_peephole_gate( g );
+
+  const auto partner = find_partner( pg );
+  if ( partner != -1 )
+  {
+    auto& other = gates[partner];
+    other.exponent = ( other.exponent + pg.exponent ) % family_order( pg.family );
+
+    if ( other.exponent == 0u )
+    {
+      other.alive = false;
+      ++cancelled;
+
+      /* drop trailing dead gates to keep the frontier short */
+      for ( const auto& a : other.actions )
+      {
+        auto& on_line = frontier[a.first];
+        while ( !on_line.empty() && !gates[on_line.back()].alive )
+        {
+          on_line.pop_back();
+        }
+      }
+    }
+    else
+    {
+      set_merged_type( other.g, pg.family, other.exponent );
+      ++merged;
+    }
+    return;
+  }
+
+  const auto index = static_cast<unsigned>( gates.size() );
+  for ( const auto& a : pg.actions )
+  {
+    frontier[a.first].push_back( index );
+  }
+  gates.push_back( std::move( pg ) );
+}
+
+void peephole_manager::write_circuit( circuit& circ ) const
+{
+  for ( const auto& pg : gates )
+  {
+    if ( pg.alive )
+    {
+      circ.append_gate() = pg.g;
+    }
+  }
+}
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+bool peephole_optimization( circuit& circ, const circuit& base, properties::ptr settings, properties::ptr statistics )
+{
+  /* settings */
+  const auto lookahead  = get( settings, "lookahead",  64u );
+  const auto max_passes = get( settings, "max_passes", 3u );
+
+  /* timer */
+  properties_timer t( statistics );
+
+  circuit tmp;
+  copy_circuit( base, tmp );
+
+  auto cancelled = 0u, merged = 0u, passes = 0u;
+
+  while ( passes < max_passes )
+  {
+    ++passes;
+
+    peephole_manager mgr( tmp.lines(), lookahead );
+    for ( const auto& g : tmp )
+    {
+      mgr.add_gate( g );
+    }
+
+    cancelled += mgr.cancelled;
+    merged += mgr.merged;
+
+    circuit next( tmp.lines() );
+    copy_metadata( tmp, next );
+    mgr.write_circuit( next );
+
+    const auto improved = next.num_gates() < tmp.num_gates();
+    tmp = next;
+
+    if ( !improved ) { break; }
+  }
+
+  copy_circuit( tmp, circ );
+
+  set( statistics, "cancelled", cancelled );
+  set( statistics, "merged",    merged );
+  set( statistics, "passes",    passes );
+
+  return true;
+}
+
+optimization_func peephole_optimization_func( properties::ptr settings, properties::ptr statistics )
+{
+  optimization_func f = [settings, statistics]( circuit& circ, const circuit& base ) {
+    return peephole_optimization( circ, base, settings, statistics );
+  };
+  f.init( settings, statistics );
+  return f;
+}
+
+}
+
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
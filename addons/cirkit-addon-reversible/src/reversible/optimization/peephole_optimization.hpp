@@ -0,0 +1,131 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file peephole_optimization.hpp
+ *
+ * @brief Commutation-aware gate cancellation in linear time
+ *
+ * @since  2.3
+ */
+
+#ifndef PEEPHOLE_OPTIMIZATION_HPP
+#define PEEPHOLE_OPTIMIZATION_HPP
+
+#include <core/properties.hpp>
+
+#include <reversible/circuit.hpp>
+#include <reversible/optimization/optimization.hpp>
+
+namespace cirkit
+{
+
+/**
+ * @brief Cancels and merges gates using commutation rules
+ *
+ * The circuit is streamed gate by gate while a frontier keeps, for each
+ * line, the gates that have been emitted on it.  For every new gate a
+ * partner with the same control/target signature (compared by hash) is
+ * searched backwards on the target line, skipping gates that commute with
+ * the new one.  Inverse partners are removed, Z-rotations (T, S, Z and
+ * their adjoints) and X-rotations (V, NOT) on the same controls and target
+ * are merged.  Two gates commute if on all shared lines both act diagonally
+ * (controls, Z-rotations) or both act as X-type targets.
+ *
+ * The backward search is bounded by `lookahead', hence each pass is linear
+ * in the number of gates.
+ *
+ * @param circ Optimized circuit
+ * @param base Original circuit
+ * @param settings <table border="0" width="100%">
+ *   <tr>
+ *     <td class="indexkey">Setting</td>
+ *     <td class="indexkey">Type</td>
+ *     <td class="indexkey">Default Value</td>
+ *   </tr>
+ *   <tr>
+ *     <td class="indexvalue">lookahead</td>
+ *     <td class="indexvalue">unsigned</td>
+ *     <td class="indexvalue">64u</td>
+ *   </tr>
+ *   <tr>
+ *     <td class="indexvalue">max_passes</td>
+ *     <td class="indexvalue">unsigned</td>
+ *     <td class="indexvalue">3u</td>
+ *   </tr>
+ * </table>
+ * @param statistics <table border="0" width="100%">
+ *   <tr>
+ *     <td class="indexkey">Information</td>
+ *     <td class="indexkey">Type</td>
+ *     <td class="indexkey">Description</td>
+ *   </tr>
+ *   <tr>
+ *     <td class="indexvalue">runtime</td>
+ *     <td class="indexvalue">double</td>
+ *     <td class="indexvalue">Run-time consumed by the algorithm in CPU seconds.</td>
+ *   </tr>
+ *   <tr>
+ *     <td class="indexvalue">cancelled</td>
+ *     <td class="indexvalue">unsigned</td>
+ *     <td class="indexvalue">Number of removed gate pairs.</td>
+ *   </tr>
+ *   <tr>
+ *     <td class="indexvalue">merged</td>
+ *     <td class="indexvalue">unsigned</td>
+ *     <td class="indexvalue">Number of gate pairs merged into one gate.</td>
+ *   </tr>
+ *   <tr>
+ *     <td class="indexvalue">passes</td>
+ *     <td class="indexvalue">unsigned</td>
+ *     <td class="indexvalue">Number of performed passes.</td>
+ *   </tr>
+ * </table>
+ * @return true on success
+ */
+bool peephole_optimization( circuit& circ, const circuit& base, properties::ptr settings = properties::ptr(), properties::ptr statistics = properties::ptr() );
+
+/**
+ * @brief Functor for the peephole_optimization algorithm
+ *
+ * @param settings Settings (see peephole_optimization)
+ * @param statistics Statistics (see peephole_optimization)
+ *
+ * @return A functor which complies with the optimization_func interface
+ */
+optimization_func peephole_optimization_func( properties::ptr settings = std::make_shared<properties>(),
+                                              properties::ptr statistics = std::make_shared<properties>() );
+
+}
+
+#endif
+
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -44,6 +44,7 @@
 #include <reversible/functions/reverse_circuit.hpp>
 #include <reversible/io/print_circuit.hpp>
 #include <reversible/optimization/esop_post_optimization.hpp>
+#include <reversible/optimization/peephole_optimization.hpp>
 #include <reversible/utils/permutation.hpp>
 
 namespace cirkit
@@ -59,7 +60,7 @@ namespace cirkit
 
 boost::dynamic_bitset<> get_optimization_vector( const std::string& methods )
 {
-  boost::dynamic_bitset<> v( 6u );
+  boost::dynamic_bitset<> v( 7u );
 
   for ( auto c : methods )
   {
@@ -71,6 +72,7 @@ boost::dynamic_bitset<> get_optimization_vector( const std::string& methods )
     case 'e': v.set( 3u ); break;
     case 'p': v.set( 4u ); break;
     case 's': v.set( 5u ); break;
+    case 'c': v.set( 6u ); break;
     }
   }
 
@@ -457,6 +459,13 @@ circuit exorcism_merge_heuristic( const circuit& base )
   return circ;
 }
 
+circuit peephole_cancellation( const circuit& base )
+{
+  circuit circ;
+  peephole_optimization( circ, base );
+  return circ;
+}
+
 circuit same_target_optimization_heuristic( const circuit& base )
 {
   circuit circ;
@@ -551,6 +560,7 @@ bool simplify( circuit& circ, const circuit& base, properties::ptr settings, pro
       tmp = simplify_swap_gates( tmp, perm ); vsize_out( "swap" );
       gperm = permutation_multiply( gperm, perm );
     }
+    if ( methods_vec[6u] ) { tmp = peephole_cancellation( tmp );              vsize_out( "peephole" ); }
 
     if ( reverse_opt )
     {
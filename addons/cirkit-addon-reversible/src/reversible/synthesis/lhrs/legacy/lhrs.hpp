@@ -33,8 +33,8 @@
  * @since  2.3
  */
 
-#ifndef LUT_BASED_SYNTHESIS_HPP
-#define LUT_BASED_SYNTHESIS_HPP
+#ifndef LEGACY_LUT_BASED_SYNTHESIS_HPP
+#define LEGACY_LUT_BASED_SYNTHESIS_HPP
 
 #include <core/properties.hpp>
 #include <classical/abc/gia/gia.hpp>
@@ -33,8 +33,8 @@
  * @since  2.3
  */
 
-#ifndef LHRS_PARAMS_HPP
-#define LHRS_PARAMS_HPP
+#ifndef LEGACY_LHRS_PARAMS_HPP
+#define LEGACY_LHRS_PARAMS_HPP
 
 #include <iostream>
 #include <string>
@@ -33,8 +33,8 @@
  * @since  2.3
  */
 
-#ifndef STG_MAP_ESOP_HPP
-#define STG_MAP_ESOP_HPP
+#ifndef LEGACY_STG_MAP_ESOP_HPP
+#define LEGACY_STG_MAP_ESOP_HPP
 
 #include <vector>
 
@@ -33,8 +33,8 @@
  * @since  2.3
  */
 
-#ifndef STG_PARTNERS_HPP
-#define STG_PARTNERS_HPP
+#ifndef LEGACY_STG_PARTNERS_HPP
+#define LEGACY_STG_PARTNERS_HPP
 
 #include <unordered_map>
 #include <vector>
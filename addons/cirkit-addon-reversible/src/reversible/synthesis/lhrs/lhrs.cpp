@@ -27,10 +27,13 @@
 #include "lhrs.hpp"
 
 #include <fstream>
+#include <future>
+#include <memory>
 #include <vector>
 
 #include <boost/dynamic_bitset.hpp>
 #include <boost/format.hpp>
+#include <boost/range/algorithm_ext/iota.hpp>
 #include <boost/range/algorithm_ext/push_back.hpp>
 #include <boost/variant.hpp>
 
@@ -40,6 +43,7 @@
 #include <core/utils/range_utils.hpp>
 #include <core/utils/temporary_filename.hpp>
 #include <core/utils/terminal.hpp>
+#include <core/utils/thread_pool.hpp>
 #include <core/utils/timer.hpp>
 #include <classical/functions/linear_classification.hpp>
 #include <classical/functions/spectral_canonization.hpp>
@@ -435,6 +439,11 @@ public:
 
     std::unordered_map<unsigned, lut_order_heuristic::step_type> orig_step_type; /* first step type of an output */
 
+    if ( use_pipeline() )
+    {
+      enqueue_lut_circuits();
+    }
+
     auto step_index = 0u;
     pbar.keep_last();
     for ( const auto& step : order_heuristic->steps() )
@@ -513,10 +522,84 @@ public:
     circ.set_constants( constants );
     circ.set_garbage( garbage );
 
+    pool.reset();
+
     return true;
   }
 
 private:
+  /* the LUT circuit of the direct mapping only depends on the LUT function,
+   * hence all of them can be computed in parallel with local line indexes
+   * and are remapped when being emitted in step order; exorcism keeps its
+   * state in ABC globals and runs under a lock, such that only extraction,
+   * collapsing, and ESOP synthesis scale with the number of threads */
+  struct lut_circuit_result
+  {
+    circuit            circ;
+    stg_map_esop_stats stats;
+  };
+
+  inline bool use_pipeline() const
+  {
+    return params.num_threads > 1u && params.mapping_strategy == lhrs_mapping_strategy::direct && !params.onlylines &&
+           params.map_esop_params.dumpfile.empty() && !params.map_esop_params.nocollapse;
+  }
+
+  void enqueue_lut_circuits()
+  {
+    pool.reset( new thread_pool( params.num_threads ) );
+
+    auto esop_params = params.map_esop_params;
+    esop_params.progress = false;
+
+    for ( const auto& step : order_heuristic->steps() )
+    {
+      if ( step.type != lut_order_heuristic::compute ) { continue; }
+
+      const auto index = step.node;
+      pending_circuits.emplace( index, pool->enqueue( [this, index, esop_params]() {
+              lut_circuit_result result;
+
+              const auto lut = xmg_extract_lut( xmg, index );
+              std::vector<unsigned> line_map( lut.inputs().size() + 1u );
+              boost::iota( line_map, 0u );
+
+              result.circ.set_lines( line_map.size() );
+              stg_map_esop( result.circ, lut, line_map, esop_params, result.stats );
+              return result;
+            } ) );
+    }
+  }
+
+  /* waits for the precomputed circuit of a LUT, the circuit is released after uncomputing */
+  void append_lut_circuit( int index, bool lookup, const std::vector<unsigned>& line_map )
+  {
+    auto it = computed_circuits.find( index );
+    if ( it == computed_circuits.end() )
+    {
+      auto pending = pending_circuits.find( index );
+      assert( pending != pending_circuits.end() );
+
+      auto result = pending->second.get();
+      pending_circuits.erase( pending );
+
+      stats.map_esop_stats.cover_runtime    += result.stats.cover_runtime;
+      stats.map_esop_stats.exorcism_runtime += result.stats.exorcism_runtime;
+      stats.map_esop_stats.cache_hits       += result.stats.cache_hits;
+      stats.map_esop_stats.cache_misses     += result.stats.cache_misses;
+      stats.map_esop_stats.cache_time_saved += result.stats.cache_time_saved;
+
+      it = computed_circuits.insert( {index, result.circ} ).first;
+    }
+
+    append_circuit( circ, it->second, gate::control_container(), line_map );
+
+    if ( lookup )
+    {
+      computed_circuits.erase( it );
+    }
+  }
+
   boost::dynamic_bitset<> get_affected_lines( unsigned begin, unsigned end )
   {
     boost::dynamic_bitset<> mask( circ.lines() );
@@ -565,6 +648,12 @@ private:
 
   void synthesize_node_direct( int index, bool lookup, const std::vector<unsigned>& line_map, const std::vector<unsigned>& clean_ancilla )
   {
+    if ( pool )
+    {
+      append_lut_circuit( index, lookup, line_map );
+      return;
+    }
+
     const auto lut = xmg_extract_lut( xmg, index );
 
     const auto sp = pbar.subprogress();
@@ -674,6 +763,8 @@ private:
   lhrs_stats& stats;
 
   std::unordered_map<unsigned, circuit> computed_circuits;
+  std::unordered_map<unsigned, std::future<lut_circuit_result>> pending_circuits;
+  std::unique_ptr<thread_pool> pool;
 
   std::shared_ptr<lut_order_heuristic> order_heuristic;
 
@@ -689,9 +780,19 @@ bool lut_based_synthesis( circuit& circ, const xmg_graph& xmg, const lhrs_params
   /* timing */
   reference_timer t( &stats.runtime );
 
+  if ( params.cache && !params.cache_file.empty() )
+  {
+    params.cache->read( params.cache_file );
+  }
+
   lut_based_synthesis_manager mgr( circ, xmg, params, stats );
   const auto result = mgr.run();
 
+  if ( params.cache && !params.cache_file.empty() )
+  {
+    params.cache->write( params.cache_file );
+  }
+
   return result;
 }
 
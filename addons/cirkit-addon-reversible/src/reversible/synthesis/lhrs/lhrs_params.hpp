@@ -37,10 +37,12 @@
 #define LHRS_PARAMS_HPP
 
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include <reversible/utils/costs.hpp>
+#include <reversible/synthesis/lhrs/stg_cache.hpp>
 #include <reversible/synthesis/lhrs/stg_map_esop.hpp>
 #include <reversible/synthesis/lhrs/stg_map_luts.hpp>
 #include <reversible/synthesis/lhrs/stg_map_precomp.hpp>
@@ -80,6 +82,11 @@ struct lhrs_params
   mutable stg_map_luts_params map_luts_params;
   stg_map_shannon_params      map_shannon_params;
 
+  unsigned               num_threads        = 1u;                                          /* threads to precompute LUT circuits ahead of emission (direct only, exorcism runs one at a time), 1u: sequential */
+
+  std::shared_ptr<stg_cache> cache;                                                        /* functional cache shared by the mappers (set by sync) */
+  std::string            cache_file;                                                       /* read cache before and write it after synthesis */
+
   bool                   progress           = false;                                       /* show progress line */
   bool                   verbose            = false;                                       /* be verbose */
 
@@ -88,6 +95,8 @@ struct lhrs_params
   inline void sync()
   {
     map_esop_params.progress = progress;
+    map_esop_params.cache    = cache;
+    map_precomp_params.cache = cache;
 
     switch ( mapping_strategy )
     {
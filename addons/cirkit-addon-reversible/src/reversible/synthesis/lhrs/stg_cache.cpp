@@ -0,0 +1,317 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "stg_cache.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include <boost/format.hpp>
+
+namespace cirkit
+{
+
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+/* one step of an NPN transformation, all of them are involutions */
+struct npn_op
+{
+  enum op_kind { output, flip, swap };
+
+  op_kind  kind;
+  unsigned i;
+  unsigned j;
+};
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+/* heuristic NPN canonization (same strategy as npn_canonization) which logs the
+ * applied operations, such that realizations can be transformed exactly; being
+ * heuristic only costs hits for equivalent functions with different representatives */
+tt npn_canonization_with_ops( const tt& t, std::vector<npn_op>& ops )
+{
+  const auto n = tt_num_vars( t );
+
+  tt npn = t;
+  auto old_count = npn.size() + 1u;
+
+  while ( old_count != npn.count() )
+  {
+    old_count = npn.count();
+
+    /* output negation */
+    if ( npn.count() > ( npn.size() >> 1u ) )
+    {
+      npn.flip();
+      ops.push_back( {npn_op::output, 0u, 0u} );
+    }
+
+    /* input negation */
+    for ( auto i = 0u; i < n; ++i )
+    {
+      if ( tt_cof1( npn, i ).count() > tt_cof0( npn, i ).count() )
+      {
+        npn = tt_flip( npn, i );
+        ops.push_back( {npn_op::flip, i, 0u} );
+      }
+    }
+
+    /* permute inputs */
+    for ( auto d = 1u; d < n; ++d )
+    {
+      for ( auto i = 0u; i < n - d; ++i )
+      {
+        const auto j = i + d;
+
+        if ( tt_cof1( npn, i ).count() > tt_cof1( npn, j ).count() )
+        {
+          npn = tt_permute( npn, i, j );
+          ops.push_back( {npn_op::swap, i, j} );
+        }
+      }
+    }
+  }
+
+  return npn;
+}
+
+/* realizations are ESOPs on a single target, so all operations act on the cubes */
+void apply_npn_op( stg_cache::cube_vec_t& cubes, unsigned num_vars, const npn_op& op )
+{
+  switch ( op.kind )
+  {
+  case npn_op::output:
+    {
+      /* toggle the constant cube, gates on the same target commute */
+      auto it = std::find_if( cubes.begin(), cubes.end(), []( const std::string& c ) { return c.find_first_not_of( '-' ) == std::string::npos; } );
+      if ( it == cubes.end() )
+      {
+        cubes.push_back( std::string( num_vars, '-' ) );
+      }
+      else
+      {
+        cubes.erase( it );
+      }
+    } break;
+
+  case npn_op::flip:
+    for ( auto& c : cubes )
+    {
+      if ( c[op.i] != '-' )
+      {
+        c[op.i] = c[op.i] == '1' ? '0' : '1';
+      }
+    }
+    break;
+
+  case npn_op::swap:
+    for ( auto& c : cubes )
+    {
+      std::swap( c[op.i], c[op.j] );
+    }
+    break;
+  }
+}
+
+std::string tt_key( const tt& func, unsigned variant )
+{
+  std::string s;
+  if ( func.size() >= 4u )
+  {
+    s = tt_to_hex( func );
+  }
+  else
+  {
+    to_string( func, s );
+  }
+  return boost::str( boost::format( "%d:%d:%s" ) % variant % tt_num_vars( func ) % s );
+}
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+bool stg_cache::lookup_network( const tt& func, unsigned variant, cube_vec_t& cubes, double& runtime ) const
+{
+  std::vector<npn_op> ops;
+  const auto key = tt_key( npn_canonization_with_ops( func, ops ), variant );
+
+  {
+    std::lock_guard<std::mutex> lock( mutex );
+
+    const auto it = networks.find( key );
+    if ( it == networks.end() )
+    {
+      return false;
+    }
+
+    cubes = it->second.cubes;
+    runtime = it->second.runtime;
+  }
+
+  /* the cached realization is for the representative, undo the canonization */
+  for ( auto it = ops.rbegin(); it != ops.rend(); ++it )
+  {
+    apply_npn_op( cubes, tt_num_vars( func ), *it );
+  }
+
+  return true;
+}
+
+void stg_cache::insert_network( const tt& func, unsigned variant, const cube_vec_t& cubes, double runtime )
+{
+  std::vector<npn_op> ops;
+  const auto key = tt_key( npn_canonization_with_ops( func, ops ), variant );
+
+  network_entry entry;
+  entry.cubes = cubes;
+  entry.runtime = runtime;
+  for ( const auto& op : ops )
+  {
+    apply_npn_op( entry.cubes, tt_num_vars( func ), op );
+  }
+
+  std::lock_guard<std::mutex> lock( mutex );
+  networks.insert( {key, entry} );
+}
+
+bool stg_cache::lookup_class( uint64_t func, unsigned num_vars, unsigned method, uint64_t& cfunc ) const
+{
+  const auto key = boost::str( boost::format( "%d:%d:%d" ) % method % num_vars % func );
+
+  std::lock_guard<std::mutex> lock( mutex );
+
+  const auto it = classes.find( key );
+  if ( it == classes.end() )
+  {
+    return false;
+  }
+
+  cfunc = it->second;
+  return true;
+}
+
+void stg_cache::insert_class( uint64_t func, unsigned num_vars, unsigned method, uint64_t cfunc )
+{
+  const auto key = boost::str( boost::format( "%d:%d:%d" ) % method % num_vars % func );
+
+  std::lock_guard<std::mutex> lock( mutex );
+  classes.insert( {key, cfunc} );
+}
+
+bool stg_cache::read( const std::string& filename )
+{
+  std::ifstream is( filename.c_str(), std::ifstream::in );
+  if ( !is.good() )
+  {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock( mutex );
+
+  std::string line;
+  while ( std::getline( is, line ) )
+  {
+    std::istringstream ls( line );
+    std::string kind, key;
+    ls >> kind >> key;
+
+    if ( kind == "n" )
+    {
+      network_entry entry;
+      ls >> entry.runtime;
+
+      std::string cube;
+      while ( ls >> cube )
+      {
+        entry.cubes.push_back( cube );
+      }
+      networks.insert( {key, entry} );
+    }
+    else if ( kind == "c" )
+    {
+      uint64_t cfunc;
+      ls >> cfunc;
+      classes.insert( {key, cfunc} );
+    }
+  }
+
+  return true;
+}
+
+bool stg_cache::write( const std::string& filename ) const
+{
+  std::ofstream os( filename.c_str(), std::ofstream::out );
+  if ( !os.good() )
+  {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock( mutex );
+
+  for ( const auto& p : networks )
+  {
+    os << "n " << p.first << " " << p.second.runtime;
+    for ( const auto& c : p.second.cubes )
+    {
+      os << " " << c;
+    }
+    os << std::endl;
+  }
+
+  for ( const auto& p : classes )
+  {
+    os << "c " << p.first << " " << p.second << std::endl;
+  }
+
+  return true;
+}
+
+std::size_t stg_cache::num_networks() const
+{
+  std::lock_guard<std::mutex> lock( mutex );
+  return networks.size();
+}
+
+std::size_t stg_cache::num_classes() const
+{
+  std::lock_guard<std::mutex> lock( mutex );
+  return classes.size();
+}
+
+}
+
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
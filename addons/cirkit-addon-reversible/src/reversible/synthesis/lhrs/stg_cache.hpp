@@ -0,0 +1,97 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file stg_cache.hpp
+ *
+ * @brief Functional cache for single-target gate realizations
+ *
+ * The cache stores ESOP-based realizations of single-target gates up to
+ * NPN equivalence and affine classification results of small functions.
+ * It can be shared among threads and persisted to a file, such that
+ * repeated LUT functions (also across runs) are only synthesized once.
+ *
+ * @since  2.3
+ */
+
+#ifndef STG_CACHE_HPP
+#define STG_CACHE_HPP
+
+#include <cinttypes>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <classical/utils/truth_table_utils.hpp>
+
+namespace cirkit
+{
+
+class stg_cache
+{
+public:
+  /* each cube corresponds to one Toffoli gate, the target is the line after
+   * the inputs, characters are '1' (positive control), '0' (negative control),
+   * and '-' (no control) */
+  using cube_vec_t = std::vector<std::string>;
+
+  /* looks up a realization for `func', `variant' distinguishes synthesis options */
+  bool lookup_network( const tt& func, unsigned variant, cube_vec_t& cubes, double& runtime ) const;
+  void insert_network( const tt& func, unsigned variant, const cube_vec_t& cubes, double runtime );
+
+  /* looks up the classification result for `func', `method' distinguishes classification methods */
+  bool lookup_class( uint64_t func, unsigned num_vars, unsigned method, uint64_t& cfunc ) const;
+  void insert_class( uint64_t func, unsigned num_vars, unsigned method, uint64_t cfunc );
+
+  /* reads entries from file and adds them to the cache, returns false if file cannot be opened */
+  bool read( const std::string& filename );
+  bool write( const std::string& filename ) const;
+
+  std::size_t num_networks() const;
+  std::size_t num_classes() const;
+
+private:
+  struct network_entry
+  {
+    cube_vec_t cubes;
+    double     runtime = 0.0;
+  };
+
+  mutable std::mutex                             mutex;
+  std::unordered_map<std::string, network_entry> networks;
+  std::unordered_map<std::string, uint64_t>      classes;
+};
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -32,9 +32,11 @@
 #include <core/utils/timer.hpp>
 #include <classical/abc/gia/gia.hpp>
 #include <classical/optimization/esop_minimization.hpp>
+#include <classical/utils/truth_table_utils.hpp>
 #include <classical/xmg/xmg_io.hpp>
 #include <classical/xmg/xmg_simulate.hpp>
 #include <reversible/functions/add_circuit.hpp>
+#include <reversible/functions/add_gates.hpp>
 #include <reversible/optimization/esop_post_optimization.hpp>
 #include <reversible/synthesis/esop_synthesis.hpp>
 
@@ -49,6 +51,61 @@ namespace cirkit
  * Private functions                                                          *
  ******************************************************************************/
 
+tt lut_truth_table( const xmg_graph& function )
+{
+  const auto num_vars = function.inputs().size();
+
+  auto func = simulate_xmg_function( function, function.outputs().front().first, xmg_tt_simulator() );
+  if ( num_vars < 6u )
+  {
+    tt_shrink( func, num_vars );
+  }
+  else
+  {
+    tt_extend( func, num_vars );
+  }
+  return func;
+}
+
+stg_cache::cube_vec_t cubes_from_esop( const gia_graph::esop_ptr& esop, unsigned num_vars )
+{
+  stg_cache::cube_vec_t cubes;
+
+  int i;
+  abc::Vec_Int_t *vec;
+  Vec_WecForEachLevel( esop.get(), vec, i )
+  {
+    std::string cube( num_vars, '-' );
+    for ( auto j = 0; j < abc::Vec_IntSize( vec ); ++j )
+    {
+      const auto lit = abc::Vec_IntEntry( vec, j );
+      if ( lit >= 0 )
+      {
+        cube[abc::Abc_Lit2Var( lit )] = abc::Abc_LitIsCompl( lit ) ? '0' : '1';
+      }
+    }
+    cubes.push_back( cube );
+  }
+
+  return cubes;
+}
+
+void append_cubes( circuit& circ, const stg_cache::cube_vec_t& cubes, const std::vector<unsigned>& line_map )
+{
+  for ( const auto& cube : cubes )
+  {
+    gate::control_container controls;
+    for ( auto i = 0u; i < cube.size(); ++i )
+    {
+      if ( cube[i] != '-' )
+      {
+        controls.push_back( make_var( line_map[i], cube[i] == '1' ) );
+      }
+    }
+    append_toffoli( circ, controls, line_map.back() );
+  }
+}
+
 /******************************************************************************
  * Public functions                                                           *
  ******************************************************************************/
@@ -71,6 +128,28 @@ void stg_map_esop( circuit& circ, const xmg_graph& function,
     return;
   }
 
+  /* functional cache, realizations are shared up to NPN equivalence */
+  const auto use_cache = params.cache && !params.optimize_postesop;
+  const auto variant = static_cast<unsigned>( params.script );
+  const auto runtime_before = stats.cover_runtime + stats.exorcism_runtime;
+  tt func;
+
+  if ( use_cache )
+  {
+    func = lut_truth_table( function );
+
+    stg_cache::cube_vec_t cubes;
+    double runtime{};
+    if ( params.cache->lookup_network( func, variant, cubes, runtime ) )
+    {
+      ++stats.cache_hits;
+      stats.cache_time_saved += runtime;
+      append_cubes( circ, cubes, line_map );
+      return;
+    }
+    ++stats.cache_misses;
+  }
+
   /* collapse AIG into initial ESOP
    *
    * note: we are using a "lambda trick" to initialize the esop directly and do some timing
@@ -134,6 +213,12 @@ void stg_map_esop( circuit& circ, const xmg_graph& function,
   {
     const auto es_settings = make_settings_from( std::make_pair( "line_map", line_map ) );
     esop_synthesis( circ, esop, function.inputs().size(), function.outputs().size(), es_settings );
+
+    if ( use_cache )
+    {
+      params.cache->insert_network( func, variant, cubes_from_esop( esop, function.inputs().size() ),
+                                    stats.cover_runtime + stats.exorcism_runtime - runtime_before );
+    }
   }
 }
 
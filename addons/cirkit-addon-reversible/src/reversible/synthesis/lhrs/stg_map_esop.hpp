@@ -36,11 +36,13 @@
 #ifndef STG_MAP_ESOP_HPP
 #define STG_MAP_ESOP_HPP
 
+#include <memory>
 #include <vector>
 
 #include <classical/optimization/exorcism_minimization.hpp>
 #include <classical/xmg/xmg.hpp>
 #include <reversible/circuit.hpp>
+#include <reversible/synthesis/lhrs/stg_cache.hpp>
 
 namespace cirkit
 {
@@ -52,6 +54,8 @@ struct stg_map_esop_params
 
   bool                         progress          = false;                                       /* show progress line */
 
+  std::shared_ptr<stg_cache>   cache;                                                           /* functional cache for realizations (not used with optimize_postesop) */
+
   bool                         nocollapse        = false;                                       /* DEBUG: do not collapse (useful with dumpfile parameter) */
   std::string                  dumpfile;                                                        /* DEBUG: dump ESOP and AIG files for each ESOP cover and LUT */
 };
@@ -61,6 +65,10 @@ struct stg_map_esop_stats
   double   cover_runtime    = 0.0;
   double   exorcism_runtime = 0.0;
   unsigned dumpfile_counter = 0u;
+
+  unsigned cache_hits       = 0u;
+  unsigned cache_misses     = 0u;
+  double   cache_time_saved = 0.0;                                                              /* synthesis runtime of cached realizations */
 };
 
 void stg_map_esop( circuit& circ, const xmg_graph& function,
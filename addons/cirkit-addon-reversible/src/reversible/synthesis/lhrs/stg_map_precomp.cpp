@@ -84,7 +84,11 @@ void stg_map_precomp( circuit& circ, uint64_t function, unsigned num_vars,
   const auto it = stats.class_hash[num_vars - 2u].find( function );
   if ( it == stats.class_hash[num_vars - 2u].end() )
   {
-    if ( params.class_method == 0u ) /* spectral */
+    if ( params.cache && params.cache->lookup_class( function, num_vars, params.class_method, cfunc ) )
+    {
+      ++stats.class_cache_hits;
+    }
+    else if ( params.class_method == 0u ) /* spectral */
     {
       const auto idx = get_spectral_class( tt( 1 << num_vars, function ) );
       cfunc = optimal_quantum_circuits::spectral_classification_representative[num_vars - 2u][idx];
@@ -93,6 +97,11 @@ void stg_map_precomp( circuit& circ, uint64_t function, unsigned num_vars,
     {
       cfunc = exact_affine_classification_output( function, num_vars );
     }
+
+    if ( params.cache )
+    {
+      params.cache->insert_class( function, num_vars, params.class_method, cfunc );
+    }
     stats.class_hash[num_vars - 2u].insert( std::make_pair( function, cfunc ) );
   }
   else
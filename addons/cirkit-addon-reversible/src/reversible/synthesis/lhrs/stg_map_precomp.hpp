@@ -37,11 +37,13 @@
 #define STG_MAP_PRECOMP_HPP
 
 #include <cinttypes>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
 #include <classical/utils/truth_table_utils.hpp>
 #include <reversible/circuit.hpp>
+#include <reversible/synthesis/lhrs/stg_cache.hpp>
 
 namespace cirkit
 {
@@ -49,6 +51,8 @@ namespace cirkit
 struct stg_map_precomp_params
 {
   unsigned                     class_method       = 0u;                                          /* classification method: 0u: spectral, 1u: affine */
+
+  std::shared_ptr<stg_cache>   cache;                                                            /* functional cache for classification results */
 };
 
 struct stg_map_precomp_stats
@@ -64,6 +68,7 @@ struct stg_map_precomp_stats
   }
 
   double   class_runtime     = 0.0;
+  unsigned class_cache_hits  = 0u;
 
   std::vector<std::vector<unsigned>> class_counter;
 
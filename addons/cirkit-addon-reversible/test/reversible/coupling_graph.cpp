@@ -0,0 +1,137 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE coupling_graph
+
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#define timer timer_class
+#include <boost/test/unit_test.hpp>
+#undef timer
+
+#include <core/utils/temporary_filename.hpp>
+
+#include <reversible/circuit.hpp>
+#include <reversible/IBMgraph.hpp>
+#include <reversible/functions/add_gates.hpp>
+
+using namespace cirkit;
+
+/* coupling graph of the 5-qubit IBM QX2 device */
+const std::string qx2 = "5\n1 0\n2 0\n2 1\n3 2\n3 4\n2 4\n";
+
+coupling_graph create_graph( const std::string& edges )
+{
+  temporary_filename tmp( "/tmp/test_coupling_graph-%d.txt" );
+  {
+    std::ofstream os( tmp.name() );
+    os << edges;
+  }
+
+  coupling_graph graph;
+  BOOST_REQUIRE( graph.read_graph( tmp.name() ) );
+  graph.create_trans( false );
+  return graph;
+}
+
+/* 3 to 5 lines with 8 CNOT and NOT gates */
+circuit create_random_circuit( unsigned seed )
+{
+  std::mt19937 gen( seed );
+  const auto k = 3u + seed % 3u;
+
+  circuit circ( k );
+  for ( auto i = 0u; i < 8u; ++i )
+  {
+    const auto a = gen() % k;
+    auto b = gen() % k;
+    if ( a == b ) { b = ( b + 1u ) % k; }
+
+    if ( gen() % 4u == 0u )
+    {
+      append_not( circ, a );
+    }
+    else
+    {
+      append_cnot( circ, a, b );
+    }
+  }
+  return circ;
+}
+
+/* the expected values were computed with the implementation that kept the
+ * graph in global arrays and enumerated all placements in try_all */
+BOOST_AUTO_TEST_CASE(transformation_costs)
+{
+  const std::vector<std::vector<int>> expected = {
+    { 0,  4,  4,  7, 10},
+    { 0,  0,  4,  7, 10},
+    { 0,  0,  0,  4,  0},
+    { 3,  3,  0,  0,  0},
+    {10, 10,  4,  4,  0}
+  };
+
+  const auto graph = create_graph( qx2 );
+
+  /* a second graph must not affect the first one */
+  const auto line = create_graph( "3\n0 1\n1 2\n" );
+
+  BOOST_CHECK_EQUAL( graph.graph_size, 5 );
+  BOOST_CHECK_EQUAL( line.graph_size, 3 );
+  BOOST_CHECK( graph.trans_cost == expected );
+}
+
+BOOST_AUTO_TEST_CASE(try_all_gate_counts)
+{
+  /* number of gates without and with removing duplicate gates */
+  const std::vector<std::pair<unsigned, unsigned>> expected = {
+    {16u, 10u}, {12u, 10u}, {16u, 14u}, {12u, 10u}, {15u, 11u}, {18u, 17u},
+    {20u, 18u}, {18u, 14u}, {16u, 16u}, {12u, 2u}, {8u, 6u}, {8u, 8u}
+  };
+
+  const auto graph = create_graph( qx2 );
+
+  for ( auto seed = 0u; seed < expected.size(); ++seed )
+  {
+    const auto circ = create_random_circuit( seed );
+
+    for ( auto num_threads : {1u, 4u} )
+    {
+      BOOST_CHECK_EQUAL( try_all( graph, circ, false, false, num_threads ).num_gates(), expected[seed].first );
+      BOOST_CHECK_EQUAL( try_all( graph, circ, false, true, num_threads ).num_gates(), expected[seed].second );
+    }
+  }
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,113 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE lhrs
+
+#include <random>
+#include <sstream>
+#include <vector>
+
+#define timer timer_class
+#include <boost/test/unit_test.hpp>
+#undef timer
+
+#include <core/properties.hpp>
+#include <classical/xmg/xmg.hpp>
+#include <classical/xmg/xmg_flow_map.hpp>
+
+#include <reversible/circuit.hpp>
+#include <reversible/io/write_realization.hpp>
+#include <reversible/synthesis/lhrs/lhrs.hpp>
+
+using namespace cirkit;
+
+/* random XMG, every gate picks its fanins from all previous nodes */
+xmg_graph random_xmg( unsigned num_inputs, unsigned num_gates, unsigned num_outputs, unsigned seed )
+{
+  std::default_random_engine gen( seed );
+  std::uniform_int_distribution<unsigned> dist( 0u, 3u );
+
+  xmg_graph xmg;
+  std::vector<xmg_function> fs;
+  for ( auto i = 0u; i < num_inputs; ++i )
+  {
+    fs.push_back( xmg.create_pi( "x" + std::to_string( i ) ) );
+  }
+
+  const auto pick = [&]() {
+    return fs[std::uniform_int_distribution<unsigned>( 0u, fs.size() - 1u )( gen )] ^ ( dist( gen ) == 0u );
+  };
+
+  for ( auto i = 0u; i < num_gates; ++i )
+  {
+    fs.push_back( dist( gen ) == 0u ? xmg.create_xor( pick(), pick() ) : xmg.create_maj( pick(), pick(), pick() ) );
+  }
+
+  for ( auto i = 0u; i < num_outputs; ++i )
+  {
+    xmg.create_po( fs[fs.size() - 1u - i], "y" + std::to_string( i ) );
+  }
+
+  return xmg;
+}
+
+std::string synthesize( const xmg_graph& xmg, unsigned num_threads )
+{
+  lhrs_params params;
+  params.num_threads = num_threads;
+  params.sync();
+
+  lhrs_stats stats;
+  circuit circ;
+  BOOST_REQUIRE( lut_based_synthesis( circ, xmg, params, stats ) );
+
+  std::stringstream s;
+  write_realization( circ, s );
+  return s.str();
+}
+
+BOOST_AUTO_TEST_CASE(lut_circuits_with_threads)
+{
+  for ( auto seed = 0u; seed < 5u; ++seed )
+  {
+    auto xmg = random_xmg( 8u, 80u, 4u, seed );
+
+    auto settings = std::make_shared<properties>();
+    settings->set( "cut_size", 4u );
+    xmg_flow_map( xmg, settings );
+
+    const auto sequential = synthesize( xmg, 1u );
+    BOOST_CHECK_EQUAL( synthesize( xmg, 2u ), sequential );
+    BOOST_CHECK_EQUAL( synthesize( xmg, 4u ), sequential );
+  }
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,185 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE peephole_optimization
+
+#include <iostream>
+#include <random>
+
+#define timer timer_class
+#include <boost/test/unit_test.hpp>
+#undef timer
+
+#include <core/properties.hpp>
+#include <core/utils/benchmark_table.hpp>
+#include <core/utils/timer.hpp>
+
+#include <reversible/circuit.hpp>
+#include <reversible/pauli_tags.hpp>
+#include <reversible/target_tags.hpp>
+#include <reversible/functions/add_gates.hpp>
+#include <reversible/functions/remove_dup_gates.hpp>
+#include <reversible/optimization/peephole_optimization.hpp>
+#include <reversible/utils/matrix_utils.hpp>
+
+using namespace cirkit;
+
+/* random Clifford+T circuit with a bias towards local cancellations */
+circuit random_clifford_t( unsigned lines, unsigned gates, unsigned seed )
+{
+  std::default_random_engine gen( seed );
+  std::uniform_int_distribution<unsigned> line_dist( 0u, lines - 1u );
+  std::uniform_int_distribution<unsigned> kind_dist( 0u, 7u );
+
+  circuit circ( lines );
+  for ( auto i = 0u; i < gates; ++i )
+  {
+    const auto t = line_dist( gen );
+    switch ( kind_dist( gen ) )
+    {
+    case 0u: append_hadamard( circ, t ); break;
+    case 1u: append_not( circ, t ); break;
+    case 2u: append_pauli( circ, t, pauli_axis::Z, 4u, false ); break;
+    case 3u: append_pauli( circ, t, pauli_axis::Z, 4u, true ); break;
+    case 4u: append_pauli( circ, t, pauli_axis::Z, 2u, false ); break;
+    case 5u: append_pauli( circ, t, pauli_axis::Z, 2u, true ); break;
+    default:
+      {
+        auto c = line_dist( gen );
+        while ( c == t ) { c = line_dist( gen ); }
+        append_cnot( circ, c, t );
+      } break;
+    }
+  }
+  return circ;
+}
+
+unsigned optimized_size( const circuit& base )
+{
+  circuit circ;
+  peephole_optimization( circ, base );
+  return circ.num_gates();
+}
+
+BOOST_AUTO_TEST_CASE(cancellation)
+{
+  circuit c1( 2u );
+  append_pauli( c1, 0u, pauli_axis::Z, 4u, false );
+  append_cnot( c1, 0u, 1u );
+  append_pauli( c1, 0u, pauli_axis::Z, 4u, true );
+  BOOST_CHECK_EQUAL( optimized_size( c1 ), 1u );
+
+  circuit c2( 2u );
+  append_pauli( c2, 1u, pauli_axis::Z, 4u, false );
+  append_cnot( c2, 0u, 1u );
+  append_pauli( c2, 1u, pauli_axis::Z, 4u, true );
+  BOOST_CHECK_EQUAL( optimized_size( c2 ), 3u );
+
+  circuit c3( 2u );
+  append_hadamard( c3, 1u );
+  append_not( c3, 1u );
+  append_cnot( c3, 0u, 1u );
+  append_not( c3, 1u );
+  append_cnot( c3, 0u, 1u );
+  append_hadamard( c3, 1u );
+  BOOST_CHECK_EQUAL( optimized_size( c3 ), 0u );
+
+  circuit c4( 1u );
+  append_pauli( c4, 0u, pauli_axis::Z, 4u, false );
+  append_pauli( c4, 0u, pauli_axis::Z, 4u, false );
+  append_pauli( c4, 0u, pauli_axis::Z, 2u, false );
+  circuit opt;
+  peephole_optimization( opt, c4 );
+  BOOST_CHECK_EQUAL( opt.num_gates(), 1u );
+  BOOST_CHECK( is_Z_gate( opt[0u] ) );
+}
+
+BOOST_AUTO_TEST_CASE(equivalence)
+{
+  for ( auto seed = 0u; seed < 20u; ++seed )
+  {
+    const auto base = random_clifford_t( 4u, 200u, seed );
+
+    circuit circ;
+    peephole_optimization( circ, base );
+
+    BOOST_CHECK( circ.num_gates() <= base.num_gates() );
+    BOOST_CHECK( complex_allclose( matrix_from_clifford_t_circuit( circ ), matrix_from_clifford_t_circuit( base ) ) );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(benchmark)
+{
+  benchmark_table<unsigned, unsigned, unsigned, double, unsigned, double> table( {"gates", "lines", "rm_dup", "Run-time", "peephole", "Run-time"} );
+
+  for ( auto gates : {1000u, 10000u, 50000u} )
+  {
+    const auto circ = random_clifford_t( 16u, gates, gates );
+
+    double rt_before, rt_after;
+    unsigned size_before, size_after;
+    {
+      reference_timer t( &rt_before );
+      size_before = remove_dup_gates( circ ).num_gates();
+    }
+    {
+      reference_timer t( &rt_after );
+      size_after = optimized_size( circ );
+    }
+    table.add( gates, 16u, size_before, rt_before, size_after, rt_after );
+  }
+
+  table.print();
+}
+
+/* run with --run_test=large_benchmark */
+BOOST_AUTO_TEST_CASE(large_benchmark, *boost::unit_test::disabled())
+{
+  benchmark_table<unsigned, unsigned, unsigned, double> table( {"gates", "lines", "peephole", "Run-time"} );
+
+  for ( auto gates : {100000u, 1000000u, 10000000u} )
+  {
+    const auto circ = random_clifford_t( 64u, gates, gates );
+
+    double runtime;
+    unsigned size;
+    {
+      reference_timer t( &runtime );
+      size = optimized_size( circ );
+    }
+    table.add( gates, 64u, size, runtime );
+  }
+
+  table.print();
+}
+
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
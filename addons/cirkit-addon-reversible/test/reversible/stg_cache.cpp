@@ -0,0 +1,164 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE stg_cache
+
+#include <random>
+
+#define timer timer_class
+#include <boost/test/unit_test.hpp>
+#undef timer
+
+#include <core/utils/temporary_filename.hpp>
+#include <classical/utils/truth_table_utils.hpp>
+#include <reversible/synthesis/lhrs/stg_cache.hpp>
+
+using namespace cirkit;
+
+/* trivial ESOP realization, one cube per minterm */
+stg_cache::cube_vec_t minterm_cubes( const tt& func )
+{
+  const auto n = tt_num_vars( func );
+
+  stg_cache::cube_vec_t cubes;
+  for ( auto x = 0u; x < func.size(); ++x )
+  {
+    if ( !func[x] ) continue;
+
+    std::string cube( n, '0' );
+    for ( auto i = 0u; i < n; ++i )
+    {
+      if ( ( x >> i ) & 1 ) { cube[i] = '1'; }
+    }
+    cubes.push_back( cube );
+  }
+  return cubes;
+}
+
+tt evaluate_cubes( const stg_cache::cube_vec_t& cubes, unsigned num_vars )
+{
+  tt func( 1u << num_vars );
+  for ( auto x = 0u; x < func.size(); ++x )
+  {
+    for ( const auto& cube : cubes )
+    {
+      auto match = true;
+      for ( auto i = 0u; i < num_vars && match; ++i )
+      {
+        match = cube[i] == '-' || ( cube[i] == '1' ) == ( ( x >> i ) & 1 );
+      }
+      if ( match ) { func.flip( x ); }
+    }
+  }
+  return func;
+}
+
+tt random_npn_transform( const tt& func, std::default_random_engine& gen )
+{
+  const auto n = tt_num_vars( func );
+  std::uniform_int_distribution<unsigned> var_dist( 0u, n - 1u );
+  std::uniform_int_distribution<unsigned> coin( 0u, 1u );
+
+  auto g = func;
+  for ( auto k = 0u; k < n; ++k )
+  {
+    g = tt_permute( g, var_dist( gen ), var_dist( gen ) );
+    if ( coin( gen ) ) { g = tt_flip( g, var_dist( gen ) ); }
+  }
+  if ( coin( gen ) ) { g.flip(); }
+  return g;
+}
+
+BOOST_AUTO_TEST_CASE(npn_equivalent_lookups)
+{
+  std::default_random_engine gen( 42 );
+  stg_cache cache;
+
+  auto hits = 0u;
+  for ( auto n = 2u; n <= 6u; ++n )
+  {
+    for ( auto k = 0u; k < 50u; ++k )
+    {
+      tt func( 1u << n );
+      for ( auto x = 0u; x < func.size(); ++x )
+      {
+        func[x] = std::uniform_int_distribution<unsigned>( 0u, 1u )( gen );
+      }
+      cache.insert_network( func, 0u, minterm_cubes( func ), 1.0 );
+
+      stg_cache::cube_vec_t cubes;
+      double runtime{};
+      BOOST_CHECK( cache.lookup_network( func, 0u, cubes, runtime ) );
+      BOOST_CHECK( evaluate_cubes( cubes, n ) == func );
+      BOOST_CHECK( !cache.lookup_network( func, 1u, cubes, runtime ) );
+
+      const auto g = random_npn_transform( func, gen );
+      if ( cache.lookup_network( g, 0u, cubes, runtime ) )
+      {
+        ++hits;
+        BOOST_CHECK( evaluate_cubes( cubes, n ) == g );
+      }
+    }
+  }
+
+  BOOST_CHECK( hits > 0u );
+}
+
+BOOST_AUTO_TEST_CASE(persistence)
+{
+  /* removed when the test ends */
+  temporary_filename tmp( "/tmp/test_stg_cache-%d.txt" );
+  const auto& filename = tmp.name();
+
+  stg_cache cache;
+  const auto func = tt_from_hex( "e8" );
+  cache.insert_network( func, 2u, minterm_cubes( func ), 0.5 );
+  cache.insert_class( 0x6996u, 4u, 1u, 0x6996u );
+  BOOST_CHECK( cache.write( filename ) );
+
+  stg_cache cache2;
+  BOOST_CHECK( cache2.read( filename ) );
+  BOOST_CHECK_EQUAL( cache2.num_networks(), 1u );
+  BOOST_CHECK_EQUAL( cache2.num_classes(), 1u );
+
+  stg_cache::cube_vec_t cubes;
+  double runtime{};
+  BOOST_CHECK( cache2.lookup_network( ~func, 2u, cubes, runtime ) );
+  BOOST_CHECK( evaluate_cubes( cubes, 3u ) == ~func );
+  BOOST_CHECK_EQUAL( runtime, 0.5 );
+
+  uint64_t cfunc{};
+  BOOST_CHECK( cache2.lookup_class( 0x6996u, 4u, 1u, cfunc ) );
+  BOOST_CHECK_EQUAL( cfunc, 0x6996u );
+  BOOST_CHECK( !cache2.lookup_class( 0x6996u, 4u, 0u, cfunc ) );
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,136 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE tabu
+
+#include <random>
+
+#define timer timer_class
+#include <boost/test/unit_test.hpp>
+#undef timer
+
+#include <boost/dynamic_bitset.hpp>
+
+#include <core/properties.hpp>
+#include <core/utils/bitset_utils.hpp>
+
+#include <reversible/circuit.hpp>
+#include <reversible/functions/add_gates.hpp>
+#include <reversible/functions/copy_circuit.hpp>
+#include <reversible/simulation/simple_simulation.hpp>
+
+#include <cli/commands/tabu.hpp>
+
+using namespace cirkit;
+
+/* random MCT circuit, some gates are repeated such that the rules find moves */
+circuit random_mct( unsigned lines, unsigned gates, unsigned seed )
+{
+  std::default_random_engine gen( seed );
+  std::uniform_int_distribution<unsigned> line_dist( 0u, lines - 1u );
+  std::uniform_int_distribution<unsigned> dist( 0u, 3u );
+
+  circuit circ( lines );
+  while ( circ.num_gates() < gates )
+  {
+    const auto target = line_dist( gen );
+    gate::control_container controls;
+    for ( auto l = 0u; l < lines && controls.size() < 3u; ++l )
+    {
+      if ( l != target && dist( gen ) == 0u )
+      {
+        controls.push_back( make_var( l, dist( gen ) != 0u ) );
+      }
+    }
+
+    append_toffoli( circ, controls, target );
+    if ( dist( gen ) == 0u )
+    {
+      append_toffoli( circ, controls, target );
+    }
+  }
+  return circ;
+}
+
+bool equivalent( const circuit& circ1, const circuit& circ2 )
+{
+  const auto lines = circ1.lines();
+  if ( circ2.lines() != lines ) return false;
+
+  boost::dynamic_bitset<> input( lines ), output1, output2;
+  do
+  {
+    simple_simulation( output1, circ1, input );
+    simple_simulation( output2, circ2, input );
+    if ( output1 != output2 ) return false;
+    inc( input );
+  } while ( input.any() );
+
+  return true;
+}
+
+BOOST_AUTO_TEST_CASE( tabu_preserves_function )
+{
+  for ( auto seed = 0u; seed < 10u; ++seed )
+  {
+    const auto orig = random_mct( 5u, 40u, seed );
+
+    for ( auto opt : {0u, 1u} )
+    {
+      circuit circ;
+      copy_circuit( orig, circ );
+      tabu_search( circ, 70u, 10u, std::make_shared<properties>(), opt, 1u );
+
+      BOOST_CHECK( equivalent( orig, circ ) );
+      if ( opt == 0u )
+      {
+        BOOST_CHECK( circ.num_gates() <= orig.num_gates() );
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( tabu_threads )
+{
+  const auto orig = random_mct( 6u, 200u, 42u );
+
+  circuit circ1, circ4;
+  copy_circuit( orig, circ1 );
+  copy_circuit( orig, circ4 );
+  tabu_search( circ1, 70u, 80u, std::make_shared<properties>(), 0u, 1u );
+  tabu_search( circ4, 70u, 80u, std::make_shared<properties>(), 0u, 4u );
+
+  BOOST_CHECK( equivalent( orig, circ1 ) );
+  BOOST_CHECK( equivalent( orig, circ4 ) );
+  BOOST_CHECK_EQUAL( circ1.num_gates(), circ4.num_gates() );
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
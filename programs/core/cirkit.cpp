@@ -38,6 +38,7 @@
 #include <cli/commands/bdd.hpp>
 #include <cli/commands/blif_to_bench.hpp>
 #include <cli/commands/bool_complex.hpp>
+#include <cli/commands/cec.hpp>
 #include <cli/commands/comb_approx.hpp>
 #include <cli/commands/compress.hpp>
 #include <cli/commands/cone.hpp>
@@ -138,6 +139,7 @@ ALICE_BEGIN(cirkit)
   ADD_COMMAND( xmgmerge );
 
   cli.set_category( "Verification" );
+  ADD_COMMAND( cec );
   ADD_COMMAND( simulate );
   ADD_COMMAND( support );
   ADD_COMMAND( unate );
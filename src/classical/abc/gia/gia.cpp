@@ -33,7 +33,6 @@
 #include <classical/abc/functions/cirkit_to_gia.hpp>
 #include <classical/abc/gia/gia_bdd.hpp>
 #include <classical/abc/gia/gia_esop.hpp>
-#include <classical/optimization/esop_minimization.hpp>
 
 #include <map/if/if.h>
 #include <misc/util/utilTruth.h>
@@ -414,31 +413,7 @@ gia_graph::esop_ptr gia_graph::compute_esop_cover( esop_cover_method method, con
     } break;
   case esop_cover_method::bdd:
     {
-      Cudd mgr;
-
-      const auto bdd = gia_to_bdd( *this, mgr, settings );
-
-      /* get initial cover using exact PSDKRO optimization */
-      exp_cache_t exp_cache;
-      count_cubes_in_exact_psdkro( bdd.first.getManager(), bdd.second.front().getNode(), exp_cache );
-
-      char * var_values = new char[bdd.first.ReadSize()];
-      std::fill( var_values, var_values + bdd.first.ReadSize(), 2 );
-
-      abc::Vec_Wec_t *esop = abc::Vec_WecAlloc( 0u );
-      generate_exact_psdkro( bdd.first.getManager(), bdd.second.front().getNode(), var_values, -1, exp_cache, [&bdd, &esop, &var_values]() {
-          auto * level = abc::Vec_WecPushLevel( esop );
-          for ( auto i = 0; i < bdd.first.ReadSize(); ++i )
-          {
-            if ( var_values[i] == 2 ) continue;
-            abc::Vec_IntPush( level, ( i << 1u ) | !var_values[i] );
-          }
-          abc::Vec_IntPush( level, -1 );
-        } );
-
-      delete[] var_values;
-
-      return esop_ptr( esop, &abc::Vec_WecFree );
+      return gia_to_psdkro_cover( *this, settings );
     } break;
   }
 
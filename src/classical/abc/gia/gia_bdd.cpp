@@ -26,10 +26,17 @@
 
 #include "gia_bdd.hpp"
 
+#include <algorithm>
+#include <future>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 
+#include <core/utils/hash_utils.hpp>
 #include <core/utils/terminal.hpp>
+#include <core/utils/thread_pool.hpp>
 #include <core/utils/timer.hpp>
+#include <classical/optimization/esop_minimization.hpp>
 
 namespace cirkit
 {
@@ -38,10 +45,63 @@ namespace cirkit
  * Types                                                                      *
  ******************************************************************************/
 
+/* input literals of a cube as in ESOP covers of gia_graph */
+using psdkro_cube_t = std::vector<int>;
+
 /******************************************************************************
  * Private functions                                                          *
  ******************************************************************************/
 
+/* computes the PSDKRO cubes for each function in fs, the expansion cache is shared among all of them */
+std::vector<std::vector<psdkro_cube_t>> compute_psdkro_cubes( Cudd& mgr, const std::vector<BDD>& fs, unsigned num_inputs )
+{
+  std::vector<std::vector<psdkro_cube_t>> cubes( fs.size() );
+
+  exp_cache_t exp_cache;
+  std::vector<char> var_values( mgr.ReadSize(), 2 );
+
+  for ( auto i = 0u; i < fs.size(); ++i )
+  {
+    count_cubes_in_exact_psdkro( mgr.getManager(), fs[i].getNode(), exp_cache );
+
+    auto& fcubes = cubes[i];
+    generate_exact_psdkro( mgr.getManager(), fs[i].getNode(), var_values.data(), -1, exp_cache, [&var_values, &fcubes, num_inputs]() {
+        psdkro_cube_t cube;
+        for ( auto j = 0u; j < num_inputs; ++j )
+        {
+          if ( var_values[j] == 2 ) continue;
+          cube.push_back( ( j << 1u ) | !var_values[j] );
+        }
+        fcubes.push_back( cube );
+      } );
+  }
+
+  return cubes;
+}
+
+/* transfers the outputs in [begin, end) into a new manager and computes their PSDKRO cubes there */
+std::vector<std::vector<psdkro_cube_t>> compute_psdkro_cubes_block( const bdd_function_t& bdd, unsigned begin, unsigned end, unsigned num_inputs, std::mutex& transfer_mutex )
+{
+  Cudd mgr;
+
+  /* keep the variable indexes of the source manager */
+  for ( auto i = 0u; i < num_inputs; ++i )
+  {
+    mgr.bddVar( i );
+  }
+
+  std::vector<BDD> fs;
+  {
+    std::lock_guard<std::mutex> lock( transfer_mutex );
+    for ( auto i = begin; i < end; ++i )
+    {
+      fs.push_back( bdd.second[i].Transfer( mgr ) );
+    }
+  }
+
+  return compute_psdkro_cubes( mgr, fs, num_inputs );
+}
+
 /******************************************************************************
  * Public functions                                                           *
  ******************************************************************************/
@@ -56,6 +116,9 @@ bdd_function_t gia_to_bdd( const gia_graph& gia, Cudd& mgr, const properties::pt
 
   std::vector<BDD> node_to_bdd( gia.size() );
 
+  /* constant node, outputs may point to it */
+  node_to_bdd[0] = mgr.bddZero();
+
   /* create BDD for each input */
   gia.foreach_input( [&mgr, &node_to_bdd]( int id, int i ) {
       node_to_bdd[id] = mgr.bddVar( i );
@@ -80,7 +143,7 @@ bdd_function_t gia_to_bdd( const gia_graph& gia, Cudd& mgr, const properties::pt
 
   /* create BDD for each output */
   std::vector<BDD> outputs;
-  gia.foreach_output( [&gia, &node_to_bdd, &outputs]( int id, int i ) {
+  gia.foreach_output( [&gia, &node_to_bdd, &outputs]( int id, int ) {
       const auto obj = abc::Gia_ManObj( gia, id );
       const auto b = node_to_bdd[abc::Gia_ObjFaninId0p( gia, obj )];
       const auto c = abc::Gia_ObjFaninC0( obj );
@@ -91,6 +154,89 @@ bdd_function_t gia_to_bdd( const gia_graph& gia, Cudd& mgr, const properties::pt
   return {mgr, outputs};
 }
 
+gia_graph::esop_ptr gia_to_psdkro_cover( const gia_graph& gia, const properties::ptr& settings, const properties::ptr& statistics )
+{
+  /* settings */
+  const auto num_threads = get( settings, "num_threads", 1u );
+
+  /* timing */
+  properties_timer t( statistics );
+
+  Cudd mgr;
+  const auto bdd = gia_to_bdd( gia, mgr, settings );
+
+  const unsigned num_inputs = gia.num_inputs();
+  const unsigned num_outputs = bdd.second.size();
+
+  /* PSDKRO cubes for each output */
+  std::vector<std::vector<psdkro_cube_t>> cubes;
+  cubes.reserve( num_outputs );
+
+  if ( num_threads <= 1u || num_outputs <= 1u )
+  {
+    cubes = compute_psdkro_cubes( mgr, bdd.second, num_inputs );
+  }
+  else
+  {
+    /* blocks of consecutive outputs, since they are more likely to share logic */
+    const auto num_blocks = std::min( num_threads, num_outputs );
+    const auto block_size = ( num_outputs + num_blocks - 1u ) / num_blocks;
+
+    std::mutex transfer_mutex;
+    std::vector<std::future<std::vector<std::vector<psdkro_cube_t>>>> blocks;
+    {
+      thread_pool pool( num_blocks );
+      for ( auto begin = 0u; begin < num_outputs; begin += block_size )
+      {
+        const auto end = std::min( begin + block_size, num_outputs );
+        blocks.push_back( pool.enqueue( [&bdd, begin, end, num_inputs, &transfer_mutex]() {
+              return compute_psdkro_cubes_block( bdd, begin, end, num_inputs, transfer_mutex );
+            } ) );
+      }
+
+      for ( auto& block : blocks )
+      {
+        for ( auto& fcubes : block.get() )
+        {
+          cubes.push_back( std::move( fcubes ) );
+        }
+      }
+    }
+  }
+
+  /* merge cubes that appear in several outputs */
+  abc::Vec_Wec_t *esop = abc::Vec_WecAlloc( 0u );
+  std::unordered_map<psdkro_cube_t, int, hash<psdkro_cube_t>> cube_to_level;
+  auto shared_cubes = 0u;
+
+  for ( auto i = 0u; i < num_outputs; ++i )
+  {
+    for ( const auto& cube : cubes[i] )
+    {
+      const auto it = cube_to_level.find( cube );
+      if ( it != cube_to_level.end() )
+      {
+        abc::Vec_IntPush( abc::Vec_WecEntry( esop, it->second ), -static_cast<int>( i ) - 1 );
+        ++shared_cubes;
+        continue;
+      }
+
+      cube_to_level.insert( {cube, abc::Vec_WecSize( esop )} );
+      auto * level = abc::Vec_WecPushLevel( esop );
+      for ( auto lit : cube )
+      {
+        abc::Vec_IntPush( level, lit );
+      }
+      abc::Vec_IntPush( level, -static_cast<int>( i ) - 1 );
+    }
+  }
+
+  set( statistics, "cube_count", static_cast<unsigned>( abc::Vec_WecSize( esop ) ) );
+  set( statistics, "shared_cubes", shared_cubes );
+
+  return gia_graph::esop_ptr( esop, &abc::Vec_WecFree );
+}
+
 }
 
 // Local Variables:
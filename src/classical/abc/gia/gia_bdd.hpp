@@ -47,6 +47,33 @@ namespace cirkit
 
 bdd_function_t gia_to_bdd( const gia_graph& gia, Cudd& mgr, const properties::ptr& settings = properties::ptr(), const properties::ptr& statistics = properties::ptr() );
 
+/**
+ * @brief Computes an ESOP cover from exact PSDKRO expressions
+ *
+ * The outputs are partitioned into blocks of consecutive outputs, one
+ * for each thread.  Each thread transfers the BDDs of its outputs into
+ * its own manager, in which the PSDKRO expansions are shared among all
+ * outputs of the block.  Cubes that appear in several outputs are merged
+ * into one multi-output cube.
+ *
+ * @param settings The following settings are possible
+ *                 +-------------+----------+---------+
+ *                 | Name        | Type     | Default |
+ *                 +-------------+----------+---------+
+ *                 | num_threads | unsigned | 1u      |
+ *                 | progress    | bool     | false   |
+ *                 +-------------+----------+---------+
+ * @param statistics The following statistics are given
+ *                 +--------------+----------+----------------------------------------+
+ *                 | Name         | Type     | Description                            |
+ *                 +--------------+----------+----------------------------------------+
+ *                 | runtime      | double   | Run-time in seconds                    |
+ *                 | cube_count   | unsigned | Number of cubes in the cover           |
+ *                 | shared_cubes | unsigned | Number of cubes shared among outputs   |
+ *                 +--------------+----------+----------------------------------------+
+ */
+gia_graph::esop_ptr gia_to_psdkro_cover( const gia_graph& gia, const properties::ptr& settings = properties::ptr(), const properties::ptr& statistics = properties::ptr() );
+
 }
 
 #endif
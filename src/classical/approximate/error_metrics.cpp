@@ -27,7 +27,9 @@
 #include "error_metrics.hpp"
 
 #include <cmath>
+#include <future>
 #include <stack>
+#include <unordered_map>
 
 #include <boost/algorithm/string/join.hpp>
 #include <boost/dynamic_bitset.hpp>
@@ -39,11 +41,14 @@
 #include <boost/version.hpp>
 
 #include <core/utils/bitset_utils.hpp>
+#include <core/utils/thread_pool.hpp>
 #include <core/utils/timer.hpp>
 #include <classical/dd/arithmetic.hpp>
 #include <classical/dd/bdd_to_truth_table.hpp>
 #include <classical/dd/characteristic.hpp>
+#include <classical/dd/copy.hpp>
 #include <classical/dd/count_solutions.hpp>
+#include <classical/dd/size.hpp>
 
 namespace cirkit
 {
@@ -52,6 +57,40 @@ namespace cirkit
  * Types                                                                      *
  ******************************************************************************/
 
+/* solution counts of nodes in one manager, nodes are never freed, therefore
+ * the counts can be shared by all candidates of that manager */
+class bdd_count_cache
+{
+public:
+  boost::multiprecision::uint256_t count( const bdd& f )
+  {
+    const boost::multiprecision::uint256_t one = 1;
+    return ( one << f.var() ) * count_rec( f );
+  }
+
+private:
+  /* same recurrence as in count_solutions */
+  const boost::multiprecision::uint256_t& count_rec( const bdd& n )
+  {
+    const auto it = counts.find( n.index );
+    if ( it != counts.end() )
+    {
+      return it->second;
+    }
+
+    const boost::multiprecision::uint256_t one = 1;
+    const auto low = n.low();
+    const auto high = n.high();
+    const auto c = ( one << ( low.var() - n.var() - 1u ) ) * count_rec( low ) +
+                   ( one << ( high.var() - n.var() - 1u ) ) * count_rec( high );
+
+    return counts[n.index] = c;
+  }
+
+private:
+  std::unordered_map<unsigned, boost::multiprecision::uint256_t> counts = { { 0u, 0 }, { 1u, 1 } };
+};
+
 /******************************************************************************
  * Private functions                                                          *
  ******************************************************************************/
@@ -161,37 +200,58 @@ boost::multiprecision::uint256_t get_max_value_with_chi( const std::vector<bdd>&
   return to_multiprecision<boost::multiprecision::uint256_t>( bs );
 }
 
-boost::multiprecision::uint256_t get_weighted_sum( const std::vector<bdd>& f )
+/* sum of f over all inputs, i.e., the sum over 2^k times the number of
+ * solutions of f_k */
+boost::multiprecision::uint256_t get_weighted_sum( const std::vector<bdd>& f, bdd_count_cache& cache )
 {
-  auto level = f.size();
-  bdd_manager mgr_chi( f.front().manager->num_vars() + level, 10u ); /* can we approximate the number of used nodes? */
+  boost::multiprecision::uint256_t sum = 0;
 
-  auto fr = f; boost::reverse( fr );
-  auto chi = characteristic_function( fr, mgr_chi );
+  for ( auto k = 0u; k < f.size(); ++k )
+  {
+    sum += cache.count( f[k] ) << k;
+  }
 
-  boost::multiprecision::uint256_t sum = 0;
-  const boost::multiprecision::uint256_t one = 1;
-  std::stack<std::pair<bdd, boost::dynamic_bitset<>>> stack;
+  return sum;
+}
+
+boost::multiprecision::uint256_t get_weighted_sum( const std::vector<bdd>& f )
+{
+  bdd_count_cache cache;
+  return get_weighted_sum( f, cache );
+}
+
+/* f and zf (zero-extended f) must be in the same manager as fhat */
+error_metrics_t compute_error_metrics( const std::vector<bdd>& f, const std::vector<bdd>& zf, const std::vector<bdd>& fhat,
+                                       bdd_count_cache& cache, worst_case_maximum_method maximum_method )
+{
+  assert_valid( f, fhat );
 
-  stack.push( {chi, boost::dynamic_bitset<>( level )} );
+  error_metrics_t metrics;
+  metrics.size = dd_size( fhat );
 
-  while ( !stack.empty() )
+  auto h = f.front().manager->bdd_bot();
+  for ( auto i = 0u; i < f.size(); ++i )
   {
-    auto p = stack.top(); stack.pop();
+    h = h || ( f[i] ^ fhat[i] );
+  }
+  metrics.error_rate = cache.count( h );
 
-    if ( p.first.var() >= level )
-    {
-      sum += to_multiprecision<boost::multiprecision::uint256_t>( p.second ) * ( count_solutions( p.first ) / ( one << level ) );
-    }
-    else
-    {
-      stack.push( {p.first.low(), p.second} );
-      p.second.set( p.first.var() );
-      stack.push( {p.first.high(), p.second} );
-    }
+  if ( metrics.error_rate == 0 )
+  {
+    metrics.worst_case = 0;
+    metrics.average_case = 0;
+    return metrics;
   }
 
-  return sum;
+  const auto diff = bdd_abs( bdd_subtract( zf, zero_extend( fhat, zf.size() ) ) );
+
+  metrics.worst_case = ( maximum_method == worst_case_maximum_method::chi ) ? get_max_value_with_chi( diff ) : get_max_value( diff );
+
+  const boost::multiprecision::uint256_t one = 1;
+  metrics.average_case = boost::multiprecision::cpp_dec_float_100( get_weighted_sum( diff, cache ) ) /
+                         boost::multiprecision::cpp_dec_float_100( one << f.front().manager->num_vars() );
+
+  return metrics;
 }
 
 /******************************************************************************
@@ -252,6 +312,73 @@ boost::multiprecision::cpp_dec_float_100 average_case( const std::vector<bdd>& f
          boost::multiprecision::cpp_dec_float_100( one << f.front().manager->num_vars() );
 }
 
+std::vector<error_metrics_t> error_metrics( const std::vector<bdd>& f, const std::vector<std::vector<bdd>>& fhats,
+                                            const properties::ptr& settings,
+                                            const properties::ptr& statistics )
+{
+  /* settings */
+  const auto num_threads    = get( settings, "num_threads",    1u );
+  const auto log_max_objs   = get( settings, "log_max_objs",   22u );
+  const auto maximum_method = get( settings, "maximum_method", worst_case_maximum_method::shift );
+
+  /* timing */
+  properties_timer t( statistics );
+
+  assert( !f.empty() );
+
+  std::vector<error_metrics_t> metrics( fhats.size() );
+  const auto num_blocks = std::max( 1u, std::min<unsigned>( num_threads, fhats.size() ) );
+
+  if ( num_blocks == 1u )
+  {
+    bdd_count_cache cache;
+    const auto zf = zero_extend( f, f.size() + 1u );
+
+    for ( auto i = 0u; i < fhats.size(); ++i )
+    {
+      metrics[i] = compute_error_metrics( f, zf, fhats[i], cache, maximum_method );
+    }
+
+    return metrics;
+  }
+
+  /* the manager of f is only read while the threads copy their candidates */
+  const auto compute_block = [&]( unsigned block ) {
+    bdd_manager mgr( f.front().manager->num_vars(), log_max_objs );
+    bdd_count_cache cache;
+
+    std::vector<bdd> lf;
+    for ( const auto& fi : f )
+    {
+      lf.push_back( bdd_copy( fi, mgr ) );
+    }
+    const auto zf = zero_extend( lf, lf.size() + 1u );
+
+    for ( auto i = block; i < fhats.size(); i += num_blocks )
+    {
+      std::vector<bdd> lfhat;
+      for ( const auto& fi : fhats[i] )
+      {
+        lfhat.push_back( bdd_copy( fi, mgr ) );
+      }
+      metrics[i] = compute_error_metrics( lf, zf, lfhat, cache, maximum_method );
+    }
+  };
+
+  thread_pool pool( num_blocks );
+  std::vector<std::future<void>> futures;
+  for ( auto block = 0u; block < num_blocks; ++block )
+  {
+    futures.push_back( pool.enqueue( compute_block, block ) );
+  }
+  for ( auto& future : futures )
+  {
+    future.get();
+  }
+
+  return metrics;
+}
+
 }
 
 // Local Variables:
@@ -50,6 +50,14 @@ namespace cirkit
 
 enum class worst_case_maximum_method { shift, chi };
 
+struct error_metrics_t
+{
+  boost::multiprecision::uint256_t         error_rate;
+  boost::multiprecision::uint256_t         worst_case;
+  boost::multiprecision::cpp_dec_float_100 average_case;
+  unsigned long                            size;
+};
+
 boost::multiprecision::uint256_t error_rate( const std::vector<bdd>& f, const std::vector<bdd>& fhat,
                                              const properties::ptr& settings = properties::ptr(),
                                              const properties::ptr& statistics = properties::ptr() );
@@ -60,6 +68,22 @@ boost::multiprecision::cpp_dec_float_100 average_case( const std::vector<bdd>& f
                                                        const properties::ptr& settings = properties::ptr(),
                                                        const properties::ptr& statistics = properties::ptr() );
 
+/**
+ * Computes error rate, worst case, average case, and BDD size for many
+ * approximations of f, all of them must be in the manager of f.  The
+ * extended f and the solution counts are shared among the candidates.  If
+ * num_threads is larger than 1, the candidates are distributed round-robin to
+ * threads, each copying f and its candidates into an own manager.
+ *
+ * Settings:
+ *   num_threads:    number of threads (default: 1)
+ *   log_max_objs:   log size of the thread-local managers (default: 22)
+ *   maximum_method: method for worst case (default: shift)
+ */
+std::vector<error_metrics_t> error_metrics( const std::vector<bdd>& f, const std::vector<std::vector<bdd>>& fhats,
+                                            const properties::ptr& settings = properties::ptr(),
+                                            const properties::ptr& statistics = properties::ptr() );
+
 }
 
 #endif
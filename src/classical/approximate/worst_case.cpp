@@ -26,177 +26,390 @@
 
 #include "worst_case.hpp"
 
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <future>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <boost/range/iterator_range.hpp>
+
 #include <core/utils/bitset_utils.hpp>
 #include <core/utils/range_utils.hpp>
+#include <core/utils/thread_pool.hpp>
 #include <core/utils/timer.hpp>
-#include <classical/abc/abc_api.hpp>
-#include <classical/abc/functions/cirkit_to_gia.hpp>
+#include <classical/sat/minisat.hpp>
+#include <classical/sat/sat_solver.hpp>
+#include <classical/sat/operations/logic.hpp>
+#include <classical/sat/utils/add_aig.hpp>
 #include <classical/utils/aig_utils.hpp>
 
-#include <aig/gia/gia.h>
-#include <sat/bsat/satSolver.h>
-
-#define LN( x ) if ( verbose ) { std::cout << x << std::endl; }
-
-namespace abc
-{
-void Wlc_BlastSubtract( Gia_Man_t * pNew, int * pAdd0, int * pAdd1, int nBits ); // result is in pAdd0
-int Wlc_BlastLessSigned( Gia_Man_t * pNew, int * pArg0, int * pArg1, int nBits );
-}
-
 namespace cirkit
 {
 
+using boost::multiprecision::uint256_t;
+
 /******************************************************************************
  * Types                                                                      *
  ******************************************************************************/
 
+/* output words for each output, then for each simulation word */
+using worst_case_sim_t = std::vector<std::vector<uint64_t>>;
+
+/* keeps f encoded in one solver, candidates are attached one after the other
+ * and retired with their activation literal afterwards */
+class worst_case_engine
+{
+public:
+  worst_case_engine( const aig_graph& f, const std::vector<std::vector<uint64_t>>& patterns, unsigned num_words, const worst_case_sim_t& fsim );
+
+  uint256_t compute( const aig_graph& fhat );
+
+  unsigned sat_calls = 0u;
+  unsigned skipped_bits = 0u;
+
+private:
+  std::vector<int> add_subtract( const std::vector<int>& a, const std::vector<int>& b );
+
+private:
+  const std::vector<std::vector<uint64_t>>& patterns;
+  unsigned                                  num_words;
+  const worst_case_sim_t&                   fsim;
+
+  minisat_solver                            solver;
+  solver_execution_statistics               solver_stats;
+  aig_cnf_encoder<minisat_solver>           fencoder;
+  std::vector<int>                          input_vars;
+  std::vector<int>                          output_lits;
+  int                                       true_var;
+  int                                       next_var;
+};
+
 /******************************************************************************
  * Private functions                                                          *
  ******************************************************************************/
 
-// po1 and po2 are vectors of literals of the original outputs
-abc::Gia_Man_t * Gia_ManDupAppendNewWithoutPOs( abc::Gia_Man_t * pOne, abc::Gia_Man_t * pTwo, std::vector<int>& po1, std::vector<int>& po2 )
+/* bit-parallel simulation, patterns are indexed by input and then by word;
+ * an empty value vector marks an unvisited node, so there must be at least
+ * one word */
+worst_case_sim_t worst_case_simulate( const aig_graph& aig, const std::vector<std::vector<uint64_t>>& patterns, unsigned num_words )
 {
-  abc::Gia_Obj_t * pObj;
-  int i;
-  auto pNew = abc::Gia_ManStart( abc::Gia_ManObjNum( pOne ) + abc::Gia_ManObjNum( pTwo ) );
-  pNew->pName = abc::Abc_UtilStrsav( pOne->pName );
-  pNew->pSpec = abc::Abc_UtilStrsav( pOne->pSpec );
-  abc::Gia_ManHashAlloc( pNew );
-  abc::Gia_ManConst0( pOne )->Value = 0;
-  Gia_ManForEachObj1( pOne, pObj, i )
-  {
-    if ( abc::Gia_ObjIsAnd( pObj ) )
+  assert( num_words >= 1u );
+
+  const auto& info = aig_info( aig );
+
+  std::vector<std::vector<uint64_t>> values( boost::num_vertices( aig ) );
+  values[info.constant].assign( num_words, 0u );
+  for ( const auto& input : index( info.inputs ) )
+  {
+    values[input.value] = patterns[input.index];
+  }
+
+  /* iterative DFS from the outputs */
+  std::vector<aig_node> stack;
+  for ( const auto& output : info.outputs )
+  {
+    stack.push_back( output.first.node );
+  }
+
+  while ( !stack.empty() )
+  {
+    const auto n = stack.back();
+    if ( !values[n].empty() )
     {
-      pObj->Value = abc::Gia_ManHashAnd( pNew, abc::Gia_ObjFanin0Copy( pObj ), abc::Gia_ObjFanin1Copy( pObj ) );
+      stack.pop_back();
+      continue;
     }
-    else if ( abc::Gia_ObjIsPi( pOne, pObj ) )
+
+    std::vector<aig_function> children;
+    auto pending = false;
+    for ( const auto& edge : boost::make_iterator_range( boost::out_edges( n, aig ) ) )
     {
-      pObj->Value = abc::Gia_ManAppendCi( pNew );
+      children.push_back( aig_to_function( aig, edge ) );
+      if ( values[children.back().node].empty() )
+      {
+        stack.push_back( children.back().node );
+        pending = true;
+      }
+    }
+    assert( children.size() == 2u );
+
+    if ( pending ) { continue; }
+
+    stack.pop_back();
+
+    const auto c0 = children[0u].complemented ? ~UINT64_C( 0 ) : 0u;
+    const auto c1 = children[1u].complemented ? ~UINT64_C( 0 ) : 0u;
+    const auto& v0 = values[children[0u].node];
+    const auto& v1 = values[children[1u].node];
+    values[n].resize( num_words );
+    for ( auto w = 0u; w < num_words; ++w )
+    {
+      values[n][w] = ( v0[w] ^ c0 ) & ( v1[w] ^ c1 );
     }
   }
-  abc::Gia_ManConst0( pTwo )->Value = 0;
-  Gia_ManForEachObj1( pTwo, pObj, i )
+
+  worst_case_sim_t sim;
+  for ( const auto& output : info.outputs )
   {
-    if ( abc::Gia_ObjIsAnd( pObj ) )
+    sim.push_back( values[output.first.node] );
+    if ( output.first.complemented )
     {
-      pObj->Value = abc::Gia_ManHashAnd( pNew, abc::Gia_ObjFanin0Copy( pObj ), abc::Gia_ObjFanin1Copy( pObj ) );
+      for ( auto& word : sim.back() )
+      {
+        word = ~word;
+      }
     }
-    else if ( abc::Gia_ObjIsPi( pTwo, pObj ) )
+  }
+  return sim;
+}
+
+/* largest |f - fhat| among the simulated patterns */
+uint256_t worst_case_sim_bound( const worst_case_sim_t& fsim, const worst_case_sim_t& fhatsim )
+{
+  uint256_t bound = 0;
+
+  const auto num_bits = fsim.size();
+  const auto num_words = num_bits == 0u ? 0u : fsim.front().size();
+
+  for ( auto w = 0u; w < num_words; ++w )
+  {
+    for ( auto b = 0u; b < 64u; ++b )
     {
-      pObj->Value = abc::Gia_ManPi( pOne, abc::Gia_ObjCioId( pObj ) )->Value;
+      uint256_t a = 0, c = 0;
+      for ( auto i = 0u; i < num_bits; ++i )
+      {
+        if ( ( fsim[i][w] >> b ) & 1u )    { bit_set( a, i ); }
+        if ( ( fhatsim[i][w] >> b ) & 1u ) { bit_set( c, i ); }
+      }
+      bound = std::max( bound, a > c ? uint256_t( a - c ) : uint256_t( c - a ) );
     }
   }
 
-  po1.clear();
-  po2.clear();
+  return bound;
+}
+
+worst_case_engine::worst_case_engine( const aig_graph& f, const std::vector<std::vector<uint64_t>>& patterns, unsigned num_words, const worst_case_sim_t& fsim )
+  : patterns( patterns ),
+    num_words( num_words ),
+    fsim( fsim ),
+    solver( make_solver<minisat_solver>() ),
+    fencoder( solver, f, 1 )
+{
+  const auto& info = aig_info( f );
 
-  Gia_ManForEachPo( pOne, pObj, i )
+  for ( auto i = 0u; i < info.inputs.size(); ++i )
   {
-    po1.push_back( Gia_ObjFanin0Copy( pObj ) );
+    input_vars.push_back( fencoder.input_var( i ) );
   }
-  Gia_ManForEachPo( pTwo, pObj, i )
+
+  for ( const auto& output : info.outputs )
   {
-    po2.push_back( Gia_ObjFanin0Copy( pObj ) );
+    output_lits.push_back( fencoder.lit( output.first ) );
   }
-  abc::Gia_ManSetRegNum( pNew, 0 );
 
-  return pNew;
+  next_var = fencoder.next_var();
+  true_var = next_var++;
+  add_clause( solver )( {true_var} );
 }
 
-/******************************************************************************
- * Public functions                                                           *
- ******************************************************************************/
-
-boost::multiprecision::uint256_t worst_case( const aig_graph& f, const aig_graph& fhat,
-                                             const properties::ptr& settings,
-                                             const properties::ptr& statistics )
+/* returns a - b on |a| bits, the last element is 1, if and only if a >= b */
+std::vector<int> worst_case_engine::add_subtract( const std::vector<int>& a, const std::vector<int>& b )
 {
-  properties_timer t( statistics );
-
-  const auto& finfo = aig_info( f );
-  const auto& fhatinfo = aig_info( fhat );
+  std::vector<int> result;
 
-  if ( ( finfo.inputs.size() != fhatinfo.inputs.size() ) || ( finfo.outputs.size() != fhatinfo.outputs.size() ) )
+  auto carry = true_var;
+  for ( auto i = 0u; i < a.size(); ++i )
   {
-    set_error_message( statistics, "circuits have incompatible sizes" );
-    return 0;
+    const auto t = next_var++;
+    const auto s = next_var++;
+    const auto c = next_var++;
+    logic_xor( solver, a[i], -b[i], t );
+    logic_xor( solver, t, carry, s );
+    logic_maj( solver, a[i], -b[i], carry, c );
+    result.push_back( s );
+    carry = c;
   }
+  result.push_back( carry );
 
-  const auto num_bits = finfo.outputs.size();
+  return result;
+}
 
-  const auto giaf = cirkit_to_gia( f );
-  const auto giafhat = cirkit_to_gia( fhat );
+uint256_t worst_case_engine::compute( const aig_graph& fhat )
+{
+  const auto num_bits = output_lits.size();
 
-  /* append giafhat to giaf and share PIs */
-  std::vector<int> po1, po2;
-  auto miter = Gia_ManDupAppendNewWithoutPOs( giaf, giafhat, po1, po2 );
-  assert( abc::Gia_ManCiNum( miter ) == static_cast<int>( finfo.inputs.size() ) );
-  assert( abc::Gia_ManCoNum( miter ) == 0 );
-  assert( po1.size() == num_bits );
-  assert( po2.size() == num_bits );
+  /* lower bound from simulation */
+  auto bound = worst_case_sim_bound( fsim, worst_case_simulate( fhat, patterns, num_words ) );
 
-  /* create comparator */
-  int * a = &po1[0];
-  int * b = &po2[0];
+  /* all clauses of this candidate are guarded by the activation literal */
+  const auto act = next_var++;
+  solver_add_blocking_var( solver, act );
 
-  const auto less = abc::Wlc_BlastLessSigned( miter, a, b, num_bits );
+  aig_cnf_encoder<minisat_solver> encoder( solver, fhat, next_var, input_vars );
+  std::vector<int> fhat_lits;
+  for ( const auto& output : aig_info( fhat ).outputs )
+  {
+    fhat_lits.push_back( encoder.lit( output.first ) );
+  }
+  next_var = encoder.next_var();
 
-  std::vector<int> m1( num_bits ), m2( num_bits );
+  /* d = f >= fhat ? f - fhat : fhat - f */
+  const auto d1 = add_subtract( output_lits, fhat_lits );
+  const auto d2 = add_subtract( fhat_lits, output_lits );
+  std::vector<int> d( num_bits );
   for ( auto i = 0u; i < num_bits; ++i )
   {
-    m1[i] = abc::Gia_ManHashMux( miter, less, po2[i], po1[i] ); /* returns the larger number */
-    m2[i] = abc::Gia_ManHashMux( miter, less, po1[i], po2[i] ); /* returns the smaller number */
+    d[i] = next_var++;
+    logic_mux( solver, d1.back(), d1[i], d2[i], d[i] );
   }
 
-  /* create subtractor */
-  abc::Wlc_BlastSubtract( miter, &m1[0], &m2[0], num_bits ); /* stores result in m1 */
+  solver_clear_blocking_vars( solver );
 
-  for ( auto l : m1 )
+  /* fix the bits of d from the most significant one; a bit is known to be 1
+   * without a SAT call, if the best value so far agrees on the prefix */
+  std::vector<int> assumptions{-act};
+  uint256_t value = 0;
+  for ( int i = num_bits - 1; i >= 0; --i )
   {
-    abc::Gia_ManAppendCo( miter, l );
+    if ( ( bound >> i ) == ( ( value >> i ) | 1 ) )
+    {
+      ++skipped_bits;
+      bit_set( value, i );
+      assumptions.push_back( d[i] );
+      continue;
+    }
+
+    assumptions.push_back( d[i] );
+    ++sat_calls;
+    const auto result = solve( solver, solver_stats, assumptions );
+    if ( result )
+    {
+      bit_set( value, i );
+
+      /* the model is a better witness for the remaining bits */
+      uint256_t witness = 0;
+      for ( auto j = 0u; j < num_bits; ++j )
+      {
+        if ( result->first[d[j] - 1] ) { bit_set( witness, j ); }
+      }
+      bound = witness;
+    }
+    else
+    {
+      assumptions.back() = -d[i];
+    }
   }
 
-  abc::Gia_ManHashStop( miter );
+  /* retire the candidate */
+  add_clause( solver )( {act} );
+
+  return value;
+}
+
+/* candidates are passed by pointer, such that a single candidate is not copied */
+std::vector<uint256_t> worst_case_candidates( const aig_graph& f, const std::vector<const aig_graph*>& fhats,
+                                              const properties::ptr& settings,
+                                              const properties::ptr& statistics )
+{
+  /* settings */
+  const auto num_threads = get( settings, "num_threads", 1u );
+  const auto num_words   = get( settings, "num_words",   4u );
+  const auto seed        = get( settings, "seed",        0xcafeu );
+
+  /* timing */
+  properties_timer t( statistics );
+
+  const auto& finfo = aig_info( f );
+  std::vector<uint256_t> results( fhats.size() );
 
-  /* create CNF */
-  auto * cnf = static_cast<abc::Cnf_Dat_t*>( abc::Mf_ManGenerateCnf( miter, 8, 0, 0, 0, 0 ) );
-  auto * solver = (abc::sat_solver *)abc::Cnf_DataWriteIntoSolver( cnf, 1, 0 );
-  abc::Cnf_DataFree( cnf );
+  if ( num_words == 0u )
+  {
+    set_error_message( statistics, "num_words must be at least 1" );
+    return results;
+  }
 
-  /* output literals are the first ones */
-  std::vector<int> lits;
-  for ( auto i = 1u; i <= num_bits; ++i )
+  for ( const auto& fhat : fhats )
   {
-    lits.push_back( abc::Abc_Var2Lit( i, 0 ) );
+    const auto& fhatinfo = aig_info( *fhat );
+    if ( ( finfo.inputs.size() != fhatinfo.inputs.size() ) || ( finfo.outputs.size() != fhatinfo.outputs.size() ) )
+    {
+      set_error_message( statistics, "circuits have incompatible sizes" );
+      return results;
+    }
   }
 
-  /* call LEXSAT on output values */
-  boost::multiprecision::uint256_t result;
-  if ( abc::sat_solver_solve_lexsat( solver, &lits[0], lits.size() ) == abc::l_True )
+  /* shared random patterns and simulation of f */
+  std::default_random_engine gen( seed );
+  std::uniform_int_distribution<uint64_t> dist;
+  std::vector<std::vector<uint64_t>> patterns( finfo.inputs.size(), std::vector<uint64_t>( num_words ) );
+  for ( auto& words : patterns )
   {
-    boost::dynamic_bitset<> sol( num_bits );
-    for ( auto i = 0u; i < num_bits; ++i )
+    std::generate( words.begin(), words.end(), [&]() { return dist( gen ); } );
+  }
+  const auto fsim = worst_case_simulate( f, patterns, num_words );
+
+  /* candidates are distributed round-robin, each thread has its own solver */
+  const auto num_blocks = std::max( 1u, std::min<unsigned>( num_threads, fhats.size() ) );
+  std::vector<unsigned> sat_calls( num_blocks ), skipped_bits( num_blocks );
+
+  const auto compute_block = [&]( unsigned block ) {
+    worst_case_engine engine( f, patterns, num_words, fsim );
+    for ( auto i = block; i < fhats.size(); i += num_blocks )
     {
-      sol[i] = abc::sat_solver_var_value( solver, i + 1 );
+      results[i] = engine.compute( *fhats[i] );
     }
+    sat_calls[block] = engine.sat_calls;
+    skipped_bits[block] = engine.skipped_bits;
+  };
 
-    result = to_multiprecision<boost::multiprecision::uint256_t>( sol );
+  if ( num_blocks == 1u )
+  {
+    compute_block( 0u );
   }
   else
   {
-    assert( false );
+    thread_pool pool( num_blocks );
+    std::vector<std::future<void>> futures;
+    for ( auto block = 0u; block < num_blocks; ++block )
+    {
+      futures.push_back( pool.enqueue( compute_block, block ) );
+    }
+    for ( auto& future : futures )
+    {
+      future.get();
+    }
   }
 
-  abc::sat_solver_delete( solver );
+  set( statistics, "sat_calls", std::accumulate( sat_calls.begin(), sat_calls.end(), 0u ) );
+  set( statistics, "skipped_bits", std::accumulate( skipped_bits.begin(), skipped_bits.end(), 0u ) );
 
-  /* clean up */
-  abc::Gia_ManStop( miter );
-  abc::Gia_ManStop( giaf );
-  abc::Gia_ManStop( giafhat );
+  return results;
+}
 
-  return result;
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+boost::multiprecision::uint256_t worst_case( const aig_graph& f, const aig_graph& fhat,
+                                             const properties::ptr& settings,
+                                             const properties::ptr& statistics )
+{
+  return worst_case_candidates( f, {&fhat}, settings, statistics ).front();
+}
+
+std::vector<boost::multiprecision::uint256_t> worst_case( const aig_graph& f, const std::vector<aig_graph>& fhats,
+                                                          const properties::ptr& settings,
+                                                          const properties::ptr& statistics )
+{
+  std::vector<const aig_graph*> pfhats;
+  for ( const auto& fhat : fhats )
+  {
+    pfhats.push_back( &fhat );
+  }
+  return worst_case_candidates( f, pfhats, settings, statistics );
 }
 
 }
@@ -29,6 +29,27 @@
  *
  * @brief Compute worst-case error with AIGs
  *
+ * The worst-case error is the largest |f(x) - fhat(x)| over all inputs x,
+ * where the outputs are read as unsigned numbers with the first output being
+ * the least significant bit.
+ *
+ * The specification f is encoded once into a SAT solver and candidates are
+ * attached with an activation literal.  The error bits are fixed from the
+ * most significant one with incremental SAT calls, where bits that are
+ * already witnessed by random simulation or by a previous model are not
+ * checked again.  Several candidates are distributed to threads, each with
+ * its own solver.
+ *
+ * Settings:
+ *   num_threads:  number of threads (default: 1)
+ *   num_words:    number of 64-bit random simulation words, at least 1 (default: 4)
+ *   seed:         seed for random simulation (default: 0xcafe)
+ *
+ * Statistics:
+ *   runtime:      run-time
+ *   sat_calls:    number of SAT calls
+ *   skipped_bits: number of error bits that were decided without SAT
+ *
  * @author Mathias Soeken
  * @since  2.3
  */
@@ -36,6 +57,8 @@
 #ifndef APPROX_WORST_CASE_AIG_HPP
 #define APPROX_WORST_CASE_AIG_HPP
 
+#include <vector>
+
 #include <boost/multiprecision/cpp_int.hpp>
 
 #include <core/properties.hpp>
@@ -44,11 +67,14 @@
 namespace cirkit
 {
 
-
 boost::multiprecision::uint256_t worst_case( const aig_graph& f, const aig_graph& fhat,
                                              const properties::ptr& settings = properties::ptr(),
                                              const properties::ptr& statistics = properties::ptr() );
 
+std::vector<boost::multiprecision::uint256_t> worst_case( const aig_graph& f, const std::vector<aig_graph>& fhats,
+                                                          const properties::ptr& settings = properties::ptr(),
+                                                          const properties::ptr& statistics = properties::ptr() );
+
 }
 
 #endif
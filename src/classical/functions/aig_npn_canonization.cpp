@@ -26,13 +26,21 @@
 
 #include "aig_npn_canonization.hpp"
 
+#include <array>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <random>
+
 #include <boost/dynamic_bitset.hpp>
 
 #include <fmt/format.h>
 
 #include <core/utils/bitset_utils.hpp>
+#include <core/utils/graph_utils.hpp>
 #include <core/utils/range_utils.hpp>
 #include <core/utils/terminal.hpp>
+#include <core/utils/thread_pool.hpp>
 #include <core/utils/timer.hpp>
 #include <classical/functions/aig_cone.hpp>
 #include <classical/functions/simulate_aig.hpp>
@@ -43,6 +51,7 @@
 #include <classical/sat/minisat.hpp>
 #include <classical/sat/utils/add_aig.hpp>
 #include <classical/sat/utils/add_aig_with_gia.hpp>
+#include <classical/sat/operations/logic.hpp>
 #include <classical/sat/utils/lexicographic.hpp>
 #include <classical/sat/utils/visit_solutions.hpp>
 
@@ -59,6 +68,22 @@ namespace cirkit
  * Types                                                                      *
  ******************************************************************************/
 
+/* a single step of the canonization heuristics */
+struct aig_npn_move_t
+{
+  enum kind_t { flip, swap, sift };
+
+  kind_t   kind;
+  unsigned i;
+  unsigned j;
+};
+
+struct aig_npn_state_t
+{
+  boost::dynamic_bitset<> phase;
+  std::vector<unsigned>   perm;
+};
+
 /******************************************************************************
  * Private functions                                                          *
  ******************************************************************************/
@@ -143,6 +168,8 @@ public:
     }
   }
 
+  inline unsigned num_inputs() const { return info.inputs.size(); }
+
   void reset( bool output_phase )
   {
     phase.reset();
@@ -495,6 +522,8 @@ public:
     build_solver();
   }
 
+  inline unsigned num_inputs() const { return info.inputs.size(); }
+
   void reset( bool output_phase )
   {
     phase.reset();
@@ -745,6 +774,579 @@ public:
   double                   encoding_runtime = 0.0;
 };
 
+/*
+ * Keeps one incremental solver in which the AIG is encoded twice.  The
+ * inputs of both copies are connected to the lexicographic variables
+ * x_0, ..., x_{n-1} through selector variables: selector (c, k, i, p)
+ * enforces that input k of copy c equals x_i XOR p.  Each query assumes n
+ * selectors per copy, which implement the input permutation and phase as
+ * a MUX layer; selectors are created when they are first used.
+ *
+ * Before calling the solver, the query is simulated on random patterns.  A
+ * pattern that distinguishes both copies replaces the first SAT call of the
+ * lexicographic search.
+ */
+class aig_npn_canonization_sat_engine
+{
+public:
+  aig_npn_canonization_sat_engine( const aig_graph& aig, unsigned num_words, unsigned seed )
+    : aig( aig ),
+      info( aig_info( aig ) ),
+      n( info.inputs.size() ),
+      num_words( num_words ),
+      solver( make_solver<minisat_solver>() ),
+      selectors( n * n << 2u, 0 )
+  {
+    encode();
+    prepare_simulation( seed );
+  }
+
+  bool try_move( aig_npn_state_t& state, const aig_npn_move_t& move )
+  {
+    switch ( move.kind )
+    {
+    case aig_npn_move_t::flip:
+      {
+        auto next = state;
+        next.phase.flip( move.i );
+        return try_explicit( state, next );
+      }
+
+    case aig_npn_move_t::swap:
+      {
+        auto next = state;
+        std::swap( next.perm[move.i], next.perm[move.j] );
+        return try_explicit( state, next );
+      }
+
+    case aig_npn_move_t::sift:
+    default:
+      {
+        const auto i = move.i;
+        auto next = state;
+        auto improvement = false;
+
+        for ( auto k = 1u; k < 8u; ++k )
+        {
+          if ( k % 4u == 0u )
+          {
+            std::swap( next.perm[i], next.perm[i + 1] );
+          }
+          else if ( k % 2u == 0 )
+          {
+            next.phase.flip( i + 1 );
+          }
+          else
+          {
+            next.phase.flip( i );
+          }
+
+          if ( lexicographically_larger( state, next ) )
+          {
+            state = next;
+            improvement = true;
+          }
+        }
+
+        return improvement;
+      }
+    }
+  }
+
+  bool try_explicit( aig_npn_state_t& state, const aig_npn_state_t& next )
+  {
+    if ( lexicographically_larger( state, next ) )
+    {
+      state = next;
+      return true;
+    }
+    return false;
+  }
+
+private:
+  void encode()
+  {
+    reference_timer t( &encoding_runtime );
+
+    std::vector<int> inputs1( n ), inputs2( n );
+    for ( auto k = 0u; k < n; ++k )
+    {
+      inputs1[k] = n + 1 + k;
+      inputs2[k] = 2 * n + 1 + k;
+    }
+
+    aig_cnf_encoder<minisat_solver> enc1( solver, aig, 3 * n + 1, inputs1 );
+    output = enc1.lit( info.outputs[0u].first );
+
+    aig_cnf_encoder<minisat_solver> enc2( solver, aig, enc1.next_var(), inputs2 );
+    const auto output2 = enc2.lit( info.outputs[0u].first );
+
+    next_var = enc2.next_var();
+    diff = next_var++;
+    logic_xor( solver, output, output2, diff );
+  }
+
+  int selector( unsigned copy, unsigned k, unsigned i, bool inv )
+  {
+    auto& sel = selectors[( ( ( copy * n + k ) * n + i ) << 1u ) + ( inv ? 1u : 0u )];
+    if ( !sel )
+    {
+      sel = next_var++;
+
+      const int a = ( copy + 1u ) * n + 1 + k;
+      const int x = inv ? -static_cast<int>( i + 1 ) : static_cast<int>( i + 1 );
+      add_clause( solver )( {-sel, -a, x} );
+      add_clause( solver )( {-sel, a, -x} );
+    }
+    return sel;
+  }
+
+  void read_model( const solver_result_t& result, boost::dynamic_bitset<>& ys, bool& value ) const
+  {
+    for ( auto i = 0u; i < n; ++i )
+    {
+      ys[i] = result->first[i];
+    }
+    value = result->first[std::abs( output ) - 1] != ( output < 0 );
+  }
+
+  bool lexicographically_larger( const aig_npn_state_t& cur, const aig_npn_state_t& next )
+  {
+    std::vector<int> assumptions;
+    assumptions.reserve( 3u * n + 1u );
+
+    assumptions.push_back( ( cur.phase[n] != next.phase[n] ) ? -diff : diff );
+    for ( auto i = 0u; i < n; ++i )
+    {
+      assumptions.push_back( selector( 0u, cur.perm[i], i, cur.phase[cur.perm[i]] ) );
+      assumptions.push_back( selector( 1u, next.perm[i], i, next.phase[next.perm[i]] ) );
+    }
+
+    ++lexsat_calls;
+
+    boost::dynamic_bitset<> ys( n );
+    auto value = false;
+
+    solver_execution_statistics stats;
+    solver_result_t result;
+
+    if ( simulate( cur, next, ys, value ) )
+    {
+      ++sim_witnesses;
+    }
+    else
+    {
+      result = solve( solver, stats, assumptions );
+      ++sat_calls;
+      runtime += stats.runtime;
+
+      if ( result == boost::none )
+      {
+        return false;
+      }
+      read_model( result, ys, value );
+    }
+
+    /* fix the largest solution from the most significant variable */
+    for ( int d = n - 1; d >= 0; --d )
+    {
+      assumptions.push_back( d + 1 );
+      if ( ys[d] ) { continue; }
+
+      result = solve( solver, stats, assumptions );
+      ++sat_calls;
+      runtime += stats.runtime;
+
+      if ( result == boost::none )
+      {
+        assumptions.back() = -( d + 1 );
+      }
+      else
+      {
+        read_model( result, ys, value );
+      }
+    }
+
+    return value != cur.phase[n];
+  }
+
+  /* simulation */
+  void prepare_simulation( unsigned seed )
+  {
+    foreach_topological( aig, [this]( const aig_node& node ) {
+        if ( boost::out_degree( node, aig ) == 2u )
+        {
+          const auto children = get_children( aig, node );
+          gates.push_back( {{static_cast<unsigned>( node ),
+                             ( static_cast<unsigned>( children[0u].node ) << 1u ) | static_cast<unsigned>( children[0u].complemented ),
+                             ( static_cast<unsigned>( children[1u].node ) << 1u ) | static_cast<unsigned>( children[1u].complemented )}} );
+        }
+        return true;
+      } );
+
+    std::mt19937_64 gen( seed );
+    patterns.resize( n * num_words );
+    std::generate( patterns.begin(), patterns.end(), std::ref( gen ) );
+    values.resize( boost::num_vertices( aig ) * num_words );
+  }
+
+  /* simulates f where input perm[i] is x_i XOR phase[perm[i]]; the result
+     is complemented by the output phase */
+  void simulate_state( const aig_npn_state_t& state, std::vector<uint64_t>& result )
+  {
+    std::fill( values.begin(), values.end(), 0u );
+
+    for ( auto i = 0u; i < n; ++i )
+    {
+      const auto k = state.perm[i];
+      const auto mask = state.phase[k] ? ~uint64_t( 0u ) : uint64_t( 0u );
+      for ( auto w = 0u; w < num_words; ++w )
+      {
+        values[info.inputs[k] * num_words + w] = patterns[i * num_words + w] ^ mask;
+      }
+    }
+
+    for ( const auto& gate : gates )
+    {
+      const auto mask0 = ( gate[1u] & 1u ) ? ~uint64_t( 0u ) : uint64_t( 0u );
+      const auto mask1 = ( gate[2u] & 1u ) ? ~uint64_t( 0u ) : uint64_t( 0u );
+      for ( auto w = 0u; w < num_words; ++w )
+      {
+        values[gate[0u] * num_words + w] = ( values[( gate[1u] >> 1u ) * num_words + w] ^ mask0 ) & ( values[( gate[2u] >> 1u ) * num_words + w] ^ mask1 );
+      }
+    }
+
+    const auto& f = info.outputs[0u].first;
+    const auto mask = ( f.complemented != state.phase[n] ) ? ~uint64_t( 0u ) : uint64_t( 0u );
+    result.resize( num_words );
+    for ( auto w = 0u; w < num_words; ++w )
+    {
+      result[w] = values[f.node * num_words + w] ^ mask;
+    }
+  }
+
+  /* finds the lexicographically largest simulated assignment on which both
+     functions differ, value is the value of the first copy (without output
+     phase) on this assignment */
+  bool simulate( const aig_npn_state_t& cur, const aig_npn_state_t& next, boost::dynamic_bitset<>& ys, bool& value )
+  {
+    if ( cur.perm != sim_state.perm || cur.phase != sim_state.phase )
+    {
+      simulate_state( cur, sim_current );
+      sim_state = cur;
+    }
+    simulate_state( next, sim_next );
+
+    auto best = -1;
+    for ( auto w = 0u; w < num_words; ++w )
+    {
+      auto bits = sim_current[w] ^ sim_next[w];
+      while ( bits )
+      {
+        const auto b = static_cast<int>( ( w << 6u ) + __builtin_ctzll( bits ) );
+        bits &= bits - 1u;
+
+        if ( best == -1 || larger_pattern( b, best ) )
+        {
+          best = b;
+        }
+      }
+    }
+
+    if ( best == -1 )
+    {
+      return false;
+    }
+
+    for ( auto i = 0u; i < n; ++i )
+    {
+      ys[i] = pattern_bit( i, best );
+    }
+    value = pattern_bit( best, sim_current ) != cur.phase[n];
+    return true;
+  }
+
+  inline bool pattern_bit( unsigned i, unsigned b ) const
+  {
+    return ( patterns[i * num_words + ( b >> 6u )] >> ( b & 63u ) ) & 1u;
+  }
+
+  inline bool pattern_bit( unsigned b, const std::vector<uint64_t>& words ) const
+  {
+    return ( words[b >> 6u] >> ( b & 63u ) ) & 1u;
+  }
+
+  inline bool larger_pattern( unsigned b1, unsigned b2 ) const
+  {
+    for ( int i = n - 1; i >= 0; --i )
+    {
+      const auto v1 = pattern_bit( i, b1 );
+      const auto v2 = pattern_bit( i, b2 );
+      if ( v1 != v2 ) { return v1; }
+    }
+    return false;
+  }
+
+private:
+  const aig_graph&                     aig;
+  const aig_graph_info&                info;
+  unsigned                             n;
+  unsigned                             num_words;
+
+  minisat_solver                       solver;
+  int                                  output;
+  int                                  diff;
+  int                                  next_var;
+  std::vector<int>                     selectors;
+
+  std::vector<std::array<unsigned, 3>> gates;
+  std::vector<uint64_t>                patterns;
+  std::vector<uint64_t>                values;
+  aig_npn_state_t                      sim_state;
+  std::vector<uint64_t>                sim_current;
+  std::vector<uint64_t>                sim_next;
+
+public:
+  unsigned long                        sat_calls        = 0ul;
+  unsigned long                        lexsat_calls     = 0ul;
+  unsigned long                        sim_witnesses    = 0ul;
+  double                               runtime          = 0.0;
+  double                               encoding_runtime = 0.0;
+};
+
+/*
+ * Manager for the SAT engine.  With num_threads > 1, consecutive moves of a
+ * round are evaluated speculatively in parallel on the same state, each
+ * thread with its own engine.  The first improving move is committed and
+ * the evaluation continues after it, which gives the same result as the
+ * sequential evaluation.
+ */
+class aig_npn_canonization_incremental_manager
+{
+public:
+  aig_npn_canonization_incremental_manager( const aig_graph& aig,
+                                            boost::dynamic_bitset<>& phase,
+                                            std::vector<unsigned>& perm,
+                                            const properties::ptr& settings )
+    : aig( aig ), info( aig_info( aig ) ), phase( phase ), perm( perm )
+  {
+    num_threads = std::max( 1u, get( settings, "num_threads", 1u ) );
+    num_words   = get( settings, "num_words", 4u );
+    seed        = get( settings, "seed", 0xcafeu );
+
+    /* initialize phase and perm */
+    const auto n = info.inputs.size();
+    phase.resize( n + 1u );
+    phase.reset();
+    perm.resize( n );
+    std::iota( perm.begin(), perm.end(), 0u );
+
+    state.phase = phase;
+    state.perm  = perm;
+
+    engines.resize( num_threads );
+    engines[0u].reset( new aig_npn_canonization_sat_engine( aig, num_words, seed ) );
+
+    if ( num_threads > 1u )
+    {
+      pool.reset( new thread_pool( num_threads ) );
+    }
+  }
+
+  void reset( bool output_phase )
+  {
+    state.phase.reset();
+    state.phase.set( info.inputs.size(), output_phase );
+    std::iota( state.perm.begin(), state.perm.end(), 0u );
+    commit();
+  }
+
+  bool try_flip( unsigned i )
+  {
+    return try_move( {aig_npn_move_t::flip, i, 0u} );
+  }
+
+  bool try_swap( unsigned i, unsigned j )
+  {
+    return try_move( {aig_npn_move_t::swap, i, j} );
+  }
+
+  bool try_sift( unsigned i )
+  {
+    return try_move( {aig_npn_move_t::sift, i, 0u} );
+  }
+
+  bool try_explicit( const std::vector<unsigned>& other_perm, const boost::dynamic_bitset<>& other_phase )
+  {
+    if ( engines[0u]->try_explicit( state, {other_phase, other_perm} ) )
+    {
+      commit();
+      return true;
+    }
+    return false;
+  }
+
+  /* returns true if some move improved */
+  bool try_moves( const std::vector<aig_npn_move_t>& moves, bool verbose )
+  {
+    auto improvement = false;
+    auto pos = 0u;
+
+    while ( pos < moves.size() )
+    {
+      const auto batch = std::min<unsigned>( num_threads, moves.size() - pos );
+
+      if ( batch == 1u )
+      {
+        if ( try_move( moves[pos] ) )
+        {
+          log_move( moves[pos], verbose );
+          improvement = true;
+        }
+        ++pos;
+        continue;
+      }
+
+      std::vector<aig_npn_state_t> states( batch, state );
+      std::vector<std::future<bool>> results;
+      for ( auto t = 0u; t < batch; ++t )
+      {
+        results.push_back( pool->enqueue( [this, &states, &moves, pos, t]() {
+              if ( !engines[t] )
+              {
+                engines[t].reset( new aig_npn_canonization_sat_engine( aig, num_words, seed ) );
+              }
+              return engines[t]->try_move( states[t], moves[pos + t] );
+            } ) );
+      }
+
+      auto first = batch;
+      for ( auto t = 0u; t < batch; ++t )
+      {
+        if ( results[t].get() && first == batch )
+        {
+          first = t;
+        }
+      }
+
+      if ( first == batch )
+      {
+        pos += batch;
+      }
+      else
+      {
+        state = states[first];
+        commit();
+        log_move( moves[pos + first], verbose );
+        improvement = true;
+        pos += first + 1u;
+      }
+    }
+
+    return improvement;
+  }
+
+  template<typename Fn>
+  void foreach_engine( Fn&& f ) const
+  {
+    for ( const auto& e : engines )
+    {
+      if ( e ) { f( *e ); }
+    }
+  }
+
+private:
+  bool try_move( const aig_npn_move_t& move )
+  {
+    if ( engines[0u]->try_move( state, move ) )
+    {
+      commit();
+      return true;
+    }
+    return false;
+  }
+
+  void commit()
+  {
+    phase = state.phase;
+    perm  = state.perm;
+  }
+
+  void log_move( const aig_npn_move_t& move, bool verbose ) const;
+
+private:
+  const aig_graph&                                              aig;
+  const aig_graph_info&                                         info;
+  boost::dynamic_bitset<>&                                      phase;
+  std::vector<unsigned>&                                        perm;
+  aig_npn_state_t                                               state;
+
+  unsigned                                                      num_threads = 1u;
+  unsigned                                                      num_words = 4u;
+  unsigned                                                      seed = 0xcafe;
+  std::vector<std::unique_ptr<aig_npn_canonization_sat_engine>> engines;
+  std::unique_ptr<thread_pool>                                  pool;
+};
+
+void log_npn_move( const aig_npn_move_t& move, unsigned n, bool verbose )
+{
+  switch ( move.kind )
+  {
+  case aig_npn_move_t::flip:
+    if ( move.i < n )
+    {
+      L( "[i]   flip input " << move.i );
+    }
+    else
+    {
+      L( "[i]   flip output" );
+    }
+    break;
+  case aig_npn_move_t::swap:
+    L( "[i]   swap inputs " << move.i << " and " << move.j );
+    break;
+  case aig_npn_move_t::sift:
+    break;
+  }
+}
+
+void aig_npn_canonization_incremental_manager::log_move( const aig_npn_move_t& move, bool verbose ) const
+{
+  log_npn_move( move, info.inputs.size(), verbose );
+}
+
+template<typename Manager>
+bool try_npn_move( Manager& mgr, const aig_npn_move_t& move )
+{
+  switch ( move.kind )
+  {
+  case aig_npn_move_t::flip: return mgr.try_flip( move.i );
+  case aig_npn_move_t::swap: return mgr.try_swap( move.i, move.j );
+  case aig_npn_move_t::sift:
+  default:                   return mgr.try_sift( move.i );
+  }
+}
+
+template<typename Manager>
+bool try_npn_moves( Manager& mgr, const std::vector<aig_npn_move_t>& moves, bool verbose )
+{
+  auto improvement = false;
+  for ( const auto& move : moves )
+  {
+    if ( try_npn_move( mgr, move ) )
+    {
+      log_npn_move( move, mgr.num_inputs(), verbose );
+      improvement = true;
+    }
+  }
+  return improvement;
+}
+
+bool try_npn_moves( aig_npn_canonization_incremental_manager& mgr, const std::vector<aig_npn_move_t>& moves, bool verbose )
+{
+  return mgr.try_moves( moves, verbose );
+}
+
 template<typename Manager>
 void fill_statistics( const Manager& mgr, const properties::ptr& statistics )
 {
@@ -755,6 +1357,27 @@ void fill_statistics( const Manager& mgr, const properties::ptr& statistics )
   set( statistics, "encoding_runtime", mgr.encoding_runtime );
 }
 
+void fill_statistics( const aig_npn_canonization_incremental_manager& mgr, const properties::ptr& statistics )
+{
+  auto lexsat_calls = 0ul, sat_calls = 0ul, sim_witnesses = 0ul;
+  auto runtime = 0.0, encoding_runtime = 0.0;
+
+  mgr.foreach_engine( [&]( const aig_npn_canonization_sat_engine& e ) {
+      lexsat_calls     += e.lexsat_calls;
+      sat_calls        += e.sat_calls;
+      sim_witnesses    += e.sim_witnesses;
+      runtime          += e.runtime;
+      encoding_runtime += e.encoding_runtime;
+    } );
+
+  set( statistics, "lexsat_calls", lexsat_calls );
+  set( statistics, "sat_calls", sat_calls );
+  set( statistics, "sim_witnesses", sim_witnesses );
+  set( statistics, "sat_runtime", runtime );
+  set( statistics, "miter_runtime", 0.0 );
+  set( statistics, "encoding_runtime", encoding_runtime );
+}
+
 template<typename Manager>
 void aig_npn_canonization_flip_swap_generic( const aig_graph& aig, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm,
                                              const properties::ptr& settings,
@@ -775,43 +1398,29 @@ void aig_npn_canonization_flip_swap_generic( const aig_graph& aig, boost::dynami
   auto improvement = true;
   auto round = 0u;
   const auto n = info.inputs.size();
-  while ( improvement )
-  {
-    L( "[i] round " << ++round );
 
-    improvement = false;
+  std::vector<aig_npn_move_t> moves;
 
-    /* input/output negation */
-    for ( auto i = 0u; i <= n; ++i )
+  /* input/output negation */
+  for ( auto i = 0u; i <= n; ++i )
+  {
+    moves.push_back( {aig_npn_move_t::flip, i, 0u} );
+  }
+
+  /* permute inputs */
+  for ( auto d = 1u; d < n - 1; ++d )
+  {
+    for ( auto i = 0u; i < n - d; ++i )
     {
-      if ( mgr.try_flip( i ) )
-      {
-        if ( i < n )
-        {
-          L( "[i]   flip input " << i );
-        }
-        else
-        {
-          L( "[i]   flip output" );
-        }
-        improvement = true;
-      }
+      moves.push_back( {aig_npn_move_t::swap, i, i + d} );
     }
+  }
 
-    /* permute inputs */
-    for ( auto d = 1u; d < n - 1; ++d )
-    {
-      for ( auto i = 0u; i < n - d; ++i )
-      {
-        auto j = i + d;
+  while ( improvement )
+  {
+    L( "[i] round " << ++round );
 
-        if ( mgr.try_swap( i, j ) )
-        {
-          L( "[i]   swap inputs " << i << " and " << j );
-          improvement = true;
-        }
-      }
-    }
+    improvement = try_npn_moves( mgr, moves, verbose );
   }
 
   fill_statistics( mgr, statistics );
@@ -845,20 +1454,19 @@ void aig_npn_canonization_sifting_generic( const aig_graph& aig, boost::dynamic_
     return;
   }
 
+  std::vector<aig_npn_move_t> forward_moves, backward_moves;
+  for ( auto i = 0u; i < n - 1; ++i )
+  {
+    forward_moves.push_back( {aig_npn_move_t::sift, i, 0u} );
+    backward_moves.push_back( {aig_npn_move_t::sift, static_cast<unsigned>( n - 2 - i ), 0u} );
+  }
+
   /* non-inverted function */
   while ( improvement )
   {
     L( "[i] round " << ++round );
 
-    improvement = false;
-
-    for ( int i = forward ? 0 : n - 2; forward ? i < static_cast<int>( n - 1 ) : i >= 0; forward ? ++i : --i )
-    {
-      if ( mgr.try_sift( i ) )
-      {
-        improvement = true;
-      }
-    }
+    improvement = try_npn_moves( mgr, forward ? forward_moves : backward_moves, verbose );
 
     forward = !forward;
   }
@@ -877,15 +1485,7 @@ void aig_npn_canonization_sifting_generic( const aig_graph& aig, boost::dynamic_
   {
     L( "[i] round " << ++round );
 
-    improvement = false;
-
-    for ( int i = forward ? 0 : n - 2; forward ? i < static_cast<int>( n - 1 ) : i >= 0; forward ? ++i : --i )
-    {
-      if ( mgr.try_sift( i ) )
-      {
-        improvement = true;
-      }
-    }
+    improvement = try_npn_moves( mgr, forward ? forward_moves : backward_moves, verbose );
 
     forward = !forward;
   }
@@ -923,6 +1523,20 @@ void aig_npn_canonization_sifting_shared_miter( const aig_graph& aig, boost::dyn
   aig_npn_canonization_sifting_generic<aig_npn_canonization_shared_miter_manager>( aig, phase, perm, settings, statistics );
 }
 
+void aig_npn_canonization_flip_swap_incremental( const aig_graph& aig, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm,
+                                                 const properties::ptr& settings,
+                                                 const properties::ptr& statistics )
+{
+  aig_npn_canonization_flip_swap_generic<aig_npn_canonization_incremental_manager>( aig, phase, perm, settings, statistics );
+}
+
+void aig_npn_canonization_sifting_incremental( const aig_graph& aig, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm,
+                                               const properties::ptr& settings,
+                                               const properties::ptr& statistics )
+{
+  aig_npn_canonization_sifting_generic<aig_npn_canonization_incremental_manager>( aig, phase, perm, settings, statistics );
+}
+
 aig_graph aig_npn_canonization( const aig_graph& aig,
                                 const properties::ptr& settings,
                                 const properties::ptr& statistics )
@@ -930,7 +1544,7 @@ aig_graph aig_npn_canonization( const aig_graph& aig,
   /* settings */
   const auto verbose   = get( settings, "verbose",   false );
   const auto progress  = get( settings, "progress",  false );
-  const auto miter     = get( settings, "miter",     0u );    /* 0: single, 1: shared */
+  const auto miter     = get( settings, "miter",     0u );    /* 0: single, 1: shared, 2: incremental */
   const auto heuristic = get( settings, "heuristic", 0u );    /* 0: flip-swap, 1: sifting */
 
   /* timining */
@@ -993,10 +1607,14 @@ aig_graph aig_npn_canonization( const aig_graph& aig,
         {
           aig_npn_canonization_flip_swap( cone, phase, perm, settings, anc_statistics );
         }
-        else
+        else if ( miter == 1u )
         {
           aig_npn_canonization_flip_swap_shared_miter( cone, phase, perm, settings, anc_statistics );
         }
+        else
+        {
+          aig_npn_canonization_flip_swap_incremental( cone, phase, perm, settings, anc_statistics );
+        }
       }
       else
       {
@@ -1004,10 +1622,14 @@ aig_graph aig_npn_canonization( const aig_graph& aig,
         {
           aig_npn_canonization_sifting( cone, phase, perm, settings, anc_statistics );
         }
-        else
+        else if ( miter == 1u )
         {
           aig_npn_canonization_sifting_shared_miter( cone, phase, perm, settings, anc_statistics );
         }
+        else
+        {
+          aig_npn_canonization_sifting_incremental( cone, phase, perm, settings, anc_statistics );
+        }
       }
 
       lexsat_calls += anc_statistics->get<unsigned long>( "lexsat_calls" );
@@ -66,6 +66,16 @@ void aig_npn_canonization_sifting_shared_miter( const aig_graph& aig, boost::dyn
                                                 const properties::ptr& settings = properties::ptr(),
                                                 const properties::ptr& statistics = properties::ptr() );
 
+/* requires a single-output AIG; uses one incremental solver (settings: num_threads, num_words, seed) */
+void aig_npn_canonization_flip_swap_incremental( const aig_graph& aig, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm,
+                                                 const properties::ptr& settings = properties::ptr(),
+                                                 const properties::ptr& statistics = properties::ptr() );
+
+/* requires a single-output AIG; uses one incremental solver (settings: num_threads, num_words, seed) */
+void aig_npn_canonization_sifting_incremental( const aig_graph& aig, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm,
+                                               const properties::ptr& settings = properties::ptr(),
+                                               const properties::ptr& statistics = properties::ptr() );
+
 /* canonicizes all outputs and builds a new AIG */
 aig_graph aig_npn_canonization( const aig_graph& aig,
                                 const properties::ptr& settings = properties::ptr(),
@@ -27,10 +27,13 @@
 #include "lad2.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <deque>
 #include <fstream>
 #include <functional>
 #include <iostream>
+#include <mutex>
+#include <numeric>
 #include <unordered_set>
 #include <vector>
 #include <stack>
@@ -46,6 +49,7 @@
 #include <core/utils/bitset_utils.hpp>
 #include <core/utils/range_utils.hpp>
 #include <core/utils/string_utils.hpp>
+#include <core/utils/thread_pool.hpp>
 #include <core/utils/timer.hpp>
 
 #include <classical/aig.hpp>
@@ -77,6 +81,21 @@ using vec_vec_int_t     = std::vector<vec_int_t>;
 using bitset_pair_vec_t = std::vector<std::pair<boost::dynamic_bitset<>, boost::dynamic_bitset<>>>;
 using bitset_vec_t      = std::vector<boost::dynamic_bitset<>>;
 
+/* scratch memory for update_matching (one instance per search thread) */
+struct lad2_matching_buffers
+{
+  vec_int_t matched_with_v, nb_pred, first_pred, pred, nb_succ, succ;
+  vec_int_t list_v, list_u, list_dv, list_du, marked_v, marked_u, unmatched, pos_in_unmatched;
+};
+
+/* scratch memory for ensure_gac_all_diff; pred and succ are stored in
+   compressed form, pred[u] in pred[first_pred[u]..first_pred[u + 1]) */
+struct lad2_gac_buffers
+{
+  vec_int_t first_pred, pred, first_succ, succ, pos, numv, numu, list;
+  bitset_vec_t used;
+};
+
 /******************************************************************************
  * Graph                                                                      *
  ******************************************************************************/
@@ -164,6 +183,7 @@ lad2_domain::lad2_domain( const simulation_graph_wrapper& gp, const simulation_g
   pos_in_val.resize( gp.size(), vec_int_t( gt.size() ) );
   marked_to_filter.resize( gp.size(), true );
   to_filter.resize( gp.size() );
+  dom.resize( gp.size(), boost::dynamic_bitset<>( gt.size() ) );
 
   /* initialize */
   auto val_size = 0;
@@ -182,6 +202,7 @@ lad2_domain::lad2_domain( const simulation_graph_wrapper& gp, const simulation_g
       {
         matching.reserve( u, v, gp.degree( u ) );
         val += v;
+        dom[u].set( v );
         nb_val[u]++;
         pos_in_val[u][v] = val_size++;
       }
@@ -301,20 +322,23 @@ void lad2_domain::dump( const std::string& filename )
 
 struct lad2_manager
 {
-  lad2_manager( const aig_graph& target, const aig_graph& pattern,
-                const std::vector<unsigned>& types,
-                bool functional, bool support_edges, const boost::optional<unsigned>& simulation_signatures,
+  lad2_manager( const simulation_graph_wrapper& gt, const simulation_graph_wrapper& gp,
+                bool functional, const boost::optional<unsigned>& simulation_signatures,
                 const std::string& texlogname, bool verbose )
-    : gp( pattern, types, support_edges, simulation_signatures ),
-      gt( target, types, support_edges, simulation_signatures ),
+    : gp( gp ),
+      gt( gt ),
       d( gp, gt, simulation_signatures, functional ),
       verbose( verbose ),
-      num( gt.size() ),
+      num( gt.size(), -1 ),
       num_inv( gt.size() ),
       nb_comp( gp.size() ),
       first_comp( gp.size() ),
-      matched_with_u( gp.size() )
+      matched_with_u( gp.size() ),
+      keep( gt.size() ),
+      scratch( gt.size() )
   {
+    gac.used.resize( gp.size(), boost::dynamic_bitset<>( gt.size() ) );
+
     if ( verbose )
     {
       std::cout << format( "[i] target graph has %d vertices" ) % gt.size() << std::endl
@@ -341,29 +365,46 @@ struct lad2_manager
   bool check_lad( int u, int v );
   bool filter();
   bool solve( unsigned& nb_sol, std::vector<unsigned>& mapping );
+  bool solve_parallel( int u, const vec_int_t& val, const vec_int_t& nb_val, const vec_int_t& global_matching,
+                       unsigned& nb_sol, std::vector<unsigned>& mapping );
   bool start_lad( std::vector<unsigned>& mapping );
 
+  inline bool stopped() const
+  {
+    return stop && stop->load();
+  }
+
   void list_target_image( std::ostream& os );
   std::tuple<unsigned, unsigned, unsigned> target_image_size();
   void list_with_names( std::ostream& os, bool only_inputs = true );
 
-  simulation_graph_wrapper gp;
-  simulation_graph_wrapper gt;
+  const simulation_graph_wrapper& gp;
+  const simulation_graph_wrapper& gt;
   lad2_domain d;
   bool verbose;
 
-  /* for check_lad */
+  /* for check_lad (num[v] is -1 for all v between calls) */
   vec_int_t num;
   vec_int_t num_inv;
   vec_int_t nb_comp;
   vec_int_t first_comp;
   vec_int_t comp;
   vec_int_t matched_with_u;
+  lad2_matching_buffers matching_buffers;
+
+  /* for match_vertices and ensure_gac_all_diff */
+  boost::dynamic_bitset<> keep;
+  boost::dynamic_bitset<> scratch;
+  lad2_gac_buffers gac;
 
   /* special settings */
   domain_hook_t on_before_first_branch;
   domain_hook_t on_filter;
 
+  /* parallel search, first solution found by any thread sets stop */
+  unsigned num_threads = 1u;
+  const std::atomic<bool>* stop = nullptr;
+
   /* statistics */
   unsigned num_branches = 0u;
 };
@@ -391,30 +432,52 @@ inline void erase_and_replace( vec_int_t& v, unsigned i )
   v.pop_back();
 }
 
-bool update_matching( int size_of_u, int size_of_v, const vec_int_t& degree, const vec_int_t& first_adj, const vec_int_t& adj, vec_int_t& matched_with_u )
+bool update_matching( int size_of_u, int size_of_v, const vec_int_t& degree, const vec_int_t& first_adj, const vec_int_t& adj, vec_int_t& matched_with_u,
+                      lad2_matching_buffers& buf )
 {
   if ( size_of_u > size_of_v ) return false;
 
-  static vec_int_t matched_with_v, nb_pred, nb_succ, list_v, list_u, list_dv, list_du, marked, marked_v, marked_u, unmatched, pos_in_unmatched;
-  static vec_vec_int_t pred, succ;
+  auto& matched_with_v = buf.matched_with_v;
+  auto& nb_pred = buf.nb_pred;
+  auto& first_pred = buf.first_pred;
+  auto& pred = buf.pred;
+  auto& nb_succ = buf.nb_succ;
+  auto& succ = buf.succ;
+  auto& list_v = buf.list_v;
+  auto& list_u = buf.list_u;
+  auto& list_dv = buf.list_dv;
+  auto& list_du = buf.list_du;
+  auto& marked_v = buf.marked_v;
+  auto& marked_u = buf.marked_u;
+  auto& unmatched = buf.unmatched;
+  auto& pos_in_unmatched = buf.pos_in_unmatched;
 
-  matched_with_v.resize( size_of_v );
-  boost::fill( matched_with_v, -1 );
+  int nbv, nbu, nbdv, nbdu;
+  int i, j, k, u, v;
+  bool stop;
+
+  /* succ[u] is a subset of adj[u] and pred[v] a subset of the vertices
+     adjacent to v, which bounds their sizes */
+  first_pred.assign( size_of_v + 1, 0 );
+  for ( u = 0; u < size_of_u; ++u )
+  {
+    for ( i = first_adj[u]; i < first_adj[u] + degree[u]; ++i )
+    {
+      ++first_pred[adj[i] + 1];
+    }
+  }
+  std::partial_sum( first_pred.begin(), first_pred.end(), first_pred.begin() );
+
+  matched_with_v.assign( size_of_v, -1 );
   nb_pred.resize( size_of_v );
-  pred.clear();
-  pred.resize( size_of_v, vec_int_t( size_of_u ) );
+  pred.resize( first_pred[size_of_v] );
   nb_succ.resize( size_of_u );
-  succ.clear();
-  succ.resize( size_of_u, vec_int_t( size_of_v ) );
+  succ.resize( adj.size() );
   list_v.resize( size_of_v );
   list_u.resize( size_of_u );
   list_dv.resize( size_of_v );
   list_du.resize( size_of_u );
 
-  int nbv, nbu, nbdv, nbdu;
-  int i, j, k, u, v;
-  bool stop;
-
   marked_v.resize( size_of_v );
   marked_u.resize( size_of_u );
   unmatched.clear();
@@ -466,8 +529,8 @@ bool update_matching( int size_of_u, int size_of_v, const vec_int_t& degree, con
       for ( i = first_adj[u]; i < first_adj[u] + degree[u]; ++i )
       {
         v = adj[i];
-        pred[v][nb_pred[v]++] = u;
-        succ[u][nb_succ[u]++] = v;
+        pred[first_pred[v] + nb_pred[v]++] = u;
+        succ[first_adj[u] + nb_succ[u]++] = v;
         if ( marked_v[v] == white )
         {
           marked_v[v] = gray;
@@ -500,8 +563,8 @@ bool update_matching( int size_of_u, int size_of_v, const vec_int_t& degree, con
           v = adj[i];
           if ( marked_v[v] != black )
           {
-            pred[v][nb_pred[v]++] = u;
-            succ[u][nb_succ[u]++] = v;
+            pred[first_pred[v] + nb_pred[v]++] = u;
+            succ[first_adj[u] + nb_succ[u]++] = v;
             if ( marked_v[v] == white )
             {
               marked_v[v] = gray;
@@ -529,7 +592,7 @@ bool update_matching( int size_of_u, int size_of_v, const vec_int_t& degree, con
         add_to_delete( v, list_dv, &nbdv, marked_v );
         do
         {
-          u = pred[v][0];
+          u = pred[first_pred[v]];
           path.push( u );
           add_to_delete( u, list_du, &nbdu, marked_u );
           if ( matched_with_u[u] != -1 )
@@ -553,9 +616,10 @@ bool update_matching( int size_of_u, int size_of_v, const vec_int_t& degree, con
             }
             for ( i = 0; i < nb_pred[v]; ++i )
             {
-              u = pred[v][i];
-              j = 0; while ( j < nb_succ[u] && v != succ[u][j] ) { ++j; }
-              succ[u][j] = succ[u][--nb_succ[u]];
+              u = pred[first_pred[v] + i];
+              const auto s = first_adj[u];
+              j = 0; while ( j < nb_succ[u] && v != succ[s + j] ) { ++j; }
+              succ[s + j] = succ[s + --nb_succ[u]];
               if ( nb_succ[u] == 0 )
               {
                 add_to_delete( u, list_du, &nbdu, marked_u );
@@ -574,9 +638,10 @@ bool update_matching( int size_of_u, int size_of_v, const vec_int_t& degree, con
             j = 0;
             for ( i = 0; i < nb_succ[u]; ++i )
             {
-              v = succ[u][i];
-              j = 0; while ( j < nb_pred[v] && u != pred[v][j] ) { ++j; }
-              pred[v][j] = pred[v][--nb_pred[v]];
+              v = succ[first_adj[u] + i];
+              const auto p = first_pred[v];
+              j = 0; while ( j < nb_pred[v] && u != pred[p + j] ) { ++j; }
+              pred[p + j] = pred[p + --nb_pred[v]];
               if ( nb_pred[v] == 0 )
               {
                 add_to_delete( v, list_dv, &nbdv, marked_v );
@@ -603,23 +668,23 @@ bool update_matching( int size_of_u, int size_of_v, const vec_int_t& degree, con
   return true;
 }
 
-void lad2_dfs( int nbu, int nbv, int u, std::vector<char>& marked, const vec_int_t& nb_succ, const vec_vec_int_t& succ, const vec_int_t& matched_with_u, vec_int_t& order, int* nb )
+void lad2_dfs( int nbu, int nbv, int u, std::vector<char>& marked, const vec_int_t& first_succ, const vec_int_t& succ, const vec_int_t& matched_with_u, vec_int_t& order, int* nb )
 {
   marked[u] = 1;
   int v = matched_with_u[u];
-  for ( int i = 0; i < nb_succ[v]; ++i )
+  for ( int i = first_succ[v]; i < first_succ[v + 1]; ++i )
   {
-    if ( !marked[succ[v][i]] )
+    if ( !marked[succ[i]] )
     {
-      lad2_dfs( nbu, nbv, succ[v][i], marked, nb_succ, succ, matched_with_u, order, nb );
+      lad2_dfs( nbu, nbv, succ[i], marked, first_succ, succ, matched_with_u, order, nb );
     }
   }
   order[*nb] = u; (*nb)--;
 }
 
 void lad2_scc( int nbu, int nbv, vec_int_t& numv, vec_int_t& numu,
-               const vec_int_t& nb_succ, const vec_vec_int_t& succ,
-               const vec_int_t& nb_pred, const vec_vec_int_t& pred,
+               const vec_int_t& first_succ, const vec_int_t& succ,
+               const vec_int_t& first_pred, const vec_int_t& pred,
                const vec_int_t& matched_with_u, const vec_int_t& matched_with_v )
 {
   vec_int_t order( nbu );
@@ -632,7 +697,7 @@ void lad2_scc( int nbu, int nbv, vec_int_t& numv, vec_int_t& numu,
   {
     if ( !marked[u] )
     {
-      lad2_dfs( nbu, nbv, u, marked, nb_succ, succ, matched_with_u, order, &nb );
+      lad2_dfs( nbu, nbv, u, marked, first_succ, succ, matched_with_u, order, &nb );
     }
   }
 
@@ -656,9 +721,9 @@ void lad2_scc( int nbu, int nbv, vec_int_t& numv, vec_int_t& numu,
         if ( u != -1 )
         {
           numu[u] = nb_scc;
-          for ( j = 0; j < nb_pred[u]; ++j )
+          for ( j = first_pred[u]; j < first_pred[u + 1]; ++j )
           {
-            v = pred[u][j];
+            v = pred[j];
             if ( numv[v] == -1 )
             {
               numv[v] = nb_scc;
@@ -685,6 +750,8 @@ bool lad2_manager::remove_all_values_but_one( int u, int v )
   d.pos_in_val[u][d.val[new_pos]] = new_pos;
   d.pos_in_val[u][d.val[old_pos]] = old_pos;
   d.nb_val[u] = 1;
+  d.dom[u].reset();
+  d.dom[u].set( v );
   if ( d.global_matching_p[u] != v )
   {
     d.global_matching_t[d.global_matching_p[u]] = -1;
@@ -707,6 +774,7 @@ bool lad2_manager::remove_value( int u, int v )
   d.val[new_pos] = v;
   d.pos_in_val[u][d.val[old_pos]] = old_pos;
   d.pos_in_val[u][d.val[new_pos]] = new_pos;
+  d.dom[u].reset( v );
   if ( d.global_matching_p[u] == v )
   {
     d.global_matching_p[u] = -1;
@@ -718,7 +786,8 @@ bool lad2_manager::remove_value( int u, int v )
 
 bool lad2_manager::match_vertices( stack_int_t& to_be_matched )
 {
-  int j, u, v, u2, old_nb_val;
+  int u, v, u2, old_nb_val;
+  unsigned dir, label;
   while ( !to_be_matched.empty() )
   {
     u = to_be_matched.top();
@@ -730,25 +799,33 @@ bool lad2_manager::match_vertices( stack_int_t& to_be_matched )
       {
         old_nb_val = d.nb_val[u2];
         if ( d.is_in_domain( u2, v ) && !remove_value( u2, v ) ) { return false; }
-        if ( gp.edge_direction( u, u2 ) != 0 )
+        if ( ( dir = gp.edge_direction( u, u2 ) ) != 0 )
         {
-          j = d.first_val[u2];
-          while ( j < d.first_val[u2] + d.nb_val[u2] )
+          /* keep only the neighbors of v that are connected by a compatible edge */
+          label = gp.edge_label( u, u2 );
+          keep.reset();
+          for ( const auto& v2 : gt.adjacent( v ) )
+          {
+            if ( compatible_edge_labels( label, gt.edge_label( v, v2 ) ) && is_compatible( dir, gt.edge_direction( v, v2 ) ) )
+            {
+              keep.set( v2 );
+            }
+          }
+          scratch = d.dom[u2];
+          scratch -= keep;
+          for ( auto v2 = scratch.find_first(); v2 != boost::dynamic_bitset<>::npos; v2 = scratch.find_next( v2 ) )
           {
-            if ( compatible_edge_labels( gp.edge_label( u, u2 ), gt.edge_label( v, d.val[j] ) ) && is_compatible( gp.edge_direction( u, u2 ), gt.edge_direction( v, d.val[j] ) ) ) { ++j; }
-            else if ( !remove_value( u2, d.val[j] ) ) { return false; }
+            if ( !remove_value( u2, v2 ) ) { return false; }
           }
         }
         /* INDUCED */
         else // (u,u2) is not an edge => remove neighbors of v from D[u2]
         {
-					j = d.first_val[u2];
-					while ( j < d.first_val[u2] + d.nb_val[u2] )
+          for ( const auto& v2 : gt.adjacent( v ) )
           {
-						if ( gt.edge_direction( v, d.val[j] ) == 0) { ++j; }
-						else if ( !remove_value( u2, d.val[j] ) ) { return false; }
-					}
-				}
+            if ( d.is_in_domain( u2, v2 ) && !remove_value( u2, v2 ) ) { return false; }
+          }
+        }
 
         if ( d.nb_val[u2] == 0 ) { return false; }
         if ( d.nb_val[u2] == 1 && old_nb_val > 1 )
@@ -764,31 +841,54 @@ bool lad2_manager::match_vertices( stack_int_t& to_be_matched )
 
 bool lad2_manager::ensure_gac_all_diff()
 {
-  vec_int_t nb_pred( gp.size() );
-  vec_vec_int_t pred( gp.size(), vec_int_t( gt.size() ) );
-  vec_int_t nb_succ( gt.size() );
-  vec_vec_int_t succ( gt.size(), vec_int_t( gp.size() ) );
+  const int nbu = gp.size();
+  const int nbv = gt.size();
+  auto& first_pred = gac.first_pred;
+  auto& pred = gac.pred;
+  auto& first_succ = gac.first_succ;
+  auto& succ = gac.succ;
+  auto& numv = gac.numv;
+  auto& numu = gac.numu;
+  auto& list = gac.list;
+  auto& used = gac.used;
   int u, v, i, w, old_nb_val;
-  vec_int_t numv( gt.size() ), numu( gp.size() );
   stack_int_t to_match;
-  std::vector<std::vector<char>> used( gp.size(), std::vector<char>( gt.size() ) );
-  for ( u = 0; u < static_cast<int>( gp.size() ); ++u )
+
+  /* pred[u] = D(u) without the matched value, succ[v] is its transpose */
+  first_pred.resize( nbu + 1 );
+  first_succ.assign( nbv + 1, 0 );
+  pred.clear();
+  for ( u = 0; u < nbu; ++u )
   {
-    for ( i = 0; i < d.nb_val[u]; ++i )
+    first_pred[u] = pred.size();
+    used[u].reset();
+    for ( const auto& v : d.get( u ) )
     {
-      v = d.val[d.first_val[u] + i];
-      used[u][v] = 0;
       if ( v != d.global_matching_p[u] )
       {
-        pred[u][nb_pred[u]++] = v;
-        succ[v][nb_succ[v]++] = u;
+        pred += v;
+        ++first_succ[v + 1];
       }
     }
   }
+  first_pred[nbu] = pred.size();
+  std::partial_sum( first_succ.begin(), first_succ.end(), first_succ.begin() );
 
-  vec_int_t list( gt.size() );
+  gac.pos.assign( first_succ.begin(), first_succ.end() - 1 );
+  succ.resize( pred.size() );
+  for ( u = 0; u < nbu; ++u )
+  {
+    for ( i = first_pred[u]; i < first_pred[u + 1]; ++i )
+    {
+      succ[gac.pos[pred[i]]++] = u;
+    }
+  }
+
+  numv.assign( nbv, 0 );
+  numu.assign( nbu, 0 );
+  list.resize( nbv );
   int nb = 0;
-  for ( v = 0; v < static_cast<int>( gt.size() ); ++v )
+  for ( v = 0; v < nbv; ++v )
   {
     if ( d.global_matching_t[v] < 0 )
     {
@@ -796,37 +896,37 @@ bool lad2_manager::ensure_gac_all_diff()
       numv[v] = 1;
     }
   }
-	while ( nb > 0 )
+  while ( nb > 0 )
   {
-		v = list[--nb];
-		for ( i = 0; i < nb_succ[v]; ++i)
+    v = list[--nb];
+    for ( i = first_succ[v]; i < first_succ[v + 1]; ++i )
     {
-			u = succ[v][i];
-			used[u][v] = 1;
-			if (numu[u] == 0)
+      u = succ[i];
+      used[u].set( v );
+      if ( numu[u] == 0 )
       {
-				numu[u] = 1;
-				w = d.global_matching_p[u];
-				used[u][w] = 1;
-				if ( numv[w] == 0 )
+        numu[u] = 1;
+        w = d.global_matching_p[u];
+        used[u].set( w );
+        if ( numv[w] == 0 )
         {
-					list[nb++] = w;
-					numv[w] = 1;
-				}
-			}
-		}
-	}
+          list[nb++] = w;
+          numv[w] = 1;
+        }
+      }
+    }
+  }
 
-  lad2_scc( gp.size(), gt.size(), numv, numu,
-            nb_succ, succ, nb_pred, pred, d.global_matching_p, d.global_matching_t );
+  lad2_scc( nbu, nbv, numv, numu,
+            first_succ, succ, first_pred, pred, d.global_matching_p, d.global_matching_t );
 
-  for ( u = 0; u < static_cast<int>( gp.size() ); ++u )
+  for ( u = 0; u < nbu; ++u )
   {
     old_nb_val = d.nb_val[u];
-		for ( i = 0; i < d.nb_val[u]; ++i)
+    for ( i = 0; i < d.nb_val[u]; ++i )
     {
       v = d.val[d.first_val[u] + i];
-      if ( !used[u][v] && numv[v] != numu[u] && d.global_matching_p[u] != v )
+      if ( !used[u].test( v ) && numv[v] != numu[u] && d.global_matching_p[u] != v )
       {
         if ( !remove_value( u, v ) )
         {
@@ -839,8 +939,8 @@ bool lad2_manager::ensure_gac_all_diff()
     {
       to_match.push( u );
     }
-	}
-	return match_vertices( to_match );
+  }
+  return match_vertices( to_match );
 }
 
 /******************************************************************************
@@ -886,9 +986,10 @@ bool lad2_manager::check_lad( int u, int v )
 
   comp.resize( gp.degree( u ) * gt.size() );
 
-  boost::fill( num, -1 );
-
   int nb_num = 0;
+  const auto clear_num = [this, &nb_num]() {
+    for ( auto i = 0; i < nb_num; ++i ) { num[num_inv[i]] = -1; }
+  };
   int pos_in_comp = 0;
   idx = 0u;
   for ( const auto& u2 : gp.adjacent( u ) )
@@ -927,7 +1028,7 @@ bool lad2_manager::check_lad( int u, int v )
         }
       }
     }
-    if ( nb_comp[idx] == 0 ) { return false; }
+    if ( nb_comp[idx] == 0 ) { clear_num(); return false; }
     auto v2 = d.matching( u, v, idx );
     if ( v2 != -1 && d.is_in_domain( u2, v2 ) )
     {
@@ -940,7 +1041,9 @@ bool lad2_manager::check_lad( int u, int v )
     ++idx;
   }
 
-  if ( !update_matching( gp.degree( u ), nb_num, nb_comp, first_comp, comp, matched_with_u ) )
+  clear_num();
+
+  if ( !update_matching( gp.degree( u ), nb_num, nb_comp, first_comp, comp, matched_with_u, matching_buffers ) )
   {
     return false;
   }
@@ -1050,9 +1153,14 @@ bool lad2_manager::solve( unsigned& nb_sol, std::vector<unsigned>& mapping )
         return false;
       }
     }
+
+    if ( num_threads > 1u && val.size() > 1u )
+    {
+      return solve_parallel( min_dom, val, nb_val, global_matching, nb_sol, mapping );
+    }
   }
 
-  for ( i = 0; i < nb_val[min_dom] && nb_sol == 0; ++i )
+  for ( i = 0; i < nb_val[min_dom] && nb_sol == 0 && !stopped(); ++i )
   {
     v = val[i];
     num_branches++;
@@ -1080,21 +1188,103 @@ bool lad2_manager::solve( unsigned& nb_sol, std::vector<unsigned>& mapping )
     {
       std::cout << format( "End of branch %d=%d" ) % min_dom % v << std::endl;
     }
-    boost::fill( d.global_matching_t, -1 );
-    // TODO use boost::copy
-    for ( const auto& u : gp.vertices() )
+    d.restore( nb_val, global_matching );
+  }
+  return true;
+}
+
+/*
+ * Splits the branches on u = val[i] among num_threads copies of this
+ * manager.  Each thread fetches the next unexplored value from a shared
+ * counter and searches its subtree sequentially.  The first thread that
+ * finds a solution stops all others, as does a thread whose search times
+ * out, in which case false is returned as in the sequential search.
+ *
+ * Whether a solution is found does not depend on the number of threads,
+ * but the returned mapping and num_branches do: they depend on which
+ * thread finds its solution first.
+ */
+bool lad2_manager::solve_parallel( int u, const vec_int_t& val, const vec_int_t& nb_val, const vec_int_t& global_matching,
+                                   unsigned& nb_sol, std::vector<unsigned>& mapping )
+{
+  std::atomic<unsigned> next( 0u );
+  std::atomic<bool> done( false ); /* solution found or timeout */
+  std::mutex result_mutex;
+  auto found = false, timeout = false;
+
+  const auto worker = [&]() {
+    /* copy of the domain after the root has been filtered */
+    lad2_manager mgr( *this );
+    mgr.num_threads = 1u;
+    mgr.stop = &done;
+    mgr.on_before_first_branch = boost::none;
+    mgr.num_branches = 0u;
+
+    unsigned local_nb_sol = 0u, i;
+    std::vector<unsigned> local_mapping;
+
+    while ( !done && ( i = next++ ) < val.size() )
+    {
+      ++mgr.num_branches;
+      if ( !mgr.remove_all_values_but_one( u, val[i] ) || !mgr.match_vertex( u ) )
+      {
+        mgr.d.reset_to_filter( gp.size() );
+      }
+      else if ( !mgr.solve( local_nb_sol, local_mapping ) )
+      {
+        std::lock_guard<std::mutex> lock( result_mutex );
+        timeout = true;
+        done = true;
+        break;
+      }
+      else if ( local_nb_sol > 0u )
+      {
+        std::lock_guard<std::mutex> lock( result_mutex );
+        if ( !found )
+        {
+          mapping = local_mapping;
+          found = true;
+        }
+        done = true;
+      }
+      mgr.d.restore( nb_val, global_matching );
+    }
+
+    return mgr.num_branches;
+  };
+
+  {
+    thread_pool pool( num_threads );
+    std::vector<std::future<unsigned>> branches;
+    for ( auto t = 0u; t < num_threads; ++t )
+    {
+      branches.push_back( pool.enqueue( worker ) );
+    }
+    for ( auto& f : branches )
     {
-      d.nb_val[u] = nb_val[u];
-      d.global_matching_p[u] = global_matching[u];
-      d.global_matching_t[global_matching[u]] = u;
+      num_branches += f.get();
     }
   }
+
+  if ( found )
+  {
+    ++nb_sol;
+  }
+  else if ( timeout )
+  {
+    if ( verbose )
+    {
+      std::cout << "[i] timeout" << std::endl;
+    }
+    return false;
+  }
+  d.reset_to_filter( gp.size() );
   return true;
 }
 
 bool lad2_manager::start_lad( std::vector<unsigned>& mapping )
 {
-  if ( !update_matching( gp.size(), gt.size(), d.nb_val, d.first_val, d.val, d.global_matching_p ) )
+  if ( !update_matching( gp.size(), gt.size(), d.nb_val, d.first_val, d.val, d.global_matching_p, matching_buffers ) )
   {
     return false;
   }
@@ -1197,13 +1387,18 @@ bool directed_lad2_from_aig( std::vector<unsigned>& mapping, const aig_graph& ta
   const auto on_filter                = get( settings, "on_filter",                domain_hook_t() );
   const auto on_before_first_branch   = get( settings, "on_before_first_branch",   domain_hook_t() );
   const auto texlogname               = get( settings, "texlogname",               std::string( "/tmp/log.tex" ) );
+  const auto num_threads              = get( settings, "num_threads",              1u );
 
   /* Timer */
   properties_timer t( statistics );
 
-  lad2_manager mgr( target, pattern, types, functional, support_edges, simulation_signatures, texlogname, false /*verbose*/ );
+  simulation_graph_wrapper gp( pattern, types, support_edges, simulation_signatures );
+  simulation_graph_wrapper gt( target, types, support_edges, simulation_signatures );
+
+  lad2_manager mgr( gt, gp, functional, simulation_signatures, texlogname, false /*verbose*/ );
   mgr.on_before_first_branch = on_before_first_branch;
-  mgr.on_filter              = on_filter;
+  mgr.on_filter              = on_filter; /* called from worker threads if num_threads > 1 */
+  mgr.num_threads            = num_threads;
   auto result = mgr.start_lad( mapping );
 
   set( statistics, "num_branches", mgr.num_branches );
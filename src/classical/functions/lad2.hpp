@@ -41,6 +41,7 @@
 #ifndef LAD2_HPP
 #define LAD2_HPP
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -105,6 +106,9 @@ struct lad2_domain
   std::vector<int> global_matching_p;
   std::vector<int> global_matching_t;
 
+  /* D(u) as bitset over target vertices, kept in sync with val */
+  std::vector<boost::dynamic_bitset<>> dom;
+
   lad2_domain( const simulation_graph_wrapper& gp, const simulation_graph_wrapper& gt, const boost::optional<unsigned>& simulation_signatures, bool functional_support_constraints );
 
   inline value_range_t get( unsigned u ) const
@@ -169,6 +173,23 @@ struct lad2_domain
     return pos_in_val[u][v] < first_val[u] + nb_val[u];
   }
 
+  /* undo all removals since old_nb_val was saved (values removed from a
+     domain are kept behind its end in val) */
+  inline void restore( const std::vector<int>& old_nb_val, const std::vector<int>& old_matching_p )
+  {
+    std::fill( global_matching_t.begin(), global_matching_t.end(), -1 );
+    for ( auto u = 0u; u < nb_val.size(); ++u )
+    {
+      for ( auto i = first_val[u] + nb_val[u]; i < first_val[u] + old_nb_val[u]; ++i )
+      {
+        dom[u].set( val[i] );
+      }
+      nb_val[u] = old_nb_val[u];
+      global_matching_p[u] = old_matching_p[u];
+      global_matching_t[old_matching_p[u]] = u;
+    }
+  }
+
   bool augmenting_path( int u, int nbv );
 
   void dump( const std::string& filename );
@@ -181,6 +202,9 @@ using domain_hook_t = boost::optional<domain_func_t>;
  * Functions                                                                  *
  ******************************************************************************/
 
+/* with num_threads > 1 the root branches are searched in parallel; whether a
+ * mapping is found does not depend on num_threads, but the returned mapping
+ * and num_branches may differ between runs */
 bool directed_lad2_from_aig( std::vector<unsigned>& mapping, const aig_graph& target, const aig_graph& pattern, const std::vector<unsigned>& types,
                              const properties::ptr& settings = properties::ptr(),
                              const properties::ptr& statistics = properties::ptr() );
@@ -26,7 +26,10 @@
 
 #include "linear_classification.hpp"
 
+#include <array>
 #include <cassert>
+#include <unordered_map>
+#include <vector>
 
 #include <algorithm>
 
@@ -41,17 +44,286 @@ namespace cirkit
  * Types                                                                      *
  ******************************************************************************/
 
+/*
+ * Canonical form search for up to 6 variables
+ *
+ * Instead of enumerating all matrices, the search builds the transformed
+ * truth table block by block.  A leaf is an ordered list of 2^n points
+ * p[i] = b ^ A i and its table is T(i) = f(p[i]).  The first point b is
+ * chosen in the first level, then every level adds a column a_k which
+ * doubles the points and appends a block of 2^(k-1) bits to T.  Only
+ * columns that yield the lexicographically smallest block (comparing from
+ * the least significant bit) are explored, and subtrees whose prefix
+ * exceeds the best leaf are pruned.
+ *
+ * Since T(~i) = f(b ^ A 1 ^ A i), reversing the bit order of T maps the
+ * set of leaves onto the affine class, and the reversed smallest leaf is
+ * the numerically smallest class member.  For the linear class b is fixed
+ * to A 1: the search chooses s = A 1 first and then a_1, ..., a_{n-1}
+ * such that s is not in their span, which forces a_n = s ^ a_1 ^ ... ^
+ * a_{n-1}.
+ *
+ * Functions with many symmetries have many equal leaves.  Two equal leaves
+ * define an automorphism of f, which is stored as a point permutation.  It
+ * is used to skip the remaining subtree of the later leaf and to skip
+ * sibling columns that lie in the same orbit under all automorphisms that
+ * fix the current points.
+ */
+class linear_canonization_manager
+{
+public:
+  linear_canonization_manager( uint64_t func, unsigned num_vars, bool affine )
+    : num_vars( num_vars ),
+      size( 1u << num_vars ),
+      all( num_vars == 6u ? ~uint64_t( 0 ) : ( ( uint64_t( 1 ) << size ) - 1u ) ),
+      affine( affine )
+  {
+    /* translations[p] has bit c set, if and only if f(p ^ c) = 1 */
+    translations[0u] = func;
+    for ( auto p = 1u; p < size; ++p )
+    {
+      translations[p] = stt_flip( translations[p & ( p - 1u )], __builtin_ctz( p ) );
+    }
+  }
+
+  uint64_t run()
+  {
+    search( 0u, 0u, 0u );
+
+    uint64_t result{};
+    for ( auto i = 0u; i < size; ++i )
+    {
+      if ( ( best >> i ) & 1u )
+      {
+        result |= uint64_t( 1 ) << ( size - 1u - i );
+      }
+    }
+    return result;
+  }
+
+private:
+  using perm_t = std::array<uint8_t, 64u>;
+
+  /* true, if x < y comparing the first len bits starting from bit 0 */
+  inline static bool lex_less( uint64_t x, uint64_t y, unsigned len )
+  {
+    const auto diff = ( x ^ y ) & ( len == 64u ? ~uint64_t( 0 ) : ( ( uint64_t( 1 ) << len ) - 1u ) );
+    return diff && !( ( x >> __builtin_ctzll( diff ) ) & 1u );
+  }
+
+  /* the set { x ^ c | x in set } */
+  inline static uint64_t translate( uint64_t set, unsigned c )
+  {
+    for ( ; c; c &= c - 1u )
+    {
+      set = stt_flip( set, __builtin_ctz( c ) );
+    }
+    return set;
+  }
+
+  /* true, if point c is mapped to some explored point by automorphisms that fix the first m points */
+  bool in_explored_orbit( unsigned c, unsigned m, uint64_t explored ) const
+  {
+    if ( !explored || generators.empty() ) { return false; }
+
+    std::vector<const perm_t*> fixing;
+    for ( const auto& g : generators )
+    {
+      auto fixes = true;
+      for ( auto i = 0u; i < m && fixes; ++i )
+      {
+        fixes = g[points[i]] == points[i];
+      }
+      if ( fixes ) { fixing.push_back( &g ); }
+    }
+    if ( fixing.empty() ) { return false; }
+
+    uint64_t orbit = uint64_t( 1 ) << c;
+    std::vector<unsigned> stack{c};
+    while ( !stack.empty() )
+    {
+      const auto x = stack.back();
+      stack.pop_back();
+      for ( const auto* g : fixing )
+      {
+        const auto y = ( *g )[x];
+        if ( !( ( orbit >> y ) & 1u ) )
+        {
+          orbit |= uint64_t( 1 ) << y;
+          stack.push_back( y );
+        }
+      }
+    }
+
+    return orbit & explored;
+  }
+
+  void leaf( uint64_t table )
+  {
+    if ( !has_best || lex_less( table, best, size ) )
+    {
+      has_best = true;
+      best = table;
+      std::copy( points.begin(), points.begin() + size, best_points.begin() );
+      return;
+    }
+
+    if ( table != best ) { return; }
+
+    /* equal leaves, store automorphism and jump back to the level in which the paths split */
+    perm_t g{};
+    auto split = size;
+    for ( auto i = 0u; i < size; ++i )
+    {
+      g[best_points[i]] = points[i];
+      if ( split == size && best_points[i] != points[i] )
+      {
+        split = i;
+      }
+    }
+    if ( split == size ) { return; }
+
+    generators.push_back( g );
+    backjump = split == 0u ? 0u : 64u - __builtin_clzll( split );
+  }
+
+  /* level l has m = 2^(l-1) points (none for l = 0), table contains their values */
+  void search( unsigned level, uint64_t table, uint64_t excluded )
+  {
+    const auto m = level == 0u ? 0u : 1u << ( level - 1u );
+
+    if ( m == size )
+    {
+      leaf( table );
+      return;
+    }
+
+    /* candidate columns (or first points in level 0) */
+    uint64_t candidates{};
+    if ( level == 0u )
+    {
+      candidates = affine ? all : ( all & ~uint64_t( 1 ) );
+    }
+    else if ( !affine && level == num_vars )
+    {
+      candidates = uint64_t( 1 ) << points[m - 1u];
+    }
+    else
+    {
+      candidates = all & ~excluded;
+    }
+
+    /* keep candidates with smallest block, bit by bit */
+    const auto len = std::max( m, 1u );
+    uint64_t block{};
+    for ( auto i = 0u; i < len; ++i )
+    {
+      const auto& t = translations[level == 0u ? 0u : points[i]];
+      if ( candidates & ~t )
+      {
+        candidates &= ~t;
+      }
+      else
+      {
+        block |= uint64_t( 1 ) << i;
+      }
+    }
+
+    const auto next_table = table | ( block << m );
+    if ( has_best && lex_less( best, next_table, m + len ) ) { return; }
+
+    /* orbits are computed on the first new point, since automorphisms may be affine */
+    uint64_t explored{};
+    for ( ; candidates; candidates &= candidates - 1u )
+    {
+      const auto c = static_cast<unsigned>( __builtin_ctzll( candidates ) );
+      const auto first = level == 0u ? c : points[0u] ^ c;
+      if ( in_explored_orbit( first, m, explored ) ) { continue; }
+
+      uint64_t next_excluded{};
+      if ( level == 0u )
+      {
+        points[0u] = c;
+        next_excluded = affine ? 1u : ( uint64_t( 1 ) | ( uint64_t( 1 ) << c ) );
+      }
+      else
+      {
+        for ( auto i = 0u; i < m; ++i )
+        {
+          points[m + i] = points[i] ^ c;
+        }
+        next_excluded = excluded | translate( excluded, c );
+      }
+
+      search( level + 1u, next_table, next_excluded );
+
+      if ( backjump != no_backjump )
+      {
+        if ( backjump < level ) { return; }
+        backjump = no_backjump;
+      }
+
+      explored |= uint64_t( 1 ) << first;
+    }
+  }
+
+private:
+  static constexpr unsigned no_backjump = 64u;
+
+  unsigned num_vars;
+  unsigned size;
+  uint64_t all;
+  bool     affine;
+
+  std::array<uint64_t, 64u> translations;
+
+  perm_t   points{};
+  bool     has_best = false;
+  uint64_t best = 0u;
+  perm_t   best_points{};
+
+  std::vector<perm_t> generators;
+  unsigned backjump = no_backjump;
+};
+
 /******************************************************************************
  * Private functions                                                          *
  ******************************************************************************/
 
+uint64_t linear_canonization_cached( uint64_t func, unsigned num_vars, bool affine )
+{
+  /* per-thread memo cache, indexed by [affine][num_vars - 5] */
+  thread_local std::unordered_map<uint64_t, uint64_t> cache[2u][2u];
+
+  auto& c = cache[affine ? 1u : 0u][num_vars - 5u];
+  const auto it = c.find( func );
+  if ( it != c.end() )
+  {
+    return it->second;
+  }
+
+  const auto repr = linear_canonization( func, num_vars, affine );
+  c.insert( {func, repr} );
+  return repr;
+}
+
+inline uint64_t linear_classification_output_mask( unsigned num_vars )
+{
+  return num_vars == 6u ? ~uint64_t( 0 ) : ( ( uint64_t( 1 ) << ( 1u << num_vars ) ) - 1u );
+}
+
 /******************************************************************************
  * Public functions                                                           *
  ******************************************************************************/
 
 uint64_t exact_linear_classification( uint64_t func, unsigned num_vars )
 {
-  assert( num_vars >= 2u && num_vars <= 4u );
+  assert( num_vars >= 2u && num_vars <= 6u );
+
+  if ( num_vars > 4u )
+  {
+    return linear_canonization_cached( func, num_vars, false );
+  }
 
   const auto offset = 2 * num_vars - 1;
 
@@ -84,14 +356,20 @@ uint64_t exact_linear_classification( uint64_t func, unsigned num_vars )
 
 uint64_t exact_linear_classification_output( uint64_t func, unsigned num_vars )
 {
-  const auto mask = num_vars == 6 ? ~0 : ( ( 1 << ( 1 << num_vars ) ) - 1 );
-  const auto func_c = ~func & mask;
+  const auto func_c = ~func & linear_classification_output_mask( num_vars );
 
   return std::min( exact_linear_classification( func, num_vars ), exact_linear_classification( func_c, num_vars ) );
 }
 
 uint64_t exact_affine_classification( uint64_t func, unsigned num_vars )
 {
+  assert( num_vars >= 2u && num_vars <= 6u );
+
+  if ( num_vars > 4u )
+  {
+    return linear_canonization_cached( func, num_vars, true );
+  }
+
   const auto& flip_array = tt_store::i().flips( num_vars );
   const auto total_flips = flip_array.size();
 
@@ -109,12 +387,18 @@ uint64_t exact_affine_classification( uint64_t func, unsigned num_vars )
 
 uint64_t exact_affine_classification_output( uint64_t func, unsigned num_vars )
 {
-  const auto mask = num_vars == 6 ? ~0 : ( ( 1 << ( 1 << num_vars ) ) - 1 );
-  const auto func_c = ~func & mask;
+  const auto func_c = ~func & linear_classification_output_mask( num_vars );
 
   return std::min( exact_affine_classification( func, num_vars ), exact_affine_classification( func_c, num_vars ) );
 }
 
+uint64_t linear_canonization( uint64_t func, unsigned num_vars, bool affine )
+{
+  assert( num_vars >= 2u && num_vars <= 6u );
+
+  return linear_canonization_manager( func, num_vars, affine ).run();
+}
+
 }
 
 // Local Variables:
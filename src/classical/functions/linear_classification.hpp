@@ -41,11 +41,18 @@
 namespace cirkit
 {
 
+/* num_vars must be between 2 and 6; functions with 5 and 6 variables are
+ * classified by a canonical form search whose results are memoized per thread */
 uint64_t exact_linear_classification( uint64_t func, unsigned num_vars );
 uint64_t exact_linear_classification_output( uint64_t func, unsigned num_vars );
 uint64_t exact_affine_classification( uint64_t func, unsigned num_vars );
 uint64_t exact_affine_classification_output( uint64_t func, unsigned num_vars );
 
+/* canonical form search that is used for 5 and 6 variables, it accepts
+ * 2 to 6 variables and returns the same representative as the enumeration;
+ * results are not memoized */
+uint64_t linear_canonization( uint64_t func, unsigned num_vars, bool affine );
+
 }
 
 #endif
@@ -37,6 +37,7 @@
 #include <core/utils/range_utils.hpp>
 #include <core/utils/timer.hpp>
 #include <classical/abc/abc_api.hpp>
+#include <classical/utils/static_truth_table_utils.hpp>
 
 #include <misc/util/utilTruth.h>
 #include <bool/lucky/lucky.h>
@@ -177,40 +178,20 @@ void npn_canonization_sifting_loop( tt& npn, unsigned n, boost::dynamic_bitset<>
   }
 }
 
-/******************************************************************************
- * Public functions                                                           *
- ******************************************************************************/
-
-tt exact_npn_canonization( const tt& t, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm, const properties::ptr& settings, const properties::ptr& statistics )
+template<unsigned NumVars>
+tt exact_npn_canonization_static( const tt& t, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm,
+                                  const std::vector<unsigned>& swap_array, const std::vector<unsigned>& flip_array )
 {
-  properties_timer tim( statistics );
-
-  /* initialize */
-  auto n = tt_num_vars( t );
-  phase.resize( n + 1u );
-  phase.reset();
-  perm.resize( n );
-  boost::iota( perm, 0u );
-
-  assert( n <= 6u );
-
-  const auto& swap_array = tt_store::i().swaps( n );
-  const auto& flip_array = tt_store::i().flips( n );
+  const auto n = NumVars;
   const auto total_swaps = swap_array.size();
   const auto total_flips = flip_array.size();
 
-  auto t1 = t;
-  auto t2 = ~t; /* inversion */
+  auto t1 = static_tt<NumVars>( t );
+  auto t2 = ~t1; /* inversion */
   auto min = std::min( t1, t2 );
 
   auto invo = ( min == t2 );
 
-  if ( false /* verbose */ )
-  {
-    std::cout << "[i] swaps: " << any_join( swap_array, " " ) << std::endl
-              << "[i] flips: " << any_join( flip_array, " " ) << std::endl;
-  }
-
   int best_flip = total_flips;
   int best_swap = total_swaps;
 
@@ -219,7 +200,6 @@ tt exact_npn_canonization( const tt& t, boost::dynamic_bitset<>& phase, std::vec
     const auto pos = swap_array[i];
     t1 = tt_permute( t1, pos, pos + 1 );
     t2 = tt_permute( t2, pos, pos + 1 );
-    tt_shrink( t1, n ); tt_shrink( t2, n );
     if ( t1 < min || t2 < min )
     {
       best_swap = i;
@@ -232,7 +212,6 @@ tt exact_npn_canonization( const tt& t, boost::dynamic_bitset<>& phase, std::vec
   {
     t1 = tt_flip( tt_permute( t1, 0u, 1u ), flip_array[j] );
     t2 = tt_flip( tt_permute( t2, 0u, 1u ), flip_array[j] );
-    tt_shrink( t1, n ); tt_shrink( t2, n );
     if ( t1 < min || t2 < min )
     {
       best_swap = total_swaps;
@@ -246,7 +225,6 @@ tt exact_npn_canonization( const tt& t, boost::dynamic_bitset<>& phase, std::vec
       const auto pos = swap_array[i];
       t1 = tt_permute( t1, pos, pos + 1 );
       t2 = tt_permute( t2, pos, pos + 1 );
-      tt_shrink( t1, n ); tt_shrink( t2, n );
       if ( t1 < min || t2 < min )
       {
         best_swap = i;
@@ -274,7 +252,43 @@ tt exact_npn_canonization( const tt& t, boost::dynamic_bitset<>& phase, std::vec
     phase.flip( n );
   }
 
-  return min;
+  return min.to_tt();
+}
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+tt exact_npn_canonization( const tt& t, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm, const properties::ptr& settings, const properties::ptr& statistics )
+{
+  properties_timer tim( statistics );
+
+  /* initialize */
+  auto n = tt_num_vars( t );
+  phase.resize( n + 1u );
+  phase.reset();
+  perm.resize( n );
+  boost::iota( perm, 0u );
+
+  assert( n <= 6u );
+
+  const auto& swap_array = tt_store::i().swaps( n );
+  const auto& flip_array = tt_store::i().flips( n );
+
+  if ( false /* verbose */ )
+  {
+    std::cout << "[i] swaps: " << any_join( swap_array, " " ) << std::endl
+              << "[i] flips: " << any_join( flip_array, " " ) << std::endl;
+  }
+
+  switch ( n )
+  {
+  case 2u: return exact_npn_canonization_static<2u>( t, phase, perm, swap_array, flip_array );
+  case 3u: return exact_npn_canonization_static<3u>( t, phase, perm, swap_array, flip_array );
+  case 4u: return exact_npn_canonization_static<4u>( t, phase, perm, swap_array, flip_array );
+  case 5u: return exact_npn_canonization_static<5u>( t, phase, perm, swap_array, flip_array );
+  default: return exact_npn_canonization_static<6u>( t, phase, perm, swap_array, flip_array );
+  }
 }
 
 tt npn_canonization( const tt& t, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm, const properties::ptr& settings, const properties::ptr& statistics )
@@ -26,7 +26,10 @@
 
 #include "simulation_graph.hpp"
 
+#include <array>
+#include <cstdint>
 #include <fstream>
+#include <future>
 
 #include <boost/assign/std/vector.hpp>
 #include <boost/format.hpp>
@@ -35,7 +38,6 @@
 #include <boost/range/algorithm.hpp>
 #include <boost/range/algorithm_ext/iota.hpp>
 #include <boost/range/algorithm_ext/push_back.hpp>
-#include <boost/range/combine.hpp>
 #include <boost/range/counting_range.hpp>
 #include <boost/range/iterator_range.hpp>
 
@@ -43,7 +45,8 @@
 #include <core/utils/combinations.hpp>
 #include <core/utils/range_utils.hpp>
 #include <core/utils/string_utils.hpp>
-#include <classical/functions/simulate_aig.hpp>
+#include <core/utils/thread_pool.hpp>
+#include <core/utils/timer.hpp>
 #include <classical/functions/aig_support.hpp>
 #include <classical/utils/aig_utils.hpp>
 
@@ -52,6 +55,173 @@ using namespace boost::assign;
 namespace cirkit
 {
 
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+/* one row of 64-bit words per input or output, bit j refers to vector j */
+using simulation_words_t = std::vector<std::vector<uint64_t>>;
+
+/* AND gates in topological order as ( node, child literal, child literal ) */
+using word_simulation_gates_t = std::vector<std::array<unsigned, 3u>>;
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+void pack_simulation_vectors( const std::vector<boost::dynamic_bitset<>>& sim_vectors, unsigned offset, simulation_words_t& input_words )
+{
+  for ( const auto& it : index( sim_vectors ) )
+  {
+    const auto j = offset + it.index;
+    foreach_bit( it.value, [&]( unsigned pos ) {
+        input_words[pos][j >> 6u] |= uint64_t( 1u ) << ( j & 63u );
+      } );
+  }
+}
+
+word_simulation_gates_t word_simulation_gates( const aig_graph& aig )
+{
+  word_simulation_gates_t gates;
+
+  foreach_topological( aig, [&]( const aig_node& node ) {
+      if ( boost::out_degree( node, aig ) == 2u )
+      {
+        const auto children = get_children( aig, node );
+        gates.push_back( {{static_cast<unsigned>( node ),
+                           ( static_cast<unsigned>( children[0u].node ) << 1u ) | static_cast<unsigned>( children[0u].complemented ),
+                           ( static_cast<unsigned>( children[1u].node ) << 1u ) | static_cast<unsigned>( children[1u].complemented )}} );
+      }
+      return true;
+    } );
+
+  return gates;
+}
+
+/* simulates the words [first, last) of all inputs; values is scratch memory */
+void simulate_aig_words( const aig_graph& aig, const word_simulation_gates_t& gates, const simulation_words_t& input_words,
+                         unsigned first, unsigned last, std::vector<uint64_t>& values, simulation_words_t& output_words )
+{
+  const auto& info = aig_info( aig );
+  const auto width = last - first;
+
+  values.assign( boost::num_vertices( aig ) * width, 0u );
+
+  for ( const auto& input : index( info.inputs ) )
+  {
+    std::copy( input_words[input.index].begin() + first, input_words[input.index].begin() + last, values.begin() + input.value * width );
+  }
+
+  for ( const auto& gate : gates )
+  {
+    const auto mask0 = ( gate[1u] & 1u ) ? ~uint64_t( 0u ) : uint64_t( 0u );
+    const auto mask1 = ( gate[2u] & 1u ) ? ~uint64_t( 0u ) : uint64_t( 0u );
+    const auto* p0 = &values[( gate[1u] >> 1u ) * width];
+    const auto* p1 = &values[( gate[2u] >> 1u ) * width];
+    auto* p = &values[gate[0u] * width];
+
+    for ( auto w = 0u; w < width; ++w )
+    {
+      p[w] = ( p0[w] ^ mask0 ) & ( p1[w] ^ mask1 );
+    }
+  }
+
+  for ( const auto& output : index( info.outputs ) )
+  {
+    const auto mask = output.value.first.complemented ? ~uint64_t( 0u ) : uint64_t( 0u );
+    const auto* p = &values[output.value.first.node * width];
+    for ( auto w = 0u; w < width; ++w )
+    {
+      output_words[output.index][first + w] = p[w] ^ mask;
+    }
+  }
+}
+
+/* simulates all num_words words, chunks of words are distributed over num_threads threads */
+simulation_words_t simulate_aig_words( const aig_graph& aig, const simulation_words_t& input_words, unsigned num_words, unsigned num_threads )
+{
+  const auto chunk_size = 16u;
+  const auto num_chunks = ( num_words + chunk_size - 1u ) / chunk_size;
+
+  const auto gates = word_simulation_gates( aig );
+  simulation_words_t output_words( aig_info( aig ).outputs.size(), std::vector<uint64_t>( num_words, 0u ) );
+
+  const auto simulate_chunks = [&]( unsigned offset, unsigned step ) {
+    std::vector<uint64_t> values;
+    for ( auto c = offset; c < num_chunks; c += step )
+    {
+      simulate_aig_words( aig, gates, input_words, c * chunk_size, std::min( ( c + 1u ) * chunk_size, num_words ), values, output_words );
+    }
+  };
+
+  if ( num_threads <= 1u || num_chunks <= 1u )
+  {
+    simulate_chunks( 0u, 1u );
+  }
+  else
+  {
+    thread_pool pool( num_threads );
+    std::vector<std::future<void>> futures;
+    for ( auto t = 0u; t < num_threads; ++t )
+    {
+      futures.push_back( pool.enqueue( simulate_chunks, t, num_threads ) );
+    }
+    for ( auto& f : futures )
+    {
+      f.get();
+    }
+  }
+
+  return output_words;
+}
+
+/* number of set bits in [from, to) */
+unsigned count_simulation_bits( const std::vector<uint64_t>& words, unsigned from, unsigned to )
+{
+  auto count = 0u;
+  while ( from < to )
+  {
+    const auto bits = std::min( 64u - ( from & 63u ), to - from );
+    const auto mask = ( bits == 64u ) ? ~uint64_t( 0u ) : ( ( uint64_t( 1u ) << bits ) - 1u );
+    count += __builtin_popcountll( ( words[from >> 6u] >> ( from & 63u ) ) & mask );
+    from += bits;
+  }
+  return count;
+}
+
+/* vectors used for simulation signatures up to maxk */
+std::vector<boost::dynamic_bitset<>> signature_vectors( unsigned n, unsigned maxk, std::vector<unsigned>& partition )
+{
+  std::vector<unsigned> types( ( maxk + 1u ) << 1u );
+  boost::iota( types, 0u );
+
+  return create_simulation_vectors( n, types, &partition );
+}
+
+std::vector<simulation_signature_t::value_type> signatures_from_words( const simulation_words_t& output_words, unsigned offset, const std::vector<unsigned>& partition )
+{
+  std::vector<simulation_signature_t::value_type> vec;
+
+  for ( const auto& ovalue : output_words )
+  {
+    std::vector<unsigned> signature( partition.size() );
+    auto pos = offset;
+    for ( auto i = 0u; i < partition.size(); ++i )
+    {
+      signature[i] = count_simulation_bits( ovalue, pos, pos + partition[i] );
+      pos += partition[i];
+    }
+
+    vec += signature;
+  }
+
+  return vec;
+}
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
 simulation_graph create_simulation_graph( const aig_graph& aig, const std::vector<boost::dynamic_bitset<>>& sim_vectors,
                                           const properties::ptr& settings, const properties::ptr& statistics )
 {
@@ -68,6 +238,7 @@ simulation_graph create_simulation_graph( const aig_graph& aig, const std::vecto
   const auto support_edges         = get( settings, "support_edges",         false );
   const auto simulation_signatures = get( settings, "simulation_signatures", boost::optional<unsigned>() );
   const auto annotate_simvectors   = get( settings, "annotate_simvectors",   false );
+  const auto num_threads           = get( settings, "num_threads",           1u );
 
   if ( support_edges && !support )
   {
@@ -81,14 +252,15 @@ simulation_graph create_simulation_graph( const aig_graph& aig, const std::vecto
   const auto& info = aig_info( aig );
   const auto n = info.inputs.size();
   const auto m = info.outputs.size();
+  const auto num_vectors = sim_vectors.size();
 
   /* meta */
   meta.num_inputs = n;
-  meta.num_vectors = sim_vectors.size();
+  meta.num_vectors = num_vectors;
   meta.num_outputs = m;
 
   /* add vertices */
-  const auto vertices_count = n + m + sim_vectors.size();
+  const auto vertices_count = n + m + num_vectors;
   add_vertices( g, vertices_count );
 
   /* edge inserting */
@@ -107,38 +279,51 @@ simulation_graph create_simulation_graph( const aig_graph& aig, const std::vecto
       } );
   }
 
-  /* simulate */
-  word_assignment_simulator::aig_name_value_map map( info.inputs.size() );
-  const auto sim_vectors_t = transpose( sim_vectors );
-  for ( const auto& p : boost::combine( info.inputs, sim_vectors_t ) )
+  /* simulate; the vectors for the simulation signatures are appended
+     after the last word of sim_vectors such that one sweep computes both */
+  std::vector<boost::dynamic_bitset<>> sig_vectors;
+  std::vector<unsigned> sig_partition;
+  if ( (bool)simulation_signatures )
   {
-    map.insert( {info.node_names.at( boost::get<0>( p ) ), boost::get<1>( p )} );
+    sig_vectors = signature_vectors( n, *simulation_signatures, sig_partition );
   }
 
-  auto results = simulate_aig( aig, word_assignment_simulator( map ) );
+  const auto sig_offset = ( ( num_vectors + 63u ) >> 6u ) << 6u;
+  const auto num_words  = ( sig_offset + sig_vectors.size() + 63u ) >> 6u;
+
+  simulation_words_t input_words( n, std::vector<uint64_t>( num_words, 0u ) );
+  pack_simulation_vectors( sim_vectors, 0u, input_words );
+  pack_simulation_vectors( sig_vectors, sig_offset, input_words );
+
+  const auto output_words = simulate_aig_words( aig, input_words, num_words, num_threads );
 
   /* prepare annotation of simvectors */
   std::vector<boost::dynamic_bitset<>> results_t;
 
   if ( annotate_simvectors )
   {
-    results_t.resize( sim_vectors.size(), boost::dynamic_bitset<>( m ) );
+    results_t.resize( num_vectors, boost::dynamic_bitset<>( m ) );
   }
 
   /* create edges */
   for ( auto j = 0u; j < m; ++j )
   {
-    const auto& ovalue = results[info.outputs[j].first];
-    for ( auto i = 0u; i < sim_vectors.size(); ++i )
+    const auto& ovalue = output_words[j];
+    for ( auto w = 0u; ( w << 6u ) < num_vectors; ++w )
     {
-      if ( ovalue[i] )
+      auto word = ovalue[w];
+      while ( word )
       {
-        add_edge_func( n + i, n + sim_vectors.size() + j );
-      }
+        const auto i = ( w << 6u ) + __builtin_ctzll( word );
+        if ( i >= num_vectors ) { break; }
+        word &= word - 1u;
 
-      if ( annotate_simvectors )
-      {
-        results_t[i][j] = ovalue[i];
+        add_edge_func( n + i, n + num_vectors + j );
+
+        if ( annotate_simvectors )
+        {
+          results_t[i][j] = true;
+        }
       }
     }
   }
@@ -165,14 +350,14 @@ simulation_graph create_simulation_graph( const aig_graph& aig, const std::vecto
     for ( const auto& o : index( info.outputs ) )
     {
       const auto& mask = s.at( o.value.first );
-      vertex_support[n + sim_vectors.size() + o.index] = mask;
+      vertex_support[n + num_vectors + o.index] = mask;
 
       if ( support_edges )
       {
         auto it_bit = mask.find_first();
         while ( it_bit != boost::dynamic_bitset<>::npos )
         {
-          const auto e = add_edge_func( n + sim_vectors.size() + o.index, it_bit );
+          const auto e = add_edge_func( n + num_vectors + o.index, it_bit );
 
           if ( !unate.empty() )
           {
@@ -193,7 +378,7 @@ simulation_graph create_simulation_graph( const aig_graph& aig, const std::vecto
 
   for ( const auto& o : index( info.outputs ) )
   {
-    meta.port_to_node[o.value.first.node] = n + sim_vectors.size() + o.index;
+    meta.port_to_node[o.value.first.node] = n + num_vectors + o.index;
   }
 
   /* annotate simulation vectors */
@@ -214,10 +399,10 @@ simulation_graph create_simulation_graph( const aig_graph& aig, const std::vecto
   {
     const auto& vertex_simulation_signatures = boost::get( boost::vertex_simulation_signature, g );
 
-    const auto signatures = compute_simulation_signatures( aig, *simulation_signatures );
+    const auto signatures = signatures_from_words( output_words, sig_offset, sig_partition );
     for ( const auto& s : index( signatures ) )
     {
-      vertex_simulation_signatures[n + sim_vectors.size() + s.index] = s.value;
+      vertex_simulation_signatures[n + num_vectors + s.index] = s.value;
     }
   }
 
@@ -244,7 +429,7 @@ simulation_graph create_simulation_graph( const aig_graph& aig, const std::vecto
     // TODO be more flexible
     write_labeled_graph_file( g, [&]( const simulation_node& v ) {
         if ( v < n ) return 1u;
-        if ( v < n + sim_vectors.size() ) return 2u + (unsigned)std::min( (unsigned)sim_vectors[v - n].count(), 3u );
+        if ( v < n + num_vectors ) return 2u + (unsigned)std::min( (unsigned)sim_vectors[v - n].count(), 3u );
         return 0u;
       }, [&]( const simulation_edge& e ) {
         if ( boost::source( e, g ) < n ) return 0u;
@@ -366,53 +551,16 @@ simulation_graph create_simulation_graph( const aig_graph& aig, const std::vecto
 
 std::vector<simulation_signature_t::value_type> compute_simulation_signatures( const aig_graph& aig, unsigned maxk )
 {
-  std::vector<simulation_signature_t::value_type> vec;
-
-  const auto& info      = aig_info( aig );
-  const auto  n         = info.inputs.size();
-  const auto  num_types = ( maxk + 1u ) << 1u;
-
-  std::vector<unsigned> types( num_types );
-  boost::iota( types, 0u );
-
-  word_assignment_simulator::aig_name_value_map map( n );
-  std::vector<unsigned> partition, offset( num_types );
-  const auto all_sim_vectors   = create_simulation_vectors( n, types, &partition );
-  const auto all_sim_vectors_t = transpose( all_sim_vectors );
-
-  assert( partition.size() == num_types );
-  offset[0] = 0;
-  for ( auto i = 1u; i < partition.size(); ++i )
-  {
-    offset[i] = offset[i - 1] + partition[i - 1];
-  }
+  const auto n = aig_info( aig ).inputs.size();
 
-  for ( const auto& p : boost::combine( info.inputs, all_sim_vectors_t ) )
-  {
-    map.insert( {info.node_names.at( boost::get<0>( p ) ), boost::get<1>( p )} );
-  }
-
-  const auto results = simulate_aig( aig, word_assignment_simulator( map ) );
-
-  for ( const auto& output : info.outputs )
-  {
-    const auto& ovalue = results.at( output.first );
-    std::vector<unsigned> signature( num_types );
-    for ( auto i = 0u; i < partition.size(); ++i )
-    {
-      signature[i] = 0u;
-      auto pos = ( i == 0u ) ? ovalue.find_first() : ovalue.find_next( offset[i] - 1u );
-      while ( pos < offset[i] + partition[i] && pos != boost::dynamic_bitset<>::npos )
-      {
-        ++signature[i];
-        pos = ovalue.find_next( pos );
-      }
-    }
+  std::vector<unsigned> partition;
+  const auto all_sim_vectors = signature_vectors( n, maxk, partition );
+  const auto num_words = ( all_sim_vectors.size() + 63u ) >> 6u;
 
-    vec += signature;
-  }
+  simulation_words_t input_words( n, std::vector<uint64_t>( num_words, 0u ) );
+  pack_simulation_vectors( all_sim_vectors, 0u, input_words );
 
-  return vec;
+  return signatures_from_words( simulate_aig_words( aig, input_words, num_words, 1u ), 0u, partition );
 }
 
 /******************************************************************************
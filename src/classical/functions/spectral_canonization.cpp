@@ -26,6 +26,8 @@
 
 #include "spectral_canonization.hpp"
 
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <numeric>
 
@@ -61,39 +63,36 @@ tt make_sum( const boost::dynamic_bitset<>& mask )
 
 std::vector<int> rademacher_walsh_spectrum( const tt& func )
 {
-  const auto n = tt_num_vars( func );
-  std::vector<int> spectrum;
+  /* +1/-1 encoding of func */
+  std::vector<int> spectrum( func.size(), 1 );
+  foreach_bit( func, [&spectrum]( unsigned pos ) { spectrum[pos] = -1; } );
 
-  foreach_bitset( n, [n, &func, &spectrum]( const boost::dynamic_bitset<>& bs ) {
-      const auto row = make_sum( bs );
-      spectrum.push_back( ( 1 << n ) - 2 * ( row ^ func ).count() );
-    } );
+  fast_walsh_hadamard_transform( spectrum );
 
   return spectrum;
 }
 
-std::vector<int> autocorrelation_spectrum( const tt& func )
+/* Wiener-Khinchin: the autocorrelation is the (scaled) transform of the squared spectrum,
+ * the squares sum up to 4^n and are therefore accumulated in 64 bits */
+std::vector<int> autocorrelation_spectrum( const std::vector<int>& rw_spectrum )
 {
-  const auto n = tt_num_vars( func );
-  std::vector<int> spectrum;
+  std::vector<int64_t> squares( rw_spectrum.size() );
+  std::transform( rw_spectrum.begin(), rw_spectrum.end(), squares.begin(), []( int c ) { return static_cast<int64_t>( c ) * c; } );
+
+  fast_walsh_hadamard_transform( squares );
+
+  const int64_t size = squares.size();
+  std::vector<int> spectrum( squares.size() );
+  std::transform( squares.begin(), squares.end(), spectrum.begin(), [size]( int64_t c ) { return static_cast<int>( c / size ); } );
 
-  foreach_bitset( n, [n, &func, &spectrum]( const boost::dynamic_bitset<>& bs ) {
-      if ( bs.none() )
-      {
-        spectrum.push_back( 1 << n );
-      }
-      else
-      {
-        boost::dynamic_bitset<> fs( func.size() );
-        foreach_bitset( n, [&bs, &fs, &func]( const boost::dynamic_bitset<>& bs2 ) {
-            fs.set( bs2.to_ulong(), func.test( ( bs2 ^ bs ).to_ulong() ) );
-          } );
-        spectrum.push_back( ( 1 << n ) - 2 * ( fs ^ func ).count() );
-      }
-    } );
   return spectrum;
 }
 
+std::vector<int> autocorrelation_spectrum( const tt& func )
+{
+  return autocorrelation_spectrum( rademacher_walsh_spectrum( func ) );
+}
+
 void print_spectrum( const std::vector<int>& spectrum, unsigned nvars )
 {
   for ( auto i = 0u; i < spectrum.size(); ++i )
@@ -156,22 +155,22 @@ int compare_abs( int a, int b )
 void operation1( std::vector<int>& spectrum, tt& func, const std::vector<unsigned>& perm )
 {
   std::vector<int> spectrum_p( spectrum.size() );
-  tt func_p = func;
+  tt func_p( func.size() );
 
   for ( auto row = 0u; row < spectrum.size(); ++row )
   {
-    boost::dynamic_bitset<> idx( perm.size(), row ), idx_p( perm.size() );
+    auto row_p = 0u;
     for ( auto i = 0u; i < perm.size(); ++i )
     {
-      idx_p[i] = idx[perm[i]];
+      row_p |= ( ( row >> perm[i] ) & 1u ) << i;
     }
 
-    spectrum_p[idx_p.to_ulong()] = spectrum[row];
-    func_p.set( idx_p.to_ulong(), func.test( row ) );
+    spectrum_p[row_p] = spectrum[row];
+    func_p[row_p] = func[row];
   }
 
-  spectrum = spectrum_p;
-  func = func_p;
+  spectrum.swap( spectrum_p );
+  func.swap( func_p );
 }
 
 void operation2( std::vector<int>& spectrum, tt& func, unsigned var )
@@ -196,9 +195,11 @@ void operation3( std::vector<int>& spectrum, tt& func )
 
 void operation4( std::vector<int>& spectrum, tt& func, unsigned var, unsigned diff )
 {
+  const auto varbit = 1u << var;
+
   for ( auto row = 0u; row < spectrum.size(); ++row )
   {
-    if ( ( row >> var ) & 1 )
+    if ( row & varbit )
     {
       auto row2 = row ^ diff;
       if ( row < row2 )
@@ -208,39 +209,18 @@ void operation4( std::vector<int>& spectrum, tt& func, unsigned var, unsigned di
     }
   }
 
-  const auto nvars = tt_num_vars( func );
-  boost::dynamic_bitset<> mask( nvars, diff );
-  const auto varbs = onehot_bitset( nvars, var );
-  const auto inc_mask = ~( varbs | mask );
-
-  //std::cout << "var = " << var << ", mask = " << mask << ", diff = " << diff << std::endl;
-  //std::cout << "func b " << func << " " << func[15] << " " << func[14] << std::endl;
-
-  auto start = varbs;
-  do {
-    //std::cout << start << std::endl;
-
-    auto pattern = start;
-    do {
-      //std::cout << " " << pattern;
-      if ( ( pattern & mask ).count() % 2 )
-      {
-        const auto r1 = pattern.to_ulong();
-        const auto r2 = ( pattern ^ varbs ).to_ulong();
-
-        const auto tmp = func.test( r1 );
-        func.set( r1, func.test( r2 ) );
-        func.set( r2, tmp );
-        //std::cout << " *, swap with " << ( pattern ^ varbs ) << " (" << r1 << " with " << r2 << ")";
-      }
-      //std::cout << std::endl;
-      inc_pos( pattern, mask );
-    } while ( ( pattern & mask ).any() );
-
-    inc_pos( start, inc_mask );
-  } while ( ( start & inc_mask ).any() );
-
-  //std::cout << "func a " << func << std::endl;
+  /* x_var becomes x_var XOR (XOR of all variables in diff), i.e., swap
+     the two rows that differ in var if the parity of diff is odd */
+  for ( auto row = 0u; row < func.size(); ++row )
+  {
+    if ( ( row & varbit ) && ( __builtin_popcount( row & diff ) & 1 ) )
+    {
+      const auto row2 = row ^ varbit;
+      const bool tmp = func[row];
+      func[row] = func[row2];
+      func[row2] = tmp;
+    }
+  }
 }
 
 void operation5( std::vector<int>& spectrum, tt& func, unsigned row )
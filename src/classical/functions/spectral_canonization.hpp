@@ -36,12 +36,18 @@
 #ifndef SPECTRAL_CANONIZATION_HPP
 #define SPECTRAL_CANONIZATION_HPP
 
+#include <vector>
+
 #include <core/properties.hpp>
 #include <classical/utils/truth_table_utils.hpp>
 
 namespace cirkit
 {
 
+/* both spectra are indexed by the row (LSB is the first variable) */
+std::vector<int> rademacher_walsh_spectrum( const tt& func );
+std::vector<int> autocorrelation_spectrum( const tt& func );
+
 tt spectral_canonization( const tt& func, const properties::ptr& settings = properties::ptr(), const properties::ptr& statistics = properties::ptr() );
 
 unsigned get_spectral_class( const tt& func );
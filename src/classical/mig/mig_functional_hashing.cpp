@@ -26,8 +26,10 @@
 
 #include "mig_functional_hashing.hpp"
 
+#include <atomic>
+#include <deque>
+#include <future>
 #include <iostream>
-#include <unordered_map>
 #include <vector>
 
 #include <boost/dynamic_bitset.hpp>
@@ -41,12 +43,11 @@
 #include <core/utils/graph_utils.hpp>
 #include <core/utils/range_utils.hpp>
 #include <core/utils/terminal.hpp>
+#include <core/utils/thread_pool.hpp>
 #include <core/utils/timer.hpp>
 #include <classical/functions/cuts/stack.hpp>
 #include <classical/functions/cuts/traits.hpp>
 #include <classical/functions/fanout_free_regions.hpp>
-#include <classical/mig/mig_from_string.hpp>
-#include <classical/functions/npn_canonization.hpp>
 #include <classical/mig/mig_simulate.hpp>
 #include <classical/mig/mig_functional_hashing_constants.hpp>
 #include <classical/utils/cut_enumeration.hpp>
@@ -161,52 +162,60 @@ void add_candidate( candidate_vec_t& vec, const candidate_t& c, unsigned max_siz
   }
 }
 
-struct npn_hash_table_entry_t
+/* replacements chosen inside one FFR in top-down mode, nodes without an
+   entry are copied as majority gates */
+struct ffr_plan_t
 {
-  npn_hash_table_entry_t() {}
-  npn_hash_table_entry_t( int tt, int npn, const std::vector<unsigned>& perm, const boost::dynamic_bitset<>& phase )
-    : tt( tt ), npn( npn ), perm( perm ), phase( phase ) {}
-
-  int                     tt  = -1;
-  int                     npn = -1;
-  std::vector<unsigned>   perm;
-  boost::dynamic_bitset<> phase;
+  std::map<mig_node, std::pair<std::vector<mig_node>, mig_fh_transform>> replacements;
+  double                                                                 runtime_cut = 0.0;
 };
 
-using npn_hash_table_t = std::vector<npn_hash_table_entry_t>;
+/* candidates of one bottom-up run, computed in a private MIG */
+struct bottom_up_result_t
+{
+  mig_graph                                      mig_tmp;
+  std::vector<std::pair<mig_node, mig_node>>     leafs; /* node in mig, node in mig_tmp */
+  std::vector<std::pair<mig_node, mig_function>> roots; /* node in mig, best candidate in mig_tmp */
+};
 
 class mig_functional_hashing_manager
 {
 public:
-  mig_functional_hashing_manager( const mig_graph& mig, bool use_ffrs, bool top_down, unsigned npn_hash_table_size, bool verbose );
+  mig_functional_hashing_manager( const mig_graph& mig, bool use_ffrs, bool top_down, unsigned num_threads, bool verbose );
 
   void run();
 
 private:
   int find_best_cut( const mig_node& node, const std::map<aig_node, structural_cut>& cuts,
-                     boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm, std::string& expr );
+                     mig_fh_transform& transform ) const;
+
+  /* top-down inside FFRs: planning is independent for each FFR,
+     instantiation happens in topological order */
+  ffr_plan_t plan_ffr( const mig_node& id ) const;
+  void plan_node( const std::vector<mig_node>& ffr_leafs, const mig_node& node,
+                  const std::map<aig_node, structural_cut>& cuts, ffr_plan_t& plan ) const;
 
   mig_function optimize_node( const std::vector<mig_node>& ffr_leafs, const mig_node& node,
-                              const std::map<aig_node, structural_cut>& cuts );
+                              const ffr_plan_t& plan );
 
   mig_function optimize_node( const mig_node& node,
                               const std::map<aig_node, structural_cut>& cuts );
 
-  tt compute_npn( const tt& tt, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm );
+  mig_function create_replacement( mig_graph& mig_target, const mig_fh_transform& transform,
+                                   const std::vector<mig_function>& leafs ) const;
 
   bool is_fanout_free_cut( const mig_node& node, const boost::dynamic_bitset<>& cut ) const;
 
   // bottom-up
+  bottom_up_result_t depth_preserving_candidates( const opt_ffr_t& ffr ) const;
   void depth_preserving_functional_hashing( const opt_ffr_t& ffr = boost::none );
+  void merge_candidates( const bottom_up_result_t& result );
   mig_function copy_tmp_to_new( const mig_node& node, const mig_graph& mig_tmp, std::map<mig_node, mig_function>& visited );
 
-private:
-  inline std::vector<unsigned> inv( const std::vector<unsigned>& perm ) const
-  {
-    std::vector<unsigned> invperm( perm.size() );
-    for ( auto i = 0u; i < perm.size(); ++i ) { invperm[perm[i]] = i; }
-    return invperm;
-  }
+  /* computes one result per FFR in parallel and merges them in topological order */
+  template<typename Result>
+  void foreach_ffr( const std::function<Result( const mig_node& )>& compute,
+                    const std::function<void( const mig_node&, Result& )>& merge );
 
 public:
   const mig_graph&                   mig;
@@ -221,7 +230,8 @@ public:
   std::map<mig_node, mig_edge_vec_t> ingoing;
   std::vector<unsigned>              depths;
   unsigned                           max_depth;
-  npn_hash_table_t                   npn_table;
+  const mig_fh_database&             db;
+  unsigned                           num_threads;
   bool                               progress;
   bool                               depth_heuristic;
   unsigned                           max_candidates = 10u;
@@ -231,9 +241,7 @@ public:
   bool                               verbose;
   double                             runtime_ffr = 0.0;
   double                             runtime_cut = 0.0;
-  double                             runtime_npn = 0.0;
-  unsigned long                      cache_hit = 0ul;
-  unsigned long                      cache_miss = 0ul;
+  mutable std::atomic<unsigned long> npn_lookups{0ul}; /* FFRs are planned concurrently */
   properties::ptr                    ffr_statistics;
 };
 
@@ -241,13 +249,14 @@ public:
  * Private functions                                                          *
  ******************************************************************************/
 
-mig_functional_hashing_manager::mig_functional_hashing_manager( const mig_graph& mig, bool use_ffrs, bool top_down, unsigned npn_hash_table_size, bool verbose )
+mig_functional_hashing_manager::mig_functional_hashing_manager( const mig_graph& mig, bool use_ffrs, bool top_down, unsigned num_threads, bool verbose )
   : mig( mig ),
     info( mig_info( mig ) ),
     use_ffrs( use_ffrs ),
     top_down( top_down ),
     topsort( boost::num_vertices( mig ) ),
-    npn_table( npn_hash_table_size ),
+    db( mig_functional_hashing_constants::min_depth_database() ),
+    num_threads( num_threads ),
     verbose( verbose )
 {
   mig_initialize( mig_new, info.model_name );
@@ -307,33 +316,17 @@ void mig_functional_hashing_manager::run()
       std::ostream null_out( &ns );
       boost::progress_display show_progress( ffrs_topsort.size(), progress ? std::cout : null_out );
 
-      for ( const auto& id : ffrs_topsort )
-      {
-        ++show_progress;
-
-        L( "[i] optimize ffr at " << id );
-
-        /* already computed? */
-        if ( old_to_new.find( id ) != old_to_new.end() ) { continue; }
-
-        /* perform cut enumeration */
-        boost::dynamic_bitset<> boundary( boost::num_vertices( mig ) );
-        for ( const auto& ffr_leaf : ffrs.at( id ) )
-        {
-          boundary.set( ffr_leaf );
-        }
-
-        auto sce_settings = std::make_shared<properties>();
-        auto sce_statistics = std::make_shared<properties>();
-        sce_settings->set( "boundary", boundary );
-        sce_settings->set( "start_nodes", std::vector<mig_node>( {id} ) );
-        auto cuts = structural_cut_enumeration( mig, 5u, sce_settings, sce_statistics );
+      foreach_ffr<ffr_plan_t>( [this]( const mig_node& id ) { return plan_ffr( id ); },
+                               [this, &show_progress]( const mig_node& id, ffr_plan_t& plan ) {
+                                 ++show_progress;
+                                 runtime_cut += plan.runtime_cut;
 
-        runtime_cut += sce_statistics->get<double>( "runtime" );
+                                 /* already computed? */
+                                 if ( old_to_new.find( id ) != old_to_new.end() ) { return; }
 
-        const auto f = optimize_node( ffrs.at( id ), id, cuts );
-        old_to_new.insert( {id, f} );
-      }
+                                 const auto f = optimize_node( ffrs.at( id ), id, plan );
+                                 old_to_new.insert( {id, f} );
+                               } );
     }
     else
     {
@@ -361,12 +354,8 @@ void mig_functional_hashing_manager::run()
   {
     if ( use_ffrs )
     {
-      for ( const auto& id : ffrs_topsort )
-      {
-        L( "[i] optimize ffr at " << id );
-
-        depth_preserving_functional_hashing( opt_ffr_t( *ffrs.find( id ) ) );
-      }
+      foreach_ffr<bottom_up_result_t>( [this]( const mig_node& id ) { return depth_preserving_candidates( opt_ffr_t( *ffrs.find( id ) ) ); },
+                                       [this]( const mig_node& id, bottom_up_result_t& result ) { merge_candidates( result ); } );
     }
     else
     {
@@ -382,7 +371,7 @@ void mig_functional_hashing_manager::run()
 }
 
 int mig_functional_hashing_manager::find_best_cut( const mig_node& node, const std::map<mig_node, structural_cut>& cuts,
-                                                   boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm, std::string& expr )
+                                                   mig_fh_transform& transform ) const
 {
   auto best_gain  = 0u;
   auto best_index = -1;
@@ -402,19 +391,19 @@ int mig_functional_hashing_manager::find_best_cut( const mig_node& node, const s
 
     tt_shrink( tt, 4u );
 
-    boost::dynamic_bitset<> local_phase;
-    std::vector<unsigned>   local_perm;
-    const auto npn = compute_npn( tt, local_phase, local_perm );
+    ++npn_lookups;
+    const auto& local_transform = db.transforms[tt.to_ulong()];
+    const auto& replacement     = db.replacements[local_transform.npn];
 
     /* better result? */
-    const auto best_area  = std::get<0>( mig_functional_hashing_constants::min_depth_mig_sizes.at( npn.to_ulong() ) );
-    const auto best_depth = std::get<1>( mig_functional_hashing_constants::min_depth_mig_sizes.at( npn.to_ulong() ) );
+    const auto best_area  = replacement.area;
+    const auto best_depth = replacement.depth;
 
     if ( verbose )
     {
       std::cout << "[i]   analyze cut ";
       print_as_set( std::cout, cut.value ) << ", tt: " << tt_to_hex( tt )
-                                           << ", npn: " << tt_to_hex( npn )
+                                           << ", npn: " << boost::format( "%04x" ) % replacement.function
                                            << ", cur. area:  " << current_area
                                            << ", cur. depth: " << current_depth
                                            << ", best area:  " << best_area
@@ -426,60 +415,100 @@ int mig_functional_hashing_manager::find_best_cut( const mig_node& node, const s
       L( "[i]    new local optimum" );
       best_gain  = current_area - best_area;
       best_index = cut.index;
-      phase      = local_phase;
-      perm       = local_perm;
-      expr       = std::get<3>( mig_functional_hashing_constants::min_depth_mig_sizes.at( npn.to_ulong() ) );
+      transform  = local_transform;
     }
   }
 
   return best_index;
 }
 
-mig_function mig_functional_hashing_manager::optimize_node( const std::vector<mig_node>& ffr_leafs, const mig_node& node,
-                                                            const std::map<aig_node, structural_cut>& cuts )
+ffr_plan_t mig_functional_hashing_manager::plan_ffr( const mig_node& id ) const
 {
-  L( "[i]  optimize node " << node );
+  L( "[i] optimize ffr at " << id );
 
-  /* node is leaf of the FFR */
-  if ( boost::find( ffr_leafs, node ) != ffr_leafs.end() )
+  ffr_plan_t plan;
+
+  /* perform cut enumeration */
+  boost::dynamic_bitset<> boundary( boost::num_vertices( mig ) );
+  for ( const auto& ffr_leaf : ffrs.at( id ) )
   {
-    return old_to_new.at( node );
+    boundary.set( ffr_leaf );
   }
 
-  boost::dynamic_bitset<> phase;
-  std::vector<unsigned>   perm;
-  std::string             expr;
-  auto best_cut = find_best_cut( node, cuts, phase, perm, expr );
+  auto sce_settings = std::make_shared<properties>();
+  auto sce_statistics = std::make_shared<properties>();
+  sce_settings->set( "boundary", boundary );
+  sce_settings->set( "start_nodes", std::vector<mig_node>( {id} ) );
+  auto cuts = structural_cut_enumeration( mig, 5u, sce_settings, sce_statistics );
+
+  plan.runtime_cut = sce_statistics->get<double>( "runtime" );
+
+  plan_node( ffrs.at( id ), id, cuts, plan );
+
+  return plan;
+}
+
+void mig_functional_hashing_manager::plan_node( const std::vector<mig_node>& ffr_leafs, const mig_node& node,
+                                                const std::map<aig_node, structural_cut>& cuts, ffr_plan_t& plan ) const
+{
+  L( "[i]  optimize node " << node );
+
+  /* node is leaf of the FFR */
+  if ( boost::find( ffr_leafs, node ) != ffr_leafs.end() ) { return; }
+
+  mig_fh_transform transform;
+  auto best_cut = find_best_cut( node, cuts, transform );
 
   /* there is no better realization */
   if ( best_cut == -1 )
   {
-    auto children = get_children( mig, node );
-    return mig_create_maj( mig_new,
-                           optimize_node( ffr_leafs, children[0].node, cuts ) ^ children[0].complemented,
-                           optimize_node( ffr_leafs, children[1].node, cuts ) ^ children[1].complemented,
-                           optimize_node( ffr_leafs, children[2].node, cuts ) ^ children[2].complemented );
+    for ( const auto& child : get_children( mig, node ) )
+    {
+      plan_node( ffr_leafs, child.node, cuts, plan );
+    }
+    return;
   }
 
-  std::map<char, mig_function> var_to_function;
-  const auto vars = std::string( "abcd" );
-  auto index = 0u;
-
-  const auto invperm = inv( perm );
-
+  std::vector<mig_node> leafs;
   foreach_bit( cuts.at( node ).at( best_cut ), [&]( unsigned child ) {
       if ( child != 0u )
       {
-        const auto childf = optimize_node( ffr_leafs, child, cuts );
-        var_to_function.insert( {vars[invperm[index]], phase.test( index ) ? !childf : childf} );
-        ++index;
+        plan_node( ffr_leafs, child, cuts, plan );
+        leafs.push_back( child );
       }
     } );
 
-  auto mfs_settings = std::make_shared<properties>();
-  mfs_settings->set( "variable_map", var_to_function );
+  plan.replacements.insert( {node, {leafs, transform}} );
+}
+
+mig_function mig_functional_hashing_manager::optimize_node( const std::vector<mig_node>& ffr_leafs, const mig_node& node,
+                                                            const ffr_plan_t& plan )
+{
+  /* node is leaf of the FFR */
+  if ( boost::find( ffr_leafs, node ) != ffr_leafs.end() )
+  {
+    return old_to_new.at( node );
+  }
+
+  const auto it = plan.replacements.find( node );
+
+  /* there is no better realization */
+  if ( it == plan.replacements.end() )
+  {
+    auto children = get_children( mig, node );
+    return mig_create_maj( mig_new,
+                           optimize_node( ffr_leafs, children[0].node, plan ) ^ children[0].complemented,
+                           optimize_node( ffr_leafs, children[1].node, plan ) ^ children[1].complemented,
+                           optimize_node( ffr_leafs, children[2].node, plan ) ^ children[2].complemented );
+  }
+
+  std::vector<mig_function> leafs;
+  for ( const auto& leaf : it->second.first )
+  {
+    leafs.push_back( optimize_node( ffr_leafs, leaf, plan ) );
+  }
 
-  return make_function( mig_from_string( mig_new, expr, mfs_settings ), phase.test( phase.size() - 1u ) );
+  return create_replacement( mig_new, it->second.second, leafs );
 }
 
 mig_function mig_functional_hashing_manager::optimize_node( const mig_node& node,
@@ -491,10 +520,8 @@ mig_function mig_functional_hashing_manager::optimize_node( const mig_node& node
   const auto it = old_to_new.find( node );
   if ( it != old_to_new.end() ) { return it->second; }
 
-  boost::dynamic_bitset<> phase;
-  std::vector<unsigned>   perm;
-  std::string             expr;
-  auto best_cut = find_best_cut( node, cuts, phase, perm, expr );
+  mig_fh_transform transform;
+  auto best_cut = find_best_cut( node, cuts, transform );
 
   /* there is no better realization */
   if ( best_cut == -1 )
@@ -509,73 +536,39 @@ mig_function mig_functional_hashing_manager::optimize_node( const mig_node& node
     return f;
   }
 
-  std::map<char, mig_function> var_to_function;
-  const auto vars = std::string( "abcd" );
-  auto index = 0u;
-
-  const auto invperm = inv( perm );
-
+  std::vector<mig_function> leafs;
   foreach_bit( cuts.at( node ).at( best_cut ), [&]( unsigned child ) {
       if ( child != 0u )
       {
-        const auto childf = optimize_node( child, cuts );
-        var_to_function.insert( {vars[invperm[index]], phase.test( index ) ? !childf : childf} );
-        ++index;
+        leafs.push_back( optimize_node( child, cuts ) );
       }
     } );
 
-  auto mfs_settings = std::make_shared<properties>();
-  mfs_settings->set( "variable_map", var_to_function );
-
-  auto f = mig_from_string( mig_new, expr, mfs_settings );
-
-  if ( phase.test( phase.size() - 1u ) )
-  {
-    f = !f;
-  }
-
+  const auto f = create_replacement( mig_new, transform, leafs );
   old_to_new.insert( {node, f} );
 
   return f;
 }
 
-tt mig_functional_hashing_manager::compute_npn( const tt& tt, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm )
+mig_function mig_functional_hashing_manager::create_replacement( mig_graph& mig_target, const mig_fh_transform& transform,
+                                                                 const std::vector<mig_function>& leafs ) const
 {
-  boost::dynamic_bitset<> npn;
+  const auto& replacement = db.replacements[transform.npn];
 
-  /* compute NPN and use hash table if possible */
-  if ( !npn_table.empty() )
+  /* constant, variables, and gates; variables not in the support stay constant */
+  std::vector<mig_function> fs( 5u + replacement.gates.size(), mig_get_constant( mig_target, false ) );
+  for ( const auto& leaf : index( leafs ) )
   {
-    const auto ttu      = tt.to_ulong();
-    const auto hash_key = ttu % npn_table.size();
-    auto& entry   = npn_table[hash_key];
-
-    if ( static_cast<unsigned long>( entry.tt ) == ttu )
-    {
-      ++cache_hit;
-      npn = boost::dynamic_bitset<>( 16u, entry.npn );
-      perm = std::vector<unsigned>( entry.perm );
-      phase = boost::dynamic_bitset<>( entry.phase );
-    }
-    else
-    {
-      ++cache_miss;
-      increment_timer t( &runtime_npn );
-      npn = exact_npn_canonization( tt, phase, perm );
-
-      entry.tt    = ttu;
-      entry.npn   = npn.to_ulong();
-      entry.perm  = perm;
-      entry.phase = phase;
-    }
+    fs[1u + transform.perm[leaf.index]] = make_function( leaf.value, ( transform.phase >> leaf.index ) & 1u );
   }
-  else
+
+  const auto literal = [&fs]( unsigned l ) { return make_function( fs[l >> 1u], l & 1u ); };
+  for ( const auto& gate : index( replacement.gates ) )
   {
-    increment_timer t( &runtime_npn );
-    npn = exact_npn_canonization( tt, phase, perm );
+    fs[5u + gate.index] = mig_create_maj( mig_target, literal( gate.value[0u] ), literal( gate.value[1u] ), literal( gate.value[2u] ) );
   }
 
-  return npn;
+  return make_function( literal( replacement.output ), ( transform.phase >> 4u ) & 1u );
 }
 
 bool mig_functional_hashing_manager::is_fanout_free_cut( const mig_node& node, const boost::dynamic_bitset<>& cut ) const
@@ -603,13 +596,14 @@ bool mig_functional_hashing_manager::is_fanout_free_cut( const mig_node& node, c
   return true;
 }
 
-void mig_functional_hashing_manager::depth_preserving_functional_hashing( const opt_ffr_t& ffr )
+bottom_up_result_t mig_functional_hashing_manager::depth_preserving_candidates( const opt_ffr_t& ffr ) const
 {
   /* size of the MIG */
   const auto n = boost::num_vertices( mig );
 
   /* a temporary MIG */
-  mig_graph mig_tmp;
+  bottom_up_result_t result;
+  auto& mig_tmp = result.mig_tmp;
   mig_initialize( mig_tmp, info.model_name );
 
   /* map nodes from mig to candidates in mig_tmp */
@@ -717,18 +711,12 @@ void mig_functional_hashing_manager::depth_preserving_functional_hashing( const
 
         tt_shrink( tt, 4u );
 
-        boost::dynamic_bitset<> phase;
-        std::vector<unsigned>   perm;
-        const auto npn = compute_npn( tt, phase, perm );
+        ++npn_lookups;
+        const auto& transform   = db.transforms[tt.to_ulong()];
+        const auto& replacement = db.replacements[transform.npn];
 
-        const auto best_area = std::get<0>( mig_functional_hashing_constants::min_depth_mig_sizes.at( npn.to_ulong() ) );
+        if ( !allow_area_inc && replacement.area > current_area ) { continue; }
 
-        if ( !allow_area_inc && best_area > current_area ) { continue; }
-
-        std::map<char, mig_function> var_to_function;
-        const auto vars = std::string( "abcd" );
-
-        const auto invperm = inv( perm );
         const auto leafs = get_index_vector( cut );
 
         /* mixed radix preparation */
@@ -742,36 +730,26 @@ void mig_functional_hashing_manager::depth_preserving_functional_hashing( const
         }
 
         mixed_radix( a, m, [&]( const std::vector<unsigned>& a ) {
-            std::map<char, mig_function> var_to_function;
+            std::vector<mig_function> leaf_functions( leafs.size() );
 
             /* depth of new_f */
             auto max_depth = 0u;
-            const auto& arrival = std::get<2>( mig_functional_hashing_constants::min_depth_mig_sizes.at( npn.to_ulong() ) );
 
-            auto index = 0u;
             for ( auto i = 0u; i < leafs.size(); ++i )
             {
-              const auto& cand  = node_map[leafs[i]].candidates[a[i + 1u]];
-              const auto childf = cand.f;
+              const auto& cand = node_map[leafs[i]].candidates[a[i + 1u]];
+              leaf_functions[i] = cand.f;
 
-              const auto key = 'a' + invperm[index];
-              var_to_function.insert( {key, make_function( childf, phase.test( i ) ) } );
-
-              const auto it_arrival = arrival.find( key );
-              if ( it_arrival != arrival.end() )
+              const auto var = transform.perm[i];
+              if ( ( replacement.support >> var ) & 1u )
               {
-                max_depth = std::max( max_depth, cand.depth + it_arrival->second );
+                max_depth = std::max( max_depth, cand.depth + replacement.arrival[var] );
               }
-              ++index;
             }
 
             if ( !allow_depth_inc && max_depth > depths[node] ) { return false; }
 
-            auto mfs_settings = std::make_shared<properties>();
-            mfs_settings->set( "variable_map", var_to_function );
-
-            const auto& expr = std::get<3>( mig_functional_hashing_constants::min_depth_mig_sizes.at( npn.to_ulong() ) );
-            const auto new_f = make_function( mig_from_string( mig_tmp, expr, mfs_settings ), phase.test( phase.size() - 1u ) );
+            const auto new_f = create_replacement( mig_tmp, transform, leaf_functions );
 
             /* area of new_f */
             const auto new_f_area = compute_coi_size( mig_tmp, new_f.node );
@@ -790,42 +768,84 @@ void mig_functional_hashing_manager::depth_preserving_functional_hashing( const
 
   if ( ffr == boost::none )
   {
-    std::map<mig_node, mig_function> tmp_to_new;
-
     for ( const auto& p : old_to_new )
     {
       assert( node_map[p.first].candidates.size() == 1u );
-      tmp_to_new.insert( {node_map[p.first].candidates.front().f.node, p.second} );
+      result.leafs.push_back( {p.first, node_map[p.first].candidates.front().f.node} );
     }
 
     for ( const auto& output : info.outputs )
     {
-      const auto tmp_f = node_map[output.first.node].min_element( max_candidates, sort_area_first ).f;
-      const auto f = make_function( copy_tmp_to_new( tmp_f.node, mig_tmp, tmp_to_new ), tmp_f.complemented );
-      old_to_new.insert( {output.first.node, f} );
+      result.roots.push_back( {output.first.node, node_map[output.first.node].min_element( max_candidates, sort_area_first ).f} );
     }
   }
   else
   {
-    std::map<mig_node, mig_function> tmp_to_new;
-
     for ( const auto& child : ffr->second )
     {
       assert( node_map[child].candidates.size() == 1u );
-      tmp_to_new.insert( {node_map[child].candidates.front().f.node, old_to_new.at( child )} );
+      result.leafs.push_back( {child, node_map[child].candidates.front().f.node} );
     }
 
-    const auto tmp_f = node_map[ffr->first].min_element( max_candidates, sort_area_first ).f;
+    result.roots.push_back( {ffr->first, node_map[ffr->first].min_element( max_candidates, sort_area_first ).f} );
+  }
 
-    // std::cout << "candidates for " << ffr->first << std::endl;
+  return result;
+}
+
+void mig_functional_hashing_manager::depth_preserving_functional_hashing( const opt_ffr_t& ffr )
+{
+  merge_candidates( depth_preserving_candidates( ffr ) );
+}
+
+void mig_functional_hashing_manager::merge_candidates( const bottom_up_result_t& result )
+{
+  std::map<mig_node, mig_function> tmp_to_new;
 
-    // for ( const auto& c : node_map[ffr->first].candidates )
-    // {
-    //   std::cout << "  " << c.f.node << " " << c.area << " " << c.depth << std::endl;
-    // }
+  for ( const auto& leaf : result.leafs )
+  {
+    tmp_to_new.insert( {leaf.second, old_to_new.at( leaf.first )} );
+  }
 
-    const auto f = make_function( copy_tmp_to_new( tmp_f.node, mig_tmp, tmp_to_new ), tmp_f.complemented );
-    old_to_new.insert( {ffr->first, f} );
+  for ( const auto& root : result.roots )
+  {
+    const auto& tmp_f = root.second;
+    const auto f = make_function( copy_tmp_to_new( tmp_f.node, result.mig_tmp, tmp_to_new ), tmp_f.complemented );
+    old_to_new.insert( {root.first, f} );
+  }
+}
+
+template<typename Result>
+void mig_functional_hashing_manager::foreach_ffr( const std::function<Result( const mig_node& )>& compute,
+                                                  const std::function<void( const mig_node&, Result& )>& merge )
+{
+  if ( num_threads <= 1u )
+  {
+    for ( const auto& id : ffrs_topsort )
+    {
+      auto result = compute( id );
+      merge( id, result );
+    }
+    return;
+  }
+
+  /* keep a bounded window of FFRs in flight, merge strictly in order such
+     that the result does not depend on the number of threads */
+  thread_pool pool( num_threads );
+  std::deque<std::future<Result>> pending;
+  const auto window = 4u * num_threads;
+  auto next = 0u;
+
+  for ( const auto& id : ffrs_topsort )
+  {
+    while ( next < ffrs_topsort.size() && pending.size() < window )
+    {
+      pending.push_back( pool.enqueue( compute, ffrs_topsort[next++] ) );
+    }
+
+    auto result = pending.front().get();
+    pending.pop_front();
+    merge( id, result );
   }
 }
 
@@ -863,7 +883,7 @@ mig_graph mig_functional_hashing( const mig_graph& mig,
   const auto top_down            = get( settings, "top_down",            true );
   const auto use_ffrs            = get( settings, "use_ffrs",            true );
   const auto depth_heuristic     = get( settings, "depth_heuristic",     false );
-  const auto npn_hash_table_size = get( settings, "npn_hash_table_size", 0u );
+  const auto num_threads         = get( settings, "num_threads",         1u );
   const auto progress            = get( settings, "progress",            false );
   const auto max_candidates      = get( settings, "max_candidates",      10u );
   const auto allow_area_inc      = get( settings, "allow_area_inc",      false );
@@ -874,8 +894,15 @@ mig_graph mig_functional_hashing( const mig_graph& mig,
   /* timing */
   properties_timer t( statistics );
 
+  /* the database is built on first use, account for it as NPN time */
+  double runtime_npn = 0.0;
+  {
+    reference_timer t_npn( &runtime_npn );
+    mig_functional_hashing_constants::min_depth_database();
+  }
+
   /* new graph */
-  mig_functional_hashing_manager mgr( mig, use_ffrs, top_down, npn_hash_table_size, verbose );
+  mig_functional_hashing_manager mgr( mig, use_ffrs, top_down, num_threads, verbose );
   mgr.depth_heuristic = depth_heuristic;
   mgr.progress        = progress;
   mgr.max_candidates  = max_candidates;
@@ -887,9 +914,9 @@ mig_graph mig_functional_hashing( const mig_graph& mig,
 
   set( statistics, "runtime_ffr", mgr.runtime_ffr );
   set( statistics, "runtime_cut", mgr.runtime_cut );
-  set( statistics, "runtime_npn", mgr.runtime_npn );
-  set( statistics, "cache_hit",   mgr.cache_hit );
-  set( statistics, "cache_miss",  mgr.cache_miss );
+  set( statistics, "runtime_npn", runtime_npn );
+  set( statistics, "cache_hit",   mgr.npn_lookups.load() );
+  set( statistics, "cache_miss",  0ul );
 
   return mgr.mig_new;
 }
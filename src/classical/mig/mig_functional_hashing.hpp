@@ -42,6 +42,45 @@
 namespace cirkit
 {
 
+/**
+ * @brief Functional hashing with minimum MIGs for all 4-input NPN classes
+ *
+ * Cut functions are mapped to their NPN class and replacement with a single
+ * table lookup.  FFRs are optimized independently on num_threads threads and
+ * merged in topological order, the result does not depend on num_threads.
+ *
+ * @settings
+ *
+   |-----------------+---------------------------------------------------+---------|
+   | Settings        | Description                                       | Default |
+   |-----------------+---------------------------------------------------+---------|
+   | top_down        | Top-down (true) or bottom-up (false) replacement  | true    |
+   | use_ffrs        | Only optimize inside FFRs                         | true    |
+   | num_threads     | Number of threads to optimize FFRs                | 1u      |
+   | depth_heuristic | Preserve depth locally (top-down)                 | false   |
+   | max_candidates  | Candidates per node (bottom-up)                   | 10u     |
+   | allow_area_inc  | Allow area increase for candidates (bottom-up)    | false   |
+   | allow_depth_inc | Allow depth increase for candidates (bottom-up)   | false   |
+   | sort_area_first | Sort candidates by area, then depth (bottom-up)   | true    |
+   | progress        | Show progress                                     | false   |
+   | verbose         | Be verbose                                        | false   |
+   |-----------------+---------------------------------------------------+---------|
+ *
+ * The former setting npn_hash_table_size is ignored.
+ *
+ * @statistics
+ *
+   |-------------+------------------------------------------------------------|
+   | Statistics  | Description                                                |
+   |-------------+------------------------------------------------------------|
+   | runtime     | Total run-time                                             |
+   | runtime_cut | Run-time for cut enumeration                               |
+   | runtime_ffr | Run-time for computing FFRs                                |
+   | runtime_npn | Run-time for building the NPN database (0 after first use) |
+   | cache_hit   | Number of NPN database lookups                             |
+   | cache_miss  | Always 0, the database covers all 4-input functions        |
+   |-------------+------------------------------------------------------------|
+ */
 mig_graph mig_functional_hashing( const mig_graph& mig,
                                   const properties::ptr& settings = properties::ptr(),
                                   const properties::ptr& statistics = properties::ptr() );
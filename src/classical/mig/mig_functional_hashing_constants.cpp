@@ -26,6 +26,11 @@
 
 #include "mig_functional_hashing_constants.hpp"
 
+#include <algorithm>
+#include <cassert>
+
+#include <boost/range/algorithm.hpp>
+
 namespace cirkit
 {
 
@@ -487,10 +492,133 @@ const std::unordered_map<unsigned, std::tuple<unsigned, unsigned, std::map<char,
  * Private functions                                                          *
  ******************************************************************************/
 
+unsigned parse_mig_fh_replacement( const std::string& expr, unsigned& pos, mig_fh_replacement& r,
+                                   std::map<std::array<unsigned, 3u>, unsigned>& strash )
+{
+  auto complement = 0u;
+  if ( expr[pos] == '!' )
+  {
+    complement = 1u;
+    ++pos;
+  }
+
+  if ( expr[pos] == '<' )
+  {
+    ++pos;
+    std::array<unsigned, 3u> children;
+    for ( auto& c : children )
+    {
+      c = parse_mig_fh_replacement( expr, pos, r, strash );
+    }
+    assert( expr[pos] == '>' );
+    ++pos;
+
+    boost::sort( children );
+    const auto it = strash.find( children );
+    if ( it != strash.end() )
+    {
+      return it->second ^ complement;
+    }
+
+    const auto lit = 2u * ( 5u + r.gates.size() );
+    r.gates.push_back( children );
+    strash.insert( {children, lit} );
+    return lit ^ complement;
+  }
+  else if ( expr[pos] == '0' || expr[pos] == '1' )
+  {
+    return ( expr[pos++] == '1' ? 1u : 0u ) ^ complement;
+  }
+  else
+  {
+    return 2u * ( 1u + ( expr[pos++] - 'a' ) ) ^ complement;
+  }
+}
+
+mig_fh_database build_mig_fh_database( const std::unordered_map<unsigned, std::tuple<unsigned, unsigned, std::map<char, unsigned>, std::string>>& table )
+{
+  mig_fh_database db;
+  db.transforms.resize( 1u << 16u );
+  std::vector<bool> assigned( 1u << 16u, false );
+
+  /* fixed order for reproducible tables */
+  std::vector<unsigned> keys;
+  for ( const auto& p : table )
+  {
+    keys.push_back( p.first );
+  }
+  boost::sort( keys );
+
+  for ( const auto& key : keys )
+  {
+    const auto& entry = table.at( key );
+
+    mig_fh_replacement r;
+    r.function = key;
+    r.area     = std::get<0>( entry );
+    r.depth    = std::get<1>( entry );
+    r.support  = 0u;
+    r.arrival.fill( 0u );
+    for ( const auto& p : std::get<2>( entry ) )
+    {
+      r.support |= 1u << ( p.first - 'a' );
+      r.arrival[p.first - 'a'] = p.second;
+    }
+
+    std::map<std::array<unsigned, 3u>, unsigned> strash;
+    auto pos = 0u;
+    r.output = parse_mig_fh_replacement( std::get<3>( entry ), pos, r, strash );
+
+    const auto npn = static_cast<unsigned short>( db.replacements.size() );
+    db.replacements.push_back( r );
+
+    /* all functions in the NPN class of key */
+    std::array<unsigned char, 4u> perm{{0u, 1u, 2u, 3u}};
+    do
+    {
+      for ( auto phase = 0u; phase < 32u; ++phase )
+      {
+        auto func = 0u;
+        for ( auto x = 0u; x < 16u; ++x )
+        {
+          auto y = 0u;
+          for ( auto i = 0u; i < 4u; ++i )
+          {
+            if ( ( ( x ^ phase ) >> i ) & 1u )
+            {
+              y |= 1u << perm[i];
+            }
+          }
+          if ( ( ( key >> y ) ^ ( phase >> 4u ) ) & 1u )
+          {
+            func |= 1u << x;
+          }
+        }
+
+        if ( !assigned[func] )
+        {
+          assigned[func] = true;
+          db.transforms[func] = {npn, perm, static_cast<unsigned char>( phase )};
+        }
+      }
+    } while ( std::next_permutation( perm.begin(), perm.end() ) );
+  }
+
+  assert( boost::find( assigned, false ) == assigned.end() );
+
+  return db;
+}
+
 /******************************************************************************
  * Public functions                                                           *
  ******************************************************************************/
 
+const mig_fh_database& mig_functional_hashing_constants::min_depth_database()
+{
+  static const auto db = build_mig_fh_database( min_depth_mig_sizes );
+  return db;
+}
+
 }
 
 // Local Variables:
@@ -36,17 +36,52 @@
 #ifndef MIG_FUNCTIONAL_HASHING_CONSTANTS_HPP
 #define MIG_FUNCTIONAL_HASHING_CONSTANTS_HPP
 
+#include <array>
 #include <map>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace cirkit
 {
 
+/* pre-parsed replacement circuit of one NPN class; operands are literals
+   2 * id + complement where id 0 is constant 0, ids 1 to 4 are the variables
+   a to d, and ids 5, 6, ... are the gates in creation order */
+struct mig_fh_replacement
+{
+  unsigned                              function; /* truth table of the class representative */
+  unsigned                              area;
+  unsigned                              depth;
+  unsigned                              support;  /* bit i is set, if variable i has an arrival time */
+  std::array<unsigned, 4u>              arrival;
+  std::vector<std::array<unsigned, 3u>> gates;
+  unsigned                              output;
+};
+
+/* transformation of a 4-input function into its NPN class representative:
+   cut leaf i is assigned to variable perm[i], complemented if bit i of phase
+   is set, and bit 4 of phase complements the output */
+struct mig_fh_transform
+{
+  unsigned short                npn;   /* index into replacements */
+  std::array<unsigned char, 4u> perm;
+  unsigned char                 phase;
+};
+
+struct mig_fh_database
+{
+  std::vector<mig_fh_replacement> replacements;
+  std::vector<mig_fh_transform>   transforms;   /* indexed by truth table */
+};
+
 struct mig_functional_hashing_constants
 {
   static const std::unordered_map<unsigned, std::tuple<unsigned, unsigned, std::map<char, unsigned>, std::string>> min_mig_sizes;
   static const std::unordered_map<unsigned, std::tuple<unsigned, unsigned, std::map<char, unsigned>, std::string>> min_depth_mig_sizes;
+
+  /* built once from min_depth_mig_sizes on first use, read-only afterwards */
+  static const mig_fh_database& min_depth_database();
 };
 
 }
@@ -26,7 +26,11 @@
 
 #include "mig_rewriting.hpp"
 
+#include <algorithm>
+#include <array>
+#include <deque>
 #include <functional>
+#include <unordered_map>
 
 #include <boost/assign/std/vector.hpp>
 #include <boost/dynamic_bitset.hpp>
@@ -34,6 +38,7 @@
 #include <boost/range/iterator_range.hpp>
 
 #include <core/graph/depth.hpp>
+#include <core/utils/hash_utils.hpp>
 #include <core/utils/timer.hpp>
 #include <classical/mig/mig_utils.hpp>
 
@@ -61,6 +66,85 @@ inline std::pair<unsigned, unsigned> three_without( unsigned x )
   return std::make_pair( x == 0u ? 1u : 0u, x == 2u ? 1u : 2u );
 }
 
+/* MIG that is rewritten in place: fanout lists and the structural hash table
+   are kept up to date, replaced nodes are substituted in their fanouts and
+   removed together with their dangling fanin cones.  Literals are 2 * node +
+   complement, node indexes of the input MIG are kept.  The manager is kept
+   over several passes; after the first push-up pass, only nodes that
+   changed (and their fanouts) are visited again. */
+class mig_inplace_manager
+{
+public:
+  mig_inplace_manager( const mig_graph& mig, bool verbose );
+
+  void run_push_up();
+  void run_relevance();
+  mig_graph to_mig() const;
+  unsigned depth() const;
+
+public:
+  bool     use_distributivity       = true;
+  bool     use_associativity        = true;
+  bool     use_compl_associativity  = true;
+  unsigned rewrite_limit            = 0u; /* 0u: until convergence */
+  unsigned relevance_cone_limit     = 64u;
+
+  /* statistics */
+  unsigned distributivity_count       = 0u;
+  unsigned associativity_count        = 0u;
+  unsigned compl_associativity_count  = 0u;
+  unsigned relevance_count            = 0u;
+
+private:
+  using literal_t = unsigned;
+  using fanin_t   = std::array<literal_t, 3u>;
+  using key_t     = std::tuple<literal_t, literal_t, literal_t>;
+
+  static inline unsigned node_of( literal_t l ) { return l >> 1u; }
+  static inline bool     is_complemented( literal_t l ) { return l & 1u; }
+  static inline key_t    make_key( const fanin_t& f ) { return std::make_tuple( f[0u], f[1u], f[2u] ); }
+
+  inline bool is_regular_gate( literal_t l ) const { return !is_complemented( l ) && is_gate[node_of( l )]; }
+  inline unsigned level_of( literal_t l ) const { return levels[node_of( l )]; }
+  inline unsigned maj_level( literal_t a, literal_t b, literal_t c ) const { return std::max( { level_of( a ), level_of( b ), level_of( c ) } ) + 1u; }
+  inline unsigned num_refs( unsigned n ) const { return fanouts[n].size() + output_refs[n]; }
+
+  boost::optional<literal_t> normalize( fanin_t& f ) const;
+  literal_t create_maj( literal_t a, literal_t b, literal_t c );
+  void substitute( unsigned node, literal_t lit );
+  void take_out( unsigned node, literal_t lit );
+  void update_levels( unsigned node );
+  void push_worklist( unsigned node );
+  void remove_dangling( unsigned first_new, literal_t keep );
+  unsigned replaced_level( literal_t root, unsigned x, literal_t lit, std::unordered_map<unsigned, unsigned>& memo ) const;
+  literal_t replace_in_cone( literal_t root, unsigned x, literal_t lit, std::unordered_map<unsigned, literal_t>& memo );
+
+  boost::optional<literal_t> distributivity( unsigned node );
+  boost::optional<literal_t> associativity( unsigned node );
+  boost::optional<literal_t> compl_associativity( unsigned node );
+  boost::optional<literal_t> relevance( unsigned node );
+
+private:
+  bool                                          verbose;
+  std::string                                   model_name;
+  bool                                          constant_used;
+  std::vector<std::pair<unsigned, std::string>> inputs;
+  std::vector<std::pair<literal_t, std::string>> outputs;
+
+  std::vector<fanin_t>                          fanins;
+  std::vector<std::vector<unsigned>>            fanouts;
+  std::vector<unsigned>                         output_refs;
+  std::vector<unsigned>                         levels;
+  std::vector<bool>                             is_gate;
+  std::vector<bool>                             is_dead;
+  std::vector<literal_t>                        replacement;
+  std::unordered_map<key_t, unsigned, hash<key_t>> strash;
+
+  std::deque<unsigned>                          worklist;
+  std::vector<bool>                             in_worklist;
+  bool                                          all_visited = false;
+};
+
 class mig_rewriting_manager
 {
 public:
@@ -81,7 +165,7 @@ public:
   mig_function distributivity_ltr( const mig_node& f );
   mig_function associativity( const mig_node& f );
   mig_function compl_associativity( const mig_node& f );
-  mig_function relevance( const mig_node& f, std::map<mig_function, mig_function> replacements );
+  mig_function relevance( const mig_node& f, std::map<mig_function, mig_function>& replacements );
 
   mig_function push_up( const mig_node& f );
   mig_function memristor_optimization( const mig_node& f );
@@ -168,6 +252,7 @@ public:
   mig_graph                        mig_old;
   mig_graph                        mig_current;
   std::map<mig_node, mig_function> old_to_new;
+  std::vector<std::map<mig_node, mig_function>> relevance_memo; /* one per nested replacement */
   bool                             verbose;
   std::vector<unsigned>            indegree;
   std::vector<unsigned>            depths;
@@ -241,6 +326,586 @@ std::vector<children_pair_t> get_children_pairs( const mig_function_vec_t& c1,
   return pairs;
 }
 
+mig_inplace_manager::mig_inplace_manager( const mig_graph& mig, bool verbose )
+  : verbose( verbose )
+{
+  const auto& info = mig_info( mig );
+  const auto n = num_vertices( mig );
+
+  model_name    = info.model_name;
+  constant_used = info.constant_used;
+
+  fanins.resize( n, {{0u, 0u, 0u}} );
+  fanouts.resize( n );
+  output_refs.resize( n, 0u );
+  levels.resize( n, 0u );
+  is_gate.resize( n, false );
+  is_dead.resize( n, false );
+  replacement.resize( n, 0u );
+  in_worklist.resize( n, false );
+
+  for ( const auto& input : info.inputs )
+  {
+    inputs.push_back( {input, info.node_names.at( input )} );
+  }
+
+  /* children are always created before their parents */
+  for ( auto node = 0u; node < n; ++node )
+  {
+    if ( out_degree( node, mig ) == 0u ) { continue; }
+
+    const auto children = get_children( mig, node );
+    for ( auto i = 0u; i < 3u; ++i )
+    {
+      assert( children[i].node < node );
+      fanins[node][i] = 2u * children[i].node + ( children[i].complemented ? 1u : 0u );
+      fanouts[children[i].node].push_back( node );
+    }
+
+    is_gate[node] = true;
+    levels[node]  = maj_level( fanins[node][0u], fanins[node][1u], fanins[node][2u] );
+    strash.insert( {make_key( fanins[node] ), node} );
+  }
+
+  for ( const auto& output : info.outputs )
+  {
+    outputs.push_back( {2u * output.first.node + ( output.first.complemented ? 1u : 0u ), output.second} );
+    ++output_refs[output.first.node];
+  }
+}
+
+unsigned mig_inplace_manager::depth() const
+{
+  auto depth = 0u;
+  for ( const auto& output : outputs )
+  {
+    depth = std::max( depth, level_of( output.first ) );
+  }
+  return depth;
+}
+
+/* returns the equivalent literal if f is trivial, otherwise sorts f */
+boost::optional<mig_inplace_manager::literal_t> mig_inplace_manager::normalize( fanin_t& f ) const
+{
+  if ( f[0u] == f[1u] )        { return f[0u]; }
+  if ( f[0u] == f[2u] )        { return f[0u]; }
+  if ( f[1u] == f[2u] )        { return f[1u]; }
+  if ( f[0u] == ( f[1u] ^ 1u ) ) { return f[2u]; }
+  if ( f[0u] == ( f[2u] ^ 1u ) ) { return f[1u]; }
+  if ( f[1u] == ( f[2u] ^ 1u ) ) { return f[0u]; }
+
+  std::sort( f.begin(), f.end() );
+  return boost::none;
+}
+
+mig_inplace_manager::literal_t mig_inplace_manager::create_maj( literal_t a, literal_t b, literal_t c )
+{
+  fanin_t f = {{a, b, c}};
+  if ( const auto trivial = normalize( f ) )
+  {
+    return *trivial;
+  }
+
+  const auto it = strash.find( make_key( f ) );
+  if ( it != strash.end() )
+  {
+    return 2u * it->second;
+  }
+
+  const auto node = static_cast<unsigned>( fanins.size() );
+  fanins.push_back( f );
+  fanouts.emplace_back();
+  output_refs.push_back( 0u );
+  levels.push_back( maj_level( a, b, c ) );
+  is_gate.push_back( true );
+  is_dead.push_back( false );
+  replacement.push_back( 0u );
+  in_worklist.push_back( false );
+
+  for ( auto l : f )
+  {
+    fanouts[node_of( l )].push_back( node );
+  }
+  strash.insert( {make_key( f ), node} );
+  push_worklist( node );
+
+  return 2u * node;
+}
+
+void mig_inplace_manager::substitute( unsigned node, literal_t lit )
+{
+  std::vector<std::pair<unsigned, literal_t>> stack( 1u, {node, lit} );
+
+  while ( !stack.empty() )
+  {
+    const auto old_node = stack.back().first;
+    auto new_lit = stack.back().second;
+    stack.pop_back();
+
+    if ( is_dead[old_node] ) { continue; }
+    while ( is_dead[node_of( new_lit )] )
+    {
+      new_lit = replacement[node_of( new_lit )] ^ ( new_lit & 1u );
+    }
+
+    for ( auto& output : outputs )
+    {
+      if ( output_refs[old_node] == 0u ) { break; }
+      if ( node_of( output.first ) != old_node ) { continue; }
+      output.first = new_lit ^ ( output.first & 1u );
+      --output_refs[old_node];
+      ++output_refs[node_of( new_lit )];
+    }
+
+    const auto parents = std::move( fanouts[old_node] );
+    fanouts[old_node].clear();
+
+    for ( auto parent : parents )
+    {
+      auto& f = fanins[parent];
+
+      const auto it = strash.find( make_key( f ) );
+      if ( it != strash.end() && it->second == parent )
+      {
+        strash.erase( it );
+      }
+
+      for ( auto& l : f )
+      {
+        if ( node_of( l ) == old_node )
+        {
+          l = new_lit ^ ( l & 1u );
+          fanouts[node_of( new_lit )].push_back( parent );
+        }
+      }
+
+      if ( const auto trivial = normalize( f ) )
+      {
+        stack.push_back( {parent, *trivial} );
+        continue;
+      }
+
+      const auto it2 = strash.find( make_key( f ) );
+      if ( it2 != strash.end() )
+      {
+        stack.push_back( {parent, 2u * it2->second} );
+        continue;
+      }
+
+      strash.insert( {make_key( f ), parent} );
+      update_levels( parent );
+      push_worklist( parent );
+    }
+
+    take_out( old_node, new_lit );
+  }
+
+  if ( is_gate[node_of( lit )] && !is_dead[node_of( lit )] && num_refs( node_of( lit ) ) == 0u )
+  {
+    take_out( node_of( lit ), lit );
+  }
+}
+
+/* removes node (which is replaced by lit) and its dangling fanin cone */
+void mig_inplace_manager::take_out( unsigned node, literal_t lit )
+{
+  is_dead[node]     = true;
+  replacement[node] = lit;
+
+  std::vector<unsigned> stack( 1u, node );
+
+  while ( !stack.empty() )
+  {
+    const auto n = stack.back();
+    stack.pop_back();
+
+    const auto it = strash.find( make_key( fanins[n] ) );
+    if ( it != strash.end() && it->second == n )
+    {
+      strash.erase( it );
+    }
+
+    for ( auto l : fanins[n] )
+    {
+      const auto child = node_of( l );
+      auto& fo = fanouts[child];
+      const auto pos = std::find( fo.begin(), fo.end(), n );
+      if ( pos == fo.end() ) { continue; }
+      fo.erase( pos );
+
+      if ( is_gate[child] && !is_dead[child] && num_refs( child ) == 0u )
+      {
+        is_dead[child] = true;
+        stack.push_back( child );
+      }
+    }
+  }
+}
+
+void mig_inplace_manager::update_levels( unsigned node )
+{
+  std::deque<unsigned> queue( 1u, node );
+
+  while ( !queue.empty() )
+  {
+    const auto n = queue.front();
+    queue.pop_front();
+
+    if ( is_dead[n] ) { continue; }
+
+    const auto& f = fanins[n];
+    const auto level = maj_level( f[0u], f[1u], f[2u] );
+    if ( level == levels[n] ) { continue; }
+
+    levels[n] = level;
+    for ( auto parent : fanouts[n] )
+    {
+      queue.push_back( parent );
+      push_worklist( parent );
+    }
+  }
+}
+
+void mig_inplace_manager::push_worklist( unsigned node )
+{
+  if ( !in_worklist[node] )
+  {
+    in_worklist[node] = true;
+    worklist.push_back( node );
+  }
+}
+
+/* removes nodes created since first_new that are not used, e.g., when the
+   last node of a rule is found in the hash table; keep is the result of the
+   rule, which is not used yet.  Removed nodes are skipped in the worklist. */
+void mig_inplace_manager::remove_dangling( unsigned first_new, literal_t keep )
+{
+  for ( auto node = static_cast<unsigned>( fanins.size() ); node-- > first_new; )
+  {
+    if ( node == node_of( keep ) || is_dead[node] || num_refs( node ) > 0u ) { continue; }
+    take_out( node, 0u );
+  }
+}
+
+/* level of replace_in_cone( root, x, lit ) without creating nodes; it is
+   an upper bound since strashing and trivial majorities only lower levels */
+unsigned mig_inplace_manager::replaced_level( literal_t root, unsigned x, literal_t lit, std::unordered_map<unsigned, unsigned>& memo ) const
+{
+  const auto n = node_of( root );
+  if ( n == x ) { return level_of( lit ); }
+  if ( !is_gate[n] || levels[n] <= levels[x] ) { return levels[n]; }
+
+  const auto it = memo.find( n );
+  if ( it != memo.end() ) { return it->second; }
+  if ( memo.size() >= relevance_cone_limit ) { return levels[n]; }
+
+  const auto& f = fanins[n];
+  const auto level = std::max( { replaced_level( f[0u], x, lit, memo ), replaced_level( f[1u], x, lit, memo ), replaced_level( f[2u], x, lit, memo ) } ) + 1u;
+
+  memo.insert( {n, level} );
+  return level;
+}
+
+/* copy of the cone of root in which node x is replaced by lit; only nodes
+   above the level of x can contain x.  At most relevance_cone_limit nodes are
+   copied, replacing only some occurrences of x is still sound. */
+mig_inplace_manager::literal_t mig_inplace_manager::replace_in_cone( literal_t root, unsigned x, literal_t lit, std::unordered_map<unsigned, literal_t>& memo )
+{
+  const auto n = node_of( root );
+  if ( n == x ) { return lit ^ is_complemented( root ); }
+  if ( !is_gate[n] || levels[n] <= levels[x] ) { return root; }
+
+  const auto it = memo.find( n );
+  if ( it != memo.end() ) { return it->second ^ is_complemented( root ); }
+  if ( memo.size() >= relevance_cone_limit ) { return root; }
+
+  const auto f = fanins[n]; /* copy, create_maj may add nodes */
+  const auto a = replace_in_cone( f[0u], x, lit, memo );
+  const auto b = replace_in_cone( f[1u], x, lit, memo );
+  const auto c = replace_in_cone( f[2u], x, lit, memo );
+  const auto res = ( a == f[0u] && b == f[1u] && c == f[2u] ) ? 2u * n : create_maj( a, b, c );
+
+  memo.insert( {n, res} );
+  return res ^ is_complemented( root );
+}
+
+/**
+ * 〈xy〈uvz〉〉↦〈〈xyu〉〈xyv〉z〉
+ */
+boost::optional<mig_inplace_manager::literal_t> mig_inplace_manager::distributivity( unsigned node )
+{
+  const auto children = fanins[node];
+
+  for ( auto i = 0u; i < 3u; ++i )
+  {
+    if ( !is_regular_gate( children[i] ) ) { continue; }
+
+    const auto grand_children = fanins[node_of( children[i] )];
+    const auto xy = three_without( i );
+    const auto x = children[xy.first];
+    const auto y = children[xy.second];
+
+    for ( auto j = 0u; j < 3u; ++j )
+    {
+      const auto uv = three_without( j );
+      const auto u = grand_children[uv.first];
+      const auto v = grand_children[uv.second];
+      const auto z = grand_children[j];
+
+      if ( std::max( level_of( z ), std::max( { level_of( x ), level_of( y ), level_of( u ), level_of( v ) } ) + 1u ) + 1u >= levels[node] ) { continue; }
+
+      ++distributivity_count;
+      return create_maj( create_maj( x, y, u ), create_maj( x, y, v ), z );
+    }
+  }
+
+  return boost::none;
+}
+
+/**
+ * 〈xu〈yuz〉〉↦〈zu〈yux〉〉
+ */
+boost::optional<mig_inplace_manager::literal_t> mig_inplace_manager::associativity( unsigned node )
+{
+  const auto children = fanins[node];
+
+  for ( auto i = 0u; i < 3u; ++i )
+  {
+    if ( !is_regular_gate( children[i] ) ) { continue; }
+
+    const auto grand_children = fanins[node_of( children[i] )];
+
+    for ( auto j = 0u; j < 3u; ++j )
+    {
+      if ( i == j ) { continue; }
+
+      const auto u = children[j];
+      const auto x = children[3u - i - j];
+      const auto pos = std::find( grand_children.begin(), grand_children.end(), u );
+      if ( pos == grand_children.end() ) { continue; }
+
+      const auto yz = three_without( std::distance( grand_children.begin(), pos ) );
+
+      for ( const auto& p : { yz, std::make_pair( yz.second, yz.first ) } )
+      {
+        const auto y = grand_children[p.first];
+        const auto z = grand_children[p.second];
+
+        if ( std::max( { level_of( z ), level_of( u ), maj_level( y, u, x ) } ) + 1u >= levels[node] ) { continue; }
+
+        ++associativity_count;
+        return create_maj( z, u, create_maj( y, u, x ) );
+      }
+    }
+  }
+
+  return boost::none;
+}
+
+/**
+ * 〈xu〈yu'z〉〉↦〈xu〈yxz〉〉
+ */
+boost::optional<mig_inplace_manager::literal_t> mig_inplace_manager::compl_associativity( unsigned node )
+{
+  const auto children = fanins[node];
+
+  for ( auto i = 0u; i < 3u; ++i )
+  {
+    if ( !is_regular_gate( children[i] ) ) { continue; }
+
+    const auto grand_children = fanins[node_of( children[i] )];
+
+    for ( auto j = 0u; j < 3u; ++j )
+    {
+      if ( i == j ) { continue; }
+
+      const auto u = children[j];
+      const auto x = children[3u - i - j];
+      const auto pos = std::find( grand_children.begin(), grand_children.end(), u ^ 1u );
+      if ( pos == grand_children.end() ) { continue; }
+
+      const auto yz = three_without( std::distance( grand_children.begin(), pos ) );
+      const auto y = grand_children[yz.first];
+      const auto z = grand_children[yz.second];
+
+      if ( std::max( { level_of( x ), level_of( u ), maj_level( y, x, z ) } ) + 1u >= levels[node] ) { continue; }
+
+      ++compl_associativity_count;
+      return create_maj( x, u, create_maj( y, x, z ) );
+    }
+  }
+
+  return boost::none;
+}
+
+/**
+ * 〈xyz〉↦〈xyz_{x/y'}〉
+ */
+boost::optional<mig_inplace_manager::literal_t> mig_inplace_manager::relevance( unsigned node )
+{
+  const auto children = fanins[node];
+
+  for ( auto i = 0u; i < 3u; ++i )
+  {
+    const auto z = children[i];
+
+    /* only a critical child can lower the level */
+    if ( !is_gate[node_of( z )] || level_of( z ) + 1u != levels[node] ) { continue; }
+
+    const auto xy = three_without( i );
+    for ( const auto& p : { xy, std::make_pair( xy.second, xy.first ) } )
+    {
+      const auto x = children[p.first];
+      const auto y = children[p.second];
+
+      if ( node_of( x ) == 0u || node_of( y ) == 0u ) { continue; }
+
+      const auto lit = ( y ^ 1u ) ^ is_complemented( x );
+
+      /* check the level before creating any node */
+      std::unordered_map<unsigned, unsigned> level_memo;
+      if ( std::max( { level_of( x ), level_of( y ), replaced_level( z, node_of( x ), lit, level_memo ) } ) + 1u >= levels[node] ) { continue; }
+
+      const auto first_new = static_cast<unsigned>( fanins.size() );
+      std::unordered_map<unsigned, literal_t> memo;
+      const auto res = create_maj( x, y, replace_in_cone( z, node_of( x ), lit, memo ) );
+      remove_dangling( first_new, res );
+      ++relevance_count;
+      return res;
+    }
+  }
+
+  return boost::none;
+}
+
+void mig_inplace_manager::run_push_up()
+{
+  /* the first pass visits all nodes, later passes only the changed ones */
+  if ( !all_visited )
+  {
+    for ( auto node = 0u; node < fanins.size(); ++node )
+    {
+      if ( is_gate[node] && !is_dead[node] )
+      {
+        push_worklist( node );
+      }
+    }
+    all_visited = true;
+  }
+
+  const auto depth_before = depth();
+  auto rewrites = 0u;
+
+  while ( !worklist.empty() && ( rewrite_limit == 0u || rewrites < rewrite_limit ) )
+  {
+    const auto node = worklist.front();
+    worklist.pop_front();
+    in_worklist[node] = false;
+
+    if ( is_dead[node] ) { continue; }
+
+    const auto first_new = static_cast<unsigned>( fanins.size() );
+
+    boost::optional<literal_t> res;
+    if ( use_distributivity )              { res = distributivity( node ); }
+    if ( !res && use_associativity )       { res = associativity( node ); }
+    if ( !res && use_compl_associativity ) { res = compl_associativity( node ); }
+
+    if ( res )
+    {
+      remove_dangling( first_new, *res );
+      substitute( node, *res );
+      ++rewrites;
+    }
+  }
+
+  if ( verbose )
+  {
+    std::cout << boost::format( "[i] in-place push-up: %d rewrites, depth %d -> %d" ) % rewrites % depth_before % depth() << std::endl;
+  }
+}
+
+void mig_inplace_manager::run_relevance()
+{
+  const auto depth_before = depth();
+  auto rewrites = 0u;
+
+  /* nodes created by the pass are not visited */
+  const auto size = static_cast<unsigned>( fanins.size() );
+  for ( auto node = 0u; node < size && ( rewrite_limit == 0u || rewrites < rewrite_limit ); ++node )
+  {
+    if ( !is_gate[node] || is_dead[node] ) { continue; }
+
+    if ( const auto res = relevance( node ) )
+    {
+      substitute( node, *res );
+      ++rewrites;
+    }
+  }
+
+  if ( verbose )
+  {
+    std::cout << boost::format( "[i] in-place relevance: %d rewrites, depth %d -> %d" ) % rewrites % depth_before % depth() << std::endl;
+  }
+}
+
+mig_graph mig_inplace_manager::to_mig() const
+{
+  mig_graph mig;
+  mig_initialize( mig, model_name );
+  mig_info( mig ).constant_used = constant_used;
+
+  std::vector<mig_function> node_to_new( fanins.size() );
+  std::vector<bool> visited( fanins.size(), false );
+
+  node_to_new[0u] = {mig_info( mig ).constant, false};
+  visited[0u] = true;
+
+  for ( const auto& input : inputs )
+  {
+    node_to_new[input.first] = mig_create_pi( mig, input.second );
+    visited[input.first] = true;
+  }
+
+  const auto to_function = [&node_to_new]( literal_t l ) { return node_to_new[node_of( l )] ^ is_complemented( l ); };
+
+  /* iterative DFS, the graph may be deep */
+  std::vector<std::pair<unsigned, bool>> stack;
+  for ( const auto& output : outputs )
+  {
+    stack.push_back( {node_of( output.first ), false} );
+
+    while ( !stack.empty() )
+    {
+      const auto n = stack.back();
+      stack.pop_back();
+
+      if ( n.second )
+      {
+        const auto& f = fanins[n.first];
+        node_to_new[n.first] = mig_create_maj( mig, to_function( f[0u] ), to_function( f[1u] ), to_function( f[2u] ) );
+        continue;
+      }
+
+      if ( visited[n.first] ) { continue; }
+      visited[n.first] = true;
+
+      stack.push_back( {n.first, true} );
+      for ( auto l : fanins[n.first] )
+      {
+        if ( !visited[node_of( l )] )
+        {
+          stack.push_back( {node_of( l ), false} );
+        }
+      }
+    }
+
+    mig_create_po( mig, to_function( output.first ), output.second );
+  }
+
+  return mig;
+}
+
 mig_rewriting_manager::mig_rewriting_manager( const mig_graph& mig, bool verbose )
   : mig_current( mig ),
     verbose( verbose )
@@ -667,19 +1332,28 @@ cache_and_return:
 /**
  * 〈xyz〉↦〈xyz_{x/y'}〉
  */
-mig_function mig_rewriting_manager::relevance( const mig_node& f, std::map<mig_function, mig_function> replacements )
+mig_function mig_rewriting_manager::relevance( const mig_node& f, std::map<mig_function, mig_function>& replacements )
 {
-  /* node should be replaced? */
+  /* node should be replaced? (keys are functions in mig_old) */
   auto it_replace = replacements.find( {f, false} );
   if ( it_replace != replacements.end() ) { return it_replace->second; }
 
   it_replace = replacements.find( {f, true} );
   if ( it_replace != replacements.end() ) { return !it_replace->second; }
 
-  /* node is terminal */
+  /* node is terminal or has been computed without replacements; the latter
+     can be reused inside a replacement, since replacing only some
+     occurrences of x in z is sound */
   const auto it = old_to_new.find( f );
   if ( it != old_to_new.end() ) { return it->second; }
 
+  /* node has been computed with the current replacements */
+  for ( auto m = relevance_memo.rbegin(); m != relevance_memo.rend(); ++m )
+  {
+    const auto it_memo = m->find( f );
+    if ( it_memo != m->end() ) { return it_memo->second; }
+  }
+
   mig_function res;
 
   const auto cand = find_depth_relevance_candidate( f );
@@ -699,11 +1373,22 @@ mig_function mig_rewriting_manager::relevance( const mig_node& f, std::map<mig_f
     const auto xf = make_function( relevance( x.node, replacements ), x.complemented );
     const auto yf = make_function( relevance( y.node, replacements ), y.complemented );
 
-    if ( xf.node != 0u && yf.node != 0u )
+    /* the replacement is only visible in the cone of z */
+    auto inserted = false;
+    if ( x.node != 0u && y.node != 0u )
     {
-      replacements.insert( {xf, !yf} );
+      inserted = replacements.insert( {x, !yf} ).second;
+    }
+    if ( inserted )
+    {
+      relevance_memo.emplace_back();
     }
     const auto zf = make_function( relevance( z.node, replacements ), z.complemented );
+    if ( inserted )
+    {
+      replacements.erase( x );
+      relevance_memo.pop_back();
+    }
 
     res = mig_create_maj( mig_current, xf, yf, zf );
   }
@@ -718,7 +1403,14 @@ mig_function mig_rewriting_manager::relevance( const mig_node& f, std::map<mig_f
                           make_function( relevance( children[2u].node, replacements ), children[2u].complemented ) );
   }
 
-  old_to_new.insert( {f, res} );
+  if ( replacements.empty() )
+  {
+    old_to_new.insert( {f, res} );
+  }
+  else
+  {
+    relevance_memo.back().insert( {f, res} );
+  }
   return res;
 }
 
@@ -955,11 +1647,37 @@ mig_graph mig_depth_rewriting( const mig_graph& mig,
   const auto use_distributivity       = get( settings, "use_distributivity", true );
   const auto use_associativity        = get( settings, "use_associativity", true );
   const auto use_compl_associativity  = get( settings, "use_compl_associativity", true );
+  const auto inplace                  = get( settings, "inplace", true );
+  const auto rewrite_limit            = get( settings, "rewrite_limit", 0u );
   const auto verbose                  = get( settings, "verbose", false );
 
   /* timer */
   properties_timer t( statistics );
 
+  if ( inplace )
+  {
+    /* one manager for all passes, converted back once in the end */
+    mig_inplace_manager mgr( mig, verbose );
+    mgr.use_distributivity      = use_distributivity;
+    mgr.use_associativity       = use_associativity;
+    mgr.use_compl_associativity = use_compl_associativity;
+    mgr.rewrite_limit           = rewrite_limit;
+
+    for ( auto k = 0u; k < effort; ++k )
+    {
+      mgr.run_push_up();
+      mgr.run_relevance();
+      mgr.run_push_up();
+    }
+
+    set( statistics, "distributivity_count",       mgr.distributivity_count );
+    set( statistics, "associativity_count",        mgr.associativity_count );
+    set( statistics, "compl_associativity_count",  mgr.compl_associativity_count );
+    set( statistics, "relevance_count",            mgr.relevance_count );
+
+    return mgr.to_mig();
+  }
+
   mig_rewriting_manager mgr( mig, verbose );
   mgr.use_distributivity = use_distributivity;
   mgr.use_associativity  = use_associativity;
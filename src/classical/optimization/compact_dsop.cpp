@@ -26,6 +26,9 @@
 
 #include "compact_dsop.hpp"
 
+#include <algorithm>
+#include <cassert>
+
 #include <boost/assign/std/vector.hpp>
 #include <boost/dynamic_bitset.hpp>
 #include <boost/graph/adjacency_list.hpp>
@@ -62,51 +65,56 @@ connected_cube_list::connected_cube_list( const cube_vec_t& new_cubes )
 void connected_cube_list::add( const cube& c )
 {
   /* check if cube already exists */
-  auto it = _connected_cubes.find( c );
-  if ( it != _connected_cubes.end() ) return;
+  if ( contains( c ) ) return;
 
   /* find matching cubes */
+  const auto candidates = intersecting_slots( c );
+  const auto slot = insert_slot( c );
+
   cube_common_vec_t commons;
   int weight = 0;
-  for ( const auto& other : _cubes )
+  for ( auto s = candidates.find_first(); s != boost::dynamic_bitset<>::npos; s = candidates.find_next( s ) )
   {
+    const auto& other = slot_cubes[s];
     int m = other.match_intersect( c );
-    if ( m != -1 )
-    {
-      commons += std::make_pair( other, (unsigned)m );
-      weight += c.dimension() - m - 1;
-      _connected_cubes[other] += std::make_pair( c, (unsigned)m );
-      cube_weights[other] += other.dimension() - m - 1;
-    }
+    assert( m != -1 );
+
+    commons += std::make_pair( (unsigned)s, (unsigned)m );
+    weight += c.dimension() - m - 1;
+    _connected_cubes[s] += std::make_pair( slot, (unsigned)m );
+    cube_weights[other] += other.dimension() - m - 1;
   }
 
   /* add cube */
   _cubes += c;
-  _connected_cubes[c] = commons;
+  _connected_cubes[slot] = commons;
   cube_weights[c] = weight;
 }
 
 void connected_cube_list::remove( const cube& c )
 {
   /* check if cube exists */
-  auto it = _connected_cubes.find( c );
-  if ( it == _connected_cubes.end() ) return;
+  auto it = cube_to_slot.find( c );
+  if ( it == cube_to_slot.end() ) return;
+  const auto slot = it->second;
 
   /* remove from others */
-  for ( const auto& p : it->second )
+  for ( const auto& p : _connected_cubes[slot] )
   {
-    auto it2 = boost::find( _connected_cubes[p.first], p );
-    if ( it2 != _connected_cubes[p.first].end() )
+    auto& others = _connected_cubes[p.first];
+    auto it2 = boost::find_if( others, [slot]( const cube_common_pair_t& q ) { return q.first == slot; } );
+    if ( it2 != others.end() )
     {
-      cube_weights[p.first] -= p.first.dimension() - p.second - 1;
-      _connected_cubes[p.first].erase( it2 );
+      const auto& other = slot_cubes[p.first];
+      cube_weights[other] -= other.dimension() - p.second - 1;
+      others.erase( it2 );
     }
   }
 
-  /* remove cube */
-  _connected_cubes.erase( c );
+  /* remove cube, it is often the last one */
   cube_weights.erase( c );
-  _cubes.erase( boost::find( _cubes, c ) );
+  _cubes.erase( std::find( _cubes.rbegin(), _cubes.rend(), c ).base() - 1 );
+  erase_slot( slot );
 }
 
 cube_vec_t connected_cube_list::remove_disjoint_cubes()
@@ -116,19 +124,17 @@ cube_vec_t connected_cube_list::remove_disjoint_cubes()
   /* find disjoint cubes */
   for ( const auto& c : _cubes )
   {
-    if ( _connected_cubes[c].empty() )
+    const auto slot = cube_to_slot.at( c );
+    if ( _connected_cubes[slot].empty() )
     {
       dis += c;
-      _connected_cubes.erase( c );
       cube_weights.erase( c );
+      erase_slot( slot );
     }
   }
 
   /* remove disjoint cubes */
-  for ( const auto& d : dis )
-  {
-    _cubes.erase( boost::find( _cubes, d ) );
-  }
+  _cubes.erase( std::remove_if( _cubes.begin(), _cubes.end(), [this]( const cube& c ) { return !contains( c ); } ), _cubes.end() );
 
   return dis;
 }
@@ -137,14 +143,101 @@ cube_vec_t connected_cube_list::connected_cubes( const cube& c ) const
 {
   cube_vec_t connected;
 
-  for ( const auto& p : _connected_cubes.find( c )->second )
+  for ( const auto& p : _connected_cubes[cube_to_slot.at( c )] )
   {
-    connected += p.first;
+    connected += slot_cubes[p.first];
   }
 
   return connected;
 }
 
+cube_vec_t connected_cube_list::intersecting_cubes( const cube& c ) const
+{
+  cube_vec_t intersecting;
+
+  const auto slots = intersecting_slots( c );
+  for ( auto s = slots.find_first(); s != boost::dynamic_bitset<>::npos; s = slots.find_next( s ) )
+  {
+    intersecting += slot_cubes[s];
+  }
+
+  return intersecting;
+}
+
+boost::dynamic_bitset<> connected_cube_list::intersecting_slots( const cube& c ) const
+{
+  /* all cubes except those that contain the complement of some literal in c */
+  auto slots = used_slots;
+
+  const auto bits = c.bits();
+  const auto care = c.care();
+  for ( auto i = care.find_first(); i != boost::dynamic_bitset<>::npos; i = care.find_next( i ) )
+  {
+    const auto lit = 2u * i + ( bits[i] ? 0u : 1u );
+    if ( lit < literal_slots.size() )
+    {
+      slots -= literal_slots[lit];
+    }
+  }
+
+  return slots;
+}
+
+unsigned connected_cube_list::insert_slot( const cube& c )
+{
+  unsigned slot;
+  if ( free_slots.empty() )
+  {
+    slot = slot_cubes.size();
+    slot_cubes.push_back( c );
+    _connected_cubes.emplace_back();
+    used_slots.push_back( false );
+    for ( auto& l : literal_slots )
+    {
+      l.push_back( false );
+    }
+  }
+  else
+  {
+    slot = free_slots.back();
+    free_slots.pop_back();
+    slot_cubes[slot] = c;
+  }
+
+  if ( literal_slots.size() < 2u * c.length() )
+  {
+    literal_slots.resize( 2u * c.length(), boost::dynamic_bitset<>( used_slots.size() ) );
+  }
+
+  const auto bits = c.bits();
+  const auto care = c.care();
+  for ( auto i = care.find_first(); i != boost::dynamic_bitset<>::npos; i = care.find_next( i ) )
+  {
+    literal_slots[2u * i + ( bits[i] ? 1u : 0u )].set( slot );
+  }
+
+  used_slots.set( slot );
+  cube_to_slot[c] = slot;
+
+  return slot;
+}
+
+void connected_cube_list::erase_slot( unsigned slot )
+{
+  const auto& c = slot_cubes[slot];
+  const auto bits = c.bits();
+  const auto care = c.care();
+  for ( auto i = care.find_first(); i != boost::dynamic_bitset<>::npos; i = care.find_next( i ) )
+  {
+    literal_slots[2u * i + ( bits[i] ? 1u : 0u )].reset( slot );
+  }
+
+  _connected_cubes[slot].clear();
+  used_slots.reset( slot );
+  cube_to_slot.erase( c );
+  free_slots.push_back( slot );
+}
+
 void connected_cube_list::sort( const sort_cube_meta_func_t& sortfunc )
 {
   boost::sort( _cubes, sortfunc( cube_weights ) );
@@ -205,8 +298,7 @@ cube_vec_t compute_dsop( cube_vec_t& c, const sort_cube_meta_func_t& sortfunc, c
 
       for ( const auto& cubeq : connected )
       {
-        auto it = boost::find( p.cubes(), cubeq );
-        if ( it == p.cubes().end() )
+        if ( !p.contains( cubeq ) )
         {
           continue;
         }
@@ -307,16 +399,9 @@ void opt_dsop_2( const cube& cubeq, const cube_vec_t& q, connected_cube_list& p,
 
 void opt_dsop_3( const cube& cubeq, const cube_vec_t& q, connected_cube_list& p, cube_vec_t& b, const sort_cube_meta_func_t& sortfunc )
 {
-  cube_vec_t remove;
+  cube_vec_t remove = p.intersecting_cubes( cubeq );
   boost::push_back( b, q );
-  for ( const auto& cube : p.cubes() )
-  {
-    if ( cube.match_intersect( cubeq ) != -1 )
-    {
-      b += cube;
-      remove += cube;
-    }
-  }
+  boost::push_back( b, remove );
 
   for ( const auto& cube : remove )
   {
@@ -39,6 +39,9 @@
 #include <functional>
 #include <map>
 #include <string>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
 
 #include <core/cube.hpp>
 #include <core/properties.hpp>
@@ -63,7 +66,9 @@ public:
   inline void operator+=( const cube& c ) { add( c ); }
   inline void operator-=( const cube& c ) { remove( c ); }
 
+  inline bool contains( const cube& c ) const { return cube_to_slot.find( c ) != cube_to_slot.end(); }
   cube_vec_t connected_cubes( const cube& c ) const;
+  cube_vec_t intersecting_cubes( const cube& c ) const;
   void sort( const sort_cube_meta_func_t& sortfunc );
 
   inline const cube_vec_t& cubes() const { return _cubes; }
@@ -71,13 +76,25 @@ public:
   inline bool empty() const { return _cubes.empty(); }
 
 private:
-  using cube_common_pair_t = std::pair<cube, unsigned>;
+  boost::dynamic_bitset<> intersecting_slots( const cube& c ) const;
+  unsigned insert_slot( const cube& c );
+  void erase_slot( unsigned slot );
+
+private:
+  using cube_common_pair_t = std::pair<unsigned, unsigned>; /* slot and number of common literals */
   using cube_common_vec_t  = std::vector<cube_common_pair_t>;
-  using cube_common_map_t  = std::map<cube, cube_common_vec_t>;
 
   cube_vec_t _cubes;
-  cube_common_map_t _connected_cubes;
   cube_weight_map_t cube_weights;
+
+  /* intersection index: each cube occupies a slot and for each literal
+   * (2 * var + value) there is a posting bitmap of all slots that contain it */
+  std::vector<cube> slot_cubes;
+  std::map<cube, unsigned> cube_to_slot;
+  std::vector<unsigned> free_slots;
+  boost::dynamic_bitset<> used_slots;
+  std::vector<boost::dynamic_bitset<>> literal_slots;
+  std::vector<cube_common_vec_t> _connected_cubes;
 };
 
 using opt_cube_func_t = std::function<void(const cube&, const cube_vec_t&, connected_cube_list&, cube_vec_t&, const sort_cube_meta_func_t&)>;
@@ -26,12 +26,14 @@
 
 #include "esop_minimization.hpp"
 
+#include <algorithm>
+#include <cstdint>
 #include <iomanip>
-#include <list>
+#include <limits>
+#include <unordered_map>
+#include <vector>
 
 #include <boost/algorithm/string/join.hpp>
-#include <boost/assign/std/list.hpp>
-#include <boost/assign/std/vector.hpp>
 #include <boost/format.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/random/mersenne_twister.hpp>
@@ -46,8 +48,6 @@
 #include <core/utils/terminal.hpp>
 #include <core/utils/timer.hpp>
 
-using namespace boost::assign;
-
 namespace cirkit
 {
 
@@ -77,25 +77,75 @@ std::ostream& operator<<( std::ostream& os, const cube_t& cube )
   return os;
 }
 
-boost::dynamic_bitset<> diff_cube( const cube_t& c1, const cube_t& c2 )
+/* Cubes are packed with two bits per variable into 64-bit words.  The lower
+ * bit of each field stores the polarity and the upper bit whether the variable
+ * is present, i.e., 00 is an absent variable, 10 a negative and 11 a positive
+ * literal.  Two cubes differ in a variable iff their fields differ in some bit.
+ */
+using packed_word_t = std::uint64_t;
+
+constexpr unsigned      packed_vars_per_word = 32u;
+constexpr packed_word_t packed_low_bits      = 0x5555555555555555ull;
+
+inline packed_word_t packed_diff( packed_word_t w1, packed_word_t w2 )
 {
-  return ((c1.second ^ c2.second) | ((c1.second & c1.first) ^ (c2.second & c2.first)));
+  const auto d = w1 ^ w2;
+  return ( d | ( d >> 1u ) ) & packed_low_bits;
 }
 
-/* Returns the distance of c1 and c2. If distance is 1 and bit_pos == -1, then bit_pos stores
- * the bit position in which they differ.
- */
-boost::dynamic_bitset<>::size_type compute_distance( const cube_t& c1, const cube_t& c2, int& bit_pos )
+/* Returns the distance of c1 and c2, stops counting as soon as bound is exceeded. */
+inline unsigned packed_distance( const packed_word_t * c1, const packed_word_t * c2, unsigned words, unsigned bound )
 {
-  boost::dynamic_bitset<> diff = diff_cube( c1, c2 );
-  auto d = diff.count();
-  if ( d == 1 && bit_pos == -1 )
+  auto d = 0u;
+  for ( auto w = 0u; w < words && d <= bound; ++w )
   {
-    bit_pos = diff.find_first();
+    d += __builtin_popcountll( packed_diff( c1[w], c2[w] ) );
   }
   return d;
 }
 
+inline std::uint64_t packed_hash_word( packed_word_t word, unsigned index )
+{
+  /* splitmix64 finalizer */
+  auto h = word + 0x9e3779b97f4a7c15ull * ( index + 1u );
+  h = ( h ^ ( h >> 30u ) ) * 0xbf58476d1ce4e5b9ull;
+  h = ( h ^ ( h >> 27u ) ) * 0x94d049bb133111ebull;
+  return h ^ ( h >> 31u );
+}
+
+/* The hash is a sum over all words, such that it can be updated in constant time
+ * when a single variable is masked or changed. */
+inline std::uint64_t packed_hash( const packed_word_t * c, unsigned words )
+{
+  std::uint64_t h = 0u;
+  for ( auto w = 0u; w < words; ++w )
+  {
+    h += packed_hash_word( c[w], w );
+  }
+  return h;
+}
+
+inline packed_word_t packed_field_mask( unsigned position )
+{
+  return 3ull << ( 2u * ( position % packed_vars_per_word ) );
+}
+
+/* This changes cube c1 at position to the value that neither c1 nor c2 have at this position. */
+inline void packed_change( packed_word_t * c1, const packed_word_t * c2, unsigned position )
+{
+  const auto w = position / packed_vars_per_word;
+  const auto s = 2u * ( position % packed_vars_per_word );
+  c1[w] ^= ( c2[w] ^ ( 1ull << s ) ) & ( 3ull << s );
+}
+
+/* This copies the value of c2 at position into c1. */
+inline void packed_copy( packed_word_t * c1, const packed_word_t * c2, unsigned position )
+{
+  const auto w = position / packed_vars_per_word;
+  const auto m = packed_field_mask( position );
+  c1[w] = ( c1[w] & ~m ) | ( c2[w] & m );
+}
+
 /* This changes cube c1 at position with respect to the value of c2 at this position. */
 void change( cube_t& c1, const cube_t& c2, unsigned position )
 {
@@ -130,120 +180,148 @@ void change_alternative( cube_t& c1, const cube_t& c2, unsigned position )
 class esop_manager
 {
 public:
-  typedef std::pair<unsigned, unsigned> cube_pair_t;
-  typedef std::list<cube_pair_t> cube_pair_list_t;
+  using packed_cube_t = std::vector<packed_word_t>;
+
+  /* pairs refer to cube slots, the stamps detect whether one of the slots was freed in between */
+  struct cube_pair_t
+  {
+    unsigned first, second;
+    unsigned first_stamp, second_stamp;
+  };
+  typedef std::vector<cube_pair_t> cube_pair_list_t;
 
   esop_manager( DdManager * cudd, bool verbose = false, unsigned capacity = 1000u )
     : cudd( cudd ),
       verbose( verbose ),
+      num_vars( Cudd_ReadSize( cudd ) ),
+      words( std::max( 1u, ( num_vars + packed_vars_per_word - 1u ) / packed_vars_per_word ) ),
       distance_lists( 3u )
   {
-    _cubes.reserve( capacity );
+    data.reserve( capacity * words );
+    stamps.reserve( capacity );
+    alive.reserve( capacity );
+    hashes.reserve( capacity );
+    hash_index.reserve( capacity );
   }
 
-  void add_cube( cube_t cube )
+  void add_cube( const cube_t& cube )
   {
-    unsigned cubeid = 0u;
-    std::vector<char> distances( _cubes.size() );
-    int bit_pos = -1;
+    packed_cube_t c( words, 0u );
+    for ( auto i = 0u; i < num_vars; ++i )
+    {
+      if ( cube.second[i] )
+      {
+        c[i / packed_vars_per_word] |= ( cube.first[i] ? 3ull : 2ull ) << ( 2u * ( i % packed_vars_per_word ) );
+      }
+    }
+    add_cube( std::move( c ) );
+  }
+
+  void add_cube( packed_cube_t cube )
+  {
+    unsigned bit_pos;
 
-    for ( ; cubeid < _cubes.size(); ++cubeid )
+    while ( true )
     {
-      const cube_t& c = _cubes.at( cubeid );
+      const auto h = packed_hash( cube.data(), words );
 
       /* distance-0 */
-      if ( ( distances[cubeid] = compute_distance( c, cube, bit_pos ) ) == 0 )
+      const auto cubeid = find_cube( cube.data(), h, 0u, cube[0u] );
+      if ( cubeid != npos )
       {
         remove_cube( cubeid );
         return;
       }
-    }
 
-    /* distance-1 */
-    auto it = boost::find( distances, 1 );
-    if ( it != distances.end() )
-    {
-      unsigned distance_one_cubeid = std::distance( distances.begin(), it );
-      cube_t c = _cubes.at( distance_one_cubeid );
-      change( c, cube, bit_pos );
+      /* distance-1 */
+      const auto distance_one_cubeid = find_neighbor( cube.data(), h, bit_pos );
+      if ( distance_one_cubeid == npos )
+      {
+        break;
+      }
+
+      packed_cube_t c( cube_begin( distance_one_cubeid ), cube_begin( distance_one_cubeid ) + words );
+      packed_change( c.data(), cube.data(), bit_pos );
       remove_cube( distance_one_cubeid );
-      add_cube( c );
-      return;
+      cube = std::move( c );
     }
 
     /* Add cube */
-    for ( unsigned i = 0u ; i < distances.size(); ++i )
+    const auto slot = allocate_slot( cube );
+    const auto * c = cube_begin( slot );
+
+    for ( auto i = 0u; i < stamps.size(); ++i )
     {
-      if ( distances[i] <= 4 )
+      if ( !alive[i] || i == slot ) continue;
+
+      const auto d = packed_distance( cube_begin( i ), c, words, 4u );
+      if ( d >= 2u && d <= 4u )
       {
-        distance_lists[distances[i] - 2u] += std::make_pair( i, _cubes.size() );
+        distance_lists[d - 2u].push_back( {i, slot, stamps[i], stamps[slot]} );
       }
     }
-
-    _cubes += cube;
-  }
-
-  void remove_from_distance_list( cube_pair_list_t& l, unsigned cubeid, bool remove_first = true, bool remove_second = true )
-  {
-    l.remove_if( [&cubeid, &remove_first, &remove_second]( const std::pair<unsigned, unsigned>& p ) {
-        return ( remove_first && p.first == cubeid ) || ( remove_second && p.second == cubeid );
-      } );
-    for ( auto it = l.begin(); it != l.end(); ++it )
-    {
-      if ( remove_first  && it->first  > cubeid ) { it->first--;  }
-      if ( remove_second && it->second > cubeid ) { it->second--; }
-    }
   }
 
   void remove_cube( unsigned cubeid )
   {
-    _cubes.erase( _cubes.begin() + cubeid );
+    assert( alive[cubeid] );
 
-    /* remove from distance lists */
-    for ( unsigned i = 0u; i < 3u; ++i )
+    const auto range = hash_index.equal_range( hashes[cubeid] );
+    for ( auto it = range.first; it != range.second; ++it )
     {
-      remove_from_distance_list( distance_lists[i], cubeid );
+      if ( it->second == cubeid )
+      {
+        hash_index.erase( it );
+        break;
+      }
     }
+
+    /* pairs referring to this slot are lazily removed from the distance lists */
+    ++stamps[cubeid];
+    alive[cubeid] = false;
+    free_slots.push_back( cubeid );
+    --_cube_count;
   }
 
   /* We know the distance when we call this function, so we do not want to recompute it */
-  void get_different_positions( const cube_t& c1, const cube_t& c2, unsigned distance, std::vector<unsigned>& positions )
+  void get_different_positions( const packed_word_t * c1, const packed_word_t * c2, unsigned distance, std::vector<unsigned>& positions ) const
   {
-    boost::dynamic_bitset<> diff = diff_cube( c1, c2 );
-    unsigned pos;
-
-    for ( unsigned i = 0u; i < distance; ++i )
+    positions.clear();
+    for ( auto w = 0u; w < words && positions.size() < distance; ++w )
     {
-      positions += ( pos = diff.find_first() );
-      diff.flip( pos );
+      for ( auto diff = packed_diff( c1[w], c2[w] ); diff; diff &= diff - 1u )
+      {
+        positions.push_back( w * packed_vars_per_word + __builtin_ctzll( diff ) / 2u );
+      }
     }
   }
 
-  std::string pair_list_to_string( const cube_pair_list_t& l )
+  std::string pair_list_to_string( const cube_pair_list_t& l ) const
   {
+    using boost::adaptors::filtered;
     using boost::adaptors::transformed;
 
-    return boost::join( l | transformed( []( const cube_pair_t& p ) {
+    return boost::join( l | filtered( [this]( const cube_pair_t& p ) { return is_valid( p ); } )
+                          | transformed( []( const cube_pair_t& p ) {
           return boost::str( boost::format( "(%d,%d)" ) % p.first % p.second ); } ), ", " );
   }
 
-  void get_exorlink_group( const cube_t& c1, const cube_t& c2, cube_t * tmp_cubes, unsigned group, const std::vector<unsigned>& positions )
+  void get_exorlink_group( const packed_word_t * c1, const packed_word_t * c2, packed_cube_t * tmp_cubes, unsigned group, const std::vector<unsigned>& positions ) const
   {
     /* distance is positions.size() */
     unsigned distance = positions.size();
     for ( unsigned i = 0u; i < distance; ++i )
     {
-      tmp_cubes[i] = c1;
+      tmp_cubes[i].assign( c1, c1 + words );
       for ( unsigned j = 0u; j < distance; ++j )
       {
         switch ( cube_groups[cube_group_offsets[distance - 2u] + group * distance * distance + i * distance + j] )
         {
         case 1u:
-          tmp_cubes[i].first.set( positions[j], c2.first[positions[j]] );
-          tmp_cubes[i].second.set( positions[j], c2.second[positions[j]] );
+          packed_copy( tmp_cubes[i].data(), c2, positions[j] );
           break;
         case 2u:
-          change( tmp_cubes[i], c2, positions[j] );
+          packed_change( tmp_cubes[i].data(), c2, positions[j] );
           break;
         }
       }
@@ -252,19 +330,15 @@ public:
 
   bool leads_to_improvement( unsigned cubeid1, unsigned cubeid2, unsigned distance )
   {
-    assert( cubeid1 < cubeid2 );
-
-    using boost::adaptors::transformed;
-
-    const cube_t& c1 = _cubes.at( cubeid1 ); /* easy access to c1 */
-    const cube_t& c2 = _cubes.at( cubeid2 ); /* easy access to c2 */
+    /* copy c1 and c2, since adding cubes may move the cube storage */
+    const packed_cube_t c1( cube_begin( cubeid1 ), cube_begin( cubeid1 ) + words );
+    const packed_cube_t c2( cube_begin( cubeid2 ), cube_begin( cubeid2 ) + words );
 
     std::vector<unsigned> positions;        /* positions of different cubes in c1 and c2 */
-    cube_t tmp_cubes[4];                    /* used for current cube computation */
+    packed_cube_t tmp_cubes[4];             /* used for current cube computation */
     int improvement;                        /* store the current possible improvement */
-    int bit_pos;
 
-    get_different_positions( c1, c2, distance, positions );
+    get_different_positions( c1.data(), c2.data(), distance, positions );
 
     /* loop over all grous */
     for ( unsigned group = 0u; group < cube_group_count[distance - 2u]; ++group )
@@ -277,33 +351,18 @@ public:
       /* reset values */
       improvement = distance - 2;
 
-      get_exorlink_group( c1, c2, tmp_cubes, group, positions );
+      get_exorlink_group( c1.data(), c2.data(), tmp_cubes, group, positions );
 
       /* follow exor link */
       for ( unsigned i = 0; i < distance; ++i )
       {
         if ( verbose )
         {
-          std::cout << "    " << i << ": " << tmp_cubes[i] << std::endl;
+          std::cout << "    " << i << ": " << to_cube( tmp_cubes[i].data() ) << std::endl;
         }
 
-        bit_pos = -1;
-        for ( unsigned cubeid = 0u; cubeid < _cubes.size(); ++cubeid )
-        {
-          /* do not calculate distance to given cubes */
-          if ( cubeid == cubeid1 || cubeid == cubeid2 ) continue;
-
-          const cube_t& ex_cube = _cubes.at( cubeid );
-          auto d = compute_distance( ex_cube, tmp_cubes[i], bit_pos );
-          if ( d == 0u )
-          {
-            improvement -= 2;
-          }
-          else if ( d == 1u )
-          {
-            improvement -= 1;
-          }
-        }
+        improvement -= 2 * count_neighbors( tmp_cubes[i].data(), 0u, cubeid1, cubeid2 );
+        improvement -= count_neighbors( tmp_cubes[i].data(), 1u, cubeid1, cubeid2 );
       }
 
       /* did we find a good permutation? */
@@ -321,7 +380,7 @@ public:
         /* add new cubes */
         for ( unsigned i = 0u; i < distance; ++i )
         {
-          add_cube( tmp_cubes[i] );
+          add_cube( std::move( tmp_cubes[i] ) );
         }
 
         return true;
@@ -333,8 +392,6 @@ public:
 
   bool exorlink( unsigned distance )
   {
-    using boost::adaptors::transformed;
-
     assert( distance >= 2 && distance <= 4 );
 
     if ( verbose )
@@ -342,9 +399,14 @@ public:
       print_banner( boost::str( boost::format( "EXOR-LINK (d = %d)" ) % distance ) );
     }
 
-    std::vector<unsigned> positions;
-    for ( const auto& p : distance_lists.at( distance - 2u ) )
+    auto& pairs = distance_lists.at( distance - 2u );
+    pairs.erase( std::remove_if( pairs.begin(), pairs.end(), [this]( const cube_pair_t& p ) { return !is_valid( p ); } ), pairs.end() );
+
+    /* the list grows when an improvement is found, but we return right after */
+    for ( auto i = 0u; i < pairs.size(); ++i )
     {
+      const auto p = pairs[i];
+
       if ( verbose )
       {
         std::cout << "Try to optimize with cube " << p.first << " and " << p.second << std::endl;
@@ -361,34 +423,50 @@ public:
 
   inline unsigned cube_count() const
   {
-    return _cubes.size();
+    return _cube_count;
   }
 
   inline unsigned literal_count() const
   {
-    using boost::adaptors::transformed;
-
-    return boost::accumulate( _cubes | transformed( []( const cube_t& c ) { return c.second.count(); } ), 0u );
+    auto count = 0u;
+    for ( auto i = 0u; i < stamps.size(); ++i )
+    {
+      if ( !alive[i] ) continue;
+      for ( auto w = 0u; w < words; ++w )
+      {
+        count += __builtin_popcountll( cube_begin( i )[w] & ( packed_low_bits << 1u ) );
+      }
+    }
+    return count;
   }
 
-  inline const std::vector<cube_t>& cubes() const
+  std::vector<cube_t> cubes() const
   {
-    return _cubes;
+    std::vector<cube_t> result;
+    result.reserve( _cube_count );
+    for ( auto i = 0u; i < stamps.size(); ++i )
+    {
+      if ( alive[i] )
+      {
+        result.push_back( to_cube( cube_begin( i ) ) );
+      }
+    }
+    return result;
   }
 
   void print_statistics()
   {
-    using boost::adaptors::indexed;
-    using boost::adaptors::transformed;
-
     print_banner( "Statistics" );
 
     std::cout << "Number of cubes:    " << cube_count() << std::endl;
     std::cout << "Number of literals: " << literal_count() << std::endl;
     std::cout << "Cubes:" << std::endl;
-    for ( auto it : index( _cubes ) )
+    for ( auto i = 0u; i < stamps.size(); ++i )
     {
-      std::cout << boost::format( "%4d: " ) % it.index << it.value << std::endl;
+      if ( alive[i] )
+      {
+        std::cout << boost::format( "%4d: " ) % i << to_cube( cube_begin( i ) ) << std::endl;
+      }
     }
     std::cout << "Distance lists:" << std::endl;
     for ( unsigned i = 0u; i < 3u; ++i )
@@ -438,7 +516,7 @@ public:
 
   DdNode * to_bdd()
   {
-    return to_bdd( _cubes );
+    return to_bdd( cubes() );
   }
 
   bool verify( DdNode * f )
@@ -455,10 +533,147 @@ public:
     return equal;
   }
 
+private:
+  static constexpr unsigned npos = std::numeric_limits<unsigned>::max();
+
+  inline const packed_word_t * cube_begin( unsigned cubeid ) const
+  {
+    return data.data() + cubeid * words;
+  }
+
+  inline bool is_valid( const cube_pair_t& p ) const
+  {
+    return stamps[p.first] == p.first_stamp && stamps[p.second] == p.second_stamp;
+  }
+
+  cube_t to_cube( const packed_word_t * c ) const
+  {
+    cube_t cube = std::make_pair( boost::dynamic_bitset<>( num_vars ), boost::dynamic_bitset<>( num_vars ) );
+    for ( auto i = 0u; i < num_vars; ++i )
+    {
+      const auto field = ( c[i / packed_vars_per_word] >> ( 2u * ( i % packed_vars_per_word ) ) ) & 3u;
+      cube.first.set( i, field == 3u );
+      cube.second.set( i, field != 0u );
+    }
+    return cube;
+  }
+
+  unsigned allocate_slot( const packed_cube_t& cube )
+  {
+    unsigned slot;
+    if ( free_slots.empty() )
+    {
+      slot = stamps.size();
+      data.insert( data.end(), cube.begin(), cube.end() );
+      stamps.push_back( 0u );
+      alive.push_back( true );
+      hashes.push_back( 0u );
+    }
+    else
+    {
+      slot = free_slots.back();
+      free_slots.pop_back();
+      std::copy( cube.begin(), cube.end(), data.begin() + slot * words );
+      alive[slot] = true;
+    }
+
+    hashes[slot] = packed_hash( cube.data(), words );
+    hash_index.emplace( hashes[slot], slot );
+    ++_cube_count;
+
+    return slot;
+  }
+
+  /* Looks up a cube that equals c in all words but w, which is replaced by word; h is the hash of this cube */
+  unsigned find_cube( const packed_word_t * c, std::uint64_t h, unsigned w, packed_word_t word ) const
+  {
+    const auto range = hash_index.equal_range( h );
+    for ( auto it = range.first; it != range.second; ++it )
+    {
+      const auto * other = cube_begin( it->second );
+      auto equal = other[w] == word;
+      for ( auto k = 0u; k < words && equal; ++k )
+      {
+        equal = k == w || other[k] == c[k];
+      }
+      if ( equal )
+      {
+        return it->second;
+      }
+    }
+    return npos;
+  }
+
+  /* Calls f( cubeid, position ) for each cube that has distance 1 to c, where h is the hash of c */
+  template<typename Fn>
+  void foreach_neighbor( const packed_word_t * c, std::uint64_t h, Fn&& f ) const
+  {
+    for ( auto i = 0u; i < num_vars; ++i )
+    {
+      const auto w     = i / packed_vars_per_word;
+      const auto s     = 2u * ( i % packed_vars_per_word );
+      const auto field = ( c[w] >> s ) & 3u;
+      const auto base  = h - packed_hash_word( c[w], w );
+
+      for ( auto value : {0ull, 2ull, 3ull} )
+      {
+        if ( value == field ) continue;
+
+        const auto word   = ( c[w] & ~( 3ull << s ) ) | ( value << s );
+        const auto cubeid = find_cube( c, base + packed_hash_word( word, w ), w, word );
+        if ( cubeid != npos && !f( cubeid, i ) )
+        {
+          return;
+        }
+      }
+    }
+  }
+
+  unsigned find_neighbor( const packed_word_t * c, std::uint64_t h, unsigned& bit_pos ) const
+  {
+    auto cubeid = npos;
+    foreach_neighbor( c, h, [&cubeid, &bit_pos]( unsigned id, unsigned position ) {
+        cubeid = id;
+        bit_pos = position;
+        return false;
+      } );
+    return cubeid;
+  }
+
+  /* Counts the cubes with distance (0 or 1) to c, ignoring cubeid1 and cubeid2 */
+  unsigned count_neighbors( const packed_word_t * c, unsigned distance, unsigned cubeid1, unsigned cubeid2 ) const
+  {
+    const auto h = packed_hash( c, words );
+    auto count = 0u;
+
+    if ( distance == 0u )
+    {
+      const auto cubeid = find_cube( c, h, 0u, c[0u] );
+      return ( cubeid != npos && cubeid != cubeid1 && cubeid != cubeid2 ) ? 1u : 0u;
+    }
+
+    foreach_neighbor( c, h, [&count, cubeid1, cubeid2]( unsigned id, unsigned position ) {
+        if ( id != cubeid1 && id != cubeid2 ) { ++count; }
+        return true;
+      } );
+    return count;
+  }
+
 private:
   DdManager * cudd;
   bool verbose;
-  std::vector<cube_t> _cubes;
+  unsigned num_vars;
+  unsigned words;
+
+  /* cube store, cube i occupies words [i * words, (i + 1) * words) */
+  std::vector<packed_word_t> data;
+  std::vector<unsigned> stamps;
+  std::vector<bool> alive;
+  std::vector<std::uint64_t> hashes;
+  std::vector<unsigned> free_slots;
+  std::unordered_multimap<std::uint64_t, unsigned> hash_index;
+  unsigned _cube_count = 0u;
+
   std::vector<cube_pair_list_t> distance_lists;
 
   static unsigned cube_groups[];
@@ -32,6 +32,7 @@
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 
 #include <boost/filesystem.hpp>
 #include <boost/format.hpp>
@@ -71,6 +72,10 @@ namespace cirkit
  * Private functions                                                          *
  ******************************************************************************/
 
+/* exorcism keeps its cover in global ABC state (g_CoverInfo, cube sets, queues),
+ * calls from several threads are therefore serialized */
+static std::mutex exorcism_mutex;
+
 class exorcism_processor : public pla_processor
 {
 public:
@@ -424,6 +429,47 @@ void reduce_cover( bool progress, exorcism_script script )
   }
 }
 
+/* ABC expects exactly one output at the end of each cube, this splits cubes
+ * that are shared among several outputs; returns nullptr if there are none */
+gia_graph::esop_ptr split_multi_output_cubes( const gia_graph::esop_ptr& esop )
+{
+  int i, j, lit;
+  abc::Vec_Int_t *vec;
+
+  auto num_levels = 0;
+  Vec_WecForEachLevel( esop.get(), vec, i )
+  {
+    Vec_IntForEachEntry( vec, lit, j )
+    {
+      if ( lit < 0 ) { ++num_levels; }
+    }
+  }
+
+  if ( num_levels == abc::Vec_WecSize( esop.get() ) )
+  {
+    return gia_graph::esop_ptr( nullptr, &abc::Vec_WecFree );
+  }
+
+  auto * split = abc::Vec_WecAlloc( num_levels );
+  Vec_WecForEachLevel( esop.get(), vec, i )
+  {
+    Vec_IntForEachEntry( vec, lit, j )
+    {
+      if ( lit >= 0 ) continue;
+
+      auto * level = abc::Vec_WecPushLevel( split );
+      int k, lit2;
+      Vec_IntForEachEntry( vec, lit2, k )
+      {
+        if ( lit2 >= 0 ) { abc::Vec_IntPush( level, lit2 ); }
+      }
+      abc::Vec_IntPush( level, lit );
+    }
+  }
+
+  return gia_graph::esop_ptr( split, &abc::Vec_WecFree );
+}
+
 /******************************************************************************
  * Public functions                                                           *
  ******************************************************************************/
@@ -467,6 +513,9 @@ void exorcism_minimization( const cube_vec_t& cubes, const properties::ptr& sett
     abc::Vec_WecPrint( esop, 0 );
   }
 
+  /* the lock also covers parsing, since the result is passed through esopname */
+  std::lock_guard<std::mutex> lock( exorcism_mutex );
+
   /* redict STDOUT because of one output line in Abc_ExorcismMain */
   abc::Abc_ExorcismMain( esop, cubes.front().length(), 1, const_cast<char*>( esopname.c_str() ), 2, verbose, 20000, 0 );
 
@@ -497,6 +546,8 @@ gia_graph::esop_ptr exorcism_minimization( const gia_graph::esop_ptr& esop, unsi
 
   properties_timer t( statistics );
 
+  std::lock_guard<std::mutex> lock( exorcism_mutex );
+
   /* initialize */
   memset( &abc::g_CoverInfo, 0, sizeof( abc::cinfo ) );
   abc::g_CoverInfo.Quality = static_cast<int>( quality );
@@ -515,7 +566,10 @@ gia_graph::esop_ptr exorcism_minimization( const gia_graph::esop_ptr& esop, unsi
   abc::g_CoverInfo.nWordsOut = twords;
   abc::g_CoverInfo.cIDs = 1;
 
-  abc::g_CoverInfo.nCubesBefore = abc::Vec_WecSize( esop.get() );
+  const auto split = split_multi_output_cubes( esop );
+  auto * cover = split ? split.get() : esop.get();
+
+  abc::g_CoverInfo.nCubesBefore = abc::Vec_WecSize( cover );
 
   if ( abc::g_CoverInfo.nCubesBefore > abc::g_CoverInfo.nCubesMax )
   {
@@ -541,7 +595,7 @@ gia_graph::esop_ptr exorcism_minimization( const gia_graph::esop_ptr& esop, unsi
   }
 
   /* reduce */
-  abc::AddCubesToStartingCover( esop.get() );
+  abc::AddCubesToStartingCover( cover );
   {
     properties_timer t( statistics, "exorcism_opt_time" );
     reduce_cover( progress, script );
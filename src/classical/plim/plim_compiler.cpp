@@ -26,10 +26,9 @@
 
 #include "plim_compiler.hpp"
 
-#include <map>
-#include <queue>
+#include <cassert>
+#include <limits>
 #include <stack>
-#include <unordered_map>
 
 #include <boost/dynamic_bitset.hpp>
 
@@ -37,7 +36,6 @@
 #include <core/utils/range_utils.hpp>
 #include <core/utils/terminal.hpp>
 #include <core/utils/timer.hpp>
-#include <classical/functions/compute_levels.hpp>
 #include <classical/utils/memristor_costs.hpp>
 #include <classical/mig/mig_utils.hpp>
 
@@ -58,6 +56,8 @@ namespace cirkit
  * Private functions                                                          *
  ******************************************************************************/
 
+/* indexes start at 1, since 0 is the null index; the compiler relies on this
+ * when it checks rram_inv[n] for an existing inverted register */
 template<typename IndexType>
 class auto_index_generator
 {
@@ -86,6 +86,7 @@ public:
         free.pop_front();
       }
 
+      assert( index );
       return index;
     }
     else
@@ -96,6 +97,7 @@ public:
 
   void release( IndexType i )
   {
+    assert( i );
     free.push_back( i );
   }
 
@@ -110,11 +112,29 @@ struct compilation_compare
   compilation_compare( const mig_graph& mig, bool enable = true )
     : mig( mig ),
       _fanout_levels( num_vertices( mig ) ),
+      levels( num_vertices( mig ), 0u ),
       enable( enable )
   {
-    fanouts = precompute_ingoing_edges( mig );
+    fanouts = precompute_ingoing_vertices( mig );
     _fanout_count = precompute_in_degrees( mig );
-    levels = compute_levels( mig, max_level );
+
+    /* outputs keep their registers */
+    for ( const auto& output : mig_info( mig ).outputs )
+    {
+      ++_fanout_count[output.first.node];
+    }
+
+    /* children are created before their parents */
+    max_level = 0u;
+    for ( const auto& node : boost::make_iterator_range( vertices( mig ) ) )
+    {
+      for ( const auto& child : boost::make_iterator_range( adjacent_vertices( node, mig ) ) )
+      {
+        assert( child < node );
+        levels[node] = std::max( levels[node], levels[child] + 1u );
+      }
+      max_level = std::max( max_level, levels[node] );
+    }
 
     using namespace std::placeholders;
     boost::transform( boost::make_iterator_range( boost::vertices( mig ) ), _fanout_levels.begin(), std::bind( &compilation_compare::fanout_levels, this, _1 ) );
@@ -152,14 +172,15 @@ struct compilation_compare
 
   inline unsigned fanout_count( mig_node a ) const { return _fanout_count[a]; }
   inline unsigned remove_fanout( mig_node a ) { return --_fanout_count[a]; }
+  inline const std::vector<mig_node>& parents( mig_node a ) const { return fanouts[a]; }
 
 private:
   unsigned number_of_releasing_fanins( mig_node a ) const
   {
     auto sum = 0u;
-    for ( const auto& c : get_children( mig, a ) )
+    for ( const auto& c : boost::make_iterator_range( adjacent_vertices( a, mig ) ) )
     {
-      if ( _fanout_count[c.node] == 1u )
+      if ( _fanout_count[c] == 1u )
       {
         ++sum;
       }
@@ -172,19 +193,10 @@ private:
     auto min = 0u;
     auto max = max_level;
 
-    const auto it = fanouts.find( a );
-
-    if ( it != fanouts.end() )
+    for ( const auto& parent : fanouts[a] )
     {
-      for ( const auto& e : it->second )
-      {
-        const auto parent = boost::source( e, mig );
-        const auto it2 = levels.find( parent );
-        if ( it2 == levels.end() ) continue;
-        const auto level = it2->second;
-        min = std::min( min, level );
-        max = std::max( max, level );
-      }
+      min = std::min( min, levels[parent] );
+      max = std::max( max, levels[parent] );
     }
 
     return std::make_pair( min, max );
@@ -192,14 +204,98 @@ private:
 
 private:
   const mig_graph& mig;
-  std::map<mig_node, std::vector<mig_edge>> fanouts;
+  std::vector<std::vector<mig_node>> fanouts;
   std::vector<std::pair<unsigned, unsigned>> _fanout_levels;
   std::vector<unsigned> _fanout_count;
   unsigned max_level;
-  std::map<mig_node, unsigned> levels;
+  std::vector<unsigned> levels;
   bool enable = true;
 };
 
+/* binary heap of candidates with positions, such that the priority of a
+   candidate can be updated when the fanout counts of its children change */
+class candidate_heap
+{
+public:
+  candidate_heap( unsigned size, const compilation_compare& cmp )
+    : position( size, std::numeric_limits<unsigned>::max() ),
+      cmp( cmp )
+  {
+  }
+
+  inline bool empty() const { return heap.empty(); }
+  inline mig_node top() const { return heap.front(); }
+  inline bool contains( mig_node n ) const { return position[n] != npos; }
+
+  void push( mig_node n )
+  {
+    position[n] = heap.size();
+    heap.push_back( n );
+    sift_up( position[n] );
+  }
+
+  void pop()
+  {
+    position[heap.front()] = npos;
+    if ( heap.size() > 1u )
+    {
+      heap.front() = heap.back();
+      position[heap.front()] = 0u;
+    }
+    heap.pop_back();
+    if ( !heap.empty() )
+    {
+      sift_down( 0u );
+    }
+  }
+
+  void update( mig_node n )
+  {
+    sift_down( sift_up( position[n] ) );
+  }
+
+private:
+  unsigned sift_up( unsigned i )
+  {
+    while ( i > 0u )
+    {
+      const auto parent = ( i - 1u ) / 2u;
+      if ( !cmp( heap[parent], heap[i] ) ) { break; }
+      swap( i, parent );
+      i = parent;
+    }
+    return i;
+  }
+
+  void sift_down( unsigned i )
+  {
+    while ( true )
+    {
+      auto best = i;
+      const auto l = 2u * i + 1u, r = 2u * i + 2u;
+      if ( l < heap.size() && cmp( heap[best], heap[l] ) ) { best = l; }
+      if ( r < heap.size() && cmp( heap[best], heap[r] ) ) { best = r; }
+      if ( best == i ) { break; }
+      swap( i, best );
+      i = best;
+    }
+  }
+
+  inline void swap( unsigned i, unsigned j )
+  {
+    std::swap( heap[i], heap[j] );
+    position[heap[i]] = i;
+    position[heap[j]] = j;
+  }
+
+private:
+  static constexpr unsigned npos = std::numeric_limits<unsigned>::max();
+
+  std::vector<mig_node>      heap;
+  std::vector<unsigned>      position;
+  const compilation_compare& cmp;
+};
+
 bool all_children_computed( mig_node n, const mig_graph& mig, const boost::dynamic_bitset<>& computed )
 {
   for ( const auto& adj : boost::make_iterator_range( boost::adjacent_vertices( n, mig ) ) )
@@ -217,25 +313,6 @@ inline std::pair<unsigned, unsigned> three_without( unsigned x )
   return std::make_pair( x == 0u ? 1u : 0u, x == 2u ? 1u : 2u );
 }
 
-}
-
-namespace std
-{
-
-template<>
-struct hash<cirkit::mig_function>
-{
-  std::size_t operator()( const cirkit::mig_function& f ) const
-  {
-    return std::hash<unsigned>()( ( f.node << 1u ) | f.complemented );
-  }
-};
-
-}
-
-namespace cirkit
-{
-
 /******************************************************************************
  * Public functions                                                           *
  ******************************************************************************/
@@ -258,8 +335,9 @@ compile_for_plim( const mig_graph& mig,
 
   const auto& info = mig_info( mig );
 
-  boost::dynamic_bitset<>                 computed( num_vertices( mig ) );
-  std::unordered_map<mig_function, memristor_index> func_to_rram;
+  boost::dynamic_bitset<>      computed( num_vertices( mig ) );
+  std::vector<memristor_index> rram( num_vertices( mig ) );     /* register of node */
+  std::vector<memristor_index> rram_inv( num_vertices( mig ) ); /* register of inverted node, if any */
   auto_index_generator<memristor_index> memristor_generator(
       generator_strategy == 0u
           ? auto_index_generator<memristor_index>::request_strategy::lifo
@@ -270,13 +348,14 @@ compile_for_plim( const mig_graph& mig,
   for ( const auto& input : info.inputs )
   {
     computed.set( input );
-    func_to_rram.insert( {{input, false}, memristor_generator.request()} );
+    rram[input] = memristor_generator.request();
+    program.add_input( rram[input] );
   }
 
   /* keep a priority queue for candidates
      invariant: candidates elements' children are all computed */
   compilation_compare cmp( mig, enable_cost_function );
-  std::priority_queue<mig_node, std::vector<mig_node>, compilation_compare> candidates( cmp );
+  candidate_heap candidates( num_vertices( mig ), cmp );
 
   /* find initial candidates */
   for ( const auto& node : boost::make_iterator_range( vertices( mig ) ) )
@@ -290,8 +369,6 @@ compile_for_plim( const mig_graph& mig,
     }
   }
 
-  const auto parent_edges = precompute_ingoing_edges( mig );
-
   null_stream ns;
   std::ostream null_out( &ns );
   boost::progress_display show_progress( num_vertices( mig ), progress ? std::cout : null_out );
@@ -333,14 +410,14 @@ compile_for_plim( const mig_graph& mig,
       }
       else
       {
-        src_neg = func_to_rram.at( {children[i_src_neg].node, false} );
+        src_neg = rram[children[i_src_neg].node];
       }
     }
     /* if there are more than one inverters, but one of them is a constant */
     else if ( children_compl.count() > 1u && children[children_compl.find_first()].node == 0u )
     {
       i_src_neg = children_compl.find_next( children_compl.find_first() );
-      src_neg = func_to_rram.at( {children[i_src_neg].node, false} );
+      src_neg = rram[children[i_src_neg].node];
     }
     /* if there is no inverter but a constant */
     else if ( children_compl.count() == 0u && children[0u].node == 0u )
@@ -361,7 +438,7 @@ compile_for_plim( const mig_graph& mig,
           if ( cmp.fanout_count( children[i].node ) > 1u )
           {
             i_src_neg = i;
-            src_neg = func_to_rram.at( {children[i_src_neg].node, false} );
+            src_neg = rram[children[i_src_neg].node];
             break;
           }
         }
@@ -369,7 +446,7 @@ compile_for_plim( const mig_graph& mig,
         if ( i_src_neg < 3u ) { break; }
 
         i_src_neg = children_compl.find_first();
-        src_neg = func_to_rram.at( {children[i_src_neg].node, false} );
+        src_neg = rram[children[i_src_neg].node];
       } while ( false );
     }
     /* if there is no inverter */
@@ -380,11 +457,10 @@ compile_for_plim( const mig_graph& mig,
         /* pick an input that has multiple fanout */
         for ( auto i = 0u; i < 3u; ++i )
         {
-          const auto it_reg = func_to_rram.find( {children[i].node, true} );
-          if ( it_reg != func_to_rram.end() )
+          if ( rram_inv[children[i].node] )
           {
             i_src_neg = i;
-            src_neg = it_reg->second;
+            src_neg = rram_inv[children[i].node];
             break;
           }
         }
@@ -407,8 +483,8 @@ compile_for_plim( const mig_graph& mig,
         /* create new register for inversion */
         const auto inv_result = memristor_generator.request();
 
-        program.invert( inv_result, func_to_rram.at( {children[i_src_neg].node, false} ) );
-        func_to_rram.insert( {{children[i_src_neg].node, true}, inv_result} );
+        program.invert( inv_result, rram[children[i_src_neg].node] );
+        rram_inv[children[i_src_neg].node] = inv_result;
         src_neg = inv_result;
       } while ( false );
     }
@@ -426,26 +502,25 @@ compile_for_plim( const mig_graph& mig,
     if ( oa_c || ob_c )
     {
       /* first check for complemented cases (to avoid them for last operand) */
-      std::unordered_map<mig_function, memristor_index>::const_iterator it;
-      if ( oa_c && children[oa].complemented && ( it = func_to_rram.find( {children[oa].node, true} ) ) != func_to_rram.end() )
+      if ( oa_c && children[oa].complemented && rram_inv[children[oa].node] )
       {
         i_dst = oa;
-        dst   = it->second;
+        dst   = rram_inv[children[oa].node];
       }
-      else if ( ob_c && children[ob].complemented && ( it = func_to_rram.find( {children[ob].node, true} ) ) != func_to_rram.end() )
+      else if ( ob_c && children[ob].complemented && rram_inv[children[ob].node] )
       {
         i_dst = ob;
-        dst   = it->second;
+        dst   = rram_inv[children[ob].node];
       }
       else if ( oa_c && !children[oa].complemented )
       {
         i_dst = oa;
-        dst   = func_to_rram.at( {children[oa].node, false} );
+        dst   = rram[children[oa].node];
       }
       else if ( ob_c && !children[ob].complemented )
       {
         i_dst = ob;
-        dst   = func_to_rram.at( {children[ob].node, false} );
+        dst   = rram[children[ob].node];
       }
     }
 
@@ -465,13 +540,13 @@ compile_for_plim( const mig_graph& mig,
       else if ( children_compl.count() > 0u )
       {
         i_dst = children_compl.find_first();
-        program.invert( dst, func_to_rram.at( {children[i_dst].node, false} ) );
+        program.invert( dst, rram[children[i_dst].node] );
       }
       /* otherwise, pick first one */
       else
       {
         i_dst = oa;
-        program.assign( dst, func_to_rram.at( {children[i_dst].node, false} ) );
+        program.assign( dst, rram[children[i_dst].node] );
       }
     }
 
@@ -485,61 +560,66 @@ compile_for_plim( const mig_graph& mig,
     }
     else if ( children[i_src_pos].complemented )
     {
-      const auto it_reg = func_to_rram.find( {node, true} );
-      if ( it_reg == func_to_rram.end() )
+      if ( !rram_inv[node] )
       {
         /* create new register for inversion */
         const auto inv_result = memristor_generator.request();
 
-        program.invert( inv_result, func_to_rram.at( {node, false} ) );
-        func_to_rram.insert( {{node, true}, inv_result} );
+        program.invert( inv_result, rram[node] );
+        rram_inv[node] = inv_result;
         src_pos = inv_result;
       }
       else
       {
-        src_pos = it_reg->second;
+        src_pos = rram_inv[node];
       }
     }
     else
     {
-      src_pos = func_to_rram.at( {node, false} );
+      src_pos = rram[node];
     }
 
     program.compute( dst, src_pos, src_neg );
-    func_to_rram.insert( {{candidate, false}, dst} );
+    rram[candidate] = dst;
 
     /* free free registers */
     for ( const auto& c : children )
     {
-      if ( cmp.remove_fanout( c.node ) == 0u && c.node != 0u )
+      const auto remaining = cmp.remove_fanout( c.node );
+
+      if ( remaining == 0u && c.node != 0u )
       {
-        const auto reg = func_to_rram.at( {c.node, false} );
+        const auto reg = rram[c.node];
         if ( reg != dst )
         {
           memristor_generator.release( reg );
         }
 
-        const auto it_reg = func_to_rram.find( {c.node, true} );
-        if ( it_reg != func_to_rram.end() && it_reg->second != dst )
+        if ( rram_inv[c.node] && rram_inv[c.node] != dst )
+        {
+          memristor_generator.release( rram_inv[c.node] );
+        }
+      }
+      /* the last parent of c would now release it */
+      else if ( remaining == 1u && c.node != 0u )
+      {
+        for ( const auto& parent : cmp.parents( c.node ) )
         {
-          memristor_generator.release( it_reg->second );
+          if ( candidates.contains( parent ) )
+          {
+            candidates.update( parent );
+          }
         }
       }
     }
 
     /* update computed and find new candidates */
     computed.set( candidate );
-    const auto it = parent_edges.find( candidate );
-    if ( it != parent_edges.end() ) /* if it has parents */
+    for ( const auto& parent : cmp.parents( candidate ) )
     {
-      for ( const auto& e : it->second )
+      if ( !computed[parent] && !candidates.contains( parent ) && all_children_computed( parent, mig, computed ) )
       {
-        const auto parent = boost::source( e, mig );
-
-        if ( !computed[parent] && all_children_computed( parent, mig, computed ) )
-        {
-          candidates.push( parent );
-        }
+        candidates.push( parent );
       }
     }
 
@@ -548,6 +628,19 @@ compile_for_plim( const mig_graph& mig,
        "    - dst:     " << i_dst << std::endl );
   }
 
+  /* outputs */
+  for ( const auto& output : info.outputs )
+  {
+    if ( output.first.node == info.constant )
+    {
+      program.add_output( output.first.complemented, false );
+    }
+    else
+    {
+      program.add_output( rram[output.first.node], output.first.complemented );
+    }
+  }
+
   set( statistics, "step_count", (int)program.step_count() );
   set( statistics, "rram_count", (int)program.rram_count() );
 
@@ -63,6 +63,16 @@ struct operand_visitor : public boost::static_visitor<std::string>
  * Public functions                                                           *
  ******************************************************************************/
 
+void plim_program::add_input( memristor_index reg )
+{
+  _inputs.push_back( reg );
+}
+
+void plim_program::add_output( operand_t src, bool complemented )
+{
+  _outputs.push_back( std::make_pair( src, complemented ) );
+}
+
 void plim_program::read_constant( memristor_index dest, bool value )
 {
   /* !value -> 0 1 dest
@@ -100,6 +110,16 @@ const std::vector<plim_program::instruction_t>& plim_program::instructions() con
   return _instructions;
 }
 
+const std::vector<memristor_index>& plim_program::inputs() const
+{
+  return _inputs;
+}
+
+const std::vector<plim_program::output_t>& plim_program::outputs() const
+{
+  return _outputs;
+}
+
 unsigned plim_program::step_count() const
 {
   return _instructions.size();
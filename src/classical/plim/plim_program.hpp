@@ -37,6 +37,7 @@
 #define PLIM_PROGRAM_HPP
 
 #include <iostream>
+#include <vector>
 
 #include <boost/variant.hpp>
 
@@ -53,22 +54,30 @@ class plim_program
 public:
   using operand_t     = boost::variant<memristor_index, bool>;
   using instruction_t = std::tuple<operand_t, operand_t, memristor_index>;
+  using output_t      = std::pair<operand_t, bool>; /* operand and complement flag */
 
 public:
+  void add_input( memristor_index reg );
+  void add_output( operand_t src, bool complemented );
+
   void read_constant( memristor_index dest, bool value );
   void invert( memristor_index dest, memristor_index src );
   void assign( memristor_index dest, memristor_index src );
   void compute( memristor_index dest, operand_t src_pos, operand_t src_neg );
 
   const std::vector<instruction_t>& instructions() const;
+  const std::vector<memristor_index>& inputs() const;
+  const std::vector<output_t>& outputs() const;
 
   unsigned step_count() const;
   unsigned rram_count() const;
   const std::vector<unsigned>& write_counts() const;
 
 private:
-  std::vector<instruction_t> _instructions;
-  std::vector<unsigned>      _write_counts;
+  std::vector<instruction_t>   _instructions;
+  std::vector<unsigned>        _write_counts;
+  std::vector<memristor_index> _inputs;
+  std::vector<output_t>        _outputs;
 };
 
 std::ostream& operator<<( std::ostream& os, const plim_program& program );
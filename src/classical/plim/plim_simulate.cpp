@@ -0,0 +1,196 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plim_simulate.hpp"
+
+#include <random>
+
+#include <boost/format.hpp>
+
+#include <core/utils/range_utils.hpp>
+#include <core/utils/timer.hpp>
+#include <classical/mig/mig_simulate.hpp>
+#include <classical/mig/mig_utils.hpp>
+
+namespace cirkit
+{
+
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+using pattern_t = boost::dynamic_bitset<>;
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+struct plim_operand_visitor : public boost::static_visitor<pattern_t>
+{
+  plim_operand_visitor( const std::vector<pattern_t>& registers, unsigned num_bits )
+    : registers( registers ),
+      num_bits( num_bits )
+  {
+  }
+
+  pattern_t operator()( bool value ) const
+  {
+    return value ? ~pattern_t( num_bits ) : pattern_t( num_bits );
+  }
+
+  pattern_t operator()( memristor_index reg ) const
+  {
+    return registers[reg.index()];
+  }
+
+private:
+  const std::vector<pattern_t>& registers;
+  unsigned num_bits;
+};
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+std::vector<pattern_t> simulate_plim_program( const plim_program& program,
+                                              const std::vector<pattern_t>& input_patterns )
+{
+  assert( input_patterns.size() == program.inputs().size() );
+
+  const auto num_bits = input_patterns.empty() ? 0u : input_patterns.front().size();
+
+  /* registers are indexed from 1, inputs may not be written by the program */
+  auto num_registers = program.rram_count();
+  for ( const auto& reg : program.inputs() )
+  {
+    num_registers = std::max( num_registers, reg.index() );
+  }
+  std::vector<pattern_t> registers( num_registers + 1u, pattern_t( num_bits ) );
+
+  for ( const auto& p : index( program.inputs() ) )
+  {
+    registers[p.value.index()] = input_patterns[p.index];
+  }
+
+  plim_operand_visitor vis( registers, num_bits );
+  for ( const auto& i : program.instructions() )
+  {
+    /* RM3: dest <- M(src_pos, !src_neg, dest) */
+    const auto a = boost::apply_visitor( vis, std::get<0>( i ) );
+    const auto b = ~boost::apply_visitor( vis, std::get<1>( i ) );
+    auto& d = registers[std::get<2>( i ).index()];
+
+    d = ( a & b ) | ( a & d ) | ( b & d );
+  }
+
+  std::vector<pattern_t> output_patterns;
+  for ( const auto& o : program.outputs() )
+  {
+    auto value = boost::apply_visitor( vis, o.first );
+    if ( o.second )
+    {
+      value.flip();
+    }
+    output_patterns.push_back( value );
+  }
+
+  return output_patterns;
+}
+
+bool verify_plim_program( const plim_program& program, const mig_graph& mig,
+                          const properties::ptr& settings,
+                          const properties::ptr& statistics )
+{
+  /* settings */
+  const auto num_words = get( settings, "num_words", 16u );
+  const auto seed      = get( settings, "seed", 0xcafeu );
+  const auto verbose   = get( settings, "verbose", false );
+
+  /* timing */
+  properties_timer t( statistics );
+
+  const auto& info = mig_info( mig );
+  const auto num_bits = 64u * num_words;
+
+  /* random input patterns */
+  std::default_random_engine gen( seed );
+  std::uniform_int_distribution<unsigned long> dist;
+
+  std::vector<pattern_t> input_patterns;
+  for ( auto k = 0u; k < info.inputs.size(); ++k )
+  {
+    std::vector<unsigned long> words( num_words );
+    std::generate( words.begin(), words.end(), [&]() { return dist( gen ); } );
+    input_patterns.push_back( pattern_t( words.begin(), words.end() ) );
+  }
+
+  const auto program_values = simulate_plim_program( program, input_patterns );
+
+  mig_lambda_simulator<pattern_t> sim(
+      [&input_patterns]( const mig_node& node, const std::string& name, unsigned pos, const mig_graph& mig ) { return input_patterns[pos]; },
+      [num_bits]() { return pattern_t( num_bits ); },
+      []( const pattern_t& v ) { return ~v; },
+      []( const mig_node& node, const pattern_t& v1, const pattern_t& v2, const pattern_t& v3 ) { return ( v1 & v2 ) | ( v1 & v3 ) | ( v2 & v3 ); } );
+  const auto mig_values = simulate_mig( mig, sim );
+
+  std::vector<std::string> mismatches;
+  if ( program_values.size() != info.outputs.size() )
+  {
+    if ( verbose )
+    {
+      std::cout << boost::format( "[w] program has %d outputs, MIG has %d" ) % program_values.size() % info.outputs.size() << std::endl;
+    }
+    mismatches.push_back( "<outputs>" );
+  }
+  else
+  {
+    for ( const auto& o : index( info.outputs ) )
+    {
+      if ( program_values[o.index] != mig_values.at( o.value.first ) )
+      {
+        if ( verbose )
+        {
+          std::cout << "[w] output " << o.value.second << " does not match" << std::endl;
+        }
+        mismatches.push_back( o.value.second );
+      }
+    }
+  }
+
+  const auto& write_counts = program.write_counts();
+  set( statistics, "mismatches", mismatches );
+  set( statistics, "max_writes", write_counts.empty() ? 0u : *boost::max_element( write_counts ) );
+
+  return mismatches.empty();
+}
+
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
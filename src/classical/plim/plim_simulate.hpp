@@ -0,0 +1,97 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file plim_simulate.hpp
+ *
+ * @brief Bit-parallel interpreter for PLiM programs
+ *
+ * @since  2.3
+ */
+
+#ifndef PLIM_SIMULATE_HPP
+#define PLIM_SIMULATE_HPP
+
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include <core/properties.hpp>
+#include <classical/mig/mig.hpp>
+#include <classical/plim/plim_program.hpp>
+
+namespace cirkit
+{
+
+/**
+ * @brief Executes a PLiM program on many input patterns at once
+ *
+ * Each input pattern vector holds one bit per simulation pattern, the
+ * order follows program.inputs().  Every RM3 instruction computes
+ * dest <- M(src_pos, !src_neg, dest) on all patterns.  Returns one
+ * pattern vector per program output.
+ */
+std::vector<boost::dynamic_bitset<>> simulate_plim_program( const plim_program& program,
+                                                             const std::vector<boost::dynamic_bitset<>>& input_patterns );
+
+/**
+ * @brief Checks a compiled PLiM program against its MIG by random simulation
+ *
+ * Returns true, if all outputs agree on 64 * num_words random patterns.
+ *
+ * @settings
+ *
+   |-----------+--------------------------------------+---------|
+   | Settings  | Description                          | Default |
+   |-----------+--------------------------------------+---------|
+   | num_words | Number of 64-bit words per input     | 16u     |
+   | seed      | Seed for the random input patterns   | 0xcafeu |
+   | verbose   | Be verbose                           | false   |
+   |-----------+--------------------------------------+---------|
+ *
+ * @statistics
+ *
+   |------------+-------------------------------------------|
+   | Statistics | Description                               |
+   |------------+-------------------------------------------|
+   | runtime    | Run-time in seconds                       |
+   | mismatches | Names of the outputs that do not match    |
+   | max_writes | Maximum number of writes to one register  |
+   |------------+-------------------------------------------|
+ */
+bool verify_plim_program( const plim_program& program, const mig_graph& mig,
+                          const properties::ptr& settings = properties::ptr(),
+                          const properties::ptr& statistics = properties::ptr() );
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -170,6 +170,29 @@ inline void logic_xnor( S& solver, int a, int b, int c )
   add_clause( solver )( {-a, -b, c} );
 }
 
+/* c <-> ( s ? t : e ), the last two clauses are redundant but help propagation */
+template<class S>
+inline void logic_mux( S& solver, int s, int t, int e, int c )
+{
+  add_clause( solver )( {-s, -t, c} );
+  add_clause( solver )( {-s, t, -c} );
+  add_clause( solver )( {s, -e, c} );
+  add_clause( solver )( {s, e, -c} );
+  add_clause( solver )( {-t, -e, c} );
+  add_clause( solver )( {t, e, -c} );
+}
+
+template<class S>
+inline void logic_maj( S& solver, int a, int b, int c, int d )
+{
+  add_clause( solver )( {-a, -b, d} );
+  add_clause( solver )( {-a, -c, d} );
+  add_clause( solver )( {-b, -c, d} );
+  add_clause( solver )( {a, b, -d} );
+  add_clause( solver )( {a, c, -d} );
+  add_clause( solver )( {b, c, -d} );
+}
+
 }
 
 #endif
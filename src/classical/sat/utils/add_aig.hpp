@@ -36,14 +36,16 @@
 #ifndef ADD_AIG_HPP
 #define ADD_AIG_HPP
 
-#include <boost/graph/depth_first_search.hpp>
-#include <boost/range/algorithm.hpp>
+#include <array>
+#include <map>
+#include <vector>
+
 #include <boost/range/algorithm_ext/iota.hpp>
+#include <boost/range/iterator_range.hpp>
 
 #include <core/utils/range_utils.hpp>
 
 #include <classical/aig.hpp>
-#include <classical/utils/aig_dfs.hpp>
 #include <classical/utils/aig_utils.hpp>
 
 #include <classical/sat/sat_solver.hpp>
@@ -52,69 +54,343 @@
 namespace cirkit
 {
 
+/**
+ * @brief Incremental Tseytin encoder for AIGs
+ *
+ * Node variables are kept in a dense vector indexed by the node and the
+ * inputs get consecutive variables starting from sid.  Each call to `lit`
+ * only encodes the part of the transitive fanin that has not been encoded
+ * yet, therefore several queries can be loaded into the same solver one after
+ * the other.
+ *
+ * If `structural` is true, single-fanout AND trees that implement a MUX,
+ * XOR, or MAJ are encoded with 6, 4, or 6 clauses and the inner nodes get no
+ * variable (unless they are queried explicitly later).  These inner nodes are
+ * therefore missing in `node_var_map`; use `structural = false` if every AND
+ * node needs a variable.
+ */
 template<class S>
-class add_aig_visitor : public aig_dfs_visitor
+class aig_cnf_encoder
 {
 public:
-  add_aig_visitor( const aig_graph& aig, S& solver, int& sid, const std::vector<int>& piids, std::map<aig_node, int>& node_var_map, bool blocking_vars, std::map<aig_node, int>& blocking_var_map )
-    : aig_dfs_visitor( aig ),
-      solver( solver ),
+  aig_cnf_encoder( S& solver, const aig_graph& aig, int sid, bool structural = true, bool blocking_vars = false )
+    : solver( solver ),
+      aig( aig ),
+      info( aig_info( aig ) ),
       cur_var( sid ),
-      piids( piids ),
-      node_var_map( node_var_map ),
+      structural( structural && !blocking_vars ),
       blocking_vars( blocking_vars ),
-      blocking_var_map( blocking_var_map )
+      node_to_var( boost::num_vertices( aig ), 0 ),
+      fanout( boost::num_vertices( aig ), 0u )
+  {
+    for ( const auto& input : info.inputs )
+    {
+      node_to_var[input] = cur_var++;
+    }
+
+    compute_fanout();
+  }
+
+  /* inputs are mapped to input_vars, e.g., to share them with another encoder */
+  aig_cnf_encoder( S& solver, const aig_graph& aig, int sid, const std::vector<int>& input_vars, bool structural = true )
+    : solver( solver ),
+      aig( aig ),
+      info( aig_info( aig ) ),
+      cur_var( sid ),
+      structural( structural ),
+      blocking_vars( false ),
+      node_to_var( boost::num_vertices( aig ), 0 ),
+      fanout( boost::num_vertices( aig ), 0u )
   {
+    assert( input_vars.size() == info.inputs.size() );
+
+    for ( const auto& input : index( info.inputs ) )
+    {
+      node_to_var[input.value] = input_vars[input.index];
+    }
+
+    compute_fanout();
   }
 
-  void finish_input( const aig_node& node, const std::string& name, const aig_graph& aig )
+  inline int input_var( unsigned index ) const
   {
-    unsigned pos = std::distance( graph_info.inputs.begin(), boost::find( graph_info.inputs, node ) );
-    node_var_map[node] = piids[pos];
+    return node_to_var[info.inputs[index]];
   }
 
-  void finish_constant( const aig_node& node, const aig_graph& aig )
+  inline int lit( const aig_function& f )
   {
-    node_var_map[node] = cur_var;
-    add_clause( solver )( {-cur_var} );
-    cur_var++;
+    const auto v = var( f.node );
+    return f.complemented ? -v : v;
   }
 
-  void finish_aig_node( const aig_node& node, const aig_function& left, const aig_function& right, const aig_graph& aig )
+  /* encodes the missing part of the transitive fanin of node */
+  int var( const aig_node& node )
   {
-    node_var_map[node] = cur_var;
-    int a = node_var_map[left.node];
-    int b = node_var_map[right.node];
-    assert( node != left.node );
-    assert( node != right.node );
-    assert( cur_var != a );
-    assert( cur_var != b );
+    if ( node_to_var[node] )
+    {
+      return node_to_var[node];
+    }
 
-    if ( blocking_vars )
+    std::vector<std::pair<aig_node, bool>> stack{{node, false}};
+    while ( !stack.empty() )
     {
-      if ( blocking_var_map.find( node ) == blocking_var_map.end() )
+      const auto n = stack.back().first;
+
+      if ( node_to_var[n] )
+      {
+        stack.pop_back();
+        continue;
+      }
+
+      const auto g = gate( n );
+
+      if ( !stack.back().second )
       {
-        blocking_var_map[node] = cur_var + 1u;
+        stack.back().second = true;
+        for ( auto i = 0u; i < g.num_fanins; ++i )
+        {
+          if ( !node_to_var[g.fanins[i].node] )
+          {
+            stack.push_back( {g.fanins[i].node, false} );
+          }
+        }
+        continue;
       }
-      blocking_and( solver, blocking_var_map[node], left.complemented ? -a : a, right.complemented ? -b : b, cur_var );
-      cur_var += 2u;
+
+      stack.pop_back();
+      encode( n, g );
     }
-    else
+
+    return node_to_var[node];
+  }
+
+  inline bool is_encoded( const aig_node& node ) const
+  {
+    return node_to_var[node] != 0;
+  }
+
+  inline int next_var() const
+  {
+    return cur_var;
+  }
+
+  inline int new_var()
+  {
+    return cur_var++;
+  }
+
+  std::map<aig_node, int> node_var_map() const
+  {
+    std::map<aig_node, int> m;
+    for ( auto n = 0u; n < node_to_var.size(); ++n )
     {
-      logic_and( solver, left.complemented ? -a : a, right.complemented ? -b : b, cur_var );
-      cur_var++;
+      if ( node_to_var[n] )
+      {
+        m.insert( {n, node_to_var[n]} );
+      }
     }
+    return m;
   }
 
 public:
-  S& solver;
-  int& cur_var;
-  const std::vector<int>& piids;
-  std::map<aig_node, int>& node_var_map;
-  bool blocking_vars;
-  std::map<aig_node, int>& blocking_var_map;
+  std::map<aig_node, int> blocking_var_map;
+
+private:
+  enum class gate_type { leaf, constant, and_gate, mux_gate, maj_gate };
+
+  struct gate_t
+  {
+    gate_type                   type = gate_type::leaf;
+    unsigned                    num_fanins = 0u;
+    std::array<aig_function, 3> fanins;
+  };
+
+  void compute_fanout()
+  {
+    for ( const auto& edge : boost::make_iterator_range( boost::edges( aig ) ) )
+    {
+      ++fanout[boost::target( edge, aig )];
+    }
+    for ( const auto& output : info.outputs )
+    {
+      ++fanout[output.first.node];
+    }
+  }
+
+  inline unsigned get_children( const aig_node& node, std::array<aig_function, 2>& children ) const
+  {
+    auto i = 0u;
+    for ( const auto& edge : boost::make_iterator_range( boost::out_edges( node, aig ) ) )
+    {
+      children[i++] = aig_to_function( aig, edge );
+    }
+    return i;
+  }
+
+  /* f is a regular edge to an AND node with a single fanout */
+  inline bool is_inner_and( const aig_function& f ) const
+  {
+    return fanout[f.node] == 1u && boost::out_degree( f.node, aig ) == 2u;
+  }
+
+  gate_t gate( const aig_node& node ) const
+  {
+    gate_t g;
+
+    std::array<aig_function, 2> c;
+    if ( get_children( node, c ) != 2u )
+    {
+      g.type = node == info.constant ? gate_type::constant : gate_type::leaf;
+      return g;
+    }
+
+    g.type = gate_type::and_gate;
+    g.num_fanins = 2u;
+    g.fanins[0u] = c[0u];
+    g.fanins[1u] = c[1u];
+
+    if ( !structural ) { return g; }
+
+    /* !( s & t ) & !( !s & e ) = !ite( s, t, e ) */
+    if ( c[0u].complemented && c[1u].complemented && c[0u].node != c[1u].node && is_inner_and( c[0u] ) && is_inner_and( c[1u] ) )
+    {
+      std::array<aig_function, 2> x, y;
+      get_children( c[0u].node, x );
+      get_children( c[1u].node, y );
+
+      for ( auto i = 0u; i < 2u; ++i )
+      {
+        for ( auto j = 0u; j < 2u; ++j )
+        {
+          if ( x[i] == !y[j] )
+          {
+            g.type = gate_type::mux_gate;
+            g.num_fanins = 3u;
+            g.fanins = {x[i], x[1u - i], y[1u - j]};
+            return g;
+          }
+        }
+      }
+    }
+
+    /* ( !( a & b ) & !( a & c ) ) & !( b & c ) = !maj( a, b, c ) */
+    for ( auto i = 0u; i < 2u; ++i )
+    {
+      const auto& inner = c[i];
+      const auto& last = c[1u - i];
+      if ( inner.complemented || !last.complemented || !is_inner_and( inner ) || !is_inner_and( last ) ) { continue; }
+
+      std::array<aig_function, 2> p, q, r;
+      get_children( inner.node, p );
+      if ( !p[0u].complemented || !p[1u].complemented || p[0u].node == p[1u].node || !is_inner_and( p[0u] ) || !is_inner_and( p[1u] ) ) { continue; }
+      get_children( p[0u].node, q );
+      get_children( p[1u].node, r );
+      get_children( last.node, p );
+
+      /* the three pairs must be {a, b}, {a, c}, {b, c} */
+      for ( auto j = 0u; j < 2u; ++j )
+      {
+        for ( auto k = 0u; k < 2u; ++k )
+        {
+          if ( q[j] != r[k] ) { continue; }
+
+          const auto& a = q[j];
+          const auto& b = q[1u - j];
+          const auto& cc = r[1u - k];
+          if ( ( p[0u] == b && p[1u] == cc ) || ( p[0u] == cc && p[1u] == b ) )
+          {
+            g.type = gate_type::maj_gate;
+            g.num_fanins = 3u;
+            g.fanins = {a, b, cc};
+            return g;
+          }
+        }
+      }
+    }
+
+    return g;
+  }
+
+  inline int fanin_lit( const aig_function& f ) const
+  {
+    const auto v = node_to_var[f.node];
+    return f.complemented ? -v : v;
+  }
+
+  void encode( const aig_node& node, const gate_t& g )
+  {
+    const auto v = node_to_var[node] = cur_var;
+
+    switch ( g.type )
+    {
+    case gate_type::leaf:
+      ++cur_var;
+      break;
+
+    case gate_type::constant:
+      add_clause( solver )( {-v} );
+      ++cur_var;
+      break;
+
+    case gate_type::and_gate:
+      if ( blocking_vars )
+      {
+        if ( blocking_var_map.find( node ) == blocking_var_map.end() )
+        {
+          blocking_var_map[node] = cur_var + 1;
+        }
+        blocking_and( solver, blocking_var_map[node], fanin_lit( g.fanins[0u] ), fanin_lit( g.fanins[1u] ), v );
+        cur_var += 2;
+      }
+      else
+      {
+        logic_and( solver, fanin_lit( g.fanins[0u] ), fanin_lit( g.fanins[1u] ), v );
+        ++cur_var;
+      }
+      break;
+
+    case gate_type::mux_gate:
+      /* ite( s, t, !t ) = xnor( s, t ) */
+      if ( g.fanins[1u] == !g.fanins[2u] )
+      {
+        logic_xnor( solver, fanin_lit( g.fanins[0u] ), fanin_lit( g.fanins[1u] ), -v );
+      }
+      else
+      {
+        logic_mux( solver, fanin_lit( g.fanins[0u] ), fanin_lit( g.fanins[1u] ), fanin_lit( g.fanins[2u] ), -v );
+      }
+      ++cur_var;
+      break;
+
+    case gate_type::maj_gate:
+      logic_maj( solver, fanin_lit( g.fanins[0u] ), fanin_lit( g.fanins[1u] ), fanin_lit( g.fanins[2u] ), -v );
+      ++cur_var;
+      break;
+    }
+  }
+
+private:
+  S&                    solver;
+  const aig_graph&      aig;
+  const aig_graph_info& info;
+  int                   cur_var;
+  bool                  structural;
+  bool                  blocking_vars;
+
+  std::vector<int>      node_to_var;
+  std::vector<unsigned> fanout;
 };
 
+/**
+ * Settings:
+ *   blocking_vars:    AND gates get blocking variables (default: false)
+ *   structural:       encode MUX, XOR, and MAJ gates directly (default: true)
+ *
+ * Statistics:
+ *   node_var_map:     variables of encoded nodes, without inner nodes of
+ *                     MUX, XOR, and MAJ gates if structural is true
+ *   blocking_var_map: blocking variables of AND gates (if blocking_vars)
+ */
 template<class S>
 int add_aig( S& solver, const aig_graph& aig, int sid, std::vector<int>& piids, std::vector<int>& poids,
              properties::ptr settings = properties::ptr(),
@@ -122,48 +398,46 @@ int add_aig( S& solver, const aig_graph& aig, int sid, std::vector<int>& piids,
 {
   /* Settings */
   auto blocking_vars = get( settings, "blocking_vars", false );
-  auto blocking_var_map = get( statistics, "blocking_var_map", std::map<aig_node, int>() );
+  auto structural    = get( settings, "structural", true );
 
   const auto& graph_info = aig_info( aig );
-  std::map<aig_node, int> node_var_map;
-  std::map<aig_node, boost::default_color_type> colors;
+
+  aig_cnf_encoder<S> encoder( solver, aig, sid, structural, blocking_vars );
+  encoder.blocking_var_map = get( statistics, "blocking_var_map", std::map<aig_node, int>() );
 
   piids.resize( graph_info.inputs.size() );
   poids.resize( graph_info.outputs.size() );
 
   boost::iota( piids, sid );
-  sid += piids.size();
 
   for ( const auto& output : index( graph_info.outputs ) )
   {
     auto node = output.value.first.node;
     auto complement = output.value.first.complemented;
 
-    add_aig_visitor<S> visitor( aig, solver, sid, piids, node_var_map, blocking_vars, blocking_var_map );
-    boost::depth_first_visit( aig, node, visitor, boost::make_assoc_property_map( colors ) );
-
     if ( complement )
     {
-      int new_output = poids[output.index] = sid++;
-      not_equals( solver, node_var_map[node], new_output );
+      const auto v = encoder.var( node );
+      int new_output = poids[output.index] = encoder.new_var();
+      not_equals( solver, v, new_output );
     }
     else
     {
-      poids[output.index] = node_var_map[node];
+      poids[output.index] = encoder.var( node );
     }
   }
 
   if ( statistics )
   {
-    statistics->set( "node_var_map", node_var_map );
+    statistics->set( "node_var_map", encoder.node_var_map() );
 
     if ( blocking_vars )
     {
-      statistics->set( "blocking_var_map", blocking_var_map );
+      statistics->set( "blocking_var_map", encoder.blocking_var_map );
     }
   }
 
-  return sid;
+  return encoder.next_var();
 }
 
 }
@@ -0,0 +1,440 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file static_truth_table_utils.hpp
+ *
+ * @brief Truth tables with a number of variables fixed at compile-time
+ *
+ * The truth table is stored in 64-bit words; all masks are known at
+ * compile-time and the kernels work on whole words instead of single
+ * bits.  Functions with up to 6 variables fit into a single word, the
+ * loops over the words for larger functions have a fixed trip count and
+ * are vectorized by the compiler.
+ *
+ * The functions overload the ones in truth_table_utils.hpp, such that
+ * code can be written for both truth table types.
+ *
+ * @since  2.3
+ */
+
+#ifndef STATIC_TRUTH_TABLE_UTILS_HPP
+#define STATIC_TRUTH_TABLE_UTILS_HPP
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include <core/utils/bitset_utils.hpp>
+#include <classical/utils/truth_table_utils.hpp>
+
+namespace cirkit
+{
+
+namespace static_tt_constants
+{
+
+constexpr uint64_t projections[6] = {0xAAAAAAAAAAAAAAAA, 0xCCCCCCCCCCCCCCCC, 0xF0F0F0F0F0F0F0F0, 0xFF00FF00FF00FF00, 0xFFFF0000FFFF0000, 0xFFFFFFFF00000000};
+
+/* masks for swapping two variables x_i and x_j (i < j) inside a word */
+constexpr uint64_t swap_mask( unsigned i, unsigned j )
+{
+  return projections[i] & ~projections[j];
+}
+
+}
+
+template<unsigned NumVars>
+class static_tt
+{
+public:
+  static constexpr unsigned    num_vars   = NumVars;
+  static constexpr unsigned    num_blocks = NumVars <= 6u ? 1u : 1u << ( NumVars - 6u );
+  static constexpr std::size_t num_bits   = std::size_t( 1u ) << NumVars;
+  static constexpr uint64_t    mask       = NumVars >= 6u ? ~uint64_t( 0u ) : ( uint64_t( 1u ) << ( 1u << NumVars ) ) - 1u;
+
+  static_tt() : blocks{} {}
+
+  /* t must have 2^NumVars bits */
+  explicit static_tt( const tt& t ) : blocks{}
+  {
+    assert( t.size() == num_bits );
+    boost::to_block_range( t, blocks.begin() );
+  }
+
+  tt to_tt() const
+  {
+    tt t( num_bits );
+    boost::from_block_range( blocks.begin(), blocks.end(), t );
+    return t;
+  }
+
+  static static_tt const0()
+  {
+    return static_tt();
+  }
+
+  static static_tt const1()
+  {
+    return ~static_tt();
+  }
+
+  static static_tt nth_var( unsigned i )
+  {
+    assert( i < NumVars );
+
+    static_tt t;
+    if ( i < 6u )
+    {
+      for ( auto& b : t.blocks ) { b = static_tt_constants::projections[i] & mask; }
+    }
+    else
+    {
+      const auto step = 1u << ( i - 6u );
+      for ( auto k = 0u; k < num_blocks; ++k )
+      {
+        t.blocks[k] = ( k & step ) ? ~uint64_t( 0u ) : uint64_t( 0u );
+      }
+    }
+    return t;
+  }
+
+  inline static_tt operator~() const
+  {
+    static_tt t;
+    for ( auto k = 0u; k < num_blocks; ++k ) { t.blocks[k] = ~blocks[k] & mask; }
+    return t;
+  }
+
+  inline static_tt& operator&=( const static_tt& other )
+  {
+    for ( auto k = 0u; k < num_blocks; ++k ) { blocks[k] &= other.blocks[k]; }
+    return *this;
+  }
+
+  inline static_tt& operator|=( const static_tt& other )
+  {
+    for ( auto k = 0u; k < num_blocks; ++k ) { blocks[k] |= other.blocks[k]; }
+    return *this;
+  }
+
+  inline static_tt& operator^=( const static_tt& other )
+  {
+    for ( auto k = 0u; k < num_blocks; ++k ) { blocks[k] ^= other.blocks[k]; }
+    return *this;
+  }
+
+  inline bool operator==( const static_tt& other ) const
+  {
+    return blocks == other.blocks;
+  }
+
+  inline bool operator!=( const static_tt& other ) const
+  {
+    return blocks != other.blocks;
+  }
+
+  /* compares as numbers, i.e., in the same order as tt */
+  inline bool operator<( const static_tt& other ) const
+  {
+    for ( int k = num_blocks - 1; k >= 0; --k )
+    {
+      if ( blocks[k] != other.blocks[k] )
+      {
+        return blocks[k] < other.blocks[k];
+      }
+    }
+    return false;
+  }
+
+  inline std::size_t count() const
+  {
+    std::size_t c = 0u;
+    for ( const auto& b : blocks ) { c += popcount( b ); }
+    return c;
+  }
+
+  inline bool test( std::size_t pos ) const
+  {
+    return ( blocks[pos >> 6u] >> ( pos & 63u ) ) & 1u;
+  }
+
+public:
+  std::array<uint64_t, num_blocks> blocks;
+};
+
+template<unsigned NumVars>
+inline static_tt<NumVars> operator&( static_tt<NumVars> t1, const static_tt<NumVars>& t2 )
+{
+  return t1 &= t2;
+}
+
+template<unsigned NumVars>
+inline static_tt<NumVars> operator|( static_tt<NumVars> t1, const static_tt<NumVars>& t2 )
+{
+  return t1 |= t2;
+}
+
+template<unsigned NumVars>
+inline static_tt<NumVars> operator^( static_tt<NumVars> t1, const static_tt<NumVars>& t2 )
+{
+  return t1 ^= t2;
+}
+
+template<unsigned NumVars>
+inline unsigned tt_num_vars( const static_tt<NumVars>& )
+{
+  return NumVars;
+}
+
+template<unsigned NumVars>
+inline bool tt_is_const0( const static_tt<NumVars>& t )
+{
+  return t == static_tt<NumVars>::const0();
+}
+
+template<unsigned NumVars>
+inline bool tt_is_const1( const static_tt<NumVars>& t )
+{
+  return t == static_tt<NumVars>::const1();
+}
+
+template<unsigned NumVars>
+bool tt_has_var( const static_tt<NumVars>& t, unsigned i )
+{
+  assert( i < NumVars );
+
+  if ( i < 6u )
+  {
+    const auto m = ~static_tt_constants::projections[i];
+    const auto s = 1u << i;
+    for ( const auto& b : t.blocks )
+    {
+      if ( ( ( b >> s ) ^ b ) & m ) { return true; }
+    }
+    return false;
+  }
+  else
+  {
+    const auto step = 1u << ( i - 6u );
+    for ( auto k = 0u; k < t.num_blocks; k += step << 1u )
+    {
+      for ( auto j = k; j < k + step; ++j )
+      {
+        if ( t.blocks[j] != t.blocks[j + step] ) { return true; }
+      }
+    }
+    return false;
+  }
+}
+
+template<unsigned NumVars>
+boost::dynamic_bitset<> tt_support( const static_tt<NumVars>& t )
+{
+  boost::dynamic_bitset<> support( NumVars );
+  for ( auto i = 0u; i < NumVars; ++i )
+  {
+    support.set( i, tt_has_var( t, i ) );
+  }
+  return support;
+}
+
+/**
+ * @brief Computes the 0 cofactor (the result does not depend on x_i)
+ */
+template<unsigned NumVars>
+static_tt<NumVars> tt_cof0( const static_tt<NumVars>& t, unsigned i )
+{
+  assert( i < NumVars );
+
+  static_tt<NumVars> r;
+  if ( i < 6u )
+  {
+    const auto m = ~static_tt_constants::projections[i];
+    const auto s = 1u << i;
+    for ( auto k = 0u; k < t.num_blocks; ++k )
+    {
+      const auto b = t.blocks[k] & m;
+      r.blocks[k] = b | ( b << s );
+    }
+  }
+  else
+  {
+    const auto step = 1u << ( i - 6u );
+    for ( auto k = 0u; k < t.num_blocks; k += step << 1u )
+    {
+      for ( auto j = k; j < k + step; ++j )
+      {
+        r.blocks[j] = r.blocks[j + step] = t.blocks[j];
+      }
+    }
+  }
+  return r;
+}
+
+/**
+ * @brief Computes the 1 cofactor (the result does not depend on x_i)
+ */
+template<unsigned NumVars>
+static_tt<NumVars> tt_cof1( const static_tt<NumVars>& t, unsigned i )
+{
+  assert( i < NumVars );
+
+  static_tt<NumVars> r;
+  if ( i < 6u )
+  {
+    const auto m = static_tt_constants::projections[i];
+    const auto s = 1u << i;
+    for ( auto k = 0u; k < t.num_blocks; ++k )
+    {
+      const auto b = t.blocks[k] & m;
+      r.blocks[k] = b | ( b >> s );
+    }
+  }
+  else
+  {
+    const auto step = 1u << ( i - 6u );
+    for ( auto k = 0u; k < t.num_blocks; k += step << 1u )
+    {
+      for ( auto j = k; j < k + step; ++j )
+      {
+        r.blocks[j] = r.blocks[j + step] = t.blocks[j + step];
+      }
+    }
+  }
+  return r;
+}
+
+template<unsigned NumVars>
+inline static_tt<NumVars> tt_exists( const static_tt<NumVars>& t, unsigned i )
+{
+  return tt_cof0( t, i ) | tt_cof1( t, i );
+}
+
+template<unsigned NumVars>
+inline static_tt<NumVars> tt_forall( const static_tt<NumVars>& t, unsigned i )
+{
+  return tt_cof0( t, i ) & tt_cof1( t, i );
+}
+
+/**
+ * @brief Flips variable i
+ */
+template<unsigned NumVars>
+static_tt<NumVars> tt_flip( const static_tt<NumVars>& t, unsigned i )
+{
+  assert( i < NumVars );
+
+  static_tt<NumVars> r;
+  if ( i < 6u )
+  {
+    const auto m = static_tt_constants::projections[i];
+    const auto s = 1u << i;
+    for ( auto k = 0u; k < t.num_blocks; ++k )
+    {
+      const auto b = t.blocks[k];
+      r.blocks[k] = ( ( b << s ) & m ) | ( ( b & m ) >> s );
+    }
+  }
+  else
+  {
+    const auto step = 1u << ( i - 6u );
+    for ( auto k = 0u; k < t.num_blocks; ++k )
+    {
+      r.blocks[k] = t.blocks[k ^ step];
+    }
+  }
+  return r;
+}
+
+/**
+ * @brief Permutes variables i and j
+ */
+template<unsigned NumVars>
+static_tt<NumVars> tt_permute( const static_tt<NumVars>& t, unsigned i, unsigned j )
+{
+  assert( i < NumVars && j < NumVars );
+
+  if ( i == j ) { return t; }
+  if ( i > j ) { std::swap( i, j ); }
+
+  static_tt<NumVars> r;
+  if ( j < 6u )
+  {
+    /* delta swap inside each word, see TAOCP 7.1.3-(69) */
+    const auto m = static_tt_constants::swap_mask( i, j );
+    const auto s = ( 1u << j ) - ( 1u << i );
+    for ( auto k = 0u; k < t.num_blocks; ++k )
+    {
+      const auto b = t.blocks[k];
+      const auto y = ( b ^ ( b >> s ) ) & m;
+      r.blocks[k] = b ^ y ^ ( y << s );
+    }
+  }
+  else if ( i < 6u )
+  {
+    /* exchange half words between pairs of words */
+    const auto m = static_tt_constants::projections[i];
+    const auto s = 1u << i;
+    const auto step = 1u << ( j - 6u );
+    for ( auto k = 0u; k < t.num_blocks; k += step << 1u )
+    {
+      for ( auto l = k; l < k + step; ++l )
+      {
+        const auto b0 = t.blocks[l];
+        const auto b1 = t.blocks[l + step];
+        r.blocks[l]        = ( b0 & ~m ) | ( ( b1 & ~m ) << s );
+        r.blocks[l + step] = ( ( b0 & m ) >> s ) | ( b1 & m );
+      }
+    }
+  }
+  else
+  {
+    /* exchange whole words */
+    const auto si = 1u << ( i - 6u );
+    const auto sj = 1u << ( j - 6u );
+    for ( auto k = 0u; k < t.num_blocks; ++k )
+    {
+      const auto ki = ( k & si ) != 0u;
+      const auto kj = ( k & sj ) != 0u;
+      r.blocks[k] = ( ki == kj ) ? t.blocks[k] : t.blocks[k ^ si ^ sj];
+    }
+  }
+  return r;
+}
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -52,6 +52,31 @@ tt_store::tt_store()
   assert( sizeof( unsigned long ) == 8 );
 }
 
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+template<typename T>
+void fast_walsh_hadamard_transform_generic( std::vector<T>& spectrum )
+{
+  /* butterfly loops, the inner loop runs over contiguous halves and can be vectorized */
+  for ( auto d = 1u; d < spectrum.size(); d <<= 1u )
+  {
+    for ( auto b = 0u; b < spectrum.size(); b += d << 1u )
+    {
+      T * lo = &spectrum[b];
+      T * hi = lo + d;
+      for ( auto e = 0u; e < d; ++e )
+      {
+        const auto v1 = lo[e] + hi[e];
+        const auto v2 = lo[e] - hi[e];
+        lo[e] = v1;
+        hi[e] = v2;
+      }
+    }
+  }
+}
+
 /******************************************************************************
  * Public functions                                                           *
  ******************************************************************************/
@@ -574,34 +599,22 @@ tt tt_from_sop_spec( const std::string& spec )
   return f;
 }
 
-std::vector<int> walsh_spectrum( const tt& func )
+void fast_walsh_hadamard_transform( std::vector<int>& spectrum )
 {
-  const auto n = tt_num_vars( func );
+  fast_walsh_hadamard_transform_generic( spectrum );
+}
 
+void fast_walsh_hadamard_transform( std::vector<int64_t>& spectrum )
+{
+  fast_walsh_hadamard_transform_generic( spectrum );
+}
+
+std::vector<int> walsh_spectrum( const tt& func )
+{
   std::vector<int> spectra( func.size(), 0u );
   foreach_bit( func, [&spectra]( unsigned pos ) { spectra[pos] = 1u; } );
 
-  /* butterfly loops */
-  for ( auto i = 0u; i < n; ++i )
-  {
-    auto i1 = 0u;
-
-    const unsigned d = ( 1 << ( n - 1 - i ) );
-    /* blocks? */
-    for ( auto b = 0u; b < ( 1u << i ); ++b, i1 += d )
-    {
-      /* block elements */
-      for ( auto e = 0u; e < d; ++e, ++i1 )
-      {
-        const auto i2 = i1 + d;
-
-        const auto v1 = spectra[i1] + spectra[i2];
-        const auto v2 = spectra[i1] - spectra[i2];
-        spectra[i1] = v1;
-        spectra[i2] = v2;
-      }
-    }
-  }
+  fast_walsh_hadamard_transform( spectra );
 
   return spectra;
 }
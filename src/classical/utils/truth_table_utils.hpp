@@ -36,6 +36,9 @@
 #ifndef TRUTH_TABLE_UTILS_HPP
 #define TRUTH_TABLE_UTILS_HPP
 
+#include <cstdint>
+#include <vector>
+
 #include <boost/dynamic_bitset.hpp>
 
 #include <core/utils/bitset_utils.hpp>
@@ -308,6 +311,9 @@ tt tt_from_expression( const expression_t::ptr& expr );
 
 tt tt_from_sop_spec( const std::string& spec );
 
+/* in-place transform in O(n 2^n), the size of spectrum must be a power of 2 */
+void fast_walsh_hadamard_transform( std::vector<int>& spectrum );
+void fast_walsh_hadamard_transform( std::vector<int64_t>& spectrum );
 std::vector<int> walsh_spectrum( const tt& func );
 
 tt tt_maj( tt a, tt b, tt c );
@@ -0,0 +1,712 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "sat_sweeping_cec.hpp"
+
+#include <array>
+#include <climits>
+#include <cstdint>
+#include <random>
+#include <stack>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/range/iterator_range.hpp>
+
+#include <core/utils/range_utils.hpp>
+#include <core/utils/timer.hpp>
+#include <classical/sat/minisat.hpp>
+#include <classical/sat/sat_solver.hpp>
+#include <classical/sat/operations/logic.hpp>
+#include <classical/utils/aig_utils.hpp>
+
+namespace cirkit
+{
+
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+/* shared AIG of both circuits, literals are 2 * node + complement, node 0 is
+ * the constant, nodes 1 to num_inputs are the inputs */
+class sweeping_miter
+{
+public:
+  sweeping_miter( unsigned num_inputs, unsigned num_words, unsigned seed );
+
+  unsigned create_and( unsigned a, unsigned b );
+  unsigned create_or( unsigned a, unsigned b );
+  unsigned create_xor( unsigned a, unsigned b );
+  unsigned create_maj( unsigned a, unsigned b, unsigned c );
+
+  void add_output_pair( unsigned circuit_lit, unsigned spec_lit );
+
+  boost::optional<counterexample_t> run();
+
+  unsigned sat_calls = 0u;
+  unsigned merged = 0u;
+  unsigned refinements = 0u;
+
+private:
+  enum class proof_result { equivalent, refuted };
+
+  inline uint64_t sim( unsigned w, unsigned lit ) const { return sims[w][lit >> 1u] ^ ( ( lit & 1u ) ? ~UINT64_C( 0 ) : 0u ); }
+  inline bool phase( unsigned node ) const { return sims[0u][node] & 1u; }
+  inline unsigned repr_lit( unsigned lit ) const { return repr[lit >> 1u] ^ ( lit & 1u ); }
+
+  void simulate_word( unsigned w );
+  void add_refinement( const boost::dynamic_bitset<>& pattern );
+  void rebuild_classes( unsigned up_to );
+  bool same_signature( unsigned node1, unsigned node2 ) const;
+
+  int sat_lit( unsigned lit );
+  proof_result prove( unsigned lit1, unsigned lit2 );
+  boost::dynamic_bitset<> model_pattern( const solver_result_t& result ) const;
+  boost::dynamic_bitset<> sim_pattern( unsigned w, unsigned bit ) const;
+  counterexample_t make_counterexample( const boost::dynamic_bitset<>& pattern ) const;
+
+private:
+  unsigned                                 num_inputs;
+  std::vector<std::array<unsigned, 2u>>    fanins;
+  std::unordered_map<uint64_t, unsigned>   strash;
+  std::vector<std::pair<unsigned, unsigned>> output_pairs;
+
+  /* simulation words, indexed by word and then by node */
+  std::vector<std::vector<uint64_t>>       sims;
+  std::vector<uint64_t>                    hashes;
+  std::unordered_multimap<uint64_t, unsigned> classes;
+  std::default_random_engine               gen;
+  unsigned                                 refinement_bit = 64u;
+
+  /* proved representatives as literals */
+  std::vector<unsigned>                    repr;
+
+  minisat_solver                           solver;
+  solver_execution_statistics              solver_stats;
+  std::vector<int>                         sat_vars;
+  int                                      next_var = 1;
+};
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+inline uint64_t sweeping_word_hash( uint64_t word, unsigned w )
+{
+  /* finalizer of MurmurHash3 */
+  auto h = word ^ ( ( w + 1u ) * UINT64_C( 0x9e3779b97f4a7c15 ) );
+  h ^= h >> 33u;
+  h *= UINT64_C( 0xff51afd7ed558ccd );
+  h ^= h >> 33u;
+  h *= UINT64_C( 0xc4ceb9fe1a85ec53 );
+  h ^= h >> 33u;
+  return h;
+}
+
+sweeping_miter::sweeping_miter( unsigned num_inputs, unsigned num_words, unsigned seed )
+  : num_inputs( num_inputs ),
+    fanins( num_inputs + 1u ),
+    gen( seed ),
+    solver( make_solver<minisat_solver>() )
+{
+  std::uniform_int_distribution<uint64_t> dist;
+
+  sims.resize( std::max( num_words, 1u ) );
+  for ( auto& words : sims )
+  {
+    words.push_back( 0u );
+    for ( auto i = 0u; i < num_inputs; ++i )
+    {
+      words.push_back( dist( gen ) );
+    }
+  }
+}
+
+unsigned sweeping_miter::create_and( unsigned a, unsigned b )
+{
+  if ( a > b ) { std::swap( a, b ); }
+
+  /* trivial cases */
+  if ( a == 0u || a == ( b ^ 1u ) ) { return 0u; }
+  if ( a == 1u || a == b )          { return b; }
+
+  const auto key = ( static_cast<uint64_t>( a ) << 32u ) | b;
+  const auto it = strash.find( key );
+  if ( it != strash.end() )
+  {
+    return it->second << 1u;
+  }
+
+  const unsigned node = fanins.size();
+  fanins.push_back( {{a, b}} );
+  strash.insert( {key, node} );
+
+  for ( auto& words : sims )
+  {
+    words.push_back( 0u );
+    words.back() = ( ( words[a >> 1u] ^ ( ( a & 1u ) ? ~UINT64_C( 0 ) : 0u ) ) & ( words[b >> 1u] ^ ( ( b & 1u ) ? ~UINT64_C( 0 ) : 0u ) ) );
+  }
+
+  return node << 1u;
+}
+
+unsigned sweeping_miter::create_or( unsigned a, unsigned b )
+{
+  return create_and( a ^ 1u, b ^ 1u ) ^ 1u;
+}
+
+unsigned sweeping_miter::create_xor( unsigned a, unsigned b )
+{
+  return create_or( create_and( a ^ 1u, b ), create_and( a, b ^ 1u ) );
+}
+
+unsigned sweeping_miter::create_maj( unsigned a, unsigned b, unsigned c )
+{
+  return create_or( create_and( a, b ), create_and( c, create_or( a, b ) ) );
+}
+
+void sweeping_miter::add_output_pair( unsigned circuit_lit, unsigned spec_lit )
+{
+  output_pairs.push_back( {circuit_lit, spec_lit} );
+}
+
+void sweeping_miter::simulate_word( unsigned w )
+{
+  auto& words = sims[w];
+  for ( auto n = num_inputs + 1u; n < fanins.size(); ++n )
+  {
+    words[n] = sim( w, fanins[n][0u] ) & sim( w, fanins[n][1u] );
+  }
+}
+
+/* adds the pattern and its distance-1 neighbors to the simulation words; up
+ * to 64 patterns share one word, the neighbors are overwritten first */
+void sweeping_miter::add_refinement( const boost::dynamic_bitset<>& pattern )
+{
+  ++refinements;
+
+  unsigned w;
+  if ( refinement_bit == 64u )
+  {
+    w = sims.size();
+    sims.emplace_back( fanins.size(), 0u );
+
+    for ( auto i = 0u; i < num_inputs; ++i )
+    {
+      sims[w][i + 1u] = pattern[i] ? ~UINT64_C( 0 ) : 0u;
+    }
+    if ( num_inputs )
+    {
+      std::uniform_int_distribution<unsigned> dist( 0u, num_inputs - 1u );
+      for ( auto b = 1u; b < 64u; ++b )
+      {
+        sims[w][dist( gen ) + 1u] ^= UINT64_C( 1 ) << b;
+      }
+    }
+    refinement_bit = 1u;
+
+    simulate_word( w );
+    for ( auto n = 0u; n < fanins.size(); ++n )
+    {
+      hashes[n] += sweeping_word_hash( sim( w, ( n << 1u ) | phase( n ) ), w );
+    }
+  }
+  else
+  {
+    w = sims.size() - 1u;
+    const auto old_words = sims[w];
+
+    for ( auto i = 0u; i < num_inputs; ++i )
+    {
+      if ( pattern[i] )
+      {
+        sims[w][i + 1u] |= UINT64_C( 1 ) << refinement_bit;
+      }
+      else
+      {
+        sims[w][i + 1u] &= ~( UINT64_C( 1 ) << refinement_bit );
+      }
+    }
+    ++refinement_bit;
+
+    simulate_word( w );
+    for ( auto n = 0u; n < fanins.size(); ++n )
+    {
+      const auto old_word = old_words[n] ^ ( phase( n ) ? ~UINT64_C( 0 ) : 0u );
+      hashes[n] += sweeping_word_hash( sim( w, ( n << 1u ) | phase( n ) ), w ) - sweeping_word_hash( old_word, w );
+    }
+  }
+}
+
+/* classes contain representatives of all nodes smaller than up_to */
+void sweeping_miter::rebuild_classes( unsigned up_to )
+{
+  classes.clear();
+  for ( auto n = 0u; n < up_to; ++n )
+  {
+    if ( repr[n] == n << 1u )
+    {
+      classes.insert( {hashes[n], n} );
+    }
+  }
+}
+
+bool sweeping_miter::same_signature( unsigned node1, unsigned node2 ) const
+{
+  const auto l1 = ( node1 << 1u ) | phase( node1 );
+  const auto l2 = ( node2 << 1u ) | phase( node2 );
+
+  for ( auto w = 0u; w < sims.size(); ++w )
+  {
+    if ( sim( w, l1 ) != sim( w, l2 ) ) { return false; }
+  }
+  return true;
+}
+
+/* encodes the literal in terms of the representatives of its transitive fanin */
+int sweeping_miter::sat_lit( unsigned lit )
+{
+  const auto root = lit >> 1u;
+
+  std::stack<unsigned> stack;
+  stack.push( root );
+
+  while ( !stack.empty() )
+  {
+    const auto n = stack.top();
+
+    if ( sat_vars[n] )
+    {
+      stack.pop();
+      continue;
+    }
+
+    if ( n == 0u )
+    {
+      sat_vars[n] = next_var++;
+      add_clause( solver )( {-sat_vars[n]} );
+      stack.pop();
+      continue;
+    }
+
+    if ( n <= num_inputs )
+    {
+      sat_vars[n] = next_var++;
+      stack.pop();
+      continue;
+    }
+
+    const auto c0 = repr_lit( fanins[n][0u] );
+    const auto c1 = repr_lit( fanins[n][1u] );
+
+    if ( !sat_vars[c0 >> 1u] || !sat_vars[c1 >> 1u] )
+    {
+      if ( !sat_vars[c0 >> 1u] ) { stack.push( c0 >> 1u ); }
+      if ( !sat_vars[c1 >> 1u] ) { stack.push( c1 >> 1u ); }
+      continue;
+    }
+
+    stack.pop();
+    sat_vars[n] = next_var++;
+
+    const auto v0 = ( c0 & 1u ) ? -sat_vars[c0 >> 1u] : sat_vars[c0 >> 1u];
+    const auto v1 = ( c1 & 1u ) ? -sat_vars[c1 >> 1u] : sat_vars[c1 >> 1u];
+    logic_and( solver, v0, v1, sat_vars[n] );
+  }
+
+  return ( lit & 1u ) ? -sat_vars[root] : sat_vars[root];
+}
+
+boost::dynamic_bitset<> sweeping_miter::model_pattern( const solver_result_t& result ) const
+{
+  boost::dynamic_bitset<> pattern( num_inputs );
+
+  const auto& bits = result->first;
+  for ( auto i = 0u; i < num_inputs; ++i )
+  {
+    const auto v = sat_vars[i + 1u];
+
+    /* inputs outside the cone keep the value of the first random pattern */
+    pattern[i] = ( v && static_cast<unsigned>( v ) <= bits.size() ) ? bits[v - 1] : static_cast<bool>( sims[0u][i + 1u] & 1u );
+  }
+
+  return pattern;
+}
+
+boost::dynamic_bitset<> sweeping_miter::sim_pattern( unsigned w, unsigned bit ) const
+{
+  boost::dynamic_bitset<> pattern( num_inputs );
+  for ( auto i = 0u; i < num_inputs; ++i )
+  {
+    pattern[i] = ( sims[w][i + 1u] >> bit ) & 1u;
+  }
+  return pattern;
+}
+
+sweeping_miter::proof_result sweeping_miter::prove( unsigned lit1, unsigned lit2 )
+{
+  const auto v1 = sat_lit( lit1 );
+  const auto v2 = sat_lit( lit2 );
+
+  for ( const auto& assumptions : {std::vector<int>{v1, -v2}, std::vector<int>{-v1, v2}} )
+  {
+    ++sat_calls;
+    const auto result = solve( solver, solver_stats, assumptions );
+    if ( result )
+    {
+      add_refinement( model_pattern( result ) );
+      return proof_result::refuted;
+    }
+  }
+
+  equals( solver, v1, v2 );
+  return proof_result::equivalent;
+}
+
+counterexample_t sweeping_miter::make_counterexample( const boost::dynamic_bitset<>& pattern ) const
+{
+  std::vector<bool> values( fanins.size() );
+  for ( auto i = 0u; i < num_inputs; ++i )
+  {
+    values[i + 1u] = pattern[i];
+  }
+  for ( auto n = num_inputs + 1u; n < fanins.size(); ++n )
+  {
+    const auto& f = fanins[n];
+    values[n] = ( values[f[0u] >> 1u] != static_cast<bool>( f[0u] & 1u ) ) && ( values[f[1u] >> 1u] != static_cast<bool>( f[1u] & 1u ) );
+  }
+
+  counterexample_t cex( num_inputs, output_pairs.size() );
+  cex.in.bits = pattern;
+  cex.in.mask.set();
+  for ( const auto& p : index( output_pairs ) )
+  {
+    cex.out.bits[p.index]          = values[p.value.first >> 1u] != static_cast<bool>( p.value.first & 1u );
+    cex.expected_out.bits[p.index] = values[p.value.second >> 1u] != static_cast<bool>( p.value.second & 1u );
+  }
+  cex.out.mask.set();
+  cex.expected_out.mask.set();
+
+  return cex;
+}
+
+boost::optional<counterexample_t> sweeping_miter::run()
+{
+  /* random simulation may already refute some output pair */
+  for ( const auto& p : output_pairs )
+  {
+    for ( auto w = 0u; w < sims.size(); ++w )
+    {
+      if ( const auto diff = sim( w, p.first ) ^ sim( w, p.second ) )
+      {
+        auto bit = 0u;
+        while ( !( ( diff >> bit ) & 1u ) ) { ++bit; }
+        return make_counterexample( sim_pattern( w, bit ) );
+      }
+    }
+  }
+
+  /* signatures are normalized such that the first pattern evaluates to 0 */
+  hashes.assign( fanins.size(), 0u );
+  for ( auto w = 0u; w < sims.size(); ++w )
+  {
+    for ( auto n = 0u; n < fanins.size(); ++n )
+    {
+      hashes[n] += sweeping_word_hash( sim( w, ( n << 1u ) | phase( n ) ), w );
+    }
+  }
+
+  repr.resize( fanins.size() );
+  for ( auto n = 0u; n < fanins.size(); ++n )
+  {
+    repr[n] = n << 1u;
+  }
+  sat_vars.assign( fanins.size(), 0 );
+
+  rebuild_classes( num_inputs + 1u );
+
+  /* prove candidates bottom-up */
+  for ( auto n = num_inputs + 1u; n < fanins.size(); ++n )
+  {
+    while ( true )
+    {
+      auto range = classes.equal_range( hashes[n] );
+      auto it = range.first;
+      while ( it != range.second && !same_signature( n, it->second ) ) { ++it; }
+
+      if ( it == range.second )
+      {
+        classes.insert( {hashes[n], n} );
+        break;
+      }
+
+      const auto r = it->second;
+      const auto lit = ( r << 1u ) | static_cast<unsigned>( phase( n ) != phase( r ) );
+
+      if ( prove( n << 1u, lit ) == proof_result::equivalent )
+      {
+        repr[n] = lit;
+        ++merged;
+        break;
+      }
+
+      rebuild_classes( n );
+    }
+  }
+
+  /* prove the outputs */
+  for ( const auto& p : output_pairs )
+  {
+    const auto l1 = repr_lit( p.first );
+    const auto l2 = repr_lit( p.second );
+
+    if ( l1 == l2 ) { continue; }
+
+    const auto v1 = sat_lit( l1 );
+    const auto v2 = sat_lit( l2 );
+    for ( const auto& assumptions : {std::vector<int>{v1, -v2}, std::vector<int>{-v1, v2}} )
+    {
+      ++sat_calls;
+      const auto result = solve( solver, solver_stats, assumptions );
+      if ( result )
+      {
+        return make_counterexample( model_pattern( result ) );
+      }
+    }
+  }
+
+  return boost::none;
+}
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+boost::optional<counterexample_t> sat_sweeping_cec( const aig_graph& circuit, const aig_graph& spec,
+                                                    const properties::ptr& settings,
+                                                    const properties::ptr& statistics )
+{
+  /* settings */
+  const auto num_words = get( settings, "num_words", 8u );
+  const auto seed      = get( settings, "seed",      0xcafeu );
+
+  /* timing */
+  properties_timer t( statistics );
+
+  const auto& circuit_info = aig_info( circuit );
+  const auto& spec_info    = aig_info( spec );
+  const auto num_inputs    = circuit_info.inputs.size();
+
+  /* circuits with different interfaces are not equivalent */
+  if ( num_inputs != spec_info.inputs.size() || circuit_info.outputs.size() != spec_info.outputs.size() )
+  {
+    set( statistics, "sat_calls", 0u );
+    set( statistics, "merged", 0u );
+    set( statistics, "refinements", 0u );
+    return counterexample_t();
+  }
+
+  sweeping_miter miter( num_inputs, num_words, seed );
+
+  std::vector<std::vector<unsigned>> lits;
+  for ( const auto* aig : {&circuit, &spec} )
+  {
+    const auto& info = aig_info( *aig );
+
+    lits.emplace_back( boost::num_vertices( *aig ), UINT_MAX );
+    auto& node_to_lit = lits.back();
+
+    node_to_lit[info.constant] = 0u;
+    for ( const auto& input : index( info.inputs ) )
+    {
+      node_to_lit[input.value] = ( input.index + 1u ) << 1u;
+    }
+
+    /* iterative DFS from the outputs */
+    std::stack<aig_node> stack;
+    for ( const auto& output : info.outputs )
+    {
+      stack.push( output.first.node );
+    }
+
+    while ( !stack.empty() )
+    {
+      const auto n = stack.top();
+      if ( node_to_lit[n] != UINT_MAX )
+      {
+        stack.pop();
+        continue;
+      }
+
+      std::array<aig_function, 2u> children;
+      auto pos = 0u;
+      auto pending = false;
+      for ( const auto& e : boost::make_iterator_range( boost::out_edges( n, *aig ) ) )
+      {
+        children[pos] = aig_to_function( *aig, e );
+        if ( node_to_lit[children[pos].node] == UINT_MAX )
+        {
+          stack.push( children[pos].node );
+          pending = true;
+        }
+        ++pos;
+      }
+      assert( pos == 2u );
+
+      if ( pending ) { continue; }
+
+      stack.pop();
+      node_to_lit[n] = miter.create_and( node_to_lit[children[0u].node] ^ static_cast<unsigned>( children[0u].complemented ),
+                                         node_to_lit[children[1u].node] ^ static_cast<unsigned>( children[1u].complemented ) );
+    }
+  }
+
+  for ( auto i = 0u; i < circuit_info.outputs.size(); ++i )
+  {
+    const auto& f1 = circuit_info.outputs[i].first;
+    const auto& f2 = spec_info.outputs[i].first;
+    miter.add_output_pair( lits[0u][f1.node] ^ static_cast<unsigned>( f1.complemented ),
+                           lits[1u][f2.node] ^ static_cast<unsigned>( f2.complemented ) );
+  }
+
+  const auto result = miter.run();
+
+  set( statistics, "sat_calls", miter.sat_calls );
+  set( statistics, "merged", miter.merged );
+  set( statistics, "refinements", miter.refinements );
+
+  return result;
+}
+
+boost::optional<counterexample_t> sat_sweeping_cec( const xmg_graph& circuit, const xmg_graph& spec,
+                                                    const properties::ptr& settings,
+                                                    const properties::ptr& statistics )
+{
+  /* settings */
+  const auto num_words = get( settings, "num_words", 8u );
+  const auto seed      = get( settings, "seed",      0xcafeu );
+
+  /* timing */
+  properties_timer t( statistics );
+
+  const auto num_inputs = circuit.inputs().size();
+
+  /* circuits with different interfaces are not equivalent */
+  if ( num_inputs != spec.inputs().size() || circuit.outputs().size() != spec.outputs().size() )
+  {
+    set( statistics, "sat_calls", 0u );
+    set( statistics, "merged", 0u );
+    set( statistics, "refinements", 0u );
+    return counterexample_t();
+  }
+
+  sweeping_miter miter( num_inputs, num_words, seed );
+
+  std::vector<std::vector<unsigned>> lits;
+  for ( const auto* xmg : {&circuit, &spec} )
+  {
+    lits.emplace_back( xmg->size(), UINT_MAX );
+    auto& node_to_lit = lits.back();
+
+    node_to_lit[xmg->get_constant( false ).node] = 0u;
+    for ( const auto& input : index( xmg->inputs() ) )
+    {
+      node_to_lit[input.value.first] = ( input.index + 1u ) << 1u;
+    }
+
+    /* iterative DFS from the outputs */
+    std::stack<xmg_node> stack;
+    for ( const auto& output : xmg->outputs() )
+    {
+      stack.push( output.first.node );
+    }
+
+    while ( !stack.empty() )
+    {
+      const auto n = stack.top();
+      if ( node_to_lit[n] != UINT_MAX )
+      {
+        stack.pop();
+        continue;
+      }
+
+      const auto children = xmg->children( n );
+      auto pending = false;
+      for ( const auto& c : children )
+      {
+        if ( node_to_lit[c.node] == UINT_MAX )
+        {
+          stack.push( c.node );
+          pending = true;
+        }
+      }
+
+      if ( pending ) { continue; }
+
+      stack.pop();
+
+      std::vector<unsigned> cl;
+      for ( const auto& c : children )
+      {
+        cl.push_back( node_to_lit[c.node] ^ static_cast<unsigned>( c.complemented ) );
+      }
+
+      if ( xmg->is_xor( n ) )
+      {
+        node_to_lit[n] = miter.create_xor( cl[0u], cl[1u] );
+      }
+      else
+      {
+        assert( xmg->is_maj( n ) );
+        node_to_lit[n] = miter.create_maj( cl[0u], cl[1u], cl[2u] );
+      }
+    }
+  }
+
+  for ( auto i = 0u; i < circuit.outputs().size(); ++i )
+  {
+    const auto& f1 = circuit.outputs()[i].first;
+    const auto& f2 = spec.outputs()[i].first;
+    miter.add_output_pair( lits[0u][f1.node] ^ static_cast<unsigned>( f1.complemented ),
+                           lits[1u][f2.node] ^ static_cast<unsigned>( f2.complemented ) );
+  }
+
+  const auto result = miter.run();
+
+  set( statistics, "sat_calls", miter.sat_calls );
+  set( statistics, "merged", miter.merged );
+  set( statistics, "refinements", miter.refinements );
+
+  return result;
+}
+
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
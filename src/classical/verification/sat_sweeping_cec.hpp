@@ -0,0 +1,89 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file sat_sweeping_cec.hpp
+ *
+ * @brief Combinational equivalence checking with SAT sweeping
+ *
+ * Both circuits are structurally hashed into a shared AIG over common
+ * inputs.  Candidate equivalences are obtained from bit-parallel random
+ * simulation and proved or refuted bottom-up with one incremental SAT
+ * solver.  Counter-examples to candidate equivalences are fed back as new
+ * simulation patterns and proven nodes are merged, such that the proofs for
+ * nodes further up only see the merged fanin.
+ *
+ * Settings:
+ *   num_words: number of initial random simulation words (default: 8)
+ *   seed:      seed for the random simulation (default: 0xcafe)
+ *
+ * Statistics:
+ *   runtime:     run-time
+ *   sat_calls:   number of SAT calls
+ *   merged:      number of nodes that were proved equivalent to another node
+ *   refinements: number of counter-examples that refined the classes
+ *
+ * @since  2.3
+ */
+
+#ifndef SAT_SWEEPING_CEC_HPP
+#define SAT_SWEEPING_CEC_HPP
+
+#include <boost/optional.hpp>
+
+#include <core/properties.hpp>
+#include <classical/aig.hpp>
+#include <classical/utils/counterexample.hpp>
+#include <classical/xmg/xmg.hpp>
+
+namespace cirkit
+{
+
+/**
+ * Returns boost::none if both circuits are equivalent, and a counter-example
+ * otherwise.  Inputs and outputs of both circuits are matched by position.
+ * Circuits with different numbers of inputs or outputs are not equivalent,
+ * in this case the counter-example is empty.
+ * In the counter-example, `in' is the input assignment, `out' are the
+ * outputs of `circuit' and `expected_out' are the outputs of `spec'.
+ */
+boost::optional<counterexample_t> sat_sweeping_cec( const aig_graph& circuit, const aig_graph& spec,
+                                                    const properties::ptr& settings = properties::ptr(),
+                                                    const properties::ptr& statistics = properties::ptr() );
+
+boost::optional<counterexample_t> sat_sweeping_cec( const xmg_graph& circuit, const xmg_graph& spec,
+                                                    const properties::ptr& settings = properties::ptr(),
+                                                    const properties::ptr& statistics = properties::ptr() );
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
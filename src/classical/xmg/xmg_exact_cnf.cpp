@@ -0,0 +1,782 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "xmg_exact_cnf.hpp"
+
+#include <array>
+#include <cassert>
+#include <iostream>
+#include <type_traits>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+#include <boost/format.hpp>
+
+#include <core/utils/timer.hpp>
+#include <classical/mig/mig_simulate.hpp>
+#include <classical/mig/mig_utils.hpp>
+#include <classical/sat/abcsat.hpp>
+#include <classical/sat/minisat.hpp>
+#include <classical/sat/sat_solver.hpp>
+#include <classical/sat/operations/cardinality.hpp>
+#include <classical/sat/operations/logic.hpp>
+#include <classical/utils/spec_representation.hpp>
+
+using boost::format;
+using boost::str;
+
+namespace cirkit
+{
+
+namespace
+{
+
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+struct exact_cnf_params
+{
+  bool                                       binary;            /* binary instead of one-hot selection variables */
+  unsigned                                   cardinality;       /* 0: pairwise, 1: Sinz, 2: Bailleux-Boufkhad */
+  boost::dynamic_bitset<>                    symmetry_breaking; /* same bits as in exact_mig */
+  boost::dynamic_bitset<>                    support;
+  std::vector<std::pair<unsigned, unsigned>> symmetries;
+};
+
+/* gate i has three fanins, each selects one of n + i + 1 candidates:
+ * 0 is the constant, 1..n are the inputs and n + 1 + l is gate l;
+ * the fanins of XOR gates are 0 and 1, fanin 2 is fixed to the constant */
+template<class S>
+class exact_cnf_instance
+{
+public:
+  exact_cnf_instance( S& solver, unsigned num_vars, unsigned num_gates, bool with_xor, const exact_cnf_params& params )
+    : solver( solver ),
+      num_vars( num_vars ),
+      num_gates( num_gates ),
+      with_xor( with_xor ),
+      params( params )
+  {
+    const_true = sid++;
+    add_clause( solver )( {const_true} );
+
+    for ( auto i = 0u; i < num_gates; ++i )
+    {
+      add_gate();
+    }
+
+    add_symmetry_breaking();
+  }
+
+  void constrain( const tt& spec )
+  {
+    for ( auto j = 0u; j < spec.size(); ++j )
+    {
+      std::vector<int> values;
+
+      for ( auto i = 0u; i < num_gates; ++i )
+      {
+        int in[3];
+        for ( auto x = 0u; x < 3u; ++x )
+        {
+          in[x] = sid++;
+
+          /* in[x] = neg ^ ite( sel, ... ) */
+          const auto m = num_candidates( i );
+          for ( auto c = 0u; c < m; ++c )
+          {
+            const auto e = sel( i, x, c );
+
+            if ( c == 0u || c <= num_vars )
+            {
+              const auto value = c != 0u && ( ( j >> ( c - 1u ) ) & 1u );
+              add_clause( solver )( {-e, -in[x], value ? -negs[i][x] : negs[i][x]} );
+              add_clause( solver )( {-e, in[x], value ? negs[i][x] : -negs[i][x]} );
+            }
+            else
+            {
+              const auto g = values[c - num_vars - 1u];
+              add_clause( solver )( {-e, -in[x], negs[i][x], g} );
+              add_clause( solver )( {-e, -in[x], -negs[i][x], -g} );
+              add_clause( solver )( {-e, in[x], negs[i][x], -g} );
+              add_clause( solver )( {-e, in[x], -negs[i][x], g} );
+            }
+          }
+        }
+
+        const auto v = sid++;
+        values.push_back( v );
+
+        /* v = <in[0] in[1] in[2]> (if not XOR) */
+        const auto t = with_xor ? types[i] : -const_true;
+        add_clause( solver )( {t, -in[0], -in[1], v} );
+        add_clause( solver )( {t, -in[0], -in[2], v} );
+        add_clause( solver )( {t, -in[1], -in[2], v} );
+        add_clause( solver )( {t, in[0], in[1], -v} );
+        add_clause( solver )( {t, in[0], in[2], -v} );
+        add_clause( solver )( {t, in[1], in[2], -v} );
+
+        /* v = in[0] ^ in[1] (if XOR) */
+        if ( with_xor )
+        {
+          add_clause( solver )( {-t, -in[0], in[1], v} );
+          add_clause( solver )( {-t, in[0], -in[1], v} );
+          add_clause( solver )( {-t, in[0], in[1], -v} );
+          add_clause( solver )( {-t, -in[0], -in[1], -v} );
+        }
+      }
+
+      add_clause( solver )( {spec[j] ? values.back() : -values.back()} );
+    }
+  }
+
+  template<class Builder>
+  typename Builder::function_t extract( Builder& builder, const solver_result_t& result ) const
+  {
+    const auto value = [&result]( int var ) {
+      return static_cast<unsigned>( var - 1 ) < result->first.size() && result->first[var - 1];
+    };
+
+    std::vector<typename Builder::function_t> candidates;
+    candidates.push_back( builder.get_constant() );
+    for ( auto i = 0u; i < num_vars; ++i )
+    {
+      candidates.push_back( builder.create_pi( str( format( "x%d" ) % i ) ) );
+    }
+
+    for ( auto i = 0u; i < num_gates; ++i )
+    {
+      typename Builder::function_t children[3];
+
+      for ( auto x = 0u; x < 3u; ++x )
+      {
+        for ( auto c = 0u; c < num_candidates( i ); ++c )
+        {
+          if ( value( sels[i][x][c] ) )
+          {
+            children[x] = candidates[c];
+            break;
+          }
+        }
+
+        if ( value( negs[i][x] ) )
+        {
+          children[x] = !children[x];
+        }
+      }
+
+      candidates.push_back( create_gate( builder, children, with_xor && value( types[i] ), std::integral_constant<bool, Builder::has_xor>() ) );
+    }
+
+    return candidates.back();
+  }
+
+private:
+  /* builders without XOR gates have no create_xor, XOR gates are only selected if with_xor is set */
+  template<class Builder>
+  static typename Builder::function_t create_gate( Builder& builder, const typename Builder::function_t* children, bool is_xor, std::true_type )
+  {
+    return is_xor ? builder.create_xor( children[0], children[1] ) : builder.create_maj( children[0], children[1], children[2] );
+  }
+
+  template<class Builder>
+  static typename Builder::function_t create_gate( Builder& builder, const typename Builder::function_t* children, bool is_xor, std::false_type )
+  {
+    assert( !is_xor );
+    return builder.create_maj( children[0], children[1], children[2] );
+  }
+
+  inline unsigned num_candidates( unsigned i ) const
+  {
+    return num_vars + i + 1u;
+  }
+
+  /* literal for fanin x of gate i selects c */
+  inline int sel( unsigned i, unsigned x, unsigned c ) const
+  {
+    return c < num_candidates( i ) ? sels[i][x][c] : -const_true;
+  }
+
+  /* literal for fanin x of gate i selects a candidate >= c (order encoding) */
+  inline int geq( unsigned i, unsigned x, unsigned c ) const
+  {
+    return c == 0u ? const_true : ( c < num_candidates( i ) ? ladders[i][x][c] : -const_true );
+  }
+
+  void add_gate()
+  {
+    const auto i = sels.size();
+    const auto m = num_candidates( i );
+
+    sels.emplace_back();
+    ladders.emplace_back();
+    negs.emplace_back();
+
+    for ( auto x = 0u; x < 3u; ++x )
+    {
+      auto& e = sels[i][x];
+
+      e.resize( m );
+      for ( auto c = 0u; c < m; ++c )
+      {
+        e[c] = sid++;
+      }
+
+      if ( params.binary )
+      {
+        auto bw = 1u;
+        while ( ( 1u << bw ) < m ) { ++bw; }
+
+        std::vector<int> bits( bw );
+        for ( auto& b : bits )
+        {
+          b = sid++;
+        }
+
+        const auto bits_equal = [&bits, bw]( unsigned c ) {
+          clause_t lits;
+          for ( auto b = 0u; b < bw; ++b )
+          {
+            lits.push_back( ( ( c >> b ) & 1u ) ? bits[b] : -bits[b] );
+          }
+          return lits;
+        };
+
+        for ( auto c = 0u; c < m; ++c )
+        {
+          logic_and( solver, bits_equal( c ), e[c] );
+        }
+
+        /* block values out of range */
+        for ( auto c = m; c < ( 1u << bw ); ++c )
+        {
+          clause_t clause;
+          for ( auto l : bits_equal( c ) )
+          {
+            clause.push_back( -l );
+          }
+          add_clause( solver )( clause );
+        }
+      }
+      else
+      {
+        switch ( params.cardinality )
+        {
+        case 0u:
+        default:
+          one_hot( solver, e );
+          break;
+        case 1u:
+          sid = equals_sinz( solver, e, 1u, sid );
+          break;
+        case 2u:
+          sid = equals_bailleux_boufkhad( solver, e, 1u, sid );
+          break;
+        }
+      }
+
+      /* ladder u[c] = e[c] | u[c + 1] */
+      auto& u = ladders[i][x];
+      u.resize( m, 0 );
+      for ( auto c = 1u; c < m; ++c )
+      {
+        u[c] = sid++;
+      }
+      for ( auto c = 1u; c < m; ++c )
+      {
+        add_clause( solver )( {-e[c], u[c]} );
+        if ( c + 1u < m )
+        {
+          add_clause( solver )( {-u[c + 1u], u[c]} );
+          add_clause( solver )( {-u[c], e[c], u[c + 1u]} );
+        }
+        else
+        {
+          add_clause( solver )( {-u[c], e[c]} );
+        }
+      }
+
+      negs[i][x] = sid++;
+    }
+
+    if ( with_xor )
+    {
+      const auto t = sid++;
+      types.push_back( t );
+
+      /* XOR has no third fanin and no constant first fanin */
+      add_clause( solver )( {-t, sel( i, 2u, 0u )} );
+      add_clause( solver )( {-t, -negs[i][2u]} );
+      add_clause( solver )( {-t, -sel( i, 0u, 0u )} );
+    }
+  }
+
+  /* guard -> fanin a of gate i < fanin b of gate j */
+  void less_than( const clause_t& guard, unsigned i, unsigned a, unsigned j, unsigned b )
+  {
+    for ( auto c = 0u; c < num_candidates( i ); ++c )
+    {
+      clause_t clause = guard;
+      clause.push_back( -geq( i, a, c ) );
+      clause.push_back( geq( j, b, c + 1u ) );
+      add_clause( solver )( clause );
+    }
+  }
+
+  /* guard -> fanin a of gate i <= fanin b of gate j */
+  void less_equal( const clause_t& guard, unsigned i, unsigned a, unsigned j, unsigned b )
+  {
+    for ( auto c = 1u; c < num_candidates( i ); ++c )
+    {
+      clause_t clause = guard;
+      clause.push_back( -geq( i, a, c ) );
+      clause.push_back( geq( j, b, c ) );
+      add_clause( solver )( clause );
+    }
+  }
+
+  /* guard -> fanin a of gate i == fanin b of gate j */
+  void equal( const clause_t& guard, unsigned i, unsigned a, unsigned j, unsigned b )
+  {
+    less_equal( guard, i, a, j, b );
+    less_equal( guard, j, b, i, a );
+  }
+
+  void add_symmetry_breaking()
+  {
+    const auto& sb = params.symmetry_breaking;
+
+    for ( auto i = 0u; i < num_gates; ++i )
+    {
+      const auto maj = with_xor ? clause_t{types[i]} : clause_t();
+      const auto xor_ = with_xor ? clause_t{-types[i]} : clause_t();
+
+      /* commutativity */
+      if ( sb[0u] )
+      {
+        less_than( {}, i, 0u, i, 1u );
+        less_than( maj, i, 1u, i, 2u );
+      }
+
+      /* inverters */
+      if ( sb[1u] )
+      {
+        for ( auto x = 0u; x < 3u; ++x )
+        {
+          for ( auto y = x + 1u; y < 3u; ++y )
+          {
+            clause_t clause = maj;
+            clause.push_back( -negs[i][x] );
+            clause.push_back( -negs[i][y] );
+            add_clause( solver )( clause );
+          }
+        }
+
+        if ( with_xor )
+        {
+          add_clause( solver )( {-types[i], -negs[i][0u]} );
+          add_clause( solver )( {-types[i], -negs[i][1u]} );
+        }
+      }
+
+      /* structural hashing: no two gates are equal */
+      if ( sb[2u] )
+      {
+        for ( auto l = 0u; l < i; ++l )
+        {
+          structural_hashing( i, l );
+        }
+      }
+
+      /* associativity */
+      if ( sb[3u] && !with_xor )
+      {
+        for ( auto l = 0u; l < i; ++l )
+        {
+          associativity( i, l );
+        }
+      }
+
+      /* co-lexicographic order */
+      if ( sb[4u] && !with_xor && i > 0u )
+      {
+        colexicographic( i );
+      }
+
+      /* support */
+      if ( sb[5u] )
+      {
+        for ( auto pos = 0u; pos < num_vars; ++pos )
+        {
+          if ( params.support[pos] ) { continue; }
+
+          for ( auto x = 0u; x < 3u; ++x )
+          {
+            add_clause( solver )( {-sel( i, x, pos + 1u )} );
+          }
+        }
+      }
+
+      /* symmetric variables: the first occurrence of p is before the first one of q */
+      if ( sb[6u] )
+      {
+        for ( const auto& p : params.symmetries )
+        {
+          for ( auto c = 0u; c < 3u; ++c )
+          {
+            if ( i == 0u && c == 0u ) { continue; }
+
+            clause_t base = {-sel( i, c, p.first + 1u )};
+            clause_t before;
+
+            for ( auto j = 0u; j <= i; ++j )
+            {
+              for ( auto d = 0u; d < ( j == i ? c : 3u ); ++d )
+              {
+                base.push_back( sel( j, d, p.first + 1u ) );
+                before.push_back( sel( j, d, p.second + 1u ) );
+              }
+            }
+
+            for ( auto l : before )
+            {
+              auto clause = base;
+              clause.push_back( -l );
+              add_clause( solver )( clause );
+            }
+          }
+        }
+      }
+    }
+  }
+
+  void structural_hashing( unsigned i, unsigned l )
+  {
+    /* d[x] -> fanin x of gates i and l differ */
+    int d[3];
+    for ( auto x = 0u; x < 3u; ++x )
+    {
+      d[x] = sid++;
+
+      for ( auto c = 0u; c < num_candidates( l ); ++c )
+      {
+        add_clause( solver )( {-d[x], -sel( i, x, c ), -sel( l, x, c ), negs[i][x], negs[l][x]} );
+        add_clause( solver )( {-d[x], -sel( i, x, c ), -sel( l, x, c ), -negs[i][x], -negs[l][x]} );
+      }
+    }
+
+    if ( with_xor )
+    {
+      add_clause( solver )( {types[i], types[l], d[0], d[1], d[2]} );
+      add_clause( solver )( {-types[i], -types[l], d[0], d[1]} );
+    }
+    else
+    {
+      add_clause( solver )( {d[0], d[1], d[2]} );
+    }
+  }
+
+  void associativity( unsigned i, unsigned l )
+  {
+    for ( auto alpha = 0u; alpha < 3u; ++alpha )
+    {
+      for ( auto gamma = 0u; gamma < 3u; ++gamma )
+      {
+        /* h <- fanin alpha of i equals fanin gamma of l (including polarity) */
+        const auto h = sid++;
+        for ( auto c = 0u; c < num_candidates( l ); ++c )
+        {
+          add_clause( solver )( {-sel( i, alpha, c ), -sel( l, gamma, c ), -negs[i][alpha], -negs[l][gamma], h} );
+          add_clause( solver )( {-sel( i, alpha, c ), -sel( l, gamma, c ), negs[i][alpha], negs[l][gamma], h} );
+        }
+
+        for ( auto beta = 0u; beta < 3u; ++beta )
+        {
+          if ( alpha == beta ) { continue; }
+
+          const auto p_child = 3u - alpha - beta;
+          const auto c_child = gamma == 2u ? 1u : 2u;
+          less_equal( {-sel( i, beta, num_vars + 1u + l ), -h}, l, c_child, i, p_child );
+        }
+      }
+    }
+  }
+
+  void colexicographic( unsigned i )
+  {
+    const auto prev = i - 1u;
+
+    const auto g1 = sid++;
+    const auto g2 = sid++;
+    const auto g3 = sid++;
+
+    add_clause( solver )( {sel( i, 2u, num_vars + 1u + prev ), g1, g2, g3} );
+
+    less_than( {-g1}, prev, 0u, i, 0u );
+
+    equal( {-g2}, prev, 0u, i, 0u );
+    less_than( {-g2}, prev, 1u, i, 1u );
+
+    equal( {-g3}, prev, 0u, i, 0u );
+    equal( {-g3}, prev, 1u, i, 1u );
+    less_equal( {-g3}, prev, 2u, i, 2u );
+  }
+
+public:
+  int sid = 1;
+
+private:
+  S&                                         solver;
+  unsigned                                   num_vars;
+  unsigned                                   num_gates;
+  bool                                       with_xor;
+  const exact_cnf_params&                    params;
+
+  int                                        const_true;
+  std::vector<std::array<std::vector<int>, 3>> sels;
+  std::vector<std::array<std::vector<int>, 3>> ladders;
+  std::vector<std::array<int, 3>>            negs;
+  std::vector<int>                           types;
+};
+
+struct mig_builder
+{
+  using function_t = mig_function;
+  static constexpr bool has_xor = false;
+
+  mig_builder( const std::string& model_name )
+  {
+    mig_initialize( mig, model_name );
+  }
+
+  function_t get_constant() { return mig_get_constant( mig, false ); }
+  function_t create_pi( const std::string& name ) { return mig_create_pi( mig, name ); }
+  function_t create_maj( const function_t& a, const function_t& b, const function_t& c ) { return mig_create_maj( mig, a, b, c ); }
+  void create_po( const function_t& f, const std::string& name ) { mig_create_po( mig, f, name ); }
+
+  mig_graph mig;
+};
+
+struct xmg_builder
+{
+  using function_t = xmg_function;
+  static constexpr bool has_xor = true;
+
+  xmg_builder( const std::string& model_name ) : xmg( model_name ) {}
+
+  function_t get_constant() { return xmg.get_constant( false ); }
+  function_t create_pi( const std::string& name ) { return xmg.create_pi( name ); }
+  function_t create_maj( const function_t& a, const function_t& b, const function_t& c ) { return xmg.create_maj( a, b, c ); }
+  function_t create_xor( const function_t& a, const function_t& b ) { return xmg.create_xor( a, b ); }
+  void create_po( const function_t& f, const std::string& name ) { xmg.create_po( f, name ); }
+
+  xmg_graph xmg;
+};
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+boost::dynamic_bitset<> symmetry_breaking_from_string( const std::string& breaking )
+{
+  boost::dynamic_bitset<> symmetry_breaking( 7u );
+
+  for ( auto c : breaking )
+  {
+    switch ( c )
+    {
+    case 'C': symmetry_breaking.set( 0u ); break;
+    case 'I': symmetry_breaking.set( 1u ); break;
+    case 's': symmetry_breaking.set( 2u ); break;
+    case 'a': symmetry_breaking.set( 3u ); break;
+    case 'l': symmetry_breaking.set( 4u ); break;
+    case 't': symmetry_breaking.set( 5u ); break;
+    case 'y': symmetry_breaking.set( 6u ); break;
+    };
+  }
+
+  return symmetry_breaking;
+}
+
+template<class Builder, class S>
+bool exact_cnf_search( Builder& builder, const tt& spec,
+                       const properties::ptr& settings, const properties::ptr& statistics )
+{
+  /* settings */
+  const auto start       = get( settings, "start",       1u );
+  const auto stop        = get( settings, "stop",        20u );
+  const auto output_name = get( settings, "output_name", std::string( "f" ) );
+  const auto breaking    = get( settings, "breaking",    std::string( "CIsalty" ) );
+  const auto verbose     = get( settings, "verbose",     false );
+
+  exact_cnf_params params;
+  params.binary            = get( settings, "binary",      false );
+  params.cardinality       = get( settings, "cardinality", 0u );
+  params.symmetry_breaking = symmetry_breaking_from_string( breaking );
+
+  /* trivial functions */
+  spec_representation rep( spec );
+  const auto triv = rep.is_trivial();
+  if ( (bool)triv )
+  {
+    std::vector<typename Builder::function_t> inputs;
+    for ( auto i = 0u; i < triv->first; ++i )
+    {
+      inputs.push_back( builder.create_pi( str( format( "x%d" ) % i ) ) );
+    }
+    const auto f = triv->first == 0u ? builder.get_constant() : inputs.back();
+    builder.create_po( triv->second ? !f : f, output_name );
+    return true;
+  }
+
+  params.support    = rep.support();
+  params.symmetries = rep.symmetric_variables();
+
+  /* normalize, such that f(0) = 0 */
+  const auto normal = rep.is_normal();
+  const auto nspec = normal ? spec : ~spec;
+  const auto num_vars = tt_num_vars( spec );
+
+  double sat_runtime = 0.0;
+  solver_execution_statistics sstats;
+
+  for ( auto k = start; k <= stop; ++k )
+  {
+    auto solver = make_solver<S>( settings );
+
+    exact_cnf_instance<S> inst( solver, num_vars, k, Builder::has_xor, params );
+    inst.constrain( nspec );
+
+    const auto result = solve( solver, sstats );
+    sat_runtime += sstats.runtime;
+
+    if ( verbose )
+    {
+      std::cout << format( "[i] %d gates: %s (vars = %d, clauses = %d, time = %.2f)" ) % k % ( result ? "sat" : "unsat" ) % sstats.num_vars % sstats.num_clauses % sstats.runtime << std::endl;
+    }
+
+    set( statistics, "last_size",   k );
+    set( statistics, "num_vars",    sstats.num_vars );
+    set( statistics, "num_clauses", sstats.num_clauses );
+    set( statistics, "sat_runtime", sat_runtime );
+
+    if ( result )
+    {
+      const auto f = inst.extract( builder, result );
+      builder.create_po( normal ? f : !f, output_name );
+      return true;
+    }
+  }
+
+  return false;
+}
+
+template<class Builder>
+bool exact_with_cnf( Builder& builder, const tt& spec,
+                     const properties::ptr& settings, const properties::ptr& statistics )
+{
+  const auto solver = get( settings, "solver", std::string( "minisat" ) );
+
+  if ( solver == "abcsat" )
+  {
+    return exact_cnf_search<Builder, abc_solver>( builder, spec, settings, statistics );
+  }
+  else
+  {
+    return exact_cnf_search<Builder, minisat_solver>( builder, spec, settings, statistics );
+  }
+}
+
+tt mig_spec_truth_table( const mig_graph& spec )
+{
+  const auto& info = mig_info( spec );
+  auto func = simulate_mig_function( spec, info.outputs.front().first, mig_tt_simulator() );
+  tt_shrink( func, info.inputs.size() );
+  return func;
+}
+
+} // anonymous namespace
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+boost::optional<mig_graph> exact_mig_with_cnf( const tt& spec,
+                                               const properties::ptr& settings,
+                                               const properties::ptr& statistics )
+{
+  /* timing */
+  properties_timer t( statistics );
+
+  assert( !spec.empty() );
+
+  mig_builder builder( get( settings, "model_name", std::string( "exact" ) ) );
+  if ( exact_with_cnf( builder, spec, settings, statistics ) )
+  {
+    return builder.mig;
+  }
+  return boost::none;
+}
+
+boost::optional<xmg_graph> exact_xmg_with_cnf( const tt& spec,
+                                               const properties::ptr& settings,
+                                               const properties::ptr& statistics )
+{
+  /* timing */
+  properties_timer t( statistics );
+
+  assert( !spec.empty() );
+
+  xmg_builder builder( get( settings, "model_name", std::string( "exact" ) ) );
+  if ( exact_with_cnf( builder, spec, settings, statistics ) )
+  {
+    return builder.xmg;
+  }
+  return boost::none;
+}
+
+boost::optional<mig_graph> exact_mig_with_cnf( const mig_graph& spec,
+                                               const properties::ptr& settings,
+                                               const properties::ptr& statistics )
+{
+  return exact_mig_with_cnf( mig_spec_truth_table( spec ), settings, statistics );
+}
+
+boost::optional<xmg_graph> exact_xmg_with_cnf( const mig_graph& spec,
+                                               const properties::ptr& settings,
+                                               const properties::ptr& statistics )
+{
+  return exact_xmg_with_cnf( mig_spec_truth_table( spec ), settings, statistics );
+}
+
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
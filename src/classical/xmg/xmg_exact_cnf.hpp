@@ -0,0 +1,108 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file xmg_exact_cnf.hpp
+ *
+ * @brief Exact MIG and XMG synthesis with a direct CNF encoding
+ *
+ * Pure SAT counterpart of the Z3-based exact synthesis in the formal
+ * addon.  Selection variables are encoded one-hot (with the cardinality
+ * encodings from sat/operations/cardinality.hpp) or binary, all
+ * comparisons for symmetry breaking use an order encoding on top of them.
+ *
+ * @since  2.3
+ */
+
+#ifndef XMG_EXACT_CNF_HPP
+#define XMG_EXACT_CNF_HPP
+
+#include <boost/optional.hpp>
+
+#include <core/properties.hpp>
+#include <classical/mig/mig.hpp>
+#include <classical/utils/truth_table_utils.hpp>
+#include <classical/xmg/xmg.hpp>
+
+namespace cirkit
+{
+
+/**
+ * @settings
+ *
+   |-------------+-----------------------------------------------------+-------------------------|
+   | Settings    | Description                                         | Default                 |
+   |-------------+-----------------------------------------------------+-------------------------|
+   | start       | Initial number of gates                             | 1u                      |
+   | stop        | Maximum number of gates                             | 20u                     |
+   | model_name  | Name of the model                                   | std::string( "exact" )  |
+   | output_name | Name of the output                                  | std::string( "f" )      |
+   | solver      | SAT solver (minisat or abcsat)                      | std::string( "minisat" )|
+   | binary      | Binary instead of one-hot selection variables       | false                   |
+   | cardinality | One-hot encoding: 0: pairwise, 1: Sinz, 2: Bailleux | 0u                      |
+   | breaking    | Symmetry breaking (same letters as exact_mig)       | std::string( "CIsalty" )|
+   | conf_budget | Conflict limit per SAT call (passed to the solver)  | solver default          |
+   | verbose     | Be verbose                                          | false                   |
+   |-------------+-----------------------------------------------------+-------------------------|
+ *
+ * @statistics
+ *
+   |-------------+------------------------------------------|
+   | Statistics  | Description                              |
+   |-------------+------------------------------------------|
+   | runtime     | Total runtime                            |
+   | sat_runtime | Runtime spent in the SAT solver          |
+   | last_size   | Last number of gates that has been tried |
+   | num_vars    | Variables in the last instance           |
+   | num_clauses | Clauses in the last instance             |
+   |-------------+------------------------------------------|
+ */
+boost::optional<mig_graph> exact_mig_with_cnf( const tt& spec,
+                                               const properties::ptr& settings = properties::ptr(),
+                                               const properties::ptr& statistics = properties::ptr() );
+
+boost::optional<xmg_graph> exact_xmg_with_cnf( const tt& spec,
+                                               const properties::ptr& settings = properties::ptr(),
+                                               const properties::ptr& statistics = properties::ptr() );
+
+/* the specification is the first output of the MIG */
+boost::optional<mig_graph> exact_mig_with_cnf( const mig_graph& spec,
+                                               const properties::ptr& settings = properties::ptr(),
+                                               const properties::ptr& statistics = properties::ptr() );
+
+boost::optional<xmg_graph> exact_xmg_with_cnf( const mig_graph& spec,
+                                               const properties::ptr& settings = properties::ptr(),
+                                               const properties::ptr& statistics = properties::ptr() );
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -26,40 +26,72 @@
 
 #include "xmg_extract.hpp"
 
+#include <cassert>
 #include <map>
 
 #include <boost/format.hpp>
 
-#include <core/properties.hpp>
 #include <classical/xmg/xmg_cover.hpp>
-#include <classical/xmg/xmg_rewrite.hpp>
 
 namespace cirkit
 {
 
-xmg_graph xmg_extract( const xmg_graph& xmg, xmg_node root, const std::vector<xmg_node>& leaves )
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+/* copies the cone of node into xcut, stops at nodes in old_to_new */
+xmg_function xmg_extract_rec( const xmg_graph& xmg, xmg_node node, xmg_graph& xcut, std::map<xmg_node, xmg_function>& old_to_new )
 {
-  auto xmg_copy = xmg;
+  const auto it = old_to_new.find( node );
+  if ( it != old_to_new.end() )
+  {
+    return it->second;
+  }
+
+  const auto c = xmg.children( node );
+  xmg_function f;
+  if ( xmg.is_maj( node ) )
+  {
+    f = xcut.create_maj( xmg_extract_rec( xmg, c[0].node, xcut, old_to_new ) ^ c[0].complemented,
+                         xmg_extract_rec( xmg, c[1].node, xcut, old_to_new ) ^ c[1].complemented,
+                         xmg_extract_rec( xmg, c[2].node, xcut, old_to_new ) ^ c[2].complemented );
+  }
+  else if ( xmg.is_xor( node ) )
+  {
+    f = xcut.create_xor( xmg_extract_rec( xmg, c[0].node, xcut, old_to_new ) ^ c[0].complemented,
+                         xmg_extract_rec( xmg, c[1].node, xcut, old_to_new ) ^ c[1].complemented );
+  }
+  else
+  {
+    /* a primary input that is not a leaf */
+    assert( false );
+  }
+
+  old_to_new.insert( {node, f} );
+  return f;
+}
 
-  /* remove all outputs from xmg_copy and add one to the root node of the cut */
-  xmg_copy.outputs().clear();
-  xmg_copy.create_po( xmg_function( root, false ), "outroot" );
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
 
+/* only reads xmg, it is therefore safe to extract from several threads */
+xmg_graph xmg_extract( const xmg_graph& xmg, xmg_node root, const std::vector<xmg_node>& leaves )
+{
   xmg_graph xcut;
 
-  prefill_func_t prefill = [leaves]( xmg_graph& xcut, std::map<xmg_node, xmg_function>& old_to_new ) {
-    auto i = 0u;
-    for ( auto leaf : leaves ) {
-      old_to_new[leaf] = xcut.create_pi( boost::str( boost::format( "x%d" ) % i ) );
-      ++i;
-    }
-  };
+  std::map<xmg_node, xmg_function> old_to_new;
+  old_to_new[0u] = xcut.get_constant( false );
 
-  auto settings = std::make_shared<properties>();
-  settings->set( "prefill", prefill );
+  auto i = 0u;
+  for ( auto leaf : leaves )
+  {
+    old_to_new[leaf] = xcut.create_pi( boost::str( boost::format( "x%d" ) % i ) );
+    ++i;
+  }
 
-  const auto o = xmg_rewrite_top_down_inplace( xcut, xmg_copy, rewrite_default_maj, rewrite_default_xor, {}, settings ).front();
-  xcut.create_po( o, "o" );
+  xcut.create_po( xmg_extract_rec( xmg, root, xcut, old_to_new ), "o" );
 
   return xcut;
 }
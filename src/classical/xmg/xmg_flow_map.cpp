@@ -26,6 +26,9 @@
 
 #include "xmg_flow_map.hpp"
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
 #include <vector>
 
 #include <boost/dynamic_bitset.hpp>
@@ -75,6 +78,64 @@ private:
   bool     verbose;
 };
 
+/* priority cut mapping: only the best `priority_cuts' cuts are kept for
+   each node during a topological sweep; a depth-oriented sweep is followed
+   by area flow and exact local area sweeps that keep the depth */
+struct xmg_priority_cut
+{
+  std::vector<unsigned> leaves; /* sorted */
+  std::uint64_t         sign;
+  unsigned              delay;
+  float                 flow;
+};
+
+class xmg_priority_map_manager
+{
+public:
+  xmg_priority_map_manager( xmg_graph& xmg, const properties::ptr& settings );
+
+  void run();
+
+private:
+  enum class mode_t { depth, area_flow, exact_area };
+
+  void sweep( mode_t mode );
+  void merge_cuts( xmg_node node, mode_t mode );
+  bool better( const xmg_priority_cut& a, const xmg_priority_cut& b, xmg_node node, mode_t mode ) const;
+  void finalize_cut( xmg_priority_cut& cut ) const;
+
+  unsigned cut_ref( const std::vector<unsigned>& leaves );
+  unsigned cut_deref( const std::vector<unsigned>& leaves );
+  unsigned exact_area( const std::vector<unsigned>& leaves );
+
+  void compute_refs();
+  unsigned lut_count() const;
+  void compute_required();
+  void extract_cover();
+
+  inline float node_flow( xmg_node n ) const
+  {
+    return xmg.is_input( n ) ? 0.0f : cuts[n].front().flow / std::max( 1u, refs[n] ? refs[n] : xmg.fanout_count( n ) );
+  }
+
+private:
+  xmg_graph&                                 xmg;
+  std::vector<xmg_node>                      top;
+  std::vector<std::vector<xmg_priority_cut>> cuts; /* best first */
+  std::vector<xmg_priority_cut>              candidates;
+  std::vector<unsigned>                      arrival;
+  std::vector<unsigned>                      required;
+  std::vector<unsigned>                      refs;
+  unsigned                                   target_depth = 0u;
+
+  /* settings */
+  unsigned cut_size;
+  unsigned priority;
+  unsigned area_flow_rounds;
+  unsigned exact_area_rounds;
+  bool     verbose;
+};
+
 xmg_flow_map_manager::xmg_flow_map_manager( xmg_graph& xmg, const properties::ptr& settings )
   : xmg( xmg ),
     node_to_cut( xmg.size() ),
@@ -171,6 +232,314 @@ void xmg_flow_map_manager::extract_cover()
   xmg.set_cover( cover );
 }
 
+xmg_priority_map_manager::xmg_priority_map_manager( xmg_graph& xmg, const properties::ptr& settings )
+  : xmg( xmg ),
+    top( xmg.topological_nodes() ),
+    cuts( xmg.size() ),
+    arrival( xmg.size(), 0u ),
+    required( xmg.size(), std::numeric_limits<unsigned>::max() ),
+    refs( xmg.size(), 0u )
+{
+  cut_size          = get( settings, "cut_size",          4u );
+  priority          = get( settings, "priority_cuts",     8u );
+  area_flow_rounds  = get( settings, "area_flow_rounds",  1u );
+  exact_area_rounds = get( settings, "exact_area_rounds", 1u );
+  verbose           = get( settings, "verbose",           false );
+
+  assert( cut_size >= 3u && priority > 0u );
+
+  xmg.compute_fanout();
+}
+
+void xmg_priority_map_manager::run()
+{
+  sweep( mode_t::depth );
+
+  target_depth = 0u;
+  for ( const auto& output : xmg.outputs() )
+  {
+    target_depth = std::max( target_depth, arrival[output.first.node] );
+  }
+  compute_refs();
+  LN( boost::format( "[i] depth sweep: depth %d, %d LUTs" ) % target_depth % lut_count() );
+
+  for ( auto i = 0u; i < area_flow_rounds; ++i )
+  {
+    compute_required();
+    sweep( mode_t::area_flow );
+    compute_refs();
+    LN( boost::format( "[i] area flow sweep: %d LUTs" ) % lut_count() );
+  }
+
+  for ( auto i = 0u; i < exact_area_rounds; ++i )
+  {
+    compute_required();
+    sweep( mode_t::exact_area );
+    compute_refs();
+    LN( boost::format( "[i] exact area sweep: %d LUTs" ) % lut_count() );
+  }
+
+  extract_cover();
+}
+
+void xmg_priority_map_manager::sweep( mode_t mode )
+{
+  for ( auto node : top )
+  {
+    if ( xmg.is_input( node ) ) { continue; }
+
+    /* a mapped node releases its current cut before the cuts are compared
+       in exact area mode */
+    const auto mapped = mode == mode_t::exact_area && refs[node] > 0u;
+    if ( mapped )
+    {
+      cut_deref( cuts[node].front().leaves );
+    }
+
+    merge_cuts( node, mode );
+    arrival[node] = cuts[node].front().delay;
+
+    if ( mapped )
+    {
+      cut_ref( cuts[node].front().leaves );
+    }
+  }
+}
+
+void xmg_priority_map_manager::merge_cuts( xmg_node node, mode_t mode )
+{
+  candidates.clear();
+
+  /* cut sets of the children, each with its trivial cut, the constant
+     contributes the empty cut */
+  const auto children = xmg.children( node );
+  const auto num_children = children.size();
+
+  std::vector<xmg_priority_cut> trivial( num_children );
+  std::vector<unsigned> num_cuts( num_children ), pos( num_children, 0u );
+
+  for ( auto i = 0u; i < num_children; ++i )
+  {
+    const auto c = children[i].node;
+    if ( c != 0u )
+    {
+      trivial[i] = {{static_cast<unsigned>( c )}, std::uint64_t( 1 ) << ( c % 64u ), 0u, 0.0f};
+    }
+    num_cuts[i] = ( xmg.is_input( c ) ? 0u : cuts[c].size() ) + 1u;
+  }
+
+  const auto get_cut = [&]( unsigned i ) -> const xmg_priority_cut& {
+    return pos[i] + 1u == num_cuts[i] ? trivial[i] : cuts[children[i].node][pos[i]];
+  };
+
+  std::vector<unsigned> buffer;
+  while ( true )
+  {
+    std::uint64_t sign = 0u;
+    for ( auto i = 0u; i < num_children; ++i )
+    {
+      sign |= get_cut( i ).sign;
+    }
+
+    if ( static_cast<unsigned>( __builtin_popcountll( sign ) ) <= cut_size )
+    {
+      xmg_priority_cut cut{{}, sign, 0u, 0.0f};
+      for ( auto i = 0u; i < num_children && cut.leaves.size() <= cut_size; ++i )
+      {
+        const auto& leaves = get_cut( i ).leaves;
+        buffer.clear();
+        std::set_union( cut.leaves.begin(), cut.leaves.end(), leaves.begin(), leaves.end(), std::back_inserter( buffer ) );
+        cut.leaves.swap( buffer );
+      }
+
+      if ( cut.leaves.size() <= cut_size )
+      {
+        finalize_cut( cut );
+        candidates.push_back( std::move( cut ) );
+      }
+    }
+
+    /* next combination */
+    auto i = 0u;
+    for ( ; i < num_children; ++i )
+    {
+      if ( ++pos[i] < num_cuts[i] ) { break; }
+      pos[i] = 0u;
+    }
+    if ( i == num_children ) { break; }
+  }
+
+  /* the current best cut is kept as candidate, it meets the required time */
+  if ( mode != mode_t::depth && !cuts[node].empty() )
+  {
+    auto cut = cuts[node].front();
+    finalize_cut( cut );
+    candidates.push_back( std::move( cut ) );
+  }
+
+  std::sort( candidates.begin(), candidates.end(), [this, node, mode]( const xmg_priority_cut& a, const xmg_priority_cut& b ) { return better( a, b, node, mode ); } );
+
+  /* keep the best cuts that are not dominated by a better one */
+  auto& node_cuts = cuts[node];
+  node_cuts.clear();
+
+  for ( auto& cut : candidates )
+  {
+    const auto dominated = std::any_of( node_cuts.begin(), node_cuts.end(), [&cut]( const xmg_priority_cut& other ) {
+        return ( other.sign & ~cut.sign ) == 0u && std::includes( cut.leaves.begin(), cut.leaves.end(), other.leaves.begin(), other.leaves.end() );
+      } );
+    if ( dominated ) { continue; }
+
+    node_cuts.push_back( std::move( cut ) );
+    if ( node_cuts.size() == priority ) { break; }
+  }
+
+  assert( !node_cuts.empty() );
+
+  /* exact local area of the cuts that meet the required time */
+  if ( mode == mode_t::exact_area && refs[node] > 0u )
+  {
+    auto best = 0u;
+    auto best_area = std::numeric_limits<unsigned>::max();
+
+    for ( auto i = 0u; i < node_cuts.size(); ++i )
+    {
+      if ( node_cuts[i].delay > required[node] ) { continue; }
+
+      const auto area = exact_area( node_cuts[i].leaves );
+      if ( area < best_area )
+      {
+        best = i;
+        best_area = area;
+      }
+    }
+
+    std::swap( node_cuts[0u], node_cuts[best] );
+  }
+}
+
+bool xmg_priority_map_manager::better( const xmg_priority_cut& a, const xmg_priority_cut& b, xmg_node node, mode_t mode ) const
+{
+  if ( mode == mode_t::depth )
+  {
+    if ( a.delay != b.delay ) { return a.delay < b.delay; }
+    if ( a.leaves.size() != b.leaves.size() ) { return a.leaves.size() < b.leaves.size(); }
+    return a.flow < b.flow;
+  }
+
+  const auto fa = a.delay <= required[node];
+  const auto fb = b.delay <= required[node];
+  if ( fa != fb ) { return fa; }
+  if ( a.flow != b.flow ) { return a.flow < b.flow; }
+  if ( a.delay != b.delay ) { return a.delay < b.delay; }
+  return a.leaves.size() < b.leaves.size();
+}
+
+void xmg_priority_map_manager::finalize_cut( xmg_priority_cut& cut ) const
+{
+  cut.delay = 0u;
+  cut.flow  = 1.0f;
+
+  for ( auto leaf : cut.leaves )
+  {
+    cut.delay = std::max( cut.delay, arrival[leaf] );
+    cut.flow += node_flow( leaf );
+  }
+
+  ++cut.delay;
+}
+
+unsigned xmg_priority_map_manager::cut_ref( const std::vector<unsigned>& leaves )
+{
+  auto area = 1u;
+
+  for ( auto leaf : leaves )
+  {
+    if ( !xmg.is_input( leaf ) && refs[leaf]++ == 0u )
+    {
+      area += cut_ref( cuts[leaf].front().leaves );
+    }
+  }
+
+  return area;
+}
+
+unsigned xmg_priority_map_manager::cut_deref( const std::vector<unsigned>& leaves )
+{
+  auto area = 1u;
+
+  for ( auto leaf : leaves )
+  {
+    if ( !xmg.is_input( leaf ) && --refs[leaf] == 0u )
+    {
+      area += cut_deref( cuts[leaf].front().leaves );
+    }
+  }
+
+  return area;
+}
+
+unsigned xmg_priority_map_manager::exact_area( const std::vector<unsigned>& leaves )
+{
+  const auto area = cut_ref( leaves );
+  cut_deref( leaves );
+  return area;
+}
+
+void xmg_priority_map_manager::compute_refs()
+{
+  std::fill( refs.begin(), refs.end(), 0u );
+
+  for ( const auto& output : xmg.outputs() )
+  {
+    const auto node = output.first.node;
+    if ( !xmg.is_input( node ) && refs[node]++ == 0u )
+    {
+      cut_ref( cuts[node].front().leaves );
+    }
+  }
+}
+
+unsigned xmg_priority_map_manager::lut_count() const
+{
+  return std::count_if( top.begin(), top.end(), [this]( xmg_node n ) { return !xmg.is_input( n ) && refs[n] > 0u; } );
+}
+
+void xmg_priority_map_manager::compute_required()
+{
+  std::fill( required.begin(), required.end(), std::numeric_limits<unsigned>::max() );
+
+  for ( const auto& output : xmg.outputs() )
+  {
+    required[output.first.node] = target_depth;
+  }
+
+  for ( auto it = top.rbegin(); it != top.rend(); ++it )
+  {
+    if ( xmg.is_input( *it ) || refs[*it] == 0u ) { continue; }
+
+    for ( auto leaf : cuts[*it].front().leaves )
+    {
+      required[leaf] = std::min( required[leaf], required[*it] - 1u );
+    }
+  }
+}
+
+void xmg_priority_map_manager::extract_cover()
+{
+  xmg_cover cover( cut_size, xmg );
+
+  for ( auto node : top )
+  {
+    if ( !xmg.is_input( node ) && refs[node] > 0u )
+    {
+      cover.add_cut( node, cuts[node].front().leaves );
+    }
+  }
+
+  xmg.set_cover( cover );
+}
+
 /******************************************************************************
  * Private functions                                                          *
  ******************************************************************************/
@@ -181,10 +550,20 @@ void xmg_flow_map_manager::extract_cover()
 
 void xmg_flow_map( xmg_graph& xmg, const properties::ptr& settings, const properties::ptr& statistics )
 {
-  xmg_flow_map_manager mgr( xmg, settings );
+  if ( get( settings, "priority_cuts", 8u ) > 0u )
+  {
+    xmg_priority_map_manager mgr( xmg, settings );
 
-  properties_timer t( statistics );
-  mgr.run();
+    properties_timer t( statistics );
+    mgr.run();
+  }
+  else
+  {
+    xmg_flow_map_manager mgr( xmg, settings );
+
+    properties_timer t( statistics );
+    mgr.run();
+  }
 }
 
 
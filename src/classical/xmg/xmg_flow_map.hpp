@@ -42,6 +42,28 @@
 namespace cirkit
 {
 
+/**
+ * @brief LUT mapping into the cover of the XMG
+ *
+ * By default, priority cuts are used: only the best `priority_cuts' cuts
+ * are stored for each node, which keeps the memory linear in the size of
+ * the XMG.  A depth-oriented sweep is followed by area recovery sweeps
+ * that do not increase the depth.  If `priority_cuts' is 0, all cuts are
+ * enumerated and the cover is computed with FlowMap.
+ *
+ * @settings
+ *
+   |-------------------+-------------------------------------------------+---------|
+   | Settings          | Description                                     | Default |
+   |-------------------+-------------------------------------------------+---------|
+   | cut_size          | Maximum number of LUT inputs                    | 4u      |
+   | priority_cuts     | Number of cuts per node (0: all cuts, FlowMap)  | 8u      |
+   | area_flow_rounds  | Number of area flow recovery sweeps             | 1u      |
+   | exact_area_rounds | Number of exact local area recovery sweeps      | 1u      |
+   | progress          | Show progress (FlowMap only)                    | false   |
+   | verbose           | Be verbose                                      | false   |
+   |-------------------+-------------------------------------------------+---------|
+ */
 void xmg_flow_map( xmg_graph& xmg, const properties::ptr& settings = properties::ptr(), const properties::ptr& statistics = properties::ptr() );
 
 }
@@ -89,7 +89,7 @@ tt xmg_tt_simulator::xor_op( const xmg_node& node, const tt& v1, const tt& v2 )
   tt _v1 = v1;
   tt _v2 = v2;
   tt_align( _v1, _v2 );
-  return v1 ^ v2;
+  return _v1 ^ _v2;
 }
 
 tt xmg_tt_simulator::maj_op( const xmg_node& node, const tt& v1, const tt& v2, const tt& v3 ) const
@@ -0,0 +1,147 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "cec.hpp"
+
+#include <iostream>
+#include <utility>
+
+#include <boost/format.hpp>
+
+#include <core/utils/program_options.hpp>
+#include <cli/stores.hpp>
+#include <classical/verification/sat_sweeping_cec.hpp>
+
+namespace cirkit
+{
+
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+inline std::pair<std::size_t, std::size_t> num_inputs_outputs( const aig_graph& aig )
+{
+  const auto& info = aig_info( aig );
+  return {info.inputs.size(), info.outputs.size()};
+}
+
+inline std::pair<std::size_t, std::size_t> num_inputs_outputs( const xmg_graph& xmg )
+{
+  return {xmg.inputs().size(), xmg.outputs().size()};
+}
+
+template<class Store>
+bool same_interface( const Store& store, unsigned id1, unsigned id2 )
+{
+  /* invalid ids are reported by the other rules */
+  return id1 >= store.size() || id2 >= store.size() || num_inputs_outputs( store[id1] ) == num_inputs_outputs( store[id2] );
+}
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+cec_command::cec_command( const environment::ptr& env )
+  : cirkit_command( env, "Combinational equivalence checking with SAT sweeping" )
+{
+  opts.add_options()
+    ( "id1",       value_with_default( &id1 ),       "id of the first circuit" )
+    ( "id2",       value_with_default( &id2 ),       "id of the second circuit" )
+    ( "num_words", value_with_default( &num_words ), "number of random simulation words" )
+    ( "xmg,x",                                       "compare XMGs instead of AIGs" )
+    ;
+  be_verbose();
+}
+
+command::rules_t cec_command::validity_rules() const
+{
+  return {
+    {[this]() { return id1 < ( is_set( "xmg" ) ? env->store<xmg_graph>().size() : env->store<aig_graph>().size() ); }, "id1 points to no valid store entry"},
+    {[this]() { return id2 < ( is_set( "xmg" ) ? env->store<xmg_graph>().size() : env->store<aig_graph>().size() ); }, "id2 points to no valid store entry"},
+    {[this]() { return is_set( "xmg" ) ? same_interface( env->store<xmg_graph>(), id1, id2 ) : same_interface( env->store<aig_graph>(), id1, id2 ); }, "circuits must have the same number of inputs and outputs"}
+  };
+}
+
+bool cec_command::execute()
+{
+  auto settings = make_settings();
+  settings->set( "num_words", num_words );
+
+  boost::optional<counterexample_t> cex;
+  if ( is_set( "xmg" ) )
+  {
+    const auto& xmgs = env->store<xmg_graph>();
+    cex = sat_sweeping_cec( xmgs[id1], xmgs[id2], settings, statistics );
+  }
+  else
+  {
+    const auto& aigs = env->store<aig_graph>();
+    cex = sat_sweeping_cec( aigs[id1], aigs[id2], settings, statistics );
+  }
+
+  equivalent = !cex;
+
+  if ( equivalent )
+  {
+    std::cout << "[i] circuits are equivalent" << std::endl;
+  }
+  else
+  {
+    std::cout << "[i] circuits are not equivalent" << std::endl
+              << "[i] counterexample: " << *cex << std::endl;
+  }
+
+  if ( is_verbose() )
+  {
+    std::cout << boost::format( "[i] SAT calls: %d, merged nodes: %d, refinements: %d" ) % statistics->get<unsigned>( "sat_calls" ) % statistics->get<unsigned>( "merged" ) % statistics->get<unsigned>( "refinements" ) << std::endl;
+  }
+
+  print_runtime();
+
+  return true;
+}
+
+command::log_opt_t cec_command::log() const
+{
+  return log_opt_t({
+      {"id1", id1},
+      {"id2", id2},
+      {"equivalent", equivalent},
+      {"runtime", statistics->get<double>( "runtime" )}
+    });
+}
+
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
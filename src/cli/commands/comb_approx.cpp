@@ -73,6 +73,8 @@ comb_approx_command::comb_approx_command( const environment::ptr& env )
     ( "print,p",                                               "Print implicants of both functions" )
     ( "truthtable,t",                                          "Print truth table of both functions" )
     ( "new,n",                                                 "Create new store element for result" )
+    ( "sweep,s",                                               "Evaluate all modes and levels and print their error metrics" )
+    ( "threads,j",      value_with_default( &num_threads ),    "Number of threads for sweep" )
     ;
   be_verbose();
 }
@@ -135,6 +137,34 @@ bool comb_approx_command::execute()
   auto settings = std::make_shared<properties>();
   auto statistics = std::make_shared<properties>();
 
+  /* sweep? */
+  if ( is_set( "sweep" ) )
+  {
+    std::vector<std::vector<bdd>> fshats;
+    for ( auto m = 0u; m < 5u; ++m )
+    {
+      for ( auto l = 0u; l < manager->num_vars(); ++l )
+      {
+        fshats.push_back( bdd_level_approximation( fs, (bdd_level_approximation_mode)m, l ) );
+      }
+    }
+
+    auto sweep_settings = std::make_shared<properties>();
+    sweep_settings->set( "num_threads", num_threads );
+    sweep_settings->set( "maximum_method", static_cast<worst_case_maximum_method>( maximum_method ) );
+    const auto metrics = error_metrics( fs, fshats, sweep_settings, statistics );
+
+    std::cout << "[i] mode level      size        error rate        worst case    average case" << std::endl;
+    for ( const auto& m : index( metrics ) )
+    {
+      std::cout << format( "[i] %4d %5d %9d %17s %17s %15.2f" ) % ( m.index / manager->num_vars() ) % ( m.index % manager->num_vars() )
+                   % m.value.size % m.value.error_rate % m.value.worst_case % m.value.average_case << std::endl;
+    }
+    std::cout << format( "[i] run-time:        %.2f secs" ) % statistics->get<double>( "runtime" ) << std::endl;
+
+    return true;
+  }
+
   auto fshat = ( mode == 5u ) ? fs : bdd_level_approximation( fs, (bdd_level_approximation_mode)mode, level, settings, statistics );
 
   /* print? */
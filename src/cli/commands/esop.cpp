@@ -42,10 +42,11 @@ esop_command::esop_command( const environment::ptr& env )
   : aig_base_command( env, "Generate ESOPs from AIGs" )
 {
   opts.add_options()
-    ( "filename",   value( &filename ),              "ESOP filename" )
-    ( "collapse,c", value_with_default( &collapse ), "collapsing method:\naig (0): ABC's AIG collapsing\nbdd (1): PSDKRO collapsing\naignew (2): CirKit's AIG collapsing" )
-    ( "minimize,m", value_with_default( &minimize ), "minimization method:\n0: none\n1: exorcism" )
-    ( "progress,p",                                  "show progress" )
+    ( "filename",   value( &filename ),                 "ESOP filename" )
+    ( "collapse,c", value_with_default( &collapse ),    "collapsing method:\naig (0): ABC's AIG collapsing\nbdd (1): PSDKRO collapsing\naignew (2): CirKit's AIG collapsing" )
+    ( "minimize,m", value_with_default( &minimize ),    "minimization method:\n0: none\n1: exorcism" )
+    ( "threads,j",  value_with_default( &num_threads ), "number of threads for PSDKRO collapsing" )
+    ( "progress,p",                                     "show progress" )
     ;
   add_new_option();
   add_positional_option( "filename" );
@@ -56,8 +57,7 @@ command::rules_t esop_command::validity_rules() const
   return {
     has_store_element<aig_graph>( env ),
     {[this]() { return is_set( "filename" ); }, "filename must be set"},
-    {[this]() { return minimize <= 2u; }, "invalid value for minimize"},
-    {[this]() { return ( collapse != gia_graph::esop_cover_method::bdd ) || ( info().outputs.size() == 1u ); }, "selected collapsing method can only be applied to single-output functions"}
+    {[this]() { return minimize <= 2u; }, "invalid value for minimize"}
   };
 }
 
@@ -65,6 +65,7 @@ bool esop_command::execute()
 {
   const auto settings = make_settings();
   settings->set( "progress", is_set( "progress" ) );
+  settings->set( "num_threads", num_threads );
 
   gia_graph gia( aig() );
 
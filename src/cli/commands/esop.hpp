@@ -58,6 +58,7 @@ private:
   std::string filename;
   gia_graph::esop_cover_method collapse = gia_graph::esop_cover_method::aig_new;
   unsigned minimize = 1u;
+  unsigned num_threads = 4u;
 
   double collapse_runtime = 0.0;
 };
@@ -54,7 +54,8 @@ migfh_command::migfh_command( const environment::ptr& env ) : mig_base_command(
     ( "mode",            value_with_default( &mode ),            "0: top-down\n1: bottom-up" )
     ( "ffrs,f",                                                  "only optimize inside FFRs" )
     ( "depth_heuristic",                                         "preserve depth locally" )
-    ( "hash",            value_with_default( &hash ),            "hash table size for NPN caching" )
+    ( "threads,j",       value_with_default( &num_threads ),     "number of threads to optimize FFRs (only with --ffrs)" )
+    ( "hash",            value_with_default( &hash ),            "deprecated, ignored (NPN classes are looked up in a precomputed table)" )
     ( "progress,p",                                              "show progress" )
     ( "max_candidates",  value_with_default( &max_candidates ),  "max candidates (only bottom-up)" )
     ( "allow_area_inc",                                          "allow area increase for candidates (only bottom-up)" )
@@ -66,11 +67,16 @@ migfh_command::migfh_command( const environment::ptr& env ) : mig_base_command(
 
 bool migfh_command::execute()
 {
+  if ( is_set( "hash" ) )
+  {
+    std::cout << "[w] option --hash is deprecated and has no effect" << std::endl;
+  }
+
   const auto settings = make_settings();
   settings->set( "top_down",            mode == 0u );
   settings->set( "use_ffrs",            is_set( "ffrs" ) );
   settings->set( "depth_heuristic",     is_set( "depth_heuristic" ) );
-  settings->set( "npn_hash_table_size", hash );
+  settings->set( "num_threads",         num_threads );
   settings->set( "progress",            is_set( "progress" ) );
   settings->set( "max_candidates",      max_candidates );
   settings->set( "allow_area_inc",      is_set( "allow_area_inc" ) );
@@ -78,18 +84,11 @@ bool migfh_command::execute()
   settings->set( "sort_area_first",     sort_area_first );
   mig() = mig_functional_hashing( mig(), settings, statistics );
 
-  auto cache_hit  = statistics->get<unsigned long>( "cache_hit" );
-  auto cache_miss = statistics->get<unsigned long>( "cache_miss" );
-
-  auto hit_rate  = (double)cache_hit / ( cache_hit + cache_miss );
-  auto miss_rate = 1.0 - hit_rate;
-
   std::cout << boost::format( "[i] run-time:        %.2f secs" ) % statistics->get<double>( "runtime" ) << std::endl
             << boost::format( "[i] run-time (cuts): %.2f secs" ) % statistics->get<double>( "runtime_cut" ) << std::endl
             << boost::format( "[i] run-time (NPN):  %.2f secs" ) % statistics->get<double>( "runtime_npn" ) << std::endl
             << boost::format( "[i] run-time (ffrs): %.2f secs" ) % statistics->get<double>( "runtime_ffr" ) << std::endl
-            << boost::format( "[i] cache hit:       %u (%.2f %%)" ) % cache_hit % ( hit_rate * 100.0) << std::endl
-            << boost::format( "[i] cache miss:      %u (%.2f %%)" ) % cache_miss % ( miss_rate * 100.0 ) << std::endl;
+            << boost::format( "[i] NPN lookups:     %u" ) % statistics->get<unsigned long>( "cache_hit" ) << std::endl;
 
   return true;
 }
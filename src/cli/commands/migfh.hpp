@@ -54,7 +54,8 @@ public:
 
 private:
   unsigned mode            = 0u;
-  unsigned hash            = 1u << 13u;
+  unsigned num_threads     = 4u;
+  unsigned hash            = 1u << 13u; /* deprecated, ignored */
   unsigned max_candidates  = 10u;
   bool     sort_area_first = true;
 };
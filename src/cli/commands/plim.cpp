@@ -31,6 +31,7 @@
 #include <core/utils/program_options.hpp>
 #include <core/utils/range_utils.hpp>
 #include <classical/plim/plim_compiler.hpp>
+#include <classical/plim/plim_simulate.hpp>
 
 namespace cirkit
 {
@@ -55,6 +56,8 @@ plim_command::plim_command( const environment::ptr& env )
     ( "generator_strategy,s", value_with_default( &generator_strategy ), "memristor generator request strategy:\n0: LIFO\n1: FIFO" )
     ( "naive",                                                           "turn off all optimization" )
     ( "progress",                                                        "show progress" )
+    ( "verify",                                                          "verify the program against the MIG by simulation" )
+    ( "words",                value_with_default( &num_words ),          "number of 64-bit simulation words per input for --verify" )
     ;
   be_verbose();
 }
@@ -82,6 +85,22 @@ bool plim_command::execute()
             << "[i] RRAM count:   " << program.rram_count() << std::endl
             << "[i] write counts: " << any_join( program.write_counts(), " " ) << std::endl;
 
+  if ( is_set( "verify" ) )
+  {
+    const auto vsettings = make_settings();
+    vsettings->set( "num_words", num_words );
+    const auto vstatistics = std::make_shared<properties>();
+
+    if ( verify_plim_program( program, mig(), vsettings, vstatistics ) )
+    {
+      std::cout << boost::format( "[i] program verified on %d patterns" ) % ( 64u * num_words ) << std::endl;
+    }
+    else
+    {
+      std::cout << "[e] program does not match MIG at outputs " << any_join( vstatistics->get<std::vector<std::string>>( "mismatches" ), " " ) << std::endl;
+    }
+  }
+
   return true;
 }
 
@@ -55,6 +55,7 @@ public:
 
 private:
   unsigned generator_strategy = 0u;
+  unsigned num_words          = 16u;
 };
 
 }
@@ -56,6 +56,7 @@ private:
   unsigned miter = 0u;
   unsigned encoding = 0u;
   unsigned heuristic = 0u;
+  unsigned num_threads = 1u;
 };
 
 }
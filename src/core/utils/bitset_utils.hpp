@@ -38,6 +38,8 @@
 #define BITSET_UTILS_HPP
 
 #include <algorithm>
+#include <bitset>
+#include <cstdint>
 #include <iostream>
 #include <random>
 #include <sstream>
@@ -92,6 +94,12 @@ std::ostream& print_as_set( std::ostream& os, const boost::dynamic_bitset<>& b )
 
 boost::dynamic_bitset<> onehot_bitset( unsigned n, unsigned pos );
 
+/* number of set bits in a word */
+inline unsigned popcount( uint64_t word )
+{
+  return std::bitset<64>( word ).count();
+}
+
 template<typename Fn>
 void foreach_bit( const boost::dynamic_bitset<>& b, const Fn&& func )
 {
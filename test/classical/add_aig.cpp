@@ -0,0 +1,139 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE add_aig
+
+#include <random>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <core/properties.hpp>
+#include <classical/aig.hpp>
+#include <classical/sat/minisat.hpp>
+#include <classical/sat/sat_solver.hpp>
+#include <classical/sat/operations/logic.hpp>
+#include <classical/sat/utils/add_aig.hpp>
+
+using namespace cirkit;
+
+/* random AIG of AND, XOR, ITE, and MAJ gates, such that the structural
+ * encoding finds gates with single and with multiple fanout */
+aig_graph random_aig( unsigned num_inputs, unsigned num_gates, unsigned num_outputs, unsigned seed )
+{
+  std::default_random_engine gen( seed );
+  std::uniform_int_distribution<unsigned> dist( 0u, 3u );
+
+  aig_graph aig;
+  aig_initialize( aig );
+
+  std::vector<aig_function> fs;
+  for ( auto i = 0u; i < num_inputs; ++i )
+  {
+    fs.push_back( aig_create_pi( aig, "x" + std::to_string( i ) ) );
+  }
+
+  const auto pick = [&]() {
+    return fs[std::uniform_int_distribution<unsigned>( 0u, fs.size() - 1u )( gen )] ^ ( dist( gen ) == 0u );
+  };
+
+  for ( auto i = 0u; i < num_gates; ++i )
+  {
+    switch ( dist( gen ) )
+    {
+    case 0u: fs.push_back( aig_create_and( aig, pick(), pick() ) ); break;
+    case 1u: fs.push_back( aig_create_xor( aig, pick(), pick() ) ); break;
+    case 2u: fs.push_back( aig_create_ite( aig, pick(), pick(), pick() ) ); break;
+    case 3u: fs.push_back( aig_create_maj( aig, pick(), pick(), pick() ) ); break;
+    }
+  }
+
+  for ( auto i = 0u; i < num_outputs; ++i )
+  {
+    aig_create_po( aig, fs[fs.size() - 1u - 3u * i] ^ ( i % 2u == 1u ), "y" + std::to_string( i ) );
+  }
+  aig_create_po( aig, aig_get_constant( aig, true ), "one" );
+
+  return aig;
+}
+
+/* encodes the AIG with and without structural encoding into one solver and
+ * checks with a miter that both encodings agree on all outputs */
+void check_structural( const aig_graph& aig, unsigned& num_vars, unsigned& num_vars_structural )
+{
+  auto solver = make_solver<minisat_solver>();
+
+  std::vector<int> piids1, poids1, piids2, poids2;
+
+  auto settings = std::make_shared<properties>();
+  settings->set( "structural", false );
+  auto statistics1 = std::make_shared<properties>();
+  auto sid = add_aig( solver, aig, 1, piids1, poids1, settings, statistics1 );
+
+  settings->set( "structural", true );
+  auto statistics2 = std::make_shared<properties>();
+  sid = add_aig( solver, aig, sid, piids2, poids2, settings, statistics2 );
+
+  for ( auto i = 0u; i < piids1.size(); ++i )
+  {
+    equals( solver, piids1[i], piids2[i] );
+  }
+
+  clause_t miter;
+  for ( auto i = 0u; i < poids1.size(); ++i )
+  {
+    logic_xor( solver, poids1[i], poids2[i], sid );
+    miter.push_back( sid++ );
+  }
+  add_clause( solver )( miter );
+
+  BOOST_CHECK( !solve( solver ) );
+
+  /* inner nodes of detected gates get no variable */
+  const auto num_vars1 = statistics1->get<std::map<aig_node, int>>( "node_var_map" ).size();
+  const auto num_vars2 = statistics2->get<std::map<aig_node, int>>( "node_var_map" ).size();
+  BOOST_CHECK( num_vars2 <= num_vars1 );
+
+  num_vars += num_vars1;
+  num_vars_structural += num_vars2;
+}
+
+BOOST_AUTO_TEST_CASE(structural_encoding)
+{
+  auto num_vars = 0u, num_vars_structural = 0u;
+  for ( auto seed = 0u; seed < 50u; ++seed )
+  {
+    check_structural( random_aig( 6u, 40u, 4u, seed ), num_vars, num_vars_structural );
+  }
+  BOOST_CHECK( num_vars_structural < num_vars );
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,119 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE aig_npn_canonization
+
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+#include <boost/format.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <core/properties.hpp>
+#include <core/utils/range_utils.hpp>
+#include <classical/aig.hpp>
+#include <classical/functions/aig_npn_canonization.hpp>
+
+using namespace cirkit;
+
+using npn_func_t = std::function<void( const aig_graph&, boost::dynamic_bitset<>&, std::vector<unsigned>&, const properties::ptr&, const properties::ptr& )>;
+
+/* random single-output AIG over AND and XOR gates */
+aig_graph create_random_aig( unsigned num_inputs, unsigned num_gates, unsigned seed )
+{
+  std::mt19937 gen( seed );
+
+  aig_graph aig;
+  aig_initialize( aig );
+
+  std::vector<aig_function> fs;
+  for ( auto i = 0u; i < num_inputs; ++i )
+  {
+    fs.push_back( aig_create_pi( aig, "x" + std::to_string( i ) ) );
+  }
+
+  const auto pick = [&]() {
+    const auto f = fs[gen() % fs.size()];
+    return ( gen() % 2u ) ? !f : f;
+  };
+
+  for ( auto i = 0u; i < num_gates; ++i )
+  {
+    const auto a = pick();
+    const auto b = pick();
+    fs.push_back( ( gen() % 3u == 0u ) ? aig_create_xor( aig, a, b ) : aig_create_and( aig, a, b ) );
+  }
+
+  aig_create_po( aig, fs.back(), "f" );
+
+  return aig;
+}
+
+/* the incremental solver (satnpn -m 2) must find the same phase and
+ * permutation as the shared miter (satnpn -m 1), also with several threads */
+BOOST_AUTO_TEST_CASE(incremental_matches_shared_miter)
+{
+  const std::vector<std::pair<npn_func_t, npn_func_t>> heuristics = {
+    {aig_npn_canonization_flip_swap_shared_miter, aig_npn_canonization_flip_swap_incremental},
+    {aig_npn_canonization_sifting_shared_miter, aig_npn_canonization_sifting_incremental}
+  };
+
+  for ( auto seed = 0u; seed < 20u; ++seed )
+  {
+    const auto aig = create_random_aig( 4u + seed % 3u, 20u, seed );
+
+    for ( const auto& h : index( heuristics ) )
+    {
+      boost::dynamic_bitset<> expected_phase;
+      std::vector<unsigned> expected_perm;
+      h.value.first( aig, expected_phase, expected_perm, properties::ptr(), properties::ptr() );
+
+      for ( auto num_threads : {1u, 4u} )
+      {
+        auto settings = std::make_shared<properties>();
+        settings->set( "num_threads", num_threads );
+
+        boost::dynamic_bitset<> phase;
+        std::vector<unsigned> perm;
+        h.value.second( aig, phase, perm, settings, properties::ptr() );
+
+        const auto msg = boost::format( "seed %d, heuristic %d, %d threads" ) % seed % h.index % num_threads;
+        BOOST_CHECK_MESSAGE( phase == expected_phase, msg );
+        BOOST_CHECK_MESSAGE( perm == expected_perm, msg );
+      }
+    }
+  }
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,190 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE compact_dsop
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <core/cube.hpp>
+#include <core/utils/temporary_filename.hpp>
+#include <classical/optimization/compact_dsop.hpp>
+
+using namespace cirkit;
+
+cube random_cube( unsigned n, std::default_random_engine& gen )
+{
+  boost::dynamic_bitset<> bits( n ), care( n );
+  for ( auto i = 0u; i < n; ++i )
+  {
+    const auto r = std::uniform_int_distribution<unsigned>( 0u, 2u )( gen );
+    if ( r == 0u ) { continue; }
+    care.set( i );
+    bits[i] = ( r == 1u );
+  }
+  return cube( bits, care );
+}
+
+bool cube_contains( const cube& c, const boost::dynamic_bitset<>& x )
+{
+  return ( ( x ^ c.bits() ) & c.care() ).none();
+}
+
+/* compare the posting-bitmap index against a linear scan */
+BOOST_AUTO_TEST_CASE(intersecting_cubes)
+{
+  std::default_random_engine gen( 11 );
+
+  for ( auto round = 0u; round < 20u; ++round )
+  {
+    const auto n = 8u;
+    connected_cube_list p;
+    for ( auto k = 0u; k < 40u; ++k )
+    {
+      p += random_cube( n, gen );
+    }
+
+    /* removal frees slots that are reused below */
+    auto remove = p.cubes();
+    remove.resize( remove.size() / 3u );
+    for ( const auto& c : remove )
+    {
+      p -= c;
+    }
+    for ( auto k = 0u; k < 10u; ++k )
+    {
+      p += random_cube( n, gen );
+    }
+
+    for ( auto k = 0u; k < 40u; ++k )
+    {
+      const auto c = random_cube( n, gen );
+
+      cube_vec_t expected;
+      for ( const auto& other : p.cubes() )
+      {
+        if ( other.match_intersect( c ) != -1 )
+        {
+          expected.push_back( other );
+        }
+      }
+
+      auto actual = p.intersecting_cubes( c );
+      std::sort( expected.begin(), expected.end() );
+      std::sort( actual.begin(), actual.end() );
+      BOOST_REQUIRE( actual == expected );
+    }
+
+    /* connected cubes and weights of each cube in the list */
+    for ( const auto& c : p.cubes() )
+    {
+      cube_vec_t expected;
+      auto weight = 0;
+      for ( const auto& other : p.cubes() )
+      {
+        const auto m = other.match_intersect( c );
+        if ( other == c || m == -1 ) { continue; }
+        expected.push_back( other );
+        weight += c.dimension() - m - 1;
+      }
+
+      auto actual = p.connected_cubes( c );
+      std::sort( expected.begin(), expected.end() );
+      std::sort( actual.begin(), actual.end() );
+      BOOST_REQUIRE( actual == expected );
+      BOOST_REQUIRE_EQUAL( p.weights().at( c ), weight );
+    }
+  }
+}
+
+/* every strategy must return disjoint cubes that cover the function exactly */
+BOOST_AUTO_TEST_CASE(random_functions)
+{
+  std::default_random_engine gen( 5 );
+
+  const std::vector<opt_cube_func_t> optfuncs = { opt_dsop_1, opt_dsop_2, opt_dsop_3, opt_dsop_4, opt_dsop_5 };
+  const std::vector<sort_cube_meta_func_t> sortfuncs = { sort_by_dimension_first, sort_by_weight_first };
+
+  for ( auto round = 0u; round < 10u; ++round )
+  {
+    const auto n = 7u;
+    const auto m = 2u;
+
+    /* random function as OR of 2n random cubes per output */
+    cube_vec_vec_t sop( m );
+    for ( auto& f : sop )
+    {
+      for ( auto k = 0u; k < 2u * n; ++k )
+      {
+        f.push_back( random_cube( n, gen ) );
+      }
+    }
+
+    temporary_filename src( "/tmp/test_compact_dsop-src-%d.pla" );
+    temporary_filename dst( "/tmp/test_compact_dsop-dst-%d.pla" );
+    common_pla_write( sop, src.name() );
+
+    for ( const auto& optfunc : optfuncs )
+    {
+      for ( const auto& sortfunc : sortfuncs )
+      {
+        auto settings = std::make_shared<properties>();
+        settings->set( "optfunc", optfunc );
+        settings->set( "sortfunc", sortfunc );
+        auto statistics = std::make_shared<properties>();
+
+        compact_dsop( dst.name(), src.name(), settings, statistics );
+
+        const auto dsop = common_pla_read( dst.name() );
+        BOOST_REQUIRE_EQUAL( dsop.size(), m );
+
+        for ( auto j = 0u; j < m; ++j )
+        {
+          for ( auto x = 0u; x < ( 1u << n ); ++x )
+          {
+            const boost::dynamic_bitset<> bits( n, x );
+
+            const auto value = std::any_of( sop[j].begin(), sop[j].end(), [&bits]( const cube& c ) { return cube_contains( c, bits ); } );
+            const auto count = std::count_if( dsop[j].begin(), dsop[j].end(), [&bits]( const cube& c ) { return cube_contains( c, bits ); } );
+
+            BOOST_REQUIRE_EQUAL( count, value ? 1 : 0 );
+          }
+        }
+      }
+    }
+  }
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
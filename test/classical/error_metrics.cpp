@@ -0,0 +1,174 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE error_metrics
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <core/properties.hpp>
+#include <classical/approximate/error_metrics.hpp>
+#include <classical/dd/bdd.hpp>
+
+using namespace cirkit;
+
+/* value of the multi-output function f (f[0] is the LSB) under input x */
+unsigned evaluate( const std::vector<std::vector<bool>>& f, unsigned x )
+{
+  auto v = 0u;
+  for ( auto k = 0u; k < f.size(); ++k )
+  {
+    if ( f[k][x] )
+    {
+      v |= 1u << k;
+    }
+  }
+  return v;
+}
+
+std::vector<std::vector<bool>> random_function( unsigned num_vars, unsigned num_outputs, std::default_random_engine& gen )
+{
+  std::bernoulli_distribution dist;
+  std::vector<std::vector<bool>> f( num_outputs, std::vector<bool>( 1u << num_vars ) );
+  for ( auto& fk : f )
+  {
+    std::generate( fk.begin(), fk.end(), [&]() { return dist( gen ); } );
+  }
+  return f;
+}
+
+/* BDD as disjunction of minterms, variable i is bit i of the input */
+std::vector<bdd> to_bdds( bdd_manager& mgr, const std::vector<std::vector<bool>>& f )
+{
+  std::vector<bdd> bdds;
+  for ( const auto& fk : f )
+  {
+    auto b = mgr.bdd_bot();
+    for ( auto x = 0u; x < fk.size(); ++x )
+    {
+      if ( !fk[x] ) { continue; }
+
+      auto minterm = mgr.bdd_top();
+      for ( auto i = 0u; i < mgr.num_vars(); ++i )
+      {
+        minterm = minterm && ( ( ( x >> i ) & 1u ) ? mgr.bdd_var( i ) : !mgr.bdd_var( i ) );
+      }
+      b = b || minterm;
+    }
+    bdds.push_back( b );
+  }
+  return bdds;
+}
+
+BOOST_AUTO_TEST_CASE(average_case_weights)
+{
+  /* f = (a, b), fhat = (a & c, b & c); the difference is f for c = 0 and 0
+   * for c = 1, i.e., it sums up to 0 + 1 + 2 + 3 over 8 inputs */
+  bdd_manager mgr( 3u, 10u );
+  const auto a = mgr.bdd_var( 0u );
+  const auto b = mgr.bdd_var( 1u );
+  const auto c = mgr.bdd_var( 2u );
+
+  const std::vector<bdd> f = { a, b };
+  const std::vector<bdd> fhat = { a && c, b && c };
+
+  BOOST_CHECK( error_rate( f, fhat ) == 3u );
+  BOOST_CHECK( worst_case( f, fhat ) == 3u );
+  BOOST_CHECK( average_case( f, fhat ) == boost::multiprecision::cpp_dec_float_100( "0.75" ) );
+}
+
+BOOST_AUTO_TEST_CASE(error_metrics_against_enumeration)
+{
+  const auto num_vars = 5u;
+  const auto num_outputs = 3u;
+
+  std::default_random_engine gen( 42u );
+  bdd_manager mgr( num_vars, 16u );
+
+  for ( auto round = 0u; round < 10u; ++round )
+  {
+    const auto tf = random_function( num_vars, num_outputs, gen );
+    const auto f = to_bdds( mgr, tf );
+
+    std::vector<std::vector<bdd>> fhats;
+    std::vector<error_metrics_t> expected;
+
+    for ( auto j = 0u; j < 8u; ++j )
+    {
+      /* the first candidate is f itself */
+      const auto tfhat = j == 0u ? tf : random_function( num_vars, num_outputs, gen );
+      fhats.push_back( to_bdds( mgr, tfhat ) );
+
+      error_metrics_t m;
+      m.error_rate = 0;
+      m.worst_case = 0;
+      auto sum = 0u;
+      for ( auto x = 0u; x < ( 1u << num_vars ); ++x )
+      {
+        const auto vf = static_cast<int>( evaluate( tf, x ) );
+        const auto vfhat = static_cast<int>( evaluate( tfhat, x ) );
+        const auto d = static_cast<unsigned>( std::abs( vf - vfhat ) );
+
+        if ( d != 0u ) { m.error_rate += 1u; }
+        m.worst_case = std::max<boost::multiprecision::uint256_t>( m.worst_case, d );
+        sum += d;
+      }
+      m.average_case = boost::multiprecision::cpp_dec_float_100( sum ) / ( 1u << num_vars );
+      expected.push_back( m );
+
+      BOOST_CHECK( error_rate( f, fhats.back() ) == m.error_rate );
+      BOOST_CHECK( worst_case( f, fhats.back() ) == m.worst_case );
+      BOOST_CHECK( average_case( f, fhats.back() ) == m.average_case );
+    }
+
+    for ( auto num_threads : {1u, 3u} )
+    {
+      auto settings = std::make_shared<properties>();
+      settings->set( "num_threads", num_threads );
+      settings->set( "log_max_objs", 16u );
+
+      const auto metrics = error_metrics( f, fhats, settings );
+      BOOST_REQUIRE( metrics.size() == fhats.size() );
+
+      for ( auto j = 0u; j < fhats.size(); ++j )
+      {
+        BOOST_CHECK( metrics[j].error_rate == expected[j].error_rate );
+        BOOST_CHECK( metrics[j].worst_case == expected[j].worst_case );
+        BOOST_CHECK( metrics[j].average_case == expected[j].average_case );
+      }
+    }
+  }
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
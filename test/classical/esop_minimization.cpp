@@ -27,6 +27,9 @@
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE esop_minimization
 
+#include <random>
+#include <vector>
+
 #include <boost/format.hpp>
 #include <boost/test/unit_test.hpp>
 
@@ -70,6 +73,80 @@ BOOST_AUTO_TEST_CASE(simple)
             << "Run-time:           " << statistics->get<double>( "runtime" ) << std::endl;
 }
 
+BOOST_AUTO_TEST_CASE(random_functions)
+{
+  using namespace cirkit;
+
+  std::default_random_engine gen( 7 );
+
+  for ( auto n = 6u; n <= 12u; n += 2u )
+  {
+    for ( auto k = 0u; k < 10u; ++k )
+    {
+      auto * cudd = Cudd_Init( n, 0, CUDD_UNIQUE_SLOTS, CUDD_CACHE_SLOTS, 0 );
+
+      /* random function as XOR of 4n random cubes */
+      auto f = Cudd_ReadLogicZero( cudd );
+      Cudd_Ref( f );
+      for ( auto c = 0u; c < 4u * n; ++c )
+      {
+        auto cube = Cudd_ReadOne( cudd );
+        Cudd_Ref( cube );
+        for ( auto i = 0u; i < n; ++i )
+        {
+          const auto r = std::uniform_int_distribution<unsigned>( 0u, 2u )( gen );
+          if ( r == 0u ) { continue; }
+
+          auto tmp = Cudd_bddAnd( cudd, cube, Cudd_NotCond( Cudd_bddIthVar( cudd, i ), r == 1u ) );
+          Cudd_Ref( tmp );
+          Cudd_RecursiveDeref( cudd, cube );
+          cube = tmp;
+        }
+
+        auto tmp = Cudd_bddXor( cudd, f, cube );
+        Cudd_Ref( tmp );
+        Cudd_RecursiveDeref( cudd, f );
+        Cudd_RecursiveDeref( cudd, cube );
+        f = tmp;
+      }
+
+      std::vector<cube_t> cubes;
+      properties::ptr settings( new properties() );
+      settings->set( "on_cube", cube_function_t( [&cubes]( const cube_t& cube ) { cubes.push_back( cube ); } ) );
+      properties::ptr statistics( new properties() );
+
+      esop_minimization( cudd, f, settings, statistics );
+
+      BOOST_CHECK_EQUAL( cubes.size(), statistics->get<unsigned>( "cube_count" ) );
+
+      /* compare ESOP against BDD on all assignments */
+      std::vector<int> assignment( n );
+      for ( auto x = 0u; x < ( 1u << n ); ++x )
+      {
+        boost::dynamic_bitset<> bits( n, x );
+        for ( auto i = 0u; i < n; ++i )
+        {
+          assignment[i] = bits[i];
+        }
+
+        auto value = false;
+        for ( const auto& cube : cubes )
+        {
+          if ( ( ( bits ^ cube.first ) & cube.second ).none() )
+          {
+            value = !value;
+          }
+        }
+
+        BOOST_REQUIRE_EQUAL( value, Cudd_Eval( cudd, f, &assignment[0] ) == Cudd_ReadOne( cudd ) );
+      }
+
+      Cudd_RecursiveDeref( cudd, f );
+      Cudd_Quit( cudd );
+    }
+  }
+}
+
 // Local Variables:
 // c-basic-offset: 2
 // eval: (c-set-offset 'substatement-open 0)
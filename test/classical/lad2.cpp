@@ -0,0 +1,134 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE lad2
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/format.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <core/properties.hpp>
+#include <classical/aig.hpp>
+#include <classical/functions/lad2.hpp>
+
+using namespace cirkit;
+
+/* random AIG, the gates refer to input perm[i] where the generator picks
+ * input i, and extra_outputs more outputs are added after the regular ones */
+aig_graph create_random_aig( unsigned num_inputs, unsigned num_gates, unsigned num_outputs, unsigned seed,
+                             const std::vector<unsigned>& perm, unsigned extra_outputs = 0u )
+{
+  std::mt19937 gen( seed );
+
+  aig_graph aig;
+  aig_initialize( aig );
+
+  std::vector<aig_function> inputs;
+  for ( auto i = 0u; i < num_inputs; ++i )
+  {
+    inputs.push_back( aig_create_pi( aig, "x" + std::to_string( i ) ) );
+  }
+
+  std::vector<aig_function> fs;
+  for ( auto i = 0u; i < num_inputs; ++i )
+  {
+    fs.push_back( inputs[perm[i]] );
+  }
+
+  const auto pick = [&]() {
+    const auto f = fs[gen() % fs.size()];
+    return ( gen() % 2u ) ? !f : f;
+  };
+
+  for ( auto i = 0u; i < num_gates; ++i )
+  {
+    const auto a = pick();
+    const auto b = pick();
+    fs.push_back( aig_create_and( aig, a, b ) );
+  }
+
+  for ( auto i = 0u; i < num_outputs + extra_outputs; ++i )
+  {
+    aig_create_po( aig, fs[fs.size() - 1u - 2u * i], "y" + std::to_string( i ) );
+  }
+
+  return aig;
+}
+
+BOOST_AUTO_TEST_CASE(threads_agree)
+{
+  const std::vector<unsigned> types = {1u, 3u};
+  auto num_found = 0u, num_not_found = 0u;
+
+  for ( auto seed = 0u; seed < 30u; ++seed )
+  {
+    const auto n = 5u;
+
+    std::vector<unsigned> identity( n ), perm( n );
+    std::iota( identity.begin(), identity.end(), 0u );
+    perm = identity;
+    std::shuffle( perm.begin(), perm.end(), std::mt19937( seed ) );
+
+    const auto pattern = create_random_aig( n, 12u, 2u, seed, identity );
+
+    /* every second target contains the pattern with permuted inputs */
+    const auto embedded = seed % 2u == 0u;
+    const auto target = create_random_aig( n, 12u, 2u, embedded ? seed : seed + 1000u, perm, 1u );
+
+    std::vector<bool> results;
+    for ( auto num_threads : {1u, 4u} )
+    {
+      auto settings = std::make_shared<properties>();
+      settings->set( "num_threads", num_threads );
+
+      std::vector<unsigned> mapping;
+      results.push_back( directed_lad2_from_aig( mapping, target, pattern, types, settings ) );
+    }
+
+    BOOST_CHECK_MESSAGE( results[0u] == results[1u], boost::format( "seed %d" ) % seed );
+    if ( embedded )
+    {
+      BOOST_CHECK_MESSAGE( results[0u], boost::format( "seed %d" ) % seed );
+    }
+    ++( results[0u] ? num_found : num_not_found );
+  }
+
+  /* both outcomes are covered */
+  BOOST_CHECK( num_found > 0u );
+  BOOST_CHECK( num_not_found > 0u );
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,157 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE linear_classification
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <classical/functions/linear_classification.hpp>
+
+using namespace cirkit;
+
+inline uint64_t function_mask( unsigned num_vars )
+{
+  return num_vars == 6u ? ~uint64_t( 0 ) : ( ( uint64_t( 1 ) << ( 1u << num_vars ) ) - 1u );
+}
+
+/* set of all linear combinations of the columns */
+uint64_t span( const std::vector<unsigned>& columns )
+{
+  uint64_t points = 1u;
+  for ( auto c : columns )
+  {
+    auto shifted = points;
+    for ( auto x = 0u; x < 64u; ++x )
+    {
+      if ( ( points >> x ) & 1u ) { shifted |= uint64_t( 1 ) << ( x ^ c ); }
+    }
+    points = shifted;
+  }
+  return points;
+}
+
+/* random invertible matrix, given by its columns */
+std::vector<unsigned> random_invertible_matrix( unsigned num_vars, std::default_random_engine& gen )
+{
+  std::uniform_int_distribution<unsigned> dist( 1u, ( 1u << num_vars ) - 1u );
+
+  std::vector<unsigned> columns( num_vars );
+  do
+  {
+    for ( auto& c : columns )
+    {
+      c = dist( gen );
+    }
+  } while ( span( columns ) != function_mask( num_vars ) );
+
+  return columns;
+}
+
+/* g(x) = f(A x ^ b) */
+uint64_t affine_transform( uint64_t func, unsigned num_vars, const std::vector<unsigned>& columns, unsigned b )
+{
+  uint64_t result{};
+  for ( auto x = 0u; x < ( 1u << num_vars ); ++x )
+  {
+    auto y = b;
+    for ( auto i = 0u; i < num_vars; ++i )
+    {
+      if ( ( x >> i ) & 1u ) { y ^= columns[i]; }
+    }
+    if ( ( func >> y ) & 1u ) { result |= uint64_t( 1 ) << x; }
+  }
+  return result;
+}
+
+BOOST_AUTO_TEST_CASE(search_matches_enumeration)
+{
+  /* all functions with 2 and 3 variables */
+  for ( auto n = 2u; n <= 3u; ++n )
+  {
+    for ( uint64_t func = 0u; func <= function_mask( n ); ++func )
+    {
+      BOOST_CHECK_EQUAL( linear_canonization( func, n, false ), exact_linear_classification( func, n ) );
+      BOOST_CHECK_EQUAL( linear_canonization( func, n, true ), exact_affine_classification( func, n ) );
+    }
+  }
+
+  /* random functions with 4 variables */
+  std::default_random_engine gen( 42 );
+  std::uniform_int_distribution<uint64_t> dist( 0u, function_mask( 4u ) );
+  for ( auto k = 0u; k < 200u; ++k )
+  {
+    const auto func = dist( gen );
+    BOOST_CHECK_EQUAL( linear_canonization( func, 4u, false ), exact_linear_classification( func, 4u ) );
+    BOOST_CHECK_EQUAL( linear_canonization( func, 4u, true ), exact_affine_classification( func, 4u ) );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(invariance_under_random_transforms)
+{
+  std::default_random_engine gen( 7 );
+
+  for ( auto n = 5u; n <= 6u; ++n )
+  {
+    std::uniform_int_distribution<uint64_t> dist( 0u, function_mask( n ) );
+    std::uniform_int_distribution<unsigned> translation( 0u, ( 1u << n ) - 1u );
+
+    for ( auto k = 0u; k < ( n == 5u ? 100u : 10u ); ++k )
+    {
+      const auto func = dist( gen );
+      const auto linear = exact_linear_classification( func, n );
+      const auto affine = exact_affine_classification( func, n );
+
+      /* representatives are class members and therefore not larger */
+      BOOST_CHECK( linear <= func );
+      BOOST_CHECK( affine <= linear );
+
+      for ( auto t = 0u; t < 5u; ++t )
+      {
+        const auto columns = random_invertible_matrix( n, gen );
+
+        const auto func_l = affine_transform( func, n, columns, 0u );
+        BOOST_CHECK_EQUAL( exact_linear_classification( func_l, n ), linear );
+
+        const auto func_a = affine_transform( func, n, columns, translation( gen ) );
+        BOOST_CHECK_EQUAL( exact_affine_classification( func_a, n ), affine );
+
+        const auto func_c = ~func_a & function_mask( n );
+        BOOST_CHECK_EQUAL( exact_affine_classification_output( func_c, n ), exact_affine_classification_output( func, n ) );
+      }
+    }
+  }
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
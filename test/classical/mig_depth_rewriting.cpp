@@ -0,0 +1,172 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE mig_depth_rewriting
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <core/graph/depth.hpp>
+#include <core/properties.hpp>
+#include <classical/mig/mig.hpp>
+#include <classical/mig/mig_rewriting.hpp>
+#include <classical/mig/mig_simulate.hpp>
+#include <classical/utils/truth_table_utils.hpp>
+
+using namespace cirkit;
+
+mig_graph create_random_mig( unsigned num_inputs, unsigned num_gates, unsigned seed )
+{
+  std::mt19937 gen( seed );
+
+  mig_graph mig;
+  mig_initialize( mig, "random" );
+
+  std::vector<mig_function> fs;
+  for ( auto i = 0u; i < num_inputs; ++i )
+  {
+    fs.push_back( mig_create_pi( mig, "x" + std::to_string( i ) ) );
+  }
+  fs.push_back( mig_get_constant( mig, false ) );
+
+  /* prefer recent nodes to get deep graphs */
+  const auto pick = [&]() {
+    const auto from = ( fs.size() > 20u && gen() % 4u ) ? fs.size() - 20u : 0u;
+    const auto f = fs[from + gen() % ( fs.size() - from )];
+    return ( gen() % 2u ) ? !f : f;
+  };
+
+  for ( auto i = 0u; i < num_gates; ++i )
+  {
+    fs.push_back( mig_create_maj( mig, pick(), pick(), pick() ) );
+  }
+
+  for ( auto i = 0u; i < 4u; ++i )
+  {
+    mig_create_po( mig, fs[fs.size() - 1u - 3u * i], "y" + std::to_string( i ) );
+  }
+
+  return mig;
+}
+
+mig_graph create_ripple_carry_adder( unsigned n )
+{
+  mig_graph mig;
+  mig_initialize( mig, "adder" );
+
+  std::vector<mig_function> as, bs;
+  for ( auto i = 0u; i < n; ++i )
+  {
+    as.push_back( mig_create_pi( mig, "a" + std::to_string( i ) ) );
+    bs.push_back( mig_create_pi( mig, "b" + std::to_string( i ) ) );
+  }
+
+  auto carry = mig_create_pi( mig, "cin" );
+  for ( auto i = 0u; i < n; ++i )
+  {
+    const auto next = mig_create_maj( mig, as[i], bs[i], carry );
+    mig_create_po( mig, mig_create_maj( mig, !next, carry, mig_create_maj( mig, as[i], bs[i], !carry ) ), "s" + std::to_string( i ) );
+    carry = next;
+  }
+  mig_create_po( mig, carry, "cout" );
+
+  return mig;
+}
+
+std::vector<tt> simulate( const mig_graph& mig )
+{
+  std::vector<tt> values;
+  for ( const auto& output : mig_info( mig ).outputs )
+  {
+    auto value = simulate_mig_function( mig, output.first, mig_tt_simulator() );
+    tt_extend( value, mig_info( mig ).inputs.size() );
+    values.push_back( value );
+  }
+  return values;
+}
+
+unsigned depth( const mig_graph& mig )
+{
+  std::vector<mig_node> outputs;
+  for ( const auto& output : mig_info( mig ).outputs )
+  {
+    outputs.push_back( output.first.node );
+  }
+
+  std::vector<unsigned> depths;
+  return compute_depth( mig, outputs, depths );
+}
+
+void check_engines( const mig_graph& mig, unsigned& sum_inplace, unsigned& sum_rebuild )
+{
+  const auto values = simulate( mig );
+  const auto d = depth( mig );
+
+  for ( auto effort : {1u, 2u} )
+  {
+    auto settings = std::make_shared<properties>();
+    settings->set( "effort", effort );
+    const auto mig_inplace = mig_depth_rewriting( mig, settings );
+
+    settings->set( "inplace", false );
+    const auto mig_rebuild = mig_depth_rewriting( mig, settings );
+
+    BOOST_CHECK( simulate( mig_inplace ) == values );
+    BOOST_CHECK( simulate( mig_rebuild ) == values );
+
+    const auto d_inplace = depth( mig_inplace );
+    BOOST_CHECK_LE( d_inplace, d );
+
+    sum_inplace += d_inplace;
+    sum_rebuild += depth( mig_rebuild );
+  }
+}
+
+BOOST_AUTO_TEST_CASE( inplace_against_rebuild )
+{
+  auto sum_inplace = 0u, sum_rebuild = 0u;
+
+  for ( auto seed = 0u; seed < 50u; ++seed )
+  {
+    check_engines( create_random_mig( 8u, 100u, seed ), sum_inplace, sum_rebuild );
+  }
+
+  check_engines( create_ripple_carry_adder( 4u ), sum_inplace, sum_rebuild );
+  check_engines( create_ripple_carry_adder( 6u ), sum_inplace, sum_rebuild );
+
+  /* single graphs may get deeper than with the rebuild engine, but not on average */
+  BOOST_CHECK_LE( sum_inplace, sum_rebuild );
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
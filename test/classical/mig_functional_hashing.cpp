@@ -0,0 +1,142 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE mig_functional_hashing
+
+#include <random>
+#include <vector>
+
+#include <boost/format.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <core/properties.hpp>
+#include <classical/mig/mig.hpp>
+#include <classical/mig/mig_functional_hashing.hpp>
+#include <classical/mig/mig_simulate.hpp>
+#include <classical/utils/truth_table_utils.hpp>
+
+using namespace cirkit;
+
+/* random MIG with multi-fanout nodes and complemented edges */
+mig_graph create_random_mig( unsigned num_inputs, unsigned num_gates, unsigned seed )
+{
+  std::mt19937 gen( seed );
+
+  mig_graph mig;
+  mig_initialize( mig, "random" );
+
+  std::vector<mig_function> fs;
+  for ( auto i = 0u; i < num_inputs; ++i )
+  {
+    fs.push_back( mig_create_pi( mig, "x" + std::to_string( i ) ) );
+  }
+  fs.push_back( mig_get_constant( mig, false ) );
+
+  const auto pick = [&]() {
+    /* prefer recent nodes to get deep cones */
+    const auto window = std::min<unsigned>( fs.size(), 3u * num_inputs );
+    const auto f = fs[fs.size() - 1u - gen() % window];
+    return ( gen() % 2u ) ? !f : f;
+  };
+
+  for ( auto i = 0u; i < num_gates; ++i )
+  {
+    fs.push_back( mig_create_maj( mig, pick(), pick(), pick() ) );
+  }
+
+  for ( auto i = 0u; i < 4u; ++i )
+  {
+    mig_create_po( mig, fs[fs.size() - 1u - 5u * i] ^ ( i % 2u == 1u ), "y" + std::to_string( i ) );
+  }
+
+  return mig;
+}
+
+std::vector<tt> simulate_outputs( const mig_graph& mig )
+{
+  const auto& info = mig_info( mig );
+
+  std::vector<tt> tts;
+  for ( const auto& output : info.outputs )
+  {
+    auto t = simulate_mig_function( mig, output.first, mig_tt_simulator() );
+    tt_extend( t, info.inputs.size() );
+    tts.push_back( t );
+  }
+  return tts;
+}
+
+BOOST_AUTO_TEST_CASE(preserves_function)
+{
+  for ( auto seed = 0u; seed < 20u; ++seed )
+  {
+    const auto mig = create_random_mig( 7u, 80u, seed );
+    const auto expected = simulate_outputs( mig );
+
+    for ( auto mode = 0u; mode < 4u; ++mode )
+    {
+      const auto top_down = mode < 2u;
+      const auto use_ffrs = mode % 2u == 0u;
+
+      std::vector<mig_graph> results;
+      for ( auto num_threads : {1u, 4u} )
+      {
+        if ( !use_ffrs && num_threads > 1u ) { continue; }
+
+        auto settings = std::make_shared<properties>();
+        settings->set( "top_down",    top_down );
+        settings->set( "use_ffrs",    use_ffrs );
+        settings->set( "num_threads", num_threads );
+        auto statistics = std::make_shared<properties>();
+
+        results.push_back( mig_functional_hashing( mig, settings, statistics ) );
+
+        BOOST_CHECK_EQUAL( statistics->get<unsigned long>( "cache_miss" ), 0ul );
+
+        const auto actual = simulate_outputs( results.back() );
+        BOOST_REQUIRE_EQUAL( actual.size(), expected.size() );
+        for ( auto i = 0u; i < expected.size(); ++i )
+        {
+          BOOST_CHECK_MESSAGE( actual[i] == expected[i], boost::format( "seed %d, mode %d, %d threads, output %d" ) % seed % mode % num_threads % i );
+        }
+      }
+
+      /* the result does not depend on the number of threads */
+      if ( results.size() == 2u )
+      {
+        BOOST_CHECK_EQUAL( boost::num_vertices( results[0u] ), boost::num_vertices( results[1u] ) );
+        BOOST_CHECK_EQUAL( boost::num_edges( results[0u] ), boost::num_edges( results[1u] ) );
+      }
+    }
+  }
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,159 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE plim_compiler
+
+#include <random>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <core/properties.hpp>
+#include <classical/mig/mig.hpp>
+#include <classical/plim/plim_compiler.hpp>
+#include <classical/plim/plim_program.hpp>
+#include <classical/plim/plim_simulate.hpp>
+
+using namespace cirkit;
+
+/* full adder with a shared carry, the sum is computed from the carry */
+mig_graph create_full_adder()
+{
+  mig_graph mig;
+  mig_initialize( mig, "full_adder" );
+
+  const auto a = mig_create_pi( mig, "a" );
+  const auto b = mig_create_pi( mig, "b" );
+  const auto c = mig_create_pi( mig, "c" );
+
+  const auto carry = mig_create_maj( mig, a, b, c );
+  const auto t = mig_create_maj( mig, a, b, !c );
+  const auto sum = mig_create_maj( mig, !carry, c, t );
+
+  mig_create_po( mig, sum, "sum" );
+  mig_create_po( mig, carry, "carry" );
+  mig_create_po( mig, !carry, "carry_n" );
+
+  return mig;
+}
+
+/* random MIG with multi-fanout nodes, complemented, constant, and duplicated
+ * outputs, and an output that is an input */
+mig_graph create_random_mig( unsigned num_inputs, unsigned num_gates, unsigned seed )
+{
+  std::mt19937 gen( seed );
+
+  mig_graph mig;
+  mig_initialize( mig, "random" );
+
+  std::vector<mig_function> fs;
+  for ( auto i = 0u; i < num_inputs; ++i )
+  {
+    fs.push_back( mig_create_pi( mig, "x" + std::to_string( i ) ) );
+  }
+  fs.push_back( mig_get_constant( mig, false ) );
+
+  const auto pick = [&]() {
+    const auto f = fs[gen() % fs.size()];
+    return ( gen() % 2u ) ? !f : f;
+  };
+
+  for ( auto i = 0u; i < num_gates; ++i )
+  {
+    fs.push_back( mig_create_maj( mig, pick(), pick(), pick() ) );
+  }
+
+  for ( auto i = 0u; i < 4u; ++i )
+  {
+    mig_create_po( mig, fs[fs.size() - 1u - 3u * i] ^ ( i % 2u == 1u ), "y" + std::to_string( i ) );
+  }
+  mig_create_po( mig, fs.back(), "y0_copy" );
+  mig_create_po( mig, mig_get_constant( mig, true ), "one" );
+  mig_create_po( mig, !fs.front(), "x0_n" );
+
+  return mig;
+}
+
+/* register 0 is the null index, no instruction may use it */
+bool uses_null_register( const plim_program& program )
+{
+  const auto is_null = []( const plim_program::operand_t& op ) {
+    const auto reg = boost::get<memristor_index>( &op );
+    return reg && !*reg;
+  };
+
+  for ( const auto& input : program.inputs() )
+  {
+    if ( !input ) { return true; }
+  }
+  for ( const auto& i : program.instructions() )
+  {
+    if ( is_null( std::get<0>( i ) ) || is_null( std::get<1>( i ) ) || !std::get<2>( i ) ) { return true; }
+  }
+  for ( const auto& output : program.outputs() )
+  {
+    if ( is_null( output.first ) ) { return true; }
+  }
+  return false;
+}
+
+void check_compiler( const mig_graph& mig )
+{
+  for ( auto strategy = 0u; strategy < 2u; ++strategy )
+  {
+    for ( auto cost_function : {true, false} )
+    {
+      auto settings = std::make_shared<properties>();
+      settings->set( "generator_strategy", strategy );
+      settings->set( "enable_cost_function", cost_function );
+
+      const auto program = compile_for_plim( mig, settings );
+
+      BOOST_CHECK( !uses_null_register( program ) );
+      BOOST_CHECK( verify_plim_program( program, mig ) );
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(full_adder)
+{
+  check_compiler( create_full_adder() );
+}
+
+BOOST_AUTO_TEST_CASE(random_migs)
+{
+  for ( auto seed = 0u; seed < 30u; ++seed )
+  {
+    check_compiler( create_random_mig( 6u, 30u, seed ) );
+  }
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
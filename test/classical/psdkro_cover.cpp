@@ -0,0 +1,226 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE psdkro_cover
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+#include <boost/format.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <classical/aig.hpp>
+#include <classical/abc/gia/gia.hpp>
+#include <classical/abc/gia/gia_bdd.hpp>
+#include <classical/functions/simulate_aig.hpp>
+#include <classical/optimization/exorcism_minimization.hpp>
+#include <classical/utils/truth_table_utils.hpp>
+
+using namespace cirkit;
+
+/* 3-bit ripple carry adder */
+aig_graph create_adder()
+{
+  aig_graph aig;
+  aig_initialize( aig );
+
+  std::vector<aig_function> a, b;
+  for ( auto i = 0u; i < 3u; ++i ) { a.push_back( aig_create_pi( aig, boost::str( boost::format( "a%d" ) % i ) ) ); }
+  for ( auto i = 0u; i < 3u; ++i ) { b.push_back( aig_create_pi( aig, boost::str( boost::format( "b%d" ) % i ) ) ); }
+
+  auto carry = aig_get_constant( aig, false );
+  for ( auto i = 0u; i < 3u; ++i )
+  {
+    aig_create_po( aig, aig_create_nary_xor( aig, {a[i], b[i], carry} ), boost::str( boost::format( "s%d" ) % i ) );
+    carry = aig_create_maj( aig, a[i], b[i], carry );
+  }
+  aig_create_po( aig, carry, "cout" );
+
+  return aig;
+}
+
+/* 2x2-bit multiplier */
+aig_graph create_multiplier()
+{
+  aig_graph aig;
+  aig_initialize( aig );
+
+  const auto a0 = aig_create_pi( aig, "a0" );
+  const auto a1 = aig_create_pi( aig, "a1" );
+  const auto b0 = aig_create_pi( aig, "b0" );
+  const auto b1 = aig_create_pi( aig, "b1" );
+
+  const auto p00 = aig_create_and( aig, a0, b0 );
+  const auto p01 = aig_create_and( aig, a0, b1 );
+  const auto p10 = aig_create_and( aig, a1, b0 );
+  const auto p11 = aig_create_and( aig, a1, b1 );
+  const auto c1  = aig_create_and( aig, p01, p10 );
+
+  aig_create_po( aig, p00, "m0" );
+  aig_create_po( aig, aig_create_xor( aig, p01, p10 ), "m1" );
+  aig_create_po( aig, aig_create_xor( aig, p11, c1 ), "m2" );
+  aig_create_po( aig, aig_create_and( aig, p11, c1 ), "m3" );
+
+  return aig;
+}
+
+/* outputs that share functions and cubes, including a constant output */
+aig_graph create_shared()
+{
+  aig_graph aig;
+  aig_initialize( aig );
+
+  std::vector<aig_function> x;
+  for ( auto i = 0u; i < 5u; ++i ) { x.push_back( aig_create_pi( aig, boost::str( boost::format( "x%d" ) % i ) ) ); }
+
+  const auto f = aig_create_xor( aig, aig_create_maj( aig, x[0], x[1], x[2] ), x[3] );
+
+  aig_create_po( aig, f, "f" );
+  aig_create_po( aig, f, "g" );
+  aig_create_po( aig, aig_create_and( aig, !f, x[4] ), "h" );
+  aig_create_po( aig, aig_create_and( aig, x[0], x[1] ), "k" );
+  aig_create_po( aig, aig_get_constant( aig, false ), "zero" );
+
+  return aig;
+}
+
+/* compares the ESOP cover against the AIG on all input assignments */
+bool is_equivalent( const aig_graph& aig, const gia_graph::esop_ptr& esop )
+{
+  const auto& info = aig_info( aig );
+  const unsigned num_inputs = info.inputs.size();
+  const unsigned num_outputs = info.outputs.size();
+
+  auto values = simulate_aig( aig, tt_simulator() );
+  std::vector<tt> spec;
+  for ( const auto& output : info.outputs )
+  {
+    auto func = values[output.first];
+    tt_extend( func, num_inputs );
+    spec.push_back( func );
+  }
+
+  for ( auto x = 0u; x < ( 1u << num_inputs ); ++x )
+  {
+    boost::dynamic_bitset<> value( num_outputs );
+
+    int i, j, lit;
+    abc::Vec_Int_t *cube;
+    Vec_WecForEachLevel( esop.get(), cube, i )
+    {
+      auto active = true;
+      Vec_IntForEachEntry( cube, lit, j )
+      {
+        if ( lit >= 0 && ( ( x >> abc::Abc_Lit2Var( lit ) ) & 1 ) == static_cast<unsigned>( abc::Abc_LitIsCompl( lit ) ) )
+        {
+          active = false;
+        }
+      }
+      if ( !active ) { continue; }
+
+      Vec_IntForEachEntry( cube, lit, j )
+      {
+        if ( lit < 0 ) { value.flip( -lit - 1 ); }
+      }
+    }
+
+    for ( auto o = 0u; o < num_outputs; ++o )
+    {
+      if ( value[o] != spec[o][x] ) { return false; }
+    }
+  }
+
+  return true;
+}
+
+const std::vector<std::function<aig_graph()>> benchmarks = {create_adder, create_multiplier, create_shared};
+
+BOOST_AUTO_TEST_CASE(multi_output_psdkro_cover)
+{
+  for ( const auto& benchmark : benchmarks )
+  {
+    const auto aig = benchmark();
+    gia_graph gia( aig );
+
+    auto cube_count = 0u;
+    for ( auto num_threads : {1u, 2u, 4u} )
+    {
+      properties::ptr settings( new properties() );
+      settings->set( "num_threads", num_threads );
+      properties::ptr statistics( new properties() );
+
+      const auto esop = gia_to_psdkro_cover( gia, settings, statistics );
+
+      BOOST_REQUIRE( esop );
+      BOOST_CHECK( is_equivalent( aig, esop ) );
+      BOOST_CHECK_EQUAL( abc::Vec_WecSize( esop.get() ), statistics->get<unsigned>( "cube_count" ) );
+
+      /* the cover does not depend on how the outputs are distributed to threads */
+      if ( num_threads == 1u )
+      {
+        cube_count = statistics->get<unsigned>( "cube_count" );
+      }
+      else
+      {
+        BOOST_CHECK_EQUAL( cube_count, statistics->get<unsigned>( "cube_count" ) );
+      }
+    }
+  }
+
+  /* outputs f and g of the last benchmark share all their cubes */
+  const auto aig = create_shared();
+  properties::ptr statistics( new properties() );
+  gia_to_psdkro_cover( gia_graph( aig ), properties::ptr(), statistics );
+  BOOST_CHECK( statistics->get<unsigned>( "shared_cubes" ) > 0u );
+}
+
+BOOST_AUTO_TEST_CASE(multi_output_exorcism)
+{
+  for ( const auto& benchmark : benchmarks )
+  {
+    const auto aig = benchmark();
+    gia_graph gia( aig );
+
+    properties::ptr settings( new properties() );
+    settings->set( "num_threads", 2u );
+
+    const auto esop = gia.compute_esop_cover( gia_graph::esop_cover_method::bdd, settings );
+    BOOST_REQUIRE( esop );
+
+    const auto esop_opt = exorcism_minimization( esop, gia.num_inputs(), gia.num_outputs() );
+    BOOST_REQUIRE( esop_opt );
+    BOOST_CHECK( is_equivalent( aig, esop_opt ) );
+  }
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,159 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE sat_sweeping_cec
+
+#include <boost/test/unit_test.hpp>
+
+#include <classical/aig.hpp>
+#include <classical/verification/sat_sweeping_cec.hpp>
+#include <classical/xmg/xmg.hpp>
+
+using namespace cirkit;
+
+/* full adder, the carry is either a majority or an AND-OR network;
+ * the buggy version computes the carry with OR instead of majority */
+aig_graph create_aig_full_adder( bool with_maj, bool buggy = false )
+{
+  aig_graph aig;
+  aig_initialize( aig );
+
+  const auto a = aig_create_pi( aig, "a" );
+  const auto b = aig_create_pi( aig, "b" );
+  const auto c = aig_create_pi( aig, "c" );
+
+  const auto ab = aig_create_xor( aig, a, b );
+  aig_create_po( aig, aig_create_xor( aig, ab, c ), "sum" );
+
+  if ( buggy )
+  {
+    aig_create_po( aig, aig_create_nary_or( aig, {a, b, c} ), "carry" );
+  }
+  else if ( with_maj )
+  {
+    aig_create_po( aig, aig_create_maj( aig, a, b, c ), "carry" );
+  }
+  else
+  {
+    aig_create_po( aig, aig_create_or( aig, aig_create_and( aig, a, b ), aig_create_and( aig, ab, c ) ), "carry" );
+  }
+
+  return aig;
+}
+
+xmg_graph create_xmg_full_adder( bool with_maj, bool buggy = false )
+{
+  xmg_graph xmg;
+
+  const auto a = xmg.create_pi( "a" );
+  const auto b = xmg.create_pi( "b" );
+  const auto c = xmg.create_pi( "c" );
+
+  const auto ab = xmg.create_xor( a, b );
+  xmg.create_po( xmg.create_xor( ab, c ), "sum" );
+
+  if ( buggy )
+  {
+    xmg.create_po( xmg.create_or( xmg.create_or( a, b ), c ), "carry" );
+  }
+  else if ( with_maj )
+  {
+    xmg.create_po( xmg.create_maj( a, b, c ), "carry" );
+  }
+  else
+  {
+    xmg.create_po( xmg.create_or( xmg.create_and( a, b ), xmg.create_and( ab, c ) ), "carry" );
+  }
+
+  return xmg;
+}
+
+BOOST_AUTO_TEST_CASE(aig_equivalence)
+{
+  const auto circuit = create_aig_full_adder( true );
+
+  BOOST_CHECK( !sat_sweeping_cec( circuit, create_aig_full_adder( false ) ) );
+
+  const auto cex = sat_sweeping_cec( circuit, create_aig_full_adder( true, true ) );
+  BOOST_REQUIRE( cex );
+  BOOST_CHECK_EQUAL( cex->in.size(), 3u );
+  BOOST_CHECK( cex->out.bits != cex->expected_out.bits );
+}
+
+BOOST_AUTO_TEST_CASE(aig_mismatched_interface)
+{
+  const auto circuit = create_aig_full_adder( true );
+
+  auto more_inputs = create_aig_full_adder( true );
+  aig_create_pi( more_inputs, "d" );
+
+  auto more_outputs = create_aig_full_adder( true );
+  aig_create_po( more_outputs, aig_get_constant( more_outputs, true ), "one" );
+
+  for ( const auto* spec : {&more_inputs, &more_outputs} )
+  {
+    const auto cex = sat_sweeping_cec( circuit, *spec );
+    BOOST_REQUIRE( cex );
+    BOOST_CHECK( cex->empty() );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(xmg_equivalence)
+{
+  const auto circuit = create_xmg_full_adder( true );
+
+  BOOST_CHECK( !sat_sweeping_cec( circuit, create_xmg_full_adder( false ) ) );
+
+  const auto cex = sat_sweeping_cec( circuit, create_xmg_full_adder( true, true ) );
+  BOOST_REQUIRE( cex );
+  BOOST_CHECK_EQUAL( cex->in.size(), 3u );
+  BOOST_CHECK( cex->out.bits != cex->expected_out.bits );
+}
+
+BOOST_AUTO_TEST_CASE(xmg_mismatched_interface)
+{
+  const auto circuit = create_xmg_full_adder( true );
+
+  auto more_inputs = create_xmg_full_adder( true );
+  more_inputs.create_pi( "d" );
+
+  auto more_outputs = create_xmg_full_adder( true );
+  more_outputs.create_po( more_outputs.get_constant( true ), "one" );
+
+  for ( const auto* spec : {&more_inputs, &more_outputs} )
+  {
+    const auto cex = sat_sweeping_cec( circuit, *spec );
+    BOOST_REQUIRE( cex );
+    BOOST_CHECK( cex->empty() );
+  }
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
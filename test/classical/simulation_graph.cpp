@@ -0,0 +1,270 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE simulation_graph
+
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+#include <boost/graph/adjacency_list.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <core/properties.hpp>
+#include <classical/aig.hpp>
+#include <classical/functions/simulate_aig.hpp>
+#include <classical/functions/simulation_graph.hpp>
+
+using namespace cirkit;
+
+/* random AIG whose outputs include a constant and an inverted input */
+aig_graph create_random_aig( unsigned num_inputs, unsigned num_gates, unsigned num_outputs, unsigned seed )
+{
+  std::mt19937 gen( seed );
+
+  aig_graph aig;
+  aig_initialize( aig );
+
+  std::vector<aig_function> fs;
+  for ( auto i = 0u; i < num_inputs; ++i )
+  {
+    fs.push_back( aig_create_pi( aig, "x" + std::to_string( i ) ) );
+  }
+
+  const auto pick = [&]() {
+    const auto f = fs[gen() % fs.size()];
+    return ( gen() % 2u ) ? !f : f;
+  };
+
+  for ( auto i = 0u; i < num_gates; ++i )
+  {
+    const auto a = pick();
+    const auto b = pick();
+    fs.push_back( ( gen() % 3u == 0u ) ? aig_create_xor( aig, a, b ) : aig_create_and( aig, a, b ) );
+  }
+
+  for ( auto i = 0u; i < num_outputs; ++i )
+  {
+    aig_create_po( aig, fs[fs.size() - 1u - i], "y" + std::to_string( i ) );
+  }
+  aig_create_po( aig, aig_get_constant( aig, false ), "zero" );
+  aig_create_po( aig, !fs.front(), "nx0" );
+
+  return aig;
+}
+
+/* output values for each vector, one pattern at a time */
+std::vector<boost::dynamic_bitset<>> simulate_vectors( const aig_graph& aig, const std::vector<boost::dynamic_bitset<>>& vectors )
+{
+  const auto& info = aig_info( aig );
+
+  std::vector<boost::dynamic_bitset<>> results;
+  for ( const auto& v : vectors )
+  {
+    const auto values = simulate_aig( aig, pattern_simulator( v ) );
+
+    boost::dynamic_bitset<> result( info.outputs.size() );
+    for ( auto j = 0u; j < info.outputs.size(); ++j )
+    {
+      result[j] = values.at( info.outputs[j].first );
+    }
+    results.push_back( result );
+  }
+  return results;
+}
+
+/* edges in the order the original builder inserted them: first all input to
+ * vector edges, vector by vector, then all vector to output edges, output by
+ * output */
+std::vector<std::pair<unsigned, unsigned>> expected_edges( unsigned n, unsigned m, const std::vector<boost::dynamic_bitset<>>& vectors,
+                                                           const std::vector<boost::dynamic_bitset<>>& results )
+{
+  std::vector<std::pair<unsigned, unsigned>> edges;
+
+  for ( auto i = 0u; i < vectors.size(); ++i )
+  {
+    for ( auto pos = 0u; pos < n; ++pos )
+    {
+      if ( vectors[i][pos] )
+      {
+        edges.push_back( {pos, n + i} );
+      }
+    }
+  }
+
+  for ( auto j = 0u; j < m; ++j )
+  {
+    for ( auto i = 0u; i < vectors.size(); ++i )
+    {
+      if ( results[i][j] )
+      {
+        edges.push_back( {n + i, n + vectors.size() + j} );
+      }
+    }
+  }
+
+  return edges;
+}
+
+std::vector<std::pair<unsigned, unsigned>> graph_edges( const simulation_graph& g )
+{
+  std::vector<std::pair<unsigned, unsigned>> edges;
+  for ( const auto& e : boost::make_iterator_range( boost::edges( g ) ) )
+  {
+    edges.push_back( {static_cast<unsigned>( boost::source( e, g ) ), static_cast<unsigned>( boost::target( e, g ) )} );
+  }
+  return edges;
+}
+
+BOOST_AUTO_TEST_CASE(edges_and_annotations)
+{
+  std::mt19937 gen( 17u );
+
+  for ( auto seed = 0u; seed < 6u; ++seed )
+  {
+    const auto n = 5u + 3u * seed;
+    const auto aig = create_random_aig( n, 60u, 3u, seed );
+    const auto& info = aig_info( aig );
+    const auto m = info.outputs.size();
+
+    /* enough vectors to fill several chunks of words */
+    std::vector<boost::dynamic_bitset<>> vectors( 1500u + 37u * seed, boost::dynamic_bitset<>( n ) );
+    for ( auto& v : vectors )
+    {
+      for ( auto pos = 0u; pos < n; ++pos )
+      {
+        v[pos] = gen() % 2u;
+      }
+    }
+
+    const auto results = simulate_vectors( aig, vectors );
+    const auto edges = expected_edges( n, m, vectors, results );
+
+    for ( auto num_threads : {1u, 4u} )
+    {
+      auto settings = std::make_shared<properties>();
+      settings->set( "annotate_simvectors", true );
+      settings->set( "num_threads", num_threads );
+
+      const auto g = create_simulation_graph( aig, vectors, settings );
+
+      BOOST_REQUIRE_EQUAL( boost::num_vertices( g ), n + vectors.size() + m );
+      BOOST_CHECK( graph_edges( g ) == edges );
+
+      const auto& vertex_in_degree  = boost::get( boost::vertex_in_degree, g );
+      const auto& vertex_out_degree = boost::get( boost::vertex_out_degree, g );
+      const auto& vertex_sim_vector = boost::get( boost::vertex_simulation_vector, g );
+      const auto& vertex_sim_result = boost::get( boost::vertex_simulation_result, g );
+
+      std::vector<unsigned> in_degree( boost::num_vertices( g ), 0u ), out_degree( boost::num_vertices( g ), 0u );
+      for ( const auto& e : edges )
+      {
+        ++out_degree[e.first];
+        ++in_degree[e.second];
+      }
+
+      for ( auto v = 0u; v < boost::num_vertices( g ); ++v )
+      {
+        BOOST_CHECK_EQUAL( vertex_in_degree[v], in_degree[v] );
+        BOOST_CHECK_EQUAL( vertex_out_degree[v], out_degree[v] );
+      }
+
+      for ( auto i = 0u; i < vectors.size(); ++i )
+      {
+        BOOST_CHECK( vertex_sim_vector[n + i] == vectors[i] );
+        BOOST_CHECK( vertex_sim_result[n + i] == results[i] );
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(simulation_signatures)
+{
+  for ( auto seed = 0u; seed < 6u; ++seed )
+  {
+    const auto n = 4u + 2u * seed;
+    const auto aig = create_random_aig( n, 40u, 2u, seed );
+    const auto& info = aig_info( aig );
+    const auto m = info.outputs.size();
+
+    for ( auto maxk : {0u, 1u, 2u} )
+    {
+      /* count the ones per vector type */
+      std::vector<unsigned> types( ( maxk + 1u ) << 1u );
+      std::vector<unsigned> partition;
+      for ( auto t = 0u; t < types.size(); ++t )
+      {
+        types[t] = t;
+      }
+      const auto vectors = create_simulation_vectors( n, types, &partition );
+      const auto results = simulate_vectors( aig, vectors );
+
+      std::vector<std::vector<unsigned>> signatures( m, std::vector<unsigned>( types.size(), 0u ) );
+      auto offset = 0u;
+      for ( auto t = 0u; t < partition.size(); ++t )
+      {
+        for ( auto i = offset; i < offset + partition[t]; ++i )
+        {
+          for ( auto j = 0u; j < m; ++j )
+          {
+            signatures[j][t] += results[i][j];
+          }
+        }
+        offset += partition[t];
+      }
+
+      BOOST_CHECK( compute_simulation_signatures( aig, maxk ) == signatures );
+
+      /* attached to the output vertices of the graph, next to its edges */
+      for ( auto num_threads : {1u, 4u} )
+      {
+        auto settings = std::make_shared<properties>();
+        settings->set( "simulation_signatures", boost::optional<unsigned>( maxk ) );
+        settings->set( "num_threads", num_threads );
+
+        const auto g = create_simulation_graph( aig, types, settings );
+        BOOST_CHECK( graph_edges( g ) == expected_edges( n, m, vectors, results ) );
+
+        const auto& vertex_simulation_signature = boost::get( boost::vertex_simulation_signature, g );
+        for ( auto j = 0u; j < m; ++j )
+        {
+          const auto& signature = vertex_simulation_signature[n + vectors.size() + j];
+          BOOST_REQUIRE( (bool)signature );
+          BOOST_CHECK( *signature == signatures[j] );
+        }
+      }
+    }
+  }
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,173 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE spectral_canonization
+
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <classical/functions/spectral_canonization.hpp>
+#include <classical/utils/truth_table_utils.hpp>
+
+using namespace cirkit;
+
+inline int sign( bool value )
+{
+  return value ? -1 : 1;
+}
+
+inline bool parity( unsigned value )
+{
+  return __builtin_popcount( value ) & 1;
+}
+
+/* straight from the definitions, in O(4^n) */
+std::vector<int> naive_walsh_spectrum( const tt& func )
+{
+  std::vector<int> spectrum( func.size(), 0 );
+  for ( auto w = 0u; w < func.size(); ++w )
+  {
+    for ( auto x = 0u; x < func.size(); ++x )
+    {
+      spectrum[w] += func[x] * sign( parity( w & x ) );
+    }
+  }
+  return spectrum;
+}
+
+std::vector<int> naive_rademacher_walsh_spectrum( const tt& func )
+{
+  std::vector<int> spectrum( func.size(), 0 );
+  for ( auto w = 0u; w < func.size(); ++w )
+  {
+    for ( auto x = 0u; x < func.size(); ++x )
+    {
+      spectrum[w] += sign( func[x] != parity( w & x ) );
+    }
+  }
+  return spectrum;
+}
+
+std::vector<int> naive_autocorrelation_spectrum( const tt& func )
+{
+  std::vector<int> spectrum( func.size(), 0 );
+  for ( auto d = 0u; d < func.size(); ++d )
+  {
+    for ( auto x = 0u; x < func.size(); ++x )
+    {
+      spectrum[d] += sign( func[x] != func[x ^ d] );
+    }
+  }
+  return spectrum;
+}
+
+void check_spectra( const tt& func )
+{
+  BOOST_CHECK( walsh_spectrum( func ) == naive_walsh_spectrum( func ) );
+  BOOST_CHECK( rademacher_walsh_spectrum( func ) == naive_rademacher_walsh_spectrum( func ) );
+  BOOST_CHECK( autocorrelation_spectrum( func ) == naive_autocorrelation_spectrum( func ) );
+}
+
+BOOST_AUTO_TEST_CASE(all_small_functions)
+{
+  for ( auto n = 1u; n <= 3u; ++n )
+  {
+    for ( auto f = 0ul; f < ( 1ul << ( 1u << n ) ); ++f )
+    {
+      check_spectra( tt( 1u << n, f ) );
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(random_functions)
+{
+  std::default_random_engine gen( 42u );
+  std::bernoulli_distribution dist;
+
+  for ( auto n = 4u; n <= 9u; ++n )
+  {
+    for ( auto i = 0u; i < 20u; ++i )
+    {
+      tt func( 1u << n );
+      for ( auto x = 0u; x < func.size(); ++x )
+      {
+        func[x] = dist( gen );
+      }
+      check_spectra( func );
+    }
+
+    check_spectra( ~tt( 1u << n ) );
+    check_spectra( tt( 1u << n ) );
+  }
+}
+
+/* x_0 x_1 ^ x_2 x_3 ^ ... is bent: all Rademacher-Walsh coefficients are
+ * +/- 2^(n/2) and all autocorrelation coefficients but the first are 0 */
+tt bent_function( unsigned n )
+{
+  tt func( 1u << n );
+  for ( auto x = 0u; x < func.size(); ++x )
+  {
+    func[x] = parity( x & ( x >> 1u ) & 0x55555555 );
+  }
+  return func;
+}
+
+BOOST_AUTO_TEST_CASE(bent_functions)
+{
+  for ( auto n = 2u; n <= 8u; n += 2u )
+  {
+    check_spectra( bent_function( n ) );
+  }
+
+  /* the squared spectrum sums up to 2^32 */
+  const auto n = 16u;
+  const auto func = bent_function( n );
+
+  const auto rw = rademacher_walsh_spectrum( func );
+  for ( auto w = 0u; w < rw.size(); ++w )
+  {
+    BOOST_REQUIRE_EQUAL( std::abs( rw[w] ), 1 << ( n / 2u ) );
+  }
+
+  const auto ac = autocorrelation_spectrum( func );
+  BOOST_CHECK_EQUAL( ac[0u], 1 << n );
+  for ( auto d = 1u; d < ac.size(); ++d )
+  {
+    BOOST_REQUIRE_EQUAL( ac[d], 0 );
+  }
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
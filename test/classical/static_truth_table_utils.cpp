@@ -0,0 +1,213 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE static_truth_table_utils
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <classical/functions/npn_canonization.hpp>
+#include <classical/utils/static_truth_table_utils.hpp>
+#include <classical/utils/truth_table_utils.hpp>
+
+using namespace cirkit;
+
+/* some tt functions work on at least 6 variables, cut back to the size of static_tt */
+inline tt fit( tt t, unsigned num_vars )
+{
+  t.resize( 1u << num_vars );
+  return t;
+}
+
+inline tt random_tt( unsigned num_vars, std::mt19937& gen )
+{
+  std::bernoulli_distribution dist;
+
+  tt t( 1u << num_vars );
+  for ( auto i = 0u; i < t.size(); ++i )
+  {
+    t[i] = dist( gen );
+  }
+  return t;
+}
+
+template<unsigned NumVars>
+void check_kernels( unsigned num_functions, std::mt19937& gen )
+{
+  for ( auto k = 0u; k < num_functions; ++k )
+  {
+    const auto t1 = random_tt( NumVars, gen );
+    const auto t2 = random_tt( NumVars, gen );
+    const static_tt<NumVars> s1( t1 ), s2( t2 );
+
+    BOOST_CHECK( s1.to_tt() == t1 );
+    BOOST_CHECK( ( ~s1 ).to_tt() == ~t1 );
+    BOOST_CHECK( ( s1 & s2 ).to_tt() == ( t1 & t2 ) );
+    BOOST_CHECK( ( s1 ^ s2 ).to_tt() == ( t1 ^ t2 ) );
+    BOOST_CHECK_EQUAL( s1 < s2, t1 < t2 );
+    BOOST_CHECK_EQUAL( s2 < s1, t2 < t1 );
+    BOOST_CHECK_EQUAL( s1.count(), t1.count() );
+    BOOST_CHECK_EQUAL( tt_num_vars( s1 ), NumVars );
+
+    for ( auto i = 0u; i < NumVars; ++i )
+    {
+      auto var = tt_nth_var( i );
+      tt_extend( var, NumVars );
+      BOOST_CHECK( static_tt<NumVars>::nth_var( i ).to_tt() == fit( var, NumVars ) );
+
+      BOOST_CHECK( tt_flip( s1, i ).to_tt() == fit( tt_flip( t1, i ), NumVars ) );
+      BOOST_CHECK( tt_cof0( s1, i ).to_tt() == fit( tt_cof0( t1, i ), NumVars ) );
+      BOOST_CHECK( tt_cof1( s1, i ).to_tt() == fit( tt_cof1( t1, i ), NumVars ) );
+      BOOST_CHECK( tt_exists( s1, i ).to_tt() == fit( tt_exists( t1, i ), NumVars ) );
+      BOOST_CHECK( tt_forall( s1, i ).to_tt() == fit( tt_forall( t1, i ), NumVars ) );
+      BOOST_CHECK_EQUAL( tt_has_var( s1, i ), tt_has_var( t1, i ) );
+      BOOST_CHECK( !tt_has_var( tt_cof0( s1, i ), i ) );
+
+      for ( auto j = 0u; j < NumVars; ++j )
+      {
+        BOOST_CHECK( tt_permute( s1, i, j ).to_tt() == fit( tt_permute( t1, i, j ), NumVars ) );
+      }
+    }
+  }
+}
+
+/* for each input permutation and input negation, the minterm that is mapped to each minterm */
+std::vector<std::vector<unsigned>> input_transformations( unsigned num_vars )
+{
+  const auto num_bits = 1u << num_vars;
+
+  std::vector<std::vector<unsigned>> transformations;
+
+  std::vector<unsigned> perm( num_vars );
+  std::iota( perm.begin(), perm.end(), 0u );
+
+  do
+  {
+    for ( auto phase = 0u; phase < num_bits; ++phase )
+    {
+      std::vector<unsigned> map( num_bits );
+      for ( auto x = 0u; x < num_bits; ++x )
+      {
+        auto y = 0u;
+        for ( auto i = 0u; i < num_vars; ++i )
+        {
+          y |= ( ( x >> i ) & 1u ) << perm[i];
+        }
+        map[x] = y ^ phase;
+      }
+      transformations.push_back( map );
+    }
+  } while ( std::next_permutation( perm.begin(), perm.end() ) );
+
+  return transformations;
+}
+
+/* smallest function over all input permutations, input negations and output negation */
+uint64_t npn_by_enumeration( uint64_t func, unsigned num_vars, const std::vector<std::vector<unsigned>>& transformations )
+{
+  const auto mask = num_vars == 6u ? ~uint64_t( 0u ) : ( uint64_t( 1u ) << ( 1u << num_vars ) ) - 1u;
+
+  auto best = func;
+  for ( const auto& map : transformations )
+  {
+    uint64_t g = 0u;
+    for ( auto x = 0u; x < map.size(); ++x )
+    {
+      g |= ( ( func >> map[x] ) & 1u ) << x;
+    }
+    best = std::min( { best, g, ~g & mask } );
+  }
+
+  return best;
+}
+
+void check_npn( uint64_t func, unsigned num_vars, const std::vector<std::vector<unsigned>>& transformations )
+{
+  const tt t( 1u << num_vars, func );
+
+  boost::dynamic_bitset<> phase;
+  std::vector<unsigned> perm;
+  const auto npn = exact_npn_canonization( t, phase, perm );
+
+  BOOST_REQUIRE_EQUAL( npn.size(), t.size() );
+  BOOST_CHECK_EQUAL( npn.to_ulong(), npn_by_enumeration( func, num_vars, transformations ) );
+  BOOST_CHECK( tt_from_npn( npn, phase, perm ) == t );
+}
+
+BOOST_AUTO_TEST_CASE( kernels_match_tt )
+{
+  std::mt19937 gen( 42u );
+
+  /* single word */
+  check_kernels<2u>( 20u, gen );
+  check_kernels<3u>( 20u, gen );
+  check_kernels<5u>( 20u, gen );
+  check_kernels<6u>( 20u, gen );
+
+  /* several words */
+  check_kernels<7u>( 10u, gen );
+  check_kernels<8u>( 10u, gen );
+  check_kernels<10u>( 5u, gen );
+}
+
+BOOST_AUTO_TEST_CASE( exact_npn_matches_enumeration )
+{
+  for ( auto n = 2u; n <= 4u; ++n )
+  {
+    const auto transformations = input_transformations( n );
+    for ( uint64_t func = 0u; func < ( uint64_t( 1u ) << ( 1u << n ) ); ++func )
+    {
+      check_npn( func, n, transformations );
+    }
+  }
+
+  std::mt19937_64 gen( 42u );
+
+  const auto transformations5 = input_transformations( 5u );
+  for ( auto k = 0u; k < 50u; ++k )
+  {
+    check_npn( gen() & 0xFFFFFFFF, 5u, transformations5 );
+  }
+
+  const auto transformations6 = input_transformations( 6u );
+  for ( auto k = 0u; k < 10u; ++k )
+  {
+    check_npn( gen(), 6u, transformations6 );
+  }
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
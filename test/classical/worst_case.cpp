@@ -0,0 +1,186 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE worst_case
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <boost/format.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <core/properties.hpp>
+#include <classical/aig.hpp>
+#include <classical/approximate/error_metrics.hpp>
+#include <classical/approximate/worst_case.hpp>
+#include <classical/dd/bdd.hpp>
+
+using namespace cirkit;
+
+/* n-bit adder with n + 1 outputs (LSB first); the lowest lower_or sum bits
+ * are computed with OR (lower-part OR adder) and the carry into bit
+ * carry_cut is dropped, if carry_cut is not 0 */
+template<typename T>
+std::vector<T> approximate_adder( const std::vector<T>& a, const std::vector<T>& b, const T& zero,
+                                  unsigned lower_or, unsigned carry_cut,
+                                  const std::function<T(const T&, const T&)>& and_op,
+                                  const std::function<T(const T&, const T&)>& or_op,
+                                  const std::function<T(const T&, const T&)>& xor_op )
+{
+  std::vector<T> sum;
+  auto carry = zero;
+
+  for ( auto i = 0u; i < a.size(); ++i )
+  {
+    if ( i < lower_or )
+    {
+      sum.push_back( or_op( a[i], b[i] ) );
+      carry = ( i + 1u == lower_or ) ? and_op( a[i], b[i] ) : zero;
+      continue;
+    }
+
+    if ( carry_cut != 0u && i == carry_cut )
+    {
+      carry = zero;
+    }
+
+    const auto p = xor_op( a[i], b[i] );
+    sum.push_back( xor_op( p, carry ) );
+    carry = or_op( and_op( a[i], b[i] ), and_op( p, carry ) );
+  }
+  sum.push_back( carry );
+
+  return sum;
+}
+
+aig_graph create_adder_aig( unsigned n, unsigned lower_or, unsigned carry_cut )
+{
+  aig_graph aig;
+  aig_initialize( aig );
+
+  std::vector<aig_function> a, b;
+  for ( auto i = 0u; i < n; ++i )
+  {
+    a.push_back( aig_create_pi( aig, "a" + std::to_string( i ) ) );
+  }
+  for ( auto i = 0u; i < n; ++i )
+  {
+    b.push_back( aig_create_pi( aig, "b" + std::to_string( i ) ) );
+  }
+
+  const auto sum = approximate_adder<aig_function>( a, b, aig_get_constant( aig, false ), lower_or, carry_cut,
+                                                    [&aig]( const aig_function& x, const aig_function& y ) { return aig_create_and( aig, x, y ); },
+                                                    [&aig]( const aig_function& x, const aig_function& y ) { return aig_create_or( aig, x, y ); },
+                                                    [&aig]( const aig_function& x, const aig_function& y ) { return aig_create_xor( aig, x, y ); } );
+
+  for ( auto i = 0u; i < sum.size(); ++i )
+  {
+    aig_create_po( aig, sum[i], "s" + std::to_string( i ) );
+  }
+
+  return aig;
+}
+
+std::vector<bdd> create_adder_bdds( bdd_manager& mgr, unsigned n, unsigned lower_or, unsigned carry_cut )
+{
+  std::vector<bdd> a, b;
+  for ( auto i = 0u; i < n; ++i )
+  {
+    a.push_back( mgr.bdd_var( i ) );
+    b.push_back( mgr.bdd_var( n + i ) );
+  }
+
+  return approximate_adder<bdd>( a, b, mgr.bdd_bot(), lower_or, carry_cut,
+                                 []( const bdd& x, const bdd& y ) { return x && y; },
+                                 []( const bdd& x, const bdd& y ) { return x || y; },
+                                 []( const bdd& x, const bdd& y ) { return x ^ y; } );
+}
+
+BOOST_AUTO_TEST_CASE(approximate_adders)
+{
+  for ( auto n = 2u; n <= 5u; ++n )
+  {
+    bdd_manager mgr( 2u * n, 16u );
+
+    const auto f = create_adder_aig( n, 0u, 0u );
+    const auto fbdd = create_adder_bdds( mgr, n, 0u, 0u );
+
+    std::vector<aig_graph> fhats;
+    std::vector<boost::multiprecision::uint256_t> expected;
+
+    for ( auto lower_or = 0u; lower_or < n; ++lower_or )
+    {
+      for ( auto carry_cut = 0u; carry_cut < n; ++carry_cut )
+      {
+        fhats.push_back( create_adder_aig( n, lower_or, carry_cut ) );
+        expected.push_back( worst_case( fbdd, create_adder_bdds( mgr, n, lower_or, carry_cut ) ) );
+
+        for ( auto num_words : {1u, 4u} )
+        {
+          auto settings = std::make_shared<properties>();
+          settings->set( "num_words", num_words );
+
+          BOOST_CHECK_MESSAGE( worst_case( f, fhats.back(), settings ) == expected.back(),
+                               boost::format( "n = %d, lower_or = %d, carry_cut = %d, num_words = %d" ) % n % lower_or % carry_cut % num_words );
+        }
+      }
+    }
+
+    for ( auto num_threads : {1u, 3u} )
+    {
+      auto settings = std::make_shared<properties>();
+      settings->set( "num_threads", num_threads );
+
+      const auto results = worst_case( f, fhats, settings );
+      BOOST_REQUIRE_EQUAL( results.size(), expected.size() );
+      for ( auto i = 0u; i < results.size(); ++i )
+      {
+        BOOST_CHECK( results[i] == expected[i] );
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(no_simulation_words)
+{
+  const auto f = create_adder_aig( 2u, 0u, 0u );
+  const auto fhat = create_adder_aig( 2u, 1u, 0u );
+
+  auto settings = std::make_shared<properties>();
+  settings->set( "num_words", 0u );
+  auto statistics = std::make_shared<properties>();
+
+  worst_case( f, fhat, settings, statistics );
+  BOOST_CHECK( statistics->has_key( "error" ) );
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,166 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE xmg_flow_map
+
+#include <algorithm>
+#include <random>
+#include <stack>
+#include <string>
+#include <vector>
+
+#include <boost/format.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <core/properties.hpp>
+#include <classical/xmg/xmg.hpp>
+#include <classical/xmg/xmg_cover.hpp>
+#include <classical/xmg/xmg_flow_map.hpp>
+
+using namespace cirkit;
+
+/* random XMG, every gate picks its fanins from all previous nodes */
+xmg_graph random_xmg( unsigned num_inputs, unsigned num_gates, unsigned num_outputs, unsigned seed )
+{
+  std::default_random_engine gen( seed );
+  std::uniform_int_distribution<unsigned> dist( 0u, 3u );
+
+  xmg_graph xmg;
+  std::vector<xmg_function> fs;
+  for ( auto i = 0u; i < num_inputs; ++i )
+  {
+    fs.push_back( xmg.create_pi( "x" + std::to_string( i ) ) );
+  }
+
+  const auto pick = [&]() {
+    return fs[std::uniform_int_distribution<unsigned>( 0u, fs.size() - 1u )( gen )] ^ ( dist( gen ) == 0u );
+  };
+
+  for ( auto i = 0u; i < num_gates; ++i )
+  {
+    fs.push_back( dist( gen ) == 0u ? xmg.create_xor( pick(), pick() ) : xmg.create_maj( pick(), pick(), pick() ) );
+  }
+
+  for ( auto i = 0u; i < num_outputs; ++i )
+  {
+    xmg.create_po( fs[fs.size() - 1u - i], "y" + std::to_string( i ) );
+  }
+
+  return xmg;
+}
+
+/* checks that the cover implements all outputs with cuts of at most
+ * cut_size leafs that separate their root from the inputs, and returns
+ * the LUT depth */
+unsigned check_cover( const xmg_graph& xmg, unsigned cut_size )
+{
+  BOOST_REQUIRE( xmg.has_cover() );
+  const auto& cover = xmg.cover();
+
+  std::vector<unsigned> depth( xmg.size(), 0u );
+  auto max_depth = 0u;
+
+  for ( auto n : xmg.topological_nodes() )
+  {
+    if ( !cover.has_cut( n ) ) { continue; }
+
+    BOOST_CHECK( !xmg.is_input( n ) );
+    BOOST_CHECK_LE( cover.num_leafs( n ), cut_size );
+
+    std::vector<unsigned> leafs( cover.cut( n ).begin(), cover.cut( n ).end() );
+    auto d = 0u;
+    for ( auto l : leafs )
+    {
+      BOOST_CHECK( xmg.is_input( l ) || cover.has_cut( l ) );
+      d = std::max( d, depth[l] );
+    }
+    depth[n] = d + 1u;
+    max_depth = std::max( max_depth, depth[n] );
+
+    /* no path from n to an input avoids the leafs */
+    std::vector<bool> visited( xmg.size(), false );
+    std::stack<xmg_node> stack;
+    stack.push( n );
+    while ( !stack.empty() )
+    {
+      const auto m = stack.top();
+      stack.pop();
+      if ( visited[m] || std::find( leafs.begin(), leafs.end(), m ) != leafs.end() ) { continue; }
+      visited[m] = true;
+
+      BOOST_CHECK( m == 0u || !xmg.is_input( m ) );
+      for ( const auto& c : xmg.children( m ) )
+      {
+        stack.push( c.node );
+      }
+    }
+  }
+
+  for ( const auto& output : xmg.outputs() )
+  {
+    BOOST_CHECK( output.first.node == 0u || xmg.is_input( output.first.node ) || cover.has_cut( output.first.node ) );
+  }
+
+  return max_depth;
+}
+
+BOOST_AUTO_TEST_CASE(priority_cuts_against_flow_map)
+{
+  for ( auto cut_size : { 4u, 6u } )
+  {
+    for ( auto seed = 1u; seed <= 10u; ++seed )
+    {
+      auto xmg = random_xmg( 8u, 200u, 4u, seed );
+
+      auto settings = std::make_shared<properties>();
+      settings->set( "cut_size", cut_size );
+      settings->set( "priority_cuts", 0u );
+      xmg_flow_map( xmg, settings );
+      const auto flow_map_depth = check_cover( xmg, cut_size );
+      const auto flow_map_luts = xmg.cover().lut_count();
+
+      settings->set( "priority_cuts", 8u );
+      xmg_flow_map( xmg, settings );
+      const auto priority_depth = check_cover( xmg, cut_size );
+      const auto priority_luts = xmg.cover().lut_count();
+
+      BOOST_TEST_MESSAGE( boost::format( "k = %d, seed = %d: FlowMap %d levels, %d LUTs; priority cuts %d levels, %d LUTs" ) % cut_size % seed % flow_map_depth % flow_map_luts % priority_depth % priority_luts );
+
+      /* the previous FlowMap mapper only sees the cuts that xmg_cuts_paged
+       * keeps per node, so it is not depth-optimal either; on these
+       * networks priority cuts are never worse in depth or LUT count */
+      BOOST_CHECK_LE( priority_depth, flow_map_depth );
+      BOOST_CHECK_LE( priority_luts, flow_map_luts );
+    }
+  }
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End: